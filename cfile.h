@@ -67,6 +67,7 @@ typedef struct _capture_file {
   epan_t      *epan;
   file_state   state;           /* Current state of capture file */
   gchar       *filename;        /* Name of capture file */
+  gchar      **set_filenames;   /* Names of the files, if opened as a file set */
   gchar       *source;          /* Temp file source, e.g. "Pipe from elsewhere" */
   gboolean     is_tempfile;     /* Is capture file a temporary file? */
   gboolean     unsaved_changes; /* Does the capture file have changes that have not been saved? */
@@ -94,6 +95,7 @@ typedef struct _capture_file {
   dfilter_t   *dfcode;          /* Compiled display filter program */
   gchar       *dfilter;         /* Display filter string */
   gboolean     redissecting;    /* TRUE if currently redissecting (cf_redissect_packets) */
+  guint32      dissection_generation; /* Incremented whenever the file is closed or redissected */
   /* search */
   gchar       *sfilter;         /* Filter, hex value, or string being searched */
   gboolean     hex;             /* TRUE if "Hex value" search was last selected */
@@ -120,6 +122,7 @@ typedef struct _capture_file {
   frame_data  *current_frame;   /* Frame data for current frame */
   gint         current_row;     /* Row number for current frame */
   epan_dissect_t *edt;          /* Protocol dissection for currently selected packet */
+  GQueue      *dissection_cache; /* Dissections of recently selected packets, most recent first */
   field_info  *finfo_selected;  /* Field info for currently selected field */
 #ifdef WANT_PACKET_EDITOR
   GTree       *edited_frames;   /* BST with modified frames */
@@ -0,0 +1,48 @@
+# Find the PCRE2 library (8-bit code units)
+#
+#  PCRE2_INCLUDE_DIRS - where to find pcre2.h
+#  PCRE2_LIBRARIES    - List of libraries when using PCRE2
+#  PCRE2_FOUND        - True if PCRE2 found
+
+include( FindWSWinLibs )
+FindWSWinLibs( "pcre2" "PCRE2_HINTS" )
+
+find_path( PCRE2_INCLUDE_DIR
+  NAMES
+  pcre2.h
+  HINTS
+    "${PCRE2_HINTS}/include"
+)
+
+find_library( PCRE2_LIBRARY
+  NAMES
+    pcre2-8
+  HINTS
+    "${PCRE2_HINTS}/lib"
+)
+
+# Retrieve the version from the header
+if( PCRE2_INCLUDE_DIR )
+  file( STRINGS "${PCRE2_INCLUDE_DIR}/pcre2.h" PCRE2_VERSION_MAJOR
+    REGEX "^#define[ \t]+PCRE2_MAJOR[ \t]+[0-9]+" )
+  string( REGEX MATCH "[0-9]+$" PCRE2_VERSION_MAJOR "${PCRE2_VERSION_MAJOR}" )
+  file( STRINGS "${PCRE2_INCLUDE_DIR}/pcre2.h" PCRE2_VERSION_MINOR
+    REGEX "^#define[ \t]+PCRE2_MINOR[ \t]+[0-9]+" )
+  string( REGEX MATCH "[0-9]+$" PCRE2_VERSION_MINOR "${PCRE2_VERSION_MINOR}" )
+  set( PCRE2_VERSION "${PCRE2_VERSION_MAJOR}.${PCRE2_VERSION_MINOR}" )
+endif()
+
+include( FindPackageHandleStandardArgs )
+find_package_handle_standard_args( PCRE2
+  REQUIRED_VARS   PCRE2_INCLUDE_DIR PCRE2_LIBRARY
+  VERSION_VAR     PCRE2_VERSION )
+
+if( PCRE2_FOUND )
+  set( PCRE2_INCLUDE_DIRS ${PCRE2_INCLUDE_DIR} )
+  set( PCRE2_LIBRARIES ${PCRE2_LIBRARY} )
+else()
+  set( PCRE2_INCLUDE_DIRS )
+  set( PCRE2_LIBRARIES )
+endif()
+
+mark_as_advanced( PCRE2_LIBRARIES PCRE2_INCLUDE_DIRS )
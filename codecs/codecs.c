@@ -213,6 +213,42 @@ size_t codec_decode(codec_handle_t codec, void *context, const void *input, size
     return (codec->decode_fn)(context, input, inputSizeBytes, output, outputSizeBytes);
 }
 
+size_t codec_decode_batch(codec_handle_t codec, void *context, guint count,
+        const void * const *inputs, const size_t *inputSizesBytes,
+        void *output, size_t outputSizeBytes, size_t *decodedSizesBytes)
+{
+    guint8 *out = (guint8 *)output;
+    size_t total = 0;
+    guint i;
+
+    if (!codec) return 0;
+
+    for (i = 0; i < count; i++) {
+        size_t needed, decoded = 0;
+
+        if (inputSizesBytes[i] > 0) {
+            /* Decoders report an upper bound when given no output */
+            needed = (codec->decode_fn)(context, inputs[i], inputSizesBytes[i], NULL, NULL);
+            if (!output) {
+                total += needed;
+                continue;
+            }
+            if (needed > outputSizeBytes - total) {
+                /* Out of room; decode nothing more */
+                for (; i < count; i++) {
+                    if (decodedSizesBytes) decodedSizesBytes[i] = 0;
+                }
+                break;
+            }
+            (codec->decode_fn)(context, inputs[i], inputSizesBytes[i], out + total, &decoded);
+        }
+        if (decodedSizesBytes) decodedSizesBytes[i] = decoded;
+        total += decoded;
+    }
+
+    return total;
+}
+
 /*
  * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
  *
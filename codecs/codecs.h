@@ -59,6 +59,28 @@ WS_DLL_PUBLIC unsigned codec_get_frequency(codec_handle_t codec, void *context);
 WS_DLL_PUBLIC size_t codec_decode(codec_handle_t codec, void *context, const void *input,
         size_t inputSizeBytes, void *output, size_t *outputSizeBytes);
 
+/** Decode several payloads in order with the same codec and context,
+ * back to back into one output buffer. This saves allocating a buffer
+ * per payload when decoding whole streams, but not calls to the codec:
+ * finding the size needed asks it for the size of each payload, and
+ * decoding asks again, to check that there's room, before decoding it,
+ * which is one call per payload more than codec_decode() needs.
+ *
+ * @param codec Codec handle.
+ * @param context Codec context from codec_init.
+ * @param count Number of payloads.
+ * @param inputs Payloads.
+ * @param inputSizesBytes Payload lengths. Zero length payloads decode to nothing.
+ * @param output Output buffer, or NULL to find the size needed.
+ * @param outputSizeBytes Size of output.
+ * @param decodedSizesBytes If non-NULL, receives the decoded size of each payload.
+ * @return The number of bytes decoded, or if output is NULL an upper bound
+ * on the size needed.
+ */
+WS_DLL_PUBLIC size_t codec_decode_batch(codec_handle_t codec, void *context, guint count,
+        const void * const *inputs, const size_t *inputSizesBytes,
+        void *output, size_t outputSizeBytes, size_t *decodedSizesBytes);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -0,0 +1,218 @@
+/* codecs_test.c
+ * Codec decoding tests and benchmarks
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib.h>
+
+#include "codecs.h"
+
+#include "G711a/G711adecode.h"
+#include "G711u/G711udecode.h"
+
+#define PAYLOAD_LEN     160     /* 20 ms of G.711 */
+#define PAYLOAD_COUNT   500     /* 10 s */
+#define PERF_SECONDS    1.0
+
+static const char *codec_names[] = { "g711U", "g711A" };
+
+static guint8 **
+codecs_test_payloads(size_t **lens)
+{
+    guint8 **payloads;
+    guint i, j;
+
+    payloads = g_new(guint8 *, PAYLOAD_COUNT);
+    *lens = g_new(size_t, PAYLOAD_COUNT);
+    for (i = 0; i < PAYLOAD_COUNT; i++) {
+        payloads[i] = (guint8 *)g_malloc(PAYLOAD_LEN);
+        for (j = 0; j < PAYLOAD_LEN; j++) {
+            payloads[i][j] = (guint8)g_test_rand_int_range(0, 256);
+        }
+        (*lens)[i] = PAYLOAD_LEN;
+    }
+    /* A lost payload, as the RTP player sees them */
+    (*lens)[PAYLOAD_COUNT / 2] = 0;
+
+    return payloads;
+}
+
+static void
+codecs_test_payloads_free(guint8 **payloads, size_t *lens)
+{
+    guint i;
+
+    for (i = 0; i < PAYLOAD_COUNT; i++) {
+        g_free(payloads[i]);
+    }
+    g_free(payloads);
+    g_free(lens);
+}
+
+/* The batch decode must match decoding each payload in turn. */
+static void
+codecs_test_batch(void)
+{
+    guint8 **payloads;
+    size_t *lens;
+    guint c, i;
+
+    payloads = codecs_test_payloads(&lens);
+
+    for (c = 0; c < G_N_ELEMENTS(codec_names); c++) {
+        codec_handle_t codec = find_codec(codec_names[c]);
+        void *ctx;
+        guint8 *batch_buff;
+        size_t batch_len, decoded, offset = 0;
+        size_t *sizes;
+
+        g_assert(codec);
+        ctx = codec_init(codec);
+
+        batch_len = codec_decode_batch(codec, ctx, PAYLOAD_COUNT,
+                (const void * const *)payloads, lens, NULL, 0, NULL);
+        g_assert(batch_len == (PAYLOAD_COUNT - 1) * PAYLOAD_LEN * 2);
+
+        batch_buff = (guint8 *)g_malloc(batch_len);
+        sizes = g_new(size_t, PAYLOAD_COUNT);
+        decoded = codec_decode_batch(codec, ctx, PAYLOAD_COUNT,
+                (const void * const *)payloads, lens, batch_buff, batch_len, sizes);
+        g_assert(decoded == batch_len);
+
+        for (i = 0; i < PAYLOAD_COUNT; i++) {
+            guint8 buff[PAYLOAD_LEN * 2];
+            size_t len = 0;
+
+            if (lens[i] == 0) {
+                g_assert(sizes[i] == 0);
+                continue;
+            }
+            codec_decode(codec, ctx, payloads[i], lens[i], buff, &len);
+            g_assert(sizes[i] == len);
+            g_assert(memcmp(batch_buff + offset, buff, len) == 0);
+            offset += len;
+        }
+
+        /* Running out of room stops decoding at a payload boundary */
+        decoded = codec_decode_batch(codec, ctx, PAYLOAD_COUNT,
+                (const void * const *)payloads, lens, batch_buff, PAYLOAD_LEN * 3, sizes);
+        g_assert(decoded == PAYLOAD_LEN * 2);
+        g_assert(sizes[0] == PAYLOAD_LEN * 2);
+        g_assert(sizes[1] == 0);
+        g_assert(sizes[PAYLOAD_COUNT - 1] == 0);
+
+        g_free(sizes);
+        g_free(batch_buff);
+        codec_release(codec, ctx);
+    }
+
+    codecs_test_payloads_free(payloads, lens);
+}
+
+/* Decoded samples per second, one payload at a time the way
+ * decode_rtp_packet does it and in one batch. */
+static void
+codecs_test_perf(void)
+{
+    guint8 **payloads;
+    size_t *lens;
+    guint c, i;
+
+    payloads = codecs_test_payloads(&lens);
+
+    for (c = 0; c < G_N_ELEMENTS(codec_names); c++) {
+        codec_handle_t codec = find_codec(codec_names[c]);
+        void *ctx = codec_init(codec);
+        guint64 samples = 0;
+        double elapsed;
+        guint8 *batch_buff;
+        size_t batch_len;
+
+        g_test_timer_start();
+        do {
+            for (i = 0; i < PAYLOAD_COUNT; i++) {
+                size_t len;
+                void *buff;
+
+                if (lens[i] == 0) continue;
+                len = codec_decode(codec, ctx, payloads[i], lens[i], NULL, NULL);
+                buff = g_malloc(len);
+                samples += codec_decode(codec, ctx, payloads[i], lens[i], buff, &len) / 2;
+                g_free(buff);
+            }
+            elapsed = g_test_timer_elapsed();
+        } while (elapsed < PERF_SECONDS);
+        g_test_maximized_result(samples / elapsed, "%-6s single %.0f samples/s",
+                codec_names[c], samples / elapsed);
+
+        batch_len = codec_decode_batch(codec, ctx, PAYLOAD_COUNT,
+                (const void * const *)payloads, lens, NULL, 0, NULL);
+        batch_buff = (guint8 *)g_malloc(batch_len);
+        samples = 0;
+        g_test_timer_start();
+        do {
+            samples += codec_decode_batch(codec, ctx, PAYLOAD_COUNT,
+                    (const void * const *)payloads, lens, batch_buff, batch_len, NULL) / 2;
+            elapsed = g_test_timer_elapsed();
+        } while (elapsed < PERF_SECONDS);
+        g_test_maximized_result(samples / elapsed, "%-6s batch  %.0f samples/s",
+                codec_names[c], samples / elapsed);
+
+        g_free(batch_buff);
+        codec_release(codec, ctx);
+    }
+
+    codecs_test_payloads_free(payloads, lens);
+}
+
+int
+main(int argc, char **argv)
+{
+    g_test_init(&argc, &argv, NULL);
+
+    register_codec("g711U", codec_g711u_init, codec_g711u_release,
+            codec_g711u_get_channels, codec_g711u_get_frequency, codec_g711u_decode);
+    register_codec("g711A", codec_g711a_init, codec_g711a_release,
+            codec_g711a_get_channels, codec_g711a_get_frequency, codec_g711a_decode);
+
+    g_test_add_func("/codecs/batch", codecs_test_batch);
+    if (g_test_perf()) {
+        g_test_add_func("/codecs/perf", codecs_test_perf);
+    }
+
+    return g_test_run();
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -168,6 +168,7 @@ static time_t                 starttime                 = 0;
 static time_t                 stoptime                  = 0;
 static gboolean               check_startstop           = FALSE;
 static gboolean               rem_vlan                  = FALSE;
+static gboolean               build_time_index          = FALSE;
 static gboolean               dup_detect                = FALSE;
 static gboolean               dup_detect_by_time        = FALSE;
 
@@ -734,6 +735,9 @@ print_usage(FILE *output)
     fprintf(output, "                         to) the given time (format as YYYY-MM-DD hh:mm:ss).\n");
     fprintf(output, "  -B <stop time>         only output packets whose timestamp is before the\n");
     fprintf(output, "                         given time (format as YYYY-MM-DD hh:mm:ss).\n");
+    fprintf(output, "                         If the input file has a time index (see\n");
+    fprintf(output, "                         --time-index) and no packets are selected by number,\n");
+    fprintf(output, "                         -A and -B use it to skip the rest of the file.\n");
     fprintf(output, "\n");
     fprintf(output, "Duplicate packet removal:\n");
     fprintf(output, "  --novlan                remove vlan info from packets before checking for duplicates.\n");
@@ -809,6 +813,9 @@ print_usage(FILE *output)
     fprintf(output, "                         If -v is used with any of the 'Duplicate Packet\n");
     fprintf(output, "                         Removal' options (-d, -D or -w) then Packet lengths\n");
     fprintf(output, "                         and MD5 hashes are printed to standard-error.\n");
+    fprintf(output, "  --time-index           write a time index for a pcap or pcapng <infile> to\n");
+    fprintf(output, "                         <infile>.tidx, for later use by -A and -B. The\n");
+    fprintf(output, "                         <outfile> may be omitted.\n");
     fprintf(output, "\n");
 }
 
@@ -935,6 +942,7 @@ main(int argc, char *argv[])
     int           opt;
     static const struct option long_options[] = {
         {"novlan", no_argument, NULL, 0x8100},
+        {"time-index", no_argument, NULL, 0x8101},
         {"help", no_argument, NULL, 'h'},
         {"version", no_argument, NULL, 'V'},
         {0, 0, 0, 0 }
@@ -1027,6 +1035,12 @@ main(int argc, char *argv[])
             break;
         }
 
+        case 0x8101:
+        {
+            build_time_index = TRUE;
+            break;
+        }
+
         case 'a':
         {
             guint frame_number;
@@ -1328,6 +1342,23 @@ main(int argc, char *argv[])
                 wtap_file_type_subtype_string(wtap_file_type_subtype(wth)));
     }
 
+    if (build_time_index) {
+        wtap_time_index_collect(wth);
+    } else if (check_startstop && (argc - optind) == 2 && !frames_user_comments) {
+        /*
+         * Packet numbers are only right if we read from the start, so
+         * only skip ahead if nothing's been selected by number.
+         */
+        if (wtap_time_index_seek(wth, argv[optind], starttime, stoptime, &read_err)) {
+            if (verbose)
+                fprintf(stderr, "Using the time index for %s.\n", argv[optind]);
+        } else if (read_err != 0) {
+            fprintf(stderr, "editcap: Can't seek in %s: %s\n", argv[optind],
+                    wtap_strerror(read_err));
+            exit(2);
+        }
+    }
+
     shb_hdrs = wtap_file_get_shb_for_new_file(wth);
     idb_inf = wtap_file_get_idb_info(wth);
     nrb_hdrs = wtap_file_get_nrb_for_new_file(wth);
@@ -1851,6 +1882,32 @@ main(int argc, char *argv[])
         if (frames_user_comments) {
             g_tree_destroy(frames_user_comments);
         }
+    } else if (build_time_index) {
+        /* Nothing to write; just read through the file for the index */
+        while (wtap_read(wth, &read_err, &read_err_info, &data_offset))
+            ;
+        if (read_err != 0) {
+            fprintf(stderr,
+                    "editcap: An error occurred while reading \"%s\": %s.\n",
+                    argv[optind], wtap_strerror(read_err));
+            if (read_err_info != NULL) {
+                fprintf(stderr, "(%s)\n", read_err_info);
+                g_free(read_err_info);
+            }
+        }
+    }
+
+    if (build_time_index) {
+        if (wtap_time_index_save(wth, argv[optind], &write_err)) {
+            if (verbose)
+                fprintf(stderr, "Wrote a time index for %s.\n", argv[optind]);
+        } else if (write_err != 0) {
+            fprintf(stderr, "editcap: Can't write the time index for %s: %s\n",
+                    argv[optind], g_strerror(write_err));
+        } else {
+            fprintf(stderr, "editcap: No time index written for %s; it is not a pcap or pcapng file, or it was not read to the end.\n",
+                    argv[optind]);
+        }
     }
 
     if (dup_detect) {
@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 
 /*
  * Win32 doesn't have SIGALRM (and it's the OS where name lookup calls
@@ -204,6 +205,56 @@ static GHashTable   *ipv4_hash_table = NULL;
 static GHashTable   *ipv6_hash_table = NULL;
 static GHashTable   *vlan_hash_table = NULL;
 
+/*
+ * LRU and expiry bookkeeping for the entries of ipv4_hash_table and
+ * ipv6_hash_table.  The hashipv4_t or hashipv6_t comes first, so the
+ * tables, and everything they hand entries out to, can treat a pointer
+ * to the wrapper as a pointer to the entry.
+ *
+ * Entries from hosts files or added by hand are pinned; they are kept
+ * off the LRU list and are never evicted or refreshed.
+ */
+typedef struct _host_cache_link {
+    struct _host_cache_link *prev;
+    struct _host_cache_link *next;
+    gpointer                 key;     /* key in the hash table */
+    time_t                   expires; /* when to ask the resolver again; 0 = never */
+    gboolean                 pinned;
+} host_cache_link_t;
+
+typedef struct {
+    hashipv4_t        host;
+    host_cache_link_t link;
+} cached_ipv4_t;
+
+typedef struct {
+    hashipv6_t        host;
+    host_cache_link_t link;
+} cached_ipv6_t;
+
+/* Sentinels; lru.next is the most recently used entry, lru.prev the least */
+static host_cache_link_t ipv4_lru;
+static host_cache_link_t ipv6_lru;
+static guint             ipv4_lru_len;
+static guint             ipv6_lru_len;
+
+/* Set while reading hosts files and adding manual entries */
+static gboolean          pin_new_hosts = FALSE;
+
+/*
+ * A name returned by get_hostname() points into its cache entry, so we
+ * don't let the limit get small enough for that entry to be evicted by
+ * the next few lookups the caller makes.
+ */
+#define HOST_CACHE_MIN_SIZE 1024
+
+static guint host_cache_size = 0;                /* 0 = unlimited */
+#ifdef HAVE_C_ARES
+static guint host_cache_ttl = 0;                 /* seconds; 0 = forever */
+static guint host_cache_negative_ttl = 0;        /* seconds; 0 = forever */
+#endif
+static host_cache_stats_t host_cache_stats;
+
 static wmem_list_t *manually_resolved_ipv4_list = NULL;
 static wmem_list_t *manually_resolved_ipv6_list = NULL;
 
@@ -240,6 +291,23 @@ static GPtrArray* extra_hosts_files = NULL;
 static hashether_t *add_eth_name(const guint8 *addr, const gchar *name);
 static void add_serv_port_cb(const guint32 port);
 
+/*
+ * The services, manuf/ethers and vlans files are read the first time
+ * something needs them rather than in addr_resolv_init(), so that runs
+ * which never resolve a name (or never resolve that kind of name) don't
+ * pay for parsing them or for keeping the tables around.
+ */
+static void initialize_services(void);
+static void initialize_ethers(void);
+static void initialize_vlans(void);
+
+#define SERVICES_LOAD_IF_NEEDED() \
+    do { if (serv_port_hashtable == NULL) initialize_services(); } while (0)
+#define ETHERS_LOAD_IF_NEEDED() \
+    do { if (eth_hashtable == NULL) initialize_ethers(); } while (0)
+#define VLANS_LOAD_IF_NEEDED() \
+    do { if (vlan_hash_table == NULL) initialize_vlans(); } while (0)
+
 
 /* http://eternallyconfuzzled.com/tuts/algorithms/jsw_tut_hashing.aspx#existing
  * One-at-a-Time hash
@@ -356,6 +424,17 @@ add_async_dns_ipv4(int type, guint32 addr)
     msg->addr.ip4 = addr;
     wmem_list_append(async_dns_queue_head, (gpointer) msg);
 }
+
+static void
+add_async_dns_ipv6(int type, const struct e_in6_addr *addr)
+{
+    async_dns_queue_msg_t *msg;
+
+    msg = wmem_new(wmem_epan_scope(), async_dns_queue_msg_t);
+    msg->family = type;
+    memcpy(&msg->addr.ip6, addr, sizeof(msg->addr.ip6));
+    wmem_list_append(async_dns_queue_head, (gpointer) msg);
+}
 #endif /* HAVE_C_ARES */
 
 typedef struct {
@@ -574,6 +653,8 @@ _serv_name_lookup(port_type proto, guint port, serv_port_t **value_ret)
 {
     serv_port_t *serv_port_table;
 
+    SERVICES_LOAD_IF_NEEDED();
+
     serv_port_table = (serv_port_t *)g_hash_table_lookup(serv_port_hashtable, &port);
 
     if (value_ret != NULL)
@@ -769,14 +850,130 @@ c_ares_ghba_cb(
 #endif /* HAVE_C_ARES */
 
 /* --------------- */
+static void
+host_cache_unlink(host_cache_link_t *link)
+{
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->prev = NULL;
+    link->next = NULL;
+}
+
+static void
+host_cache_link_first(host_cache_link_t *lru, host_cache_link_t *link)
+{
+    link->prev = lru;
+    link->next = lru->next;
+    lru->next->prev = link;
+    lru->next = link;
+}
+
+static void
+host_cache_init(host_cache_link_t *lru, guint *lru_len)
+{
+    lru->prev = lru;
+    lru->next = lru;
+    *lru_len = 0;
+}
+
+/* Make an entry the most recently used one */
+static void
+host_cache_touch(host_cache_link_t *lru, host_cache_link_t *link)
+{
+    if (link->pinned || lru->next == link)
+        return;
+    host_cache_unlink(link);
+    host_cache_link_first(lru, link);
+}
+
+static void
+host_cache_pin(host_cache_link_t *link, guint *lru_len)
+{
+    if (link->pinned)
+        return;
+    host_cache_unlink(link);
+    (*lru_len)--;
+    link->pinned = TRUE;
+    link->expires = 0;
+}
+
+/* Start the lifetime of what we know about an entry */
+static void
+host_cache_set_expiry(host_cache_link_t *link, guint8 flags)
+{
+#ifdef HAVE_C_ARES
+    guint ttl = (flags & NAME_RESOLVED) ? host_cache_ttl : host_cache_negative_ttl;
+
+    link->expires = (ttl == 0 || link->pinned) ? 0 : time(NULL) + ttl;
+#else
+    (void)flags;
+    link->expires = 0;
+#endif
+}
+
+#ifdef HAVE_C_ARES
+static gboolean
+host_cache_expired(host_cache_link_t *link, guint8 flags)
+{
+    if (link->expires == 0 || time(NULL) < link->expires)
+        return FALSE;
+
+    host_cache_stats.expirations++;
+    host_cache_set_expiry(link, flags);
+    return TRUE;
+}
+#endif
+
+/* Drop least recently used entries until we're within the size limit */
+static void
+host_cache_trim(GHashTable *table, host_cache_link_t *lru, guint *lru_len)
+{
+    guint limit;
+
+    if (host_cache_size == 0)
+        return;
+
+    limit = MAX(host_cache_size, HOST_CACHE_MIN_SIZE);
+    while (*lru_len > limit) {
+        host_cache_link_t *victim = lru->prev;
+
+        host_cache_unlink(victim);
+        (*lru_len)--;
+        /* This frees the entry */
+        g_hash_table_remove(table, victim->key);
+        host_cache_stats.evictions++;
+    }
+}
+
+static void
+host_cache_add(GHashTable *table, host_cache_link_t *lru, guint *lru_len,
+        host_cache_link_t *link, gpointer key, gpointer entry)
+{
+    link->key = key;
+    link->expires = 0;
+    link->pinned = pin_new_hosts;
+    link->prev = NULL;
+    link->next = NULL;
+    g_hash_table_insert(table, key, entry);
+    if (!link->pinned) {
+        host_cache_link_first(lru, link);
+        (*lru_len)++;
+        host_cache_trim(table, lru, lru_len);
+    }
+}
+
 static hashipv4_t *
 new_ipv4(const guint addr)
 {
-    hashipv4_t *tp = wmem_new(wmem_epan_scope(), hashipv4_t);
+    cached_ipv4_t *entry = g_new(cached_ipv4_t, 1);
+    hashipv4_t *tp = &entry->host;
+
     tp->addr = addr;
     tp->flags = 0;
     tp->name[0] = '\0';
     ip_to_str_buf((const guint8 *)&addr, tp->ip, sizeof(tp->ip));
+    host_cache_add(ipv4_hash_table, &ipv4_lru, &ipv4_lru_len,
+            &entry->link, GUINT_TO_POINTER(addr), entry);
     return tp;
 }
 
@@ -784,6 +981,7 @@ static hashipv4_t *
 host_lookup(const guint addr)
 {
     hashipv4_t * volatile tp;
+    cached_ipv4_t *entry;
 
     tp = (hashipv4_t *)g_hash_table_lookup(ipv4_hash_table, GUINT_TO_POINTER(addr));
     if (tp == NULL) {
@@ -791,10 +989,25 @@ host_lookup(const guint addr)
          * We don't already have an entry for this host name; create one,
          * and then try to resolve it.
          */
+        host_cache_stats.misses++;
         tp = new_ipv4(addr);
-        g_hash_table_insert(ipv4_hash_table, GUINT_TO_POINTER(addr), tp);
-    } else if ((tp->flags & DUMMY_AND_RESOLVE_FLGS) != DUMMY_ADDRESS_ENTRY) {
-        return tp;
+    } else {
+        host_cache_stats.hits++;
+        entry = (cached_ipv4_t *)tp;
+        host_cache_touch(&ipv4_lru, &entry->link);
+#ifdef HAVE_C_ARES
+        if (host_cache_expired(&entry->link, tp->flags)) {
+            /* Ask again, but keep what we have until we get an answer */
+            if (gbl_resolv_flags.network_name &&
+                    gbl_resolv_flags.use_external_net_name_resolver &&
+                    async_dns_initialized && name_resolve_concurrency > 0) {
+                add_async_dns_ipv4(AF_INET, addr);
+            }
+            return tp;
+        }
+#endif
+        if ((tp->flags & DUMMY_AND_RESOLVE_FLGS) != DUMMY_ADDRESS_ENTRY)
+            return tp;
     }
 
     /*
@@ -808,6 +1021,7 @@ host_lookup(const guint addr)
 
     if (gbl_resolv_flags.use_external_net_name_resolver) {
         tp->flags |= TRIED_RESOLVE_ADDRESS;
+        host_cache_set_expiry(&((cached_ipv4_t *)tp)->link, tp->flags);
 
 #ifdef HAVE_C_ARES
         if (async_dns_initialized && name_resolve_concurrency > 0) {
@@ -824,11 +1038,16 @@ host_lookup(const guint addr)
 static hashipv6_t *
 new_ipv6(const struct e_in6_addr *addr)
 {
-    hashipv6_t *tp = wmem_new(wmem_epan_scope(), hashipv6_t);
+    cached_ipv6_t *entry = g_new(cached_ipv6_t, 1);
+    hashipv6_t *tp = &entry->host;
+
     memcpy(tp->addr, addr->bytes, sizeof tp->addr);
     tp->flags = 0;
     tp->name[0] = '\0';
     ip6_to_str_buf(addr, tp->ip6, sizeof(tp->ip6));
+    /* The entry's own copy of the address is the key */
+    host_cache_add(ipv6_hash_table, &ipv6_lru, &ipv6_lru_len,
+            &entry->link, tp->addr, entry);
     return tp;
 }
 
@@ -837,9 +1056,7 @@ static hashipv6_t *
 host_lookup6(const struct e_in6_addr *addr)
 {
     hashipv6_t * volatile tp;
-#ifdef HAVE_C_ARES
-    async_dns_queue_msg_t *caqm;
-#endif
+    cached_ipv6_t *entry;
 
     tp = (hashipv6_t *)g_hash_table_lookup(ipv6_hash_table, addr);
     if (tp == NULL) {
@@ -847,14 +1064,25 @@ host_lookup6(const struct e_in6_addr *addr)
          * We don't already have an entry for this host name; create one,
          * and then try to resolve it.
          */
-        struct e_in6_addr *addr_key;
-
-        addr_key = wmem_new(wmem_epan_scope(), struct e_in6_addr);
+        host_cache_stats.misses++;
         tp = new_ipv6(addr);
-        memcpy(addr_key, addr, 16);
-        g_hash_table_insert(ipv6_hash_table, addr_key, tp);
-    } else if ((tp->flags & DUMMY_AND_RESOLVE_FLGS) != DUMMY_ADDRESS_ENTRY) {
-        return tp;
+    } else {
+        host_cache_stats.hits++;
+        entry = (cached_ipv6_t *)tp;
+        host_cache_touch(&ipv6_lru, &entry->link);
+#ifdef HAVE_C_ARES
+        if (host_cache_expired(&entry->link, tp->flags)) {
+            /* Ask again, but keep what we have until we get an answer */
+            if (gbl_resolv_flags.network_name &&
+                    gbl_resolv_flags.use_external_net_name_resolver &&
+                    async_dns_initialized && name_resolve_concurrency > 0) {
+                add_async_dns_ipv6(AF_INET6, addr);
+            }
+            return tp;
+        }
+#endif
+        if ((tp->flags & DUMMY_AND_RESOLVE_FLGS) != DUMMY_ADDRESS_ENTRY)
+            return tp;
     }
 
     /*
@@ -868,12 +1096,10 @@ host_lookup6(const struct e_in6_addr *addr)
 
     if (gbl_resolv_flags.use_external_net_name_resolver) {
         tp->flags |= TRIED_RESOLVE_ADDRESS;
+        host_cache_set_expiry(&((cached_ipv6_t *)tp)->link, tp->flags);
 #ifdef HAVE_C_ARES
         if (async_dns_initialized && name_resolve_concurrency > 0) {
-            caqm = wmem_new(wmem_epan_scope(), async_dns_queue_msg_t);
-            caqm->family = AF_INET6;
-            memcpy(&caqm->addr.ip6, addr, sizeof(caqm->addr.ip6));
-            wmem_list_append(async_dns_queue_head, (gpointer) caqm);
+            add_async_dns_ipv6(AF_INET6, addr);
         }
 #endif
     }
@@ -1204,6 +1430,8 @@ manuf_name_lookup(const guint8 *addr)
     guint8       oct;
     hashmanuf_t  *manuf_value;
 
+    ETHERS_LOAD_IF_NEEDED();
+
     /* manuf needs only the 3 most significant octets of the ethernet address */
     manuf_key = addr[0];
     manuf_key = manuf_key<<8;
@@ -1246,9 +1474,7 @@ wka_name_lookup(const guint8 *addr, const unsigned int mask)
     gint       i;
     gchar     *name;
 
-    if (wka_hashtable == NULL) {
-        return NULL;
-    }
+    ETHERS_LOAD_IF_NEEDED();
     /* Get the part of the address covered by the mask. */
     for (i = 0, num = mask; num >= 8; i++, num -= 8)
         masked_addr[i] = addr[i];   /* copy octets entirely covered by the mask */
@@ -1300,6 +1526,8 @@ initialize_ethers(void)
     char    *manuf_path;
     guint    mask = 0;
 
+    g_assert(eth_hashtable == NULL);
+
     /* hash table initialization */
     wka_hashtable   = g_hash_table_new(eth_addr_hash, eth_addr_cmp);
     manuf_hashtable = g_hash_table_new(g_int_hash, g_int_equal);
@@ -1502,6 +1730,8 @@ add_eth_name(const guint8 *addr, const gchar *name)
 {
     hashether_t *tp;
 
+    ETHERS_LOAD_IF_NEEDED();
+
     tp = (hashether_t *)g_hash_table_lookup(eth_hashtable, addr);
 
     if (tp == NULL) {
@@ -1522,6 +1752,8 @@ eth_name_lookup(const guint8 *addr, const gboolean resolve)
 {
     hashether_t  *tp;
 
+    ETHERS_LOAD_IF_NEEDED();
+
     tp = (hashether_t *)g_hash_table_lookup(eth_hashtable, addr);
     if (tp == NULL) {
         tp = eth_hash_new_entry(addr, resolve);
@@ -1970,6 +2202,8 @@ vlan_name_lookup(const guint id)
     hashvlan_t *tp;
     vlan_t *vlan;
 
+    VLANS_LOAD_IF_NEEDED();
+
     tp = (hashvlan_t *)g_hash_table_lookup(vlan_hash_table, &id);
     if (tp == NULL) {
         int *key;
@@ -2143,9 +2377,21 @@ ipv6_hash_table_resolved_to_list(gpointer key _U_, gpointer value, gpointer user
 
 }
 
+static void
+free_addrinfo_lists(void)
+{
+    g_list_free(addrinfo_lists.ipv4_addr_list);
+    addrinfo_lists.ipv4_addr_list = NULL;
+    g_list_free(addrinfo_lists.ipv6_addr_list);
+    addrinfo_lists.ipv6_addr_list = NULL;
+}
+
 addrinfo_lists_t *
 get_addrinfo_list(void) {
 
+    /* Entries can be evicted from the tables, so start from scratch */
+    free_addrinfo_lists();
+
     if (ipv4_hash_table) {
         g_hash_table_foreach(ipv4_hash_table, ipv4_hash_table_resolved_to_list, &addrinfo_lists);
     }
@@ -2398,6 +2644,20 @@ addr_resolve_pref_init(module_t *nameres)
             " your DNS server behave badly.",
             10,
             &name_resolve_concurrency);
+
+    prefs_register_uint_preference(nameres, "hosts_cache_ttl",
+            "Resolved name lifetime (seconds)",
+            "How long a name returned by the external resolver is used"
+            " before the address is looked up again. 0 means forever.",
+            10,
+            &host_cache_ttl);
+
+    prefs_register_uint_preference(nameres, "hosts_cache_negative_ttl",
+            "Failed lookup lifetime (seconds)",
+            "How long to wait before retrying an address the external"
+            " resolver couldn't find a name for. 0 means never retry.",
+            10,
+            &host_cache_negative_ttl);
 #else
     prefs_register_static_text_preference(nameres, "use_external_name_resolver",
             "Use an external network name resolver: N/A",
@@ -2405,6 +2665,17 @@ addr_resolve_pref_init(module_t *nameres)
             " compiled into this version of Wireshark");
 #endif
 
+    prefs_register_uint_preference(nameres, "hosts_cache_size",
+            "Maximum cached addresses",
+            "The maximum number of IPv4 and, separately, IPv6 addresses"
+            " to keep names for; the least recently used ones are"
+            " dropped beyond that. Addresses from \"hosts\" files are"
+            " always kept. 0 means no limit; other values below "
+            G_STRINGIFY(HOST_CACHE_MIN_SIZE) " are raised to "
+            G_STRINGIFY(HOST_CACHE_MIN_SIZE) ".",
+            10,
+            &host_cache_size);
+
     prefs_register_bool_preference(nameres, "hosts_file_handling",
             "Only use the profile \"hosts\" file",
             "By default \"hosts\" files will be loaded from multiple sources."
@@ -2562,7 +2833,8 @@ add_ipv4_name(const guint addr, const gchar *name)
     tp = (hashipv4_t *)g_hash_table_lookup(ipv4_hash_table, GUINT_TO_POINTER(addr));
     if (!tp) {
         tp = new_ipv4(addr);
-        g_hash_table_insert(ipv4_hash_table, GUINT_TO_POINTER(addr), tp);
+    } else if (pin_new_hosts) {
+        host_cache_pin(&((cached_ipv4_t *)tp)->link, &ipv4_lru_len);
     }
 
     if (g_ascii_strcasecmp(tp->name, name)) {
@@ -2570,6 +2842,7 @@ add_ipv4_name(const guint addr, const gchar *name)
         new_resolved_objects = TRUE;
     }
     tp->flags |= TRIED_RESOLVE_ADDRESS|NAME_RESOLVED;
+    host_cache_set_expiry(&((cached_ipv4_t *)tp)->link, tp->flags);
 } /* add_ipv4_name */
 
 /* -------------------------- */
@@ -2587,12 +2860,9 @@ add_ipv6_name(const struct e_in6_addr *addrp, const gchar *name)
 
     tp = (hashipv6_t *)g_hash_table_lookup(ipv6_hash_table, addrp);
     if (!tp) {
-        struct e_in6_addr *addr_key;
-
-        addr_key = wmem_new(wmem_epan_scope(), struct e_in6_addr);
         tp = new_ipv6(addrp);
-        memcpy(addr_key, addrp, 16);
-        g_hash_table_insert(ipv6_hash_table, addr_key, tp);
+    } else if (pin_new_hosts) {
+        host_cache_pin(&((cached_ipv6_t *)tp)->link, &ipv6_lru_len);
     }
 
     if (g_ascii_strcasecmp(tp->name, name)) {
@@ -2600,6 +2870,7 @@ add_ipv6_name(const struct e_in6_addr *addrp, const gchar *name)
         new_resolved_objects = TRUE;
     }
     tp->flags |= TRIED_RESOLVE_ADDRESS|NAME_RESOLVED;
+    host_cache_set_expiry(&((cached_ipv6_t *)tp)->link, tp->flags);
 } /* add_ipv6_name */
 
 static void
@@ -2640,10 +2911,12 @@ host_name_lookup_init(void)
     ipxnet_hash_table = g_hash_table_new(g_int_hash, g_int_equal);
 
     g_assert(ipv4_hash_table == NULL);
-    ipv4_hash_table = g_hash_table_new(g_direct_hash, g_direct_equal);
+    ipv4_hash_table = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+    host_cache_init(&ipv4_lru, &ipv4_lru_len);
 
     g_assert(ipv6_hash_table == NULL);
-    ipv6_hash_table = g_hash_table_new(ipv6_oat_hash, ipv6_equal);
+    ipv6_hash_table = g_hash_table_new_full(ipv6_oat_hash, ipv6_equal, NULL, g_free);
+    host_cache_init(&ipv6_lru, &ipv6_lru_len);
 
 #ifdef HAVE_C_ARES
     g_assert(async_dns_queue_head == NULL);
@@ -2656,6 +2929,12 @@ host_name_lookup_init(void)
     if (manually_resolved_ipv6_list == NULL)
         manually_resolved_ipv6_list = wmem_list_new(wmem_epan_scope());
 
+    /*
+     * Names from hosts files and added by hand are kept for as long
+     * as the tables are.
+     */
+    pin_new_hosts = TRUE;
+
     /*
      * Load the global hosts file, if we have one.
      */
@@ -2696,6 +2975,8 @@ host_name_lookup_init(void)
     subnet_name_lookup_init();
 
     add_manually_resolved();
+
+    pin_new_hosts = FALSE;
 }
 
 void
@@ -2706,6 +2987,8 @@ host_name_lookup_cleanup(void)
 
     _host_name_lookup_cleanup();
 
+    free_addrinfo_lists();
+
     if (ipxnet_hash_table) {
         g_hash_table_destroy(ipxnet_hash_table);
         ipxnet_hash_table = NULL;
@@ -3017,6 +3300,8 @@ get_manuf_name_if_known(const guint8 *addr)
     oct = addr[2];
     manuf_key = manuf_key | oct;
 
+    ETHERS_LOAD_IF_NEEDED();
+
     manuf_value = (hashmanuf_t *)g_hash_table_lookup(manuf_hashtable, &manuf_key);
     if ((manuf_value == NULL) || (manuf_value->status != HASHETHER_STATUS_UNRESOLVED)) {
         return NULL;
@@ -3031,6 +3316,8 @@ uint_get_manuf_name_if_known(const guint manuf_key)
 {
     hashmanuf_t *manuf_value;
 
+    ETHERS_LOAD_IF_NEEDED();
+
     manuf_value = (hashmanuf_t *)g_hash_table_lookup(manuf_hashtable, &manuf_key);
     if ((manuf_value == NULL) || (manuf_value->status != HASHETHER_STATUS_UNRESOLVED)) {
         return NULL;
@@ -3234,24 +3521,28 @@ get_host_ipaddr6(const char *host, struct e_in6_addr *addrp)
 GHashTable *
 get_manuf_hashtable(void)
 {
+    ETHERS_LOAD_IF_NEEDED();
     return manuf_hashtable;
 }
 
 GHashTable *
 get_wka_hashtable(void)
 {
+    ETHERS_LOAD_IF_NEEDED();
     return wka_hashtable;
 }
 
 GHashTable *
 get_eth_hashtable(void)
 {
+    ETHERS_LOAD_IF_NEEDED();
     return eth_hashtable;
 }
 
 GHashTable *
 get_serv_port_hashtable(void)
 {
+    SERVICES_LOAD_IF_NEEDED();
     return serv_port_hashtable;
 }
 
@@ -3264,9 +3555,18 @@ get_ipxnet_hash_table(void)
 GHashTable *
 get_vlan_hash_table(void)
 {
+        VLANS_LOAD_IF_NEEDED();
         return vlan_hash_table;
 }
 
+void
+get_host_cache_stats(host_cache_stats_t *stats)
+{
+    *stats = host_cache_stats;
+    stats->entries = (ipv4_hash_table ? g_hash_table_size(ipv4_hash_table) : 0) +
+        (ipv6_hash_table ? g_hash_table_size(ipv6_hash_table) : 0);
+}
+
 GHashTable *
 get_ipv4_hash_table(void)
 {
@@ -3282,10 +3582,8 @@ get_ipv6_hash_table(void)
 void
 addr_resolv_init(void)
 {
-    initialize_services();
-    initialize_ethers();
+    /* services, ethers and vlans are loaded on first use */
     initialize_ipxnets();
-    initialize_vlans();
     /* host name initialization is done on a per-capture-file basis */
     /*host_name_lookup_init();*/
 }
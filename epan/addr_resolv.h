@@ -347,6 +347,18 @@ GHashTable *get_ipv4_hash_table(void);
 WS_DLL_PUBLIC
 GHashTable *get_ipv6_hash_table(void);
 
+/** Counters for the IPv4 and IPv6 host name caches, summed over both */
+typedef struct _host_cache_stats_t {
+    guint64 hits;        /**< lookups of an address that was already cached */
+    guint64 misses;      /**< lookups that had to add an address */
+    guint64 evictions;   /**< addresses dropped to stay within nameres.hosts_cache_size */
+    guint64 expirations; /**< addresses looked up again after their lifetime ran out */
+    guint   entries;     /**< addresses currently cached */
+} host_cache_stats_t;
+
+WS_DLL_PUBLIC
+void get_host_cache_stats(host_cache_stats_t *stats);
+
 /*
  * private functions (should only be called by epan directly)
  */
@@ -0,0 +1,165 @@
+/* addr_resolv_test.c
+ * Tests for the bounded host name caches
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <glib.h>
+
+#include "epan.h"
+#include "prefs.h"
+#include "addr_resolv.h"
+
+/* The smallest limit nameres.hosts_cache_size can set */
+#define CACHE_SIZE 1024
+
+/* Addresses from the benchmarking range, 198.18.0.0/15, which no hosts
+   file should name */
+#define PINNED_ADDR "198.18.0.1"
+#define PINNED_NAME "pinned.example"
+#define TEST_ADDR(i) g_htonl(0xC6130000 + (i))
+
+static void
+register_nothing(register_cb cb _U_, gpointer client_data _U_)
+{
+}
+
+/* Start each test with empty tables, apart from what's pinned */
+static void
+reset_host_cache(void)
+{
+    host_name_lookup_cleanup();
+    host_name_lookup_init();
+}
+
+static gboolean
+is_cached(guint addr)
+{
+    return g_hash_table_lookup(get_ipv4_hash_table(), GUINT_TO_POINTER(addr)) != NULL;
+}
+
+static void
+addr_resolv_test_lru(void)
+{
+    host_cache_stats_t before, after;
+    guint i;
+
+    reset_host_cache();
+    get_host_cache_stats(&before);
+
+    /* Fill the cache exactly */
+    for (i = 0; i < CACHE_SIZE; i++)
+        get_hostname(TEST_ADDR(i));
+    get_host_cache_stats(&after);
+    g_assert_cmpuint(after.misses - before.misses, ==, CACHE_SIZE);
+    g_assert_cmpuint(after.evictions - before.evictions, ==, 0);
+
+    /* Using the oldest entry makes the second oldest the one to go */
+    get_hostname(TEST_ADDR(0));
+    get_hostname(TEST_ADDR(CACHE_SIZE));
+    get_host_cache_stats(&after);
+    g_assert_cmpuint(after.hits - before.hits, ==, 1);
+    g_assert_cmpuint(after.evictions - before.evictions, ==, 1);
+    g_assert(is_cached(TEST_ADDR(0)));
+    g_assert(!is_cached(TEST_ADDR(1)));
+    g_assert(is_cached(TEST_ADDR(2)));
+    g_assert(is_cached(TEST_ADDR(CACHE_SIZE)));
+
+    /* Another round evicts everything but the newest CACHE_SIZE */
+    for (i = CACHE_SIZE + 1; i < 3 * CACHE_SIZE; i++)
+        get_hostname(TEST_ADDR(i));
+    get_host_cache_stats(&after);
+    g_assert_cmpuint(after.evictions - before.evictions, ==, 2 * CACHE_SIZE);
+    g_assert(!is_cached(TEST_ADDR(0)));
+    g_assert(!is_cached(TEST_ADDR(2 * CACHE_SIZE - 1)));
+    g_assert(is_cached(TEST_ADDR(2 * CACHE_SIZE)));
+    g_assert(is_cached(TEST_ADDR(3 * CACHE_SIZE - 1)));
+}
+
+static void
+addr_resolv_test_pinned(void)
+{
+    host_cache_stats_t before, after;
+    hashipv4_t *tp;
+    guint32 pinned;
+    guint i;
+
+    g_assert(str_to_ip(PINNED_ADDR, &pinned));
+
+    reset_host_cache();
+    get_host_cache_stats(&before);
+
+    /* A lookup of a pinned address is a hit, and doesn't evict anything */
+    get_hostname(pinned);
+    for (i = 0; i < 4 * CACHE_SIZE; i++)
+        get_hostname(TEST_ADDR(i));
+    get_host_cache_stats(&after);
+    g_assert_cmpuint(after.hits - before.hits, ==, 1);
+    g_assert_cmpuint(after.evictions - before.evictions, ==, 3 * CACHE_SIZE);
+
+    /* The pinned address is never the least recently used one */
+    tp = (hashipv4_t *)g_hash_table_lookup(get_ipv4_hash_table(), GUINT_TO_POINTER(pinned));
+    g_assert(tp != NULL);
+    g_assert_cmpstr(tp->name, ==, PINNED_NAME);
+}
+
+int
+main(int argc, char **argv)
+{
+    int result;
+    char *prefarg;
+
+    g_test_init(&argc, &argv, NULL);
+
+    epan_init(register_nothing, register_nothing, NULL, NULL);
+    prefs_reset();
+    prefarg = g_strdup_printf("nameres.hosts_cache_size:%d", CACHE_SIZE);
+    g_assert(prefs_set_pref(prefarg) == PREFS_SET_OK);
+    g_free(prefarg);
+
+    /* Addresses added by hand are pinned when the tables are set up */
+    host_name_lookup_init();
+    g_assert(add_ip_name_from_string(PINNED_ADDR, PINNED_NAME));
+
+    g_test_add_func("/addr_resolv/host_cache/lru", addr_resolv_test_lru);
+    g_test_add_func("/addr_resolv/host_cache/pinned", addr_resolv_test_pinned);
+
+    result = g_test_run();
+
+    host_name_lookup_cleanup();
+    epan_cleanup();
+
+    return result;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
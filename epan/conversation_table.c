@@ -216,62 +216,99 @@ register_ct_t *get_conversation_table_by_num(guint table_num)
     return (register_ct_t *) g_slist_nth_data(registered_ct_tables, table_num);
 }
 
+/** Slot in a conv_hash_t. */
+struct _conv_hash_slot {
+    guint hash_val;     /**< hash value of the entry */
+    guint index;        /**< conv_array index + 1, or 0 if the slot is empty */
+};
+
+#define CONV_HASH_MIN_SLOTS 256
+
+/** Finish a hash value computed with add_address_to_hash, so that its low
+ * bits (which we use to pick a slot) depend on all of the input.
+ */
+static guint
+finish_hash(guint hash_val)
+{
+    hash_val += (hash_val << 3);
+    hash_val ^= (hash_val >> 11);
+    hash_val += (hash_val << 15);
+    return hash_val;
+}
+
 /** Compute the hash value for two given address/port pairs.
- * (Parameter type is gconstpointer for GHashTable compatibility.)
  *
- * @param v Conversation Key. MUST point to a conv_key_t struct.
  * @return Computed key hash.
  */
 static guint
-conversation_hash(gconstpointer v)
+conversation_hash(const address *addr1, const address *addr2, guint32 port1, guint32 port2, conv_id_t conv_id)
 {
-    const conv_key_t *key = (const conv_key_t *)v;
     guint hash_val;
 
     hash_val = 0;
-    hash_val = add_address_to_hash(hash_val, &key->addr1);
-    hash_val += key->port1;
-    hash_val = add_address_to_hash(hash_val, &key->addr2);
-    hash_val += key->port2;
-    hash_val ^= key->conv_id;
+    hash_val = add_address_to_hash(hash_val, addr1);
+    hash_val += port1;
+    hash_val = add_address_to_hash(hash_val, addr2);
+    hash_val += port2;
+    hash_val ^= conv_id;
 
-    return hash_val;
+    return finish_hash(hash_val);
 }
 
-/** Compare two conversation keys for an exact match.
- * (Parameter types are gconstpointer for GHashTable compatibility.)
- *
- * @param key1 First conversation. MUST point to a conv_key_t struct.
- * @param key2 Second conversation. MUST point to a conv_key_t struct.
- * @return TRUE if conversations are equal, FALSE otherwise.
+/** Compare a conversation with the given addresses and ports. Callers
+ * always pass them in key order (see add_conversation_table_data_with_conv_id),
+ * so we don't have to check for a match in the other direction.
  */
 static gboolean
-conversation_equal(gconstpointer key1, gconstpointer key2)
-{
-    const conv_key_t *ck1 = (const conv_key_t *)key1;
-    const conv_key_t *ck2 = (const conv_key_t *)key2;
-
-    if (ck1->conv_id == ck2->conv_id)
-    {
-        if (ck1->port1 == ck2->port1 &&
-            ck1->port2 == ck2->port2 &&
-            addresses_equal(&ck1->addr1, &ck2->addr1) &&
-            addresses_equal(&ck1->addr2, &ck2->addr2)) {
-            return TRUE;
-        }
+conversation_equal(const conv_item_t *conv_item, const address *addr1, const address *addr2,
+        guint32 port1, guint32 port2, conv_id_t conv_id)
+{
+    return conv_item->conv_id == conv_id &&
+            conv_item->src_port == port1 &&
+            conv_item->dst_port == port2 &&
+            addresses_equal(&conv_item->src_address, addr1) &&
+            addresses_equal(&conv_item->dst_address, addr2);
+}
 
-        if (ck1->port2 == ck2->port1 &&
-            ck1->port1 == ck2->port2 &&
-            addresses_equal(&ck1->addr2, &ck2->addr1) &&
-            addresses_equal(&ck1->addr1, &ck2->addr2)) {
-            return TRUE;
+/** Make sure that the hash has room for one more entry, growing it if
+ * it would become more than half full.
+ */
+static void
+conv_hash_reserve(conv_hash_t *ch)
+{
+    struct _conv_hash_slot *old_slots = ch->hash_slots;
+    guint old_num_slots = ch->num_hash_slots;
+    guint used = ch->conv_array ? ch->conv_array->len : 0;
+    guint mask, i;
+
+    if (ch->hash_slots && (used + 1) * 2 <= ch->num_hash_slots) {
+        return;
+    }
+
+    ch->num_hash_slots = old_slots ? old_num_slots * 2 : CONV_HASH_MIN_SLOTS;
+    ch->hash_slots = g_new0(struct _conv_hash_slot, ch->num_hash_slots);
+    mask = ch->num_hash_slots - 1;
+
+    for (i = 0; i < old_num_slots; i++) {
+        guint pos;
+
+        if (old_slots[i].index == 0) {
+            continue;
         }
+        for (pos = old_slots[i].hash_val & mask; ch->hash_slots[pos].index != 0; pos = (pos + 1) & mask)
+            ;
+        ch->hash_slots[pos] = old_slots[i];
     }
+    g_free(old_slots);
+}
 
-    /*
-     * The addresses, ports, or conversation IDs don't match.
-     */
-    return FALSE;
+/** Free the hash slots. */
+static void
+conv_hash_free(conv_hash_t *ch)
+{
+    g_free(ch->hash_slots);
+    ch->hash_slots = NULL;
+    ch->num_hash_slots = 0;
 }
 
 void
@@ -292,12 +329,9 @@ reset_conversation_table_data(conv_hash_t *ch)
         g_array_free(ch->conv_array, TRUE);
     }
 
-    if (ch->hashtable != NULL) {
-        g_hash_table_destroy(ch->hashtable);
-    }
+    conv_hash_free(ch);
 
     ch->conv_array=NULL;
-    ch->hashtable=NULL;
 }
 
 void reset_hostlist_table_data(conv_hash_t *ch)
@@ -316,12 +350,9 @@ void reset_hostlist_table_data(conv_hash_t *ch)
         g_array_free(ch->conv_array, TRUE);
     }
 
-    if (ch->hashtable != NULL) {
-        g_hash_table_destroy(ch->hashtable);
-    }
+    conv_hash_free(ch);
 
     ch->conv_array=NULL;
-    ch->hashtable=NULL;
 }
 
 char *get_conversation_address(wmem_allocator_t *allocator, address *addr, gboolean resolve_names)
@@ -585,6 +616,68 @@ add_conversation_table_data(conv_hash_t *ch, const address *src, const address *
     add_conversation_table_data_with_conv_id(ch, src, dst, src_port, dst_port, CONV_ID_UNSET, num_frames, num_bytes, ts, abs_ts, ct_info, ptype);
 }
 
+/* Find the conversation with the given (ordered) addresses and ports,
+   adding it if it is new */
+static conv_item_t *
+get_conversation_item(conv_hash_t *ch, const address *addr1, const address *addr2,
+        guint32 port1, guint32 port2, conv_id_t conv_id, nstime_t *ts, nstime_t *abs_ts,
+        ct_dissector_info_t *ct_info, port_type ptype)
+{
+    conv_item_t *conv_item;
+    conv_item_t new_conv_item;
+    guint hash_val = conversation_hash(addr1, addr2, port1, port2, conv_id);
+    guint mask, pos;
+
+    /* if we don't have any entries at all yet */
+    if (ch->conv_array == NULL) {
+        ch->conv_array = g_array_sized_new(FALSE, FALSE, sizeof(conv_item_t), 10000);
+    }
+    conv_hash_reserve(ch);
+
+    /* try to find it among the existing known conversations */
+    mask = ch->num_hash_slots - 1;
+    for (pos = hash_val & mask; ch->hash_slots[pos].index != 0; pos = (pos + 1) & mask) {
+        if (ch->hash_slots[pos].hash_val == hash_val) {
+            conv_item = &g_array_index(ch->conv_array, conv_item_t, ch->hash_slots[pos].index - 1);
+            if (conversation_equal(conv_item, addr1, addr2, port1, port2, conv_id)) {
+                return conv_item;
+            }
+        }
+    }
+
+    /* if we still don't know what conversation this is it has to be a new one
+       and we have to allocate it and append it to the end of the list */
+    copy_address(&new_conv_item.src_address, addr1);
+    copy_address(&new_conv_item.dst_address, addr2);
+    new_conv_item.dissector_info = ct_info;
+    new_conv_item.ptype = ptype;
+    new_conv_item.src_port = port1;
+    new_conv_item.dst_port = port2;
+    new_conv_item.conv_id = conv_id;
+    new_conv_item.rx_frames = 0;
+    new_conv_item.tx_frames = 0;
+    new_conv_item.rx_bytes = 0;
+    new_conv_item.tx_bytes = 0;
+    new_conv_item.modified = TRUE;
+
+    if (ts) {
+        memcpy(&new_conv_item.start_time, ts, sizeof(new_conv_item.start_time));
+        memcpy(&new_conv_item.stop_time, ts, sizeof(new_conv_item.stop_time));
+        memcpy(&new_conv_item.start_abs_time, abs_ts, sizeof(new_conv_item.start_abs_time));
+    } else {
+        nstime_set_unset(&new_conv_item.start_abs_time);
+        nstime_set_unset(&new_conv_item.start_time);
+        nstime_set_unset(&new_conv_item.stop_time);
+    }
+    g_array_append_val(ch->conv_array, new_conv_item);
+
+    /* pos is the empty slot that ended our search */
+    ch->hash_slots[pos].hash_val = hash_val;
+    ch->hash_slots[pos].index = ch->conv_array->len;
+
+    return &g_array_index(ch->conv_array, conv_item_t, ch->conv_array->len - 1);
+}
+
 void
 add_conversation_table_data_with_conv_id(
     conv_hash_t *ch,
@@ -602,8 +695,7 @@ add_conversation_table_data_with_conv_id(
 {
     const address *addr1, *addr2;
     guint32 port1, port2;
-    conv_item_t *conv_item = NULL;
-    unsigned int conversation_idx = 0;
+    conv_item_t *conv_item;
 
     if (src_port > dst_port) {
         addr1 = src;
@@ -627,71 +719,7 @@ add_conversation_table_data_with_conv_id(
         port1 = dst_port;
     }
 
-    /* if we don't have any entries at all yet */
-    if (ch->conv_array == NULL) {
-        ch->conv_array = g_array_sized_new(FALSE, FALSE, sizeof(conv_item_t), 10000);
-
-        ch->hashtable = g_hash_table_new_full(conversation_hash,
-                                              conversation_equal, /* key_equal_func */
-                                              g_free,             /* key_destroy_func */
-                                              NULL);              /* value_destroy_func */
-
-    } else {
-        /* try to find it among the existing known conversations */
-        conv_key_t existing_key;
-        gpointer conversation_idx_hash_val;
-
-        existing_key.addr1 = *addr1;
-        existing_key.addr2 = *addr2;
-        existing_key.port1 = port1;
-        existing_key.port2 = port2;
-        existing_key.conv_id = conv_id;
-        if (g_hash_table_lookup_extended(ch->hashtable, &existing_key, NULL, &conversation_idx_hash_val)) {
-            conv_item = &g_array_index(ch->conv_array, conv_item_t, GPOINTER_TO_UINT(conversation_idx_hash_val));
-        }
-    }
-
-    /* if we still don't know what conversation this is it has to be a new one
-       and we have to allocate it and append it to the end of the list */
-    if (conv_item == NULL) {
-        conv_key_t *new_key;
-        conv_item_t new_conv_item;
-
-        copy_address(&new_conv_item.src_address, addr1);
-        copy_address(&new_conv_item.dst_address, addr2);
-        new_conv_item.dissector_info = ct_info;
-        new_conv_item.ptype = ptype;
-        new_conv_item.src_port = port1;
-        new_conv_item.dst_port = port2;
-        new_conv_item.conv_id = conv_id;
-        new_conv_item.rx_frames = 0;
-        new_conv_item.tx_frames = 0;
-        new_conv_item.rx_bytes = 0;
-        new_conv_item.tx_bytes = 0;
-        new_conv_item.modified = TRUE;
-
-        if (ts) {
-            memcpy(&new_conv_item.start_time, ts, sizeof(new_conv_item.start_time));
-            memcpy(&new_conv_item.stop_time, ts, sizeof(new_conv_item.stop_time));
-            memcpy(&new_conv_item.start_abs_time, abs_ts, sizeof(new_conv_item.start_abs_time));
-        } else {
-            nstime_set_unset(&new_conv_item.start_abs_time);
-            nstime_set_unset(&new_conv_item.start_time);
-            nstime_set_unset(&new_conv_item.stop_time);
-        }
-        g_array_append_val(ch->conv_array, new_conv_item);
-        conversation_idx = ch->conv_array->len - 1;
-        conv_item = &g_array_index(ch->conv_array, conv_item_t, conversation_idx);
-
-        /* ct->conversations address is not a constant but src/dst_address.data are */
-        new_key = g_new(conv_key_t, 1);
-        set_address(&new_key->addr1, conv_item->src_address.type, conv_item->src_address.len, conv_item->src_address.data);
-        set_address(&new_key->addr2, conv_item->dst_address.type, conv_item->dst_address.len, conv_item->dst_address.data);
-        new_key->port1 = port1;
-        new_key->port2 = port2;
-        new_key->conv_id = conv_id;
-        g_hash_table_insert(ch->hashtable, new_key, GUINT_TO_POINTER(conversation_idx));
-    }
+    conv_item = get_conversation_item(ch, addr1, addr2, port1, port2, conv_id, ts, abs_ts, ct_info, ptype);
 
     /* update the conversation struct */
     conv_item->modified = TRUE;
@@ -713,96 +741,109 @@ add_conversation_table_data_with_conv_id(
     }
 }
 
-/*
- * Compute the hash value for a given address/port pairs if the match
- * is to be exact.
- */
-static guint
-host_hash(gconstpointer v)
+void
+merge_conversation_table_data(conv_hash_t *ch, const conv_hash_t *src_ch)
 {
-    const host_key_t *key = (const host_key_t *)v;
-    guint hash_val;
+    guint i;
 
-    hash_val = 0;
-    hash_val = add_address_to_hash(hash_val, &key->myaddress);
-    hash_val += key->port;
-    return hash_val;
+    if (src_ch->conv_array == NULL)
+        return;
+
+    for (i = 0; i < src_ch->conv_array->len; i++) {
+        conv_item_t *src_item = &g_array_index(src_ch->conv_array, conv_item_t, i);
+        nstime_t *ts = nstime_is_unset(&src_item->start_time) ? NULL : &src_item->start_time;
+        conv_item_t *conv_item;
+
+        /* src_item's addresses and ports are already in key order */
+        conv_item = get_conversation_item(ch, &src_item->src_address, &src_item->dst_address,
+                src_item->src_port, src_item->dst_port, src_item->conv_id,
+                ts, &src_item->start_abs_time, src_item->dissector_info, src_item->ptype);
+
+        conv_item->modified = TRUE;
+        conv_item->tx_frames += src_item->tx_frames;
+        conv_item->tx_bytes += src_item->tx_bytes;
+        conv_item->rx_frames += src_item->rx_frames;
+        conv_item->rx_bytes += src_item->rx_bytes;
+
+        if (ts) {
+            if (nstime_is_unset(&conv_item->start_time) ||
+                nstime_cmp(&src_item->start_time, &conv_item->start_time) < 0) {
+                conv_item->start_time = src_item->start_time;
+                conv_item->start_abs_time = src_item->start_abs_time;
+            }
+            if (nstime_is_unset(&conv_item->stop_time) ||
+                nstime_cmp(&src_item->stop_time, &conv_item->stop_time) > 0) {
+                conv_item->stop_time = src_item->stop_time;
+            }
+        }
+    }
 }
 
 /*
- * Compare two host keys for an exact match.
+ * Compute the hash value for a given address/port pair.
  */
-static gint
-host_match(gconstpointer v, gconstpointer w)
+static guint
+host_hash(const address *addr, guint32 port)
 {
-    const host_key_t *v1 = (const host_key_t *)v;
-    const host_key_t *v2 = (const host_key_t *)w;
+    guint hash_val;
 
-    if (v1->port == v2->port &&
-        addresses_equal(&v1->myaddress, &v2->myaddress)) {
-        return 1;
-    }
-    /*
-     * The addresses or the ports don't match.
-     */
-    return 0;
+    hash_val = 0;
+    hash_val = add_address_to_hash(hash_val, addr);
+    hash_val += port;
+    return finish_hash(hash_val);
 }
 
-void
-add_hostlist_table_data(conv_hash_t *ch, const address *addr, guint32 port, gboolean sender, int num_frames, int num_bytes, hostlist_dissector_info_t *host_info, port_type port_type_val)
+/* Find the talker with the given address and port, adding it if it is new */
+static hostlist_talker_t *
+get_hostlist_talker(conv_hash_t *ch, const address *addr, guint32 port, hostlist_dissector_info_t *host_info, port_type port_type_val)
 {
-    hostlist_talker_t *talker=NULL;
-    int talker_idx=0;
+    hostlist_talker_t *talker;
+    hostlist_talker_t host;
+    guint hash_val = host_hash(addr, port);
+    guint mask, pos;
 
-    /* XXX should be optimized to allocate n extra entries at a time
-       instead of just one */
     /* if we don't have any entries at all yet */
     if(ch->conv_array==NULL){
         ch->conv_array=g_array_sized_new(FALSE, FALSE, sizeof(hostlist_talker_t), 10000);
-        ch->hashtable = g_hash_table_new_full(host_hash,
-                                              host_match, /* key_equal_func */
-                                              g_free,     /* key_destroy_func */
-                                              NULL);      /* value_destroy_func */
     }
-    else {
-        /* try to find it among the existing known conversations */
-        host_key_t existing_key;
-        gpointer talker_idx_hash_val;
-
-        copy_address_shallow(&existing_key.myaddress, addr);
-        existing_key.port = port;
-
-        if (g_hash_table_lookup_extended(ch->hashtable, &existing_key, NULL, &talker_idx_hash_val)) {
-            talker = &g_array_index(ch->conv_array, hostlist_talker_t, GPOINTER_TO_UINT(talker_idx_hash_val));
+    conv_hash_reserve(ch);
+
+    /* try to find it among the existing known conversations */
+    mask = ch->num_hash_slots - 1;
+    for (pos = hash_val & mask; ch->hash_slots[pos].index != 0; pos = (pos + 1) & mask) {
+        if (ch->hash_slots[pos].hash_val == hash_val) {
+            talker = &g_array_index(ch->conv_array, hostlist_talker_t, ch->hash_slots[pos].index - 1);
+            if (talker->port == port && addresses_equal(&talker->myaddress, addr)) {
+                return talker;
+            }
         }
     }
 
     /* if we still don't know what talker this is it has to be a new one
        and we have to allocate it and append it to the end of the list */
-    if(talker==NULL){
-        host_key_t *new_key;
-        hostlist_talker_t host;
-
-        copy_address(&host.myaddress, addr);
-        host.dissector_info = host_info;
-        host.ptype=port_type_val;
-        host.port=port;
-        host.rx_frames=0;
-        host.tx_frames=0;
-        host.rx_bytes=0;
-        host.tx_bytes=0;
-        host.modified = TRUE;
-
-        g_array_append_val(ch->conv_array, host);
-        talker_idx= ch->conv_array->len - 1;
-        talker=&g_array_index(ch->conv_array, hostlist_talker_t, talker_idx);
-
-        /* hl->hosts address is not a constant but address.data is */
-        new_key = g_new(host_key_t,1);
-        set_address(&new_key->myaddress, talker->myaddress.type, talker->myaddress.len, talker->myaddress.data);
-        new_key->port = port;
-        g_hash_table_insert(ch->hashtable, new_key, GUINT_TO_POINTER(talker_idx));
-    }
+    copy_address(&host.myaddress, addr);
+    host.dissector_info = host_info;
+    host.ptype=port_type_val;
+    host.port=port;
+    host.rx_frames=0;
+    host.tx_frames=0;
+    host.rx_bytes=0;
+    host.tx_bytes=0;
+    host.modified = TRUE;
+
+    g_array_append_val(ch->conv_array, host);
+
+    /* pos is the empty slot that ended our search */
+    ch->hash_slots[pos].hash_val = hash_val;
+    ch->hash_slots[pos].index = ch->conv_array->len;
+
+    return &g_array_index(ch->conv_array, hostlist_talker_t, ch->conv_array->len - 1);
+}
+
+void
+add_hostlist_table_data(conv_hash_t *ch, const address *addr, guint32 port, gboolean sender, int num_frames, int num_bytes, hostlist_dissector_info_t *host_info, port_type port_type_val)
+{
+    hostlist_talker_t *talker = get_hostlist_talker(ch, addr, port, host_info, port_type_val);
 
     /* if this is a new talker we need to initialize the struct */
     talker->modified = TRUE;
@@ -817,6 +858,29 @@ add_hostlist_table_data(conv_hash_t *ch, const address *addr, guint32 port, gboo
     }
 }
 
+void
+merge_hostlist_table_data(conv_hash_t *ch, const conv_hash_t *src_ch)
+{
+    guint i;
+
+    if (src_ch->conv_array == NULL)
+        return;
+
+    for (i = 0; i < src_ch->conv_array->len; i++) {
+        hostlist_talker_t *src_talker = &g_array_index(src_ch->conv_array, hostlist_talker_t, i);
+        hostlist_talker_t *talker;
+
+        talker = get_hostlist_talker(ch, &src_talker->myaddress, src_talker->port,
+                src_talker->dissector_info, src_talker->ptype);
+
+        talker->modified = TRUE;
+        talker->tx_frames += src_talker->tx_frames;
+        talker->tx_bytes += src_talker->tx_bytes;
+        talker->rx_frames += src_talker->rx_frames;
+        talker->rx_bytes += src_talker->rx_bytes;
+    }
+}
+
 /*
  * Editor modelines
  *
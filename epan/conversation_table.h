@@ -57,29 +57,19 @@ typedef enum {
     CONV_DIR_ANY_FROM_B
 } conv_direction_e;
 
+struct _conv_hash_slot;
+
 /** Conversation hash + value storage
- * Hash table keys are conv_key_t. Hash table values are indexes into conv_array.
+ * The hash slots hold indexes into conv_array and are looked up with the
+ * addresses and ports of the conv_array entries themselves.
  */
 typedef struct _conversation_hash_t {
-    GHashTable  *hashtable;       /**< conversations hash table */
+    struct _conv_hash_slot *hash_slots; /**< open-addressed hash of conv_array indexes */
+    guint        num_hash_slots;  /**< number of hash_slots, a power of two */
     GArray      *conv_array;      /**< array of conversation values */
     void        *user_data;       /**< "GUI" specifics (if necessary) */
 } conv_hash_t;
 
-/** Key for hash lookups */
-typedef struct _conversation_key_t {
-    address     addr1;
-    address     addr2;
-    guint32     port1;
-    guint32     port2;
-    conv_id_t   conv_id;
-} conv_key_t;
-
-typedef struct {
-    address  myaddress;
-    guint32  port;
-} host_key_t;
-
 struct _conversation_item_t;
 typedef const char* (*conv_get_filter_type)(struct _conversation_item_t* item, conv_filter_type_e filter);
 
@@ -300,7 +290,7 @@ WS_DLL_PUBLIC char *get_hostlist_filter(hostlist_talker_t *host);
  * @param ct_info callback handlers from the dissector
  * @param ptype the port type (e.g. PT_TCP)
  */
-extern void add_conversation_table_data(conv_hash_t *ch, const address *src, const address *dst,
+WS_DLL_PUBLIC void add_conversation_table_data(conv_hash_t *ch, const address *src, const address *dst,
             guint32 src_port, guint32 dst_port, int num_frames, int num_bytes, nstime_t *ts, nstime_t *abs_ts,
             ct_dissector_info_t *ct_info, port_type ptype);
 
@@ -337,9 +327,26 @@ add_conversation_table_data_with_conv_id(conv_hash_t *ch, const address *src, co
  * @param host_info conversation information provided by dissector
  * @param port_type_val the port type (e.g. PT_TCP)
  */
-void add_hostlist_table_data(conv_hash_t *ch, const address *addr,
+WS_DLL_PUBLIC void add_hostlist_table_data(conv_hash_t *ch, const address *addr,
                              guint32 port, gboolean sender, int num_frames, int num_bytes, hostlist_dissector_info_t *host_info, port_type port_type_val);
 
+/** Add the conversations of one table to another, e.g. to combine the
+ * results of taps run over different parts of a capture or over different
+ * files. Start and stop times are relative, so they are only meaningful
+ * if both tables share the same reference time.
+ *
+ * @param ch the table to add the data to
+ * @param src_ch the table whose conversations are added
+ */
+WS_DLL_PUBLIC void merge_conversation_table_data(conv_hash_t *ch, const conv_hash_t *src_ch);
+
+/** Add the endpoints of one table to another.
+ *
+ * @param ch the table to add the data to
+ * @param src_ch the table whose endpoints are added
+ */
+WS_DLL_PUBLIC void merge_hostlist_table_data(conv_hash_t *ch, const conv_hash_t *src_ch);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
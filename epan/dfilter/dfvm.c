@@ -48,6 +48,9 @@ dfvm_value_free(dfvm_value_t *v)
 		case DRANGE:
 			drange_free(v->value.drange);
 			break;
+		case CONTAINS_SET:
+			fvalue_contains_set_free(v->value.contains_set);
+			break;
 		default:
 			/* nothing */
 			;
@@ -97,6 +100,8 @@ dfvm_dump(FILE *f, dfilter_t *df)
 	char		*value_str;
 	GSList		*range_list;
 	drange_node	*range_item;
+	const GPtrArray	*patterns;
+	guint		i;
 
 	/* First dump the constant initializations */
 	fprintf(f, "Constants:\n");
@@ -129,6 +134,7 @@ dfvm_dump(FILE *f, dfilter_t *df)
 			case ANY_LE:
 			case ANY_BITWISE_AND:
 			case ANY_CONTAINS:
+			case ANY_CONTAINS_ANY:
 			case ANY_MATCHES:
 			case NOT:
 			case RETURN:
@@ -259,6 +265,20 @@ dfvm_dump(FILE *f, dfilter_t *df)
 					id, arg1->value.numeric, arg2->value.numeric);
 				break;
 
+			case ANY_CONTAINS_ANY:
+				fprintf(f, "%05d ANY_CONTAINS_ANY\treg#%u contains any of {",
+					id, arg1->value.numeric);
+				patterns = fvalue_contains_set_patterns(arg2->value.contains_set);
+				for (i = 0; i < patterns->len; i++) {
+					value_str = fvalue_to_string_repr(NULL,
+						(fvalue_t *)g_ptr_array_index(patterns, i),
+						FTREPR_DFILTER, BASE_NONE);
+					fprintf(f, "%s%s", i ? ", " : "", value_str);
+					wmem_free(NULL, value_str);
+				}
+				fprintf(f, "}\n");
+				break;
+
 			case ANY_MATCHES:
 				fprintf(f, "%05d ANY_MATCHES\treg#%u matches reg#%u\n",
 					id, arg1->value.numeric, arg2->value.numeric);
@@ -369,6 +389,20 @@ any_test(dfilter_t *df, FvalueCmpFunc cmp, int reg1, int reg2)
 	return FALSE;
 }
 
+/* Like any_test() with fvalue_contains, for a whole set of
+ * constant operands at once. */
+static gboolean
+any_contains_any(dfilter_t *df, int reg, const fvalue_contains_set_t *set)
+{
+	GList	*list_a;
+
+	for (list_a = df->registers[reg]; list_a; list_a = g_list_next(list_a)) {
+		if (fvalue_contains_any((fvalue_t *)list_a->data, set)) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
 
 /* Free the list nodes w/o freeing the memory that each
  * list node points to. */
@@ -522,6 +556,11 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 						arg1->value.numeric, arg2->value.numeric);
 				break;
 
+			case ANY_CONTAINS_ANY:
+				accum = any_contains_any(df, arg1->value.numeric,
+						arg2->value.contains_set);
+				break;
+
 			case ANY_MATCHES:
 				accum = any_test(df, fvalue_matches,
 						arg1->value.numeric, arg2->value.numeric);
@@ -600,6 +639,7 @@ dfvm_init_const(dfilter_t *df)
 			case ANY_LE:
 			case ANY_BITWISE_AND:
 			case ANY_CONTAINS:
+			case ANY_CONTAINS_ANY:
 			case ANY_MATCHES:
 			case NOT:
 			case RETURN:
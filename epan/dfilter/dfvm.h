@@ -35,7 +35,8 @@ typedef enum {
 	REGISTER,
 	INTEGER,
 	DRANGE,
-	FUNCTION_DEF
+	FUNCTION_DEF,
+	CONTAINS_SET
 } dfvm_value_type_t;
 
 typedef struct {
@@ -46,6 +47,7 @@ typedef struct {
 		guint32			numeric;
 		drange_t		*drange;
 		header_field_info	*hfinfo;
+		fvalue_contains_set_t	*contains_set;
         df_func_def_t   *funcdef;
 	} value;
 
@@ -69,6 +71,7 @@ typedef enum {
 	ANY_LE,
 	ANY_BITWISE_AND,
 	ANY_CONTAINS,
+	ANY_CONTAINS_ANY,
 	ANY_MATCHES,
 	MK_RANGE,
     CALL_FUNCTION
@@ -391,6 +391,165 @@ gen_entity(dfwork_t *dfw, stnode_t *st_arg, dfvm_value_t **p_jmp)
 	return reg;
 }
 
+/* If this is a test of whether a field contains a constant, and the
+ * field type allows such tests to be combined, return the field. */
+static header_field_info *
+contains_any_field(stnode_t *st_node)
+{
+	test_op_t		st_op;
+	stnode_t		*st_arg1, *st_arg2;
+	header_field_info	*hfinfo;
+
+	if (stnode_type_id(st_node) != STTYPE_TEST) {
+		return NULL;
+	}
+	sttype_test_get(st_node, &st_op, &st_arg1, &st_arg2);
+	if (st_op != TEST_OP_CONTAINS ||
+	    stnode_type_id(st_arg1) != STTYPE_FIELD ||
+	    stnode_type_id(st_arg2) != STTYPE_FVALUE) {
+		return NULL;
+	}
+	hfinfo = (header_field_info*)stnode_data(st_arg1);
+	if (!ftype_can_contains_any(hfinfo->type) ||
+	    !ftype_can_contains_any(fvalue_type_ftenum((fvalue_t *)stnode_data(st_arg2)))) {
+		return NULL;
+	}
+	return hfinfo;
+}
+
+/* Collect the operands of a series of OR tests. */
+static void
+flatten_or(stnode_t *st_node, GPtrArray *leaves)
+{
+	test_op_t	st_op;
+	stnode_t	*st_arg1, *st_arg2;
+
+	if (stnode_type_id(st_node) == STTYPE_TEST) {
+		sttype_test_get(st_node, &st_op, &st_arg1, &st_arg2);
+		if (st_op == TEST_OP_OR) {
+			flatten_or(st_arg1, leaves);
+			flatten_or(st_arg2, leaves);
+			return;
+		}
+	}
+	g_ptr_array_add(leaves, st_node);
+}
+
+/* Test a field against a set of constants in one instruction. The
+ * constants' fvalue_t's are moved into the set. */
+static void
+gen_contains_any(dfwork_t *dfw, header_field_info *hfinfo, GPtrArray *patterns)
+{
+	dfvm_insn_t	*insn;
+	dfvm_value_t	*val1, *val2, *jmp;
+	int		reg;
+
+	reg = dfw_append_read_tree(dfw, hfinfo);
+
+	insn = dfvm_insn_new(IF_FALSE_GOTO);
+	jmp = dfvm_value_new(INSN_NUMBER);
+	insn->arg1 = jmp;
+	dfw_append_insn(dfw, insn);
+
+	insn = dfvm_insn_new(ANY_CONTAINS_ANY);
+	val1 = dfvm_value_new(REGISTER);
+	val1->value.numeric = reg;
+	val2 = dfvm_value_new(CONTAINS_SET);
+	val2->value.contains_set = fvalue_contains_set_new(patterns);
+	insn->arg1 = val1;
+	insn->arg2 = val2;
+	dfw_append_insn(dfw, insn);
+
+	jmp->value.numeric = dfw->next_insn_id;
+}
+
+/* Generate the code for a series of OR tests in which "contains" tests
+ * of the same field against constants are combined, so that the field
+ * value is only scanned once for all of them ("frame contains "a" or
+ * frame contains "b" or ...").  The order of the tests doesn't matter,
+ * as none of them has side effects.  Returns FALSE, without generating
+ * anything, if there is nothing to combine. */
+static gboolean
+gen_or_contains_any(dfwork_t *dfw, stnode_t *st_node)
+{
+	GPtrArray		*leaves;
+	GPtrArray		*patterns;
+	GSList			*jumplist = NULL;
+	gboolean		*done;
+	gboolean		combine = FALSE;
+	guint			i, j;
+	header_field_info	*hfinfo;
+	test_op_t		st_op;
+	stnode_t		*st_arg1, *st_arg2;
+	dfvm_insn_t		*insn;
+	dfvm_value_t		*val1;
+
+	leaves = g_ptr_array_new();
+	flatten_or(st_node, leaves);
+
+	for (i = 0; i < leaves->len && !combine; i++) {
+		hfinfo = contains_any_field((stnode_t*)g_ptr_array_index(leaves, i));
+		if (hfinfo == NULL) {
+			continue;
+		}
+		for (j = i + 1; j < leaves->len; j++) {
+			if (contains_any_field((stnode_t*)g_ptr_array_index(leaves, j)) == hfinfo) {
+				combine = TRUE;
+				break;
+			}
+		}
+	}
+	if (!combine) {
+		g_ptr_array_free(leaves, TRUE);
+		return FALSE;
+	}
+
+	done = g_new0(gboolean, leaves->len);
+	for (i = 0; i < leaves->len; i++) {
+		if (done[i]) {
+			continue;
+		}
+
+		/* Exit as soon as one of the tests succeeds */
+		if (i > 0) {
+			insn = dfvm_insn_new(IF_TRUE_GOTO);
+			val1 = dfvm_value_new(INSN_NUMBER);
+			insn->arg1 = val1;
+			dfw_append_insn(dfw, insn);
+			jumplist = g_slist_prepend(jumplist, val1);
+		}
+
+		hfinfo = contains_any_field((stnode_t*)g_ptr_array_index(leaves, i));
+		if (hfinfo == NULL) {
+			gencode(dfw, (stnode_t*)g_ptr_array_index(leaves, i));
+			continue;
+		}
+
+		patterns = g_ptr_array_new();
+		for (j = i; j < leaves->len; j++) {
+			stnode_t *leaf = (stnode_t*)g_ptr_array_index(leaves, j);
+
+			if (!done[j] && contains_any_field(leaf) == hfinfo) {
+				sttype_test_get(leaf, &st_op, &st_arg1, &st_arg2);
+				g_ptr_array_add(patterns, stnode_data(st_arg2));
+				done[j] = TRUE;
+			}
+		}
+		if (patterns->len == 1) {
+			gencode(dfw, (stnode_t*)g_ptr_array_index(leaves, i));
+		}
+		else {
+			gen_contains_any(dfw, hfinfo, patterns);
+		}
+		g_ptr_array_free(patterns, TRUE);
+	}
+
+	g_slist_foreach(jumplist, fixup_jumps, dfw);
+	g_slist_free(jumplist);
+	g_free(done);
+	g_ptr_array_free(leaves, TRUE);
+	return TRUE;
+}
 
 static void
 gen_test(dfwork_t *dfw, stnode_t *st_node)
@@ -451,6 +610,9 @@ gen_test(dfwork_t *dfw, stnode_t *st_node)
 			break;
 
 		case TEST_OP_OR:
+			if (gen_or_contains_any(dfw, st_node)) {
+				break;
+			}
 			gencode(dfw, st_arg1);
 
 			insn = dfvm_insn_new(IF_TRUE_GOTO);
@@ -506,7 +506,7 @@ ssl_follow_tap_listener(void *tapdata, packet_info *pinfo, epan_dissect_t *edt _
         memcpy(rec->data.data, appl_data->plain_data.data, appl_data->plain_data.data_len);
 
         /* Append the record to the follow_info structure. */
-        follow_info->payload = g_list_append(follow_info->payload, rec);
+        follow_append_record(follow_info, rec);
         follow_info->bytes_written[from] += rec->data.data_len;
     }
 
@@ -232,6 +232,11 @@ epan_free(epan_t *session)
 		/* XXX, it should take session as param */
 		cleanup_dissection();
 
+		/* The cached pinfo pool hangs on to the memory used by the
+		 * biggest packet we've seen; we're idle now, so give it back. */
+		if (pinfo_pool_cache != NULL)
+			wmem_gc(pinfo_pool_cache);
+
 		g_slice_free(epan_t, session);
 	}
 }
@@ -288,7 +293,7 @@ epan_dissect_init(epan_dissect_t *edt, epan_t *session, const gboolean create_pr
 		pinfo_pool_cache = NULL;
 	}
 	else {
-		edt->pi.pool = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK_FAST);
+		edt->pi.pool = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK_POOL);
 	}
 
 	if (create_proto_tree) {
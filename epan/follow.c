@@ -164,6 +164,21 @@ follow_reset_stream(follow_info_t* info)
     info->server_ip.len = 0;
 }
 
+void
+follow_append_record(follow_info_t* info, gpointer record)
+{
+    if (!info->payload) {
+        info->payload = info->payload_last = g_list_append(NULL, record);
+        return;
+    }
+
+    /* Someone else might have appended without updating payload_last */
+    if (!info->payload_last || info->payload_last->next)
+        info->payload_last = g_list_last(info->payload);
+
+    info->payload_last = g_list_append(info->payload_last, record)->next;
+}
+
 gboolean
 follow_tvb_tap_listener(void *tapdata, packet_info *pinfo,
                       epan_dissect_t *edt _U_, const void *data)
@@ -195,7 +210,7 @@ follow_tvb_tap_listener(void *tapdata, packet_info *pinfo,
     /* update stream counter */
     follow_info->bytes_written[follow_record->is_server] += follow_record->data->len;
 
-    follow_info->payload = g_list_append(follow_info->payload, follow_record);
+    follow_append_record(follow_info, follow_record);
     return FALSE;
 }
 
@@ -95,6 +95,7 @@ typedef struct _follow_info {
     show_stream_t   show_stream;
     char            *filter_out_filter;
     GList           *payload;
+    GList           *payload_last;    /* Last element of payload, see follow_append_record() */
     guint           bytes_written[2]; /* Index with FROM_CLIENT or FROM_SERVER for readability. */
     guint           client_port;
     guint           server_port;
@@ -195,6 +196,15 @@ WS_DLL_PUBLIC void follow_iterate_followers(GFunc func, gpointer user_data);
  */
 WS_DLL_PUBLIC gchar* follow_get_stat_tap_string(register_follow_t* follower);
 
+/** Append a record to the payload of follow_info_t in constant time.
+ * Taps should use this rather than g_list_append(), which walks the
+ * whole list and makes following a long stream quadratic.
+ *
+ * @param info [in] follower info
+ * @param record [in] record to append, e.g. a follow_record_t
+ */
+WS_DLL_PUBLIC void follow_append_record(follow_info_t* info, gpointer record);
+
 /** Clear counters, addresses and ports of follow_info_t
  *
  * @param info [in] follower info
@@ -673,18 +673,7 @@ static gboolean
 cmp_matches(const fvalue_t *fv_a, const fvalue_t *fv_b)
 {
 	GByteArray *a = fv_a->value.bytes;
-	GRegex *regex = fv_b->value.re;
 
-	/* fv_b is always a FT_PCRE, otherwise the dfilter semcheck() would have
-	 * warned us. For the same reason (and because we're using g_malloc()),
-	 * fv_b->value.re is not NULL.
-	 */
-	if (strcmp(fv_b->ftype->name, "FT_PCRE") != 0) {
-		return FALSE;
-	}
-	if (! regex) {
-		return FALSE;
-	}
 	/*
 	 * XXX - do we want G_REGEX_RAW or not?
 	 *
@@ -709,16 +698,7 @@ cmp_matches(const fvalue_t *fv_a, const fvalue_t *fv_b)
 	 *
 	 * So we don't use G_REGEX_RAW for now.
 	 */
-	return g_regex_match_full(
-		regex,			/* Compiled PCRE */
-		(char *)a->data,	/* The data to check for the pattern... */
-		(int)a->len,		/* ... and its length */
-		0,			/* Start offset within data */
-		(GRegexMatchFlags)0,	/* GRegexMatchFlags */
-		NULL,			/* We are not interested in the match information */
-		NULL			/* We don't want error information */
-		);
-	/* NOTE - DO NOT g_free(data) */
+	return fvalue_regex_match(fv_b, (const char *)a->data, a->len);
 }
 
 void
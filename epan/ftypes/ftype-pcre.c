@@ -30,6 +30,26 @@
 #include <glib.h>
 #include <string.h>
 
+#ifdef HAVE_PCRE2
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+#endif
+
+/*
+ * With PCRE2 the pattern is JIT-compiled if possible, and the match data
+ * block is allocated once and reused for every packet; otherwise GRegex
+ * is used, which allocates a GMatchInfo for each match.
+ */
+struct _fvalue_regex_t {
+    gchar *pattern;
+#ifdef HAVE_PCRE2
+    pcre2_code *code;
+    pcre2_match_data *match_data;
+#else
+    GRegex *re;
+#endif
+};
+
 static void
 gregex_fvalue_new(fvalue_t *fv)
 {
@@ -39,8 +59,17 @@ gregex_fvalue_new(fvalue_t *fv)
 static void
 gregex_fvalue_free(fvalue_t *fv)
 {
-    if (fv->value.re) {
-        g_regex_unref(fv->value.re);
+    fvalue_regex_t *re = fv->value.re;
+
+    if (re) {
+#ifdef HAVE_PCRE2
+        pcre2_match_data_free(re->match_data);
+        pcre2_code_free(re->code);
+#else
+        g_regex_unref(re->re);
+#endif
+        g_free(re->pattern);
+        g_free(re);
         fv->value.re = NULL;
     }
 }
@@ -73,20 +102,58 @@ raw_flag_needed(const gchar *pattern)
 static gboolean
 val_from_string(fvalue_t *fv, const char *pattern, gchar **err_msg)
 {
+    fvalue_regex_t *re;
+#ifdef HAVE_PCRE2
+    guint32 cflags = 0;
+    int errorcode;
+    PCRE2_SIZE erroroffset;
+    PCRE2_UCHAR errbuf[256];
+#else
     GError *regex_error = NULL;
     GRegexCompileFlags cflags = G_REGEX_OPTIMIZE;
+#endif
+
+    /* Free up the old value, if we have one */
+    gregex_fvalue_free(fv);
+
+    re = g_new0(fvalue_regex_t, 1);
+    re->pattern = g_strdup(pattern);
 
     /* Set RAW flag only if pattern requires matching raw byte
-       sequences. Otherwise, omit it so that GRegex treats its
-       input as UTF8-encoded string. */
+       sequences. Otherwise, omit it so that the pattern is
+       matched against the input as a UTF8-encoded string. */
+#ifdef HAVE_PCRE2
+    if (!raw_flag_needed(pattern)) {
+        /* Invalid UTF-8 in the data (bytes, frame or protocol
+           fields) can't match, but doesn't make every match fail,
+           nor need a validity check before each match. This needs
+           PCRE2 10.34 or later, which configure and CMake require. */
+        cflags = PCRE2_UTF | PCRE2_MATCH_INVALID_UTF;
+    }
+
+    re->code = pcre2_compile((PCRE2_SPTR)pattern, PCRE2_ZERO_TERMINATED,
+            cflags, &errorcode, &erroroffset, NULL);
+    if (re->code == NULL) {
+        if (err_msg) {
+            pcre2_get_error_message(errorcode, errbuf, sizeof errbuf);
+            *err_msg = g_strdup_printf("%s at offset %lu", (const char *)errbuf,
+                    (unsigned long)erroroffset);
+        }
+        g_free(re->pattern);
+        g_free(re);
+        return FALSE;
+    }
+
+    /* If JIT isn't available the interpreter is used instead */
+    pcre2_jit_compile(re->code, PCRE2_JIT_COMPLETE);
+
+    re->match_data = pcre2_match_data_create_from_pattern(re->code, NULL);
+#else
     if (raw_flag_needed(pattern)) {
         cflags = (GRegexCompileFlags)(G_REGEX_OPTIMIZE | G_REGEX_RAW);
     }
 
-    /* Free up the old value, if we have one */
-    gregex_fvalue_free(fv);
-
-    fv->value.re = g_regex_new(
+    re->re = g_regex_new(
             pattern,            /* pattern */
             cflags,             /* Compile options */
             (GRegexMatchFlags)0,                  /* Match options */
@@ -98,11 +165,16 @@ val_from_string(fvalue_t *fv, const char *pattern, gchar **err_msg)
             *err_msg = g_strdup(regex_error->message);
         }
         g_error_free(regex_error);
-        if (fv->value.re) {
-            g_regex_unref(fv->value.re);
+        if (re->re) {
+            g_regex_unref(re->re);
         }
+        g_free(re->pattern);
+        g_free(re);
         return FALSE;
     }
+#endif
+
+    fv->value.re = re;
     return TRUE;
 }
 
@@ -121,14 +193,14 @@ static int
 gregex_repr_len(fvalue_t *fv, ftrepr_t rtype, int field_display _U_)
 {
     g_assert(rtype == FTREPR_DFILTER);
-    return (int)strlen(g_regex_get_pattern(fv->value.re));
+    return (int)strlen(fv->value.re->pattern);
 }
 
 static void
 gregex_to_repr(fvalue_t *fv, ftrepr_t rtype, int field_display _U_, char *buf, unsigned int size)
 {
     g_assert(rtype == FTREPR_DFILTER);
-    g_strlcpy(buf, g_regex_get_pattern(fv->value.re), size);
+    g_strlcpy(buf, fv->value.re->pattern, size);
 }
 
 /* BEHOLD - value contains the string representation of the regular expression,
@@ -148,13 +220,48 @@ gregex_fvalue_get(fvalue_t *fv)
     return fv->value.re;
 }
 
+/* Does data, of length len, match the FT_PCRE value fv_re?  Used by
+ * the cmp_matches functions of other types; the data is matched where
+ * it is, without being copied. */
+gboolean
+fvalue_regex_match(const fvalue_t *fv_re, const char *data, gsize len)
+{
+    const fvalue_regex_t *re;
+
+    /* fv_re is always a FT_PCRE, otherwise the dfilter semcheck() would
+     * have warned us. */
+    if (fv_re->ftype->ftype != FT_PCRE) {
+        return FALSE;
+    }
+    re = fv_re->value.re;
+    if (re == NULL) {
+        return FALSE;
+    }
+
+#ifdef HAVE_PCRE2
+    /* Errors are negative and count as no match */
+    return pcre2_match(re->code, (PCRE2_SPTR)data, len, 0, 0,
+            re->match_data, NULL) >= 0;
+#else
+    return g_regex_match_full(
+            re->re,             /* Compiled PCRE */
+            data,               /* The data to check for the pattern... */
+            (gssize)len,        /* ... and its length */
+            0,                  /* Start offset within data */
+            (GRegexMatchFlags)0,/* GRegexMatchFlags */
+            NULL,               /* We are not interested in the match information */
+            NULL                /* We don't want error information */
+            );
+#endif
+}
+
 void
 ftype_register_pcre(void)
 {
     static ftype_t pcre_type = {
         FT_PCRE,            /* ftype */
         "FT_PCRE",          /* name */
-        "Compiled Perl-Compatible Regular Expression (GRegex) object", /* pretty_name */
+        "Compiled Perl-Compatible Regular Expression object", /* pretty_name */
         0,                  /* wire_size */
         gregex_fvalue_new,  /* new_value */
         gregex_fvalue_free, /* free_value */
@@ -46,6 +46,10 @@ void ftype_register_time(void);
 void ftype_register_tvbuff(void);
 void ftype_register_pcre(void);
 
+/* Used by the cmp_matches functions to match their data against a
+ * FT_PCRE value. */
+gboolean fvalue_regex_match(const fvalue_t *fv_re, const char *data, gsize len);
+
 typedef void (*FvalueNewFunc)(fvalue_t*);
 typedef void (*FvalueFreeFunc)(fvalue_t*);
 
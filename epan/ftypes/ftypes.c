@@ -22,8 +22,11 @@
 
 #include <ftypes-int.h>
 #include <glib.h>
+#include <string.h>
 
 #include "ftypes.h"
+#include <epan/exceptions.h>
+#include <wsutil/ws_memmem.h>
 
 /* Keep track of ftype_t's via their ftenum number */
 static ftype_t* type_list[FT_NUM_TYPES];
@@ -260,6 +263,31 @@ ftype_can_matches(enum ftenum ftype)
 	return ft->cmp_matches ? TRUE : FALSE;
 }
 
+gboolean
+ftype_can_contains_any(enum ftenum ftype)
+{
+	/* The types whose cmp_contains is a plain substring search */
+	switch (ftype) {
+		case FT_PROTOCOL:
+		case FT_BYTES:
+		case FT_UINT_BYTES:
+		case FT_AX25:
+		case FT_VINES:
+		case FT_ETHER:
+		case FT_OID:
+		case FT_REL_OID:
+		case FT_SYSTEM_ID:
+		case FT_FCWWN:
+		case FT_STRING:
+		case FT_STRINGZ:
+		case FT_UINT_STRING:
+		case FT_STRINGZPAD:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
 /* ---------------------------------------------------------- */
 
 /* Allocate and initialize an fvalue_t, given an ftype */
@@ -688,6 +716,143 @@ fvalue_matches(const fvalue_t *a, const fvalue_t *b)
 	return a->ftype->cmp_matches(a, b);
 }
 
+struct _fvalue_contains_set_t {
+	GPtrArray	*patterns;
+	/* NULL if a pattern isn't a plain byte string */
+	ws_mempatterns	*mempatterns;
+};
+
+/* Get the bytes that cmp_contains searches, for a type accepted by
+ * ftype_can_contains_any().  Returns FALSE for a protocol without a
+ * tvbuff, whose string is searched instead; throws if the tvbuff data
+ * can't be fetched. */
+static gboolean
+contains_data(const fvalue_t *fv, const guint8 **data, size_t *len)
+{
+	tvbuff_t *tvb;
+
+	switch (fv->ftype->ftype) {
+		case FT_PROTOCOL:
+			tvb = fv->value.protocol.tvb;
+			if (tvb == NULL) {
+				return FALSE;
+			}
+			*len = tvb_captured_length(tvb);
+			*data = *len ? tvb_get_ptr(tvb, 0, (gint)*len) : NULL;
+			return TRUE;
+
+		case FT_STRING:
+		case FT_STRINGZ:
+		case FT_UINT_STRING:
+		case FT_STRINGZPAD:
+			*data = (const guint8 *)fv->value.string;
+			*len = *data ? strlen(fv->value.string) : 0;
+			return TRUE;
+
+		default:
+			*data = fv->value.bytes->data;
+			*len = fv->value.bytes->len;
+			return TRUE;
+	}
+}
+
+fvalue_contains_set_t*
+fvalue_contains_set_new(GPtrArray *patterns)
+{
+	fvalue_contains_set_t *set;
+	const guint8 **data;
+	size_t *lens;
+	volatile gboolean usable = TRUE;
+	guint i;
+
+	set = g_new(fvalue_contains_set_t, 1);
+	set->patterns = g_ptr_array_sized_new(patterns->len);
+	set->mempatterns = NULL;
+
+	data = g_new(const guint8 *, patterns->len);
+	lens = g_new(size_t, patterns->len);
+	for (i = 0; i < patterns->len; i++) {
+		fvalue_t *fv = (fvalue_t *)g_ptr_array_index(patterns, i);
+
+		g_assert(ftype_can_contains_any(fv->ftype->ftype));
+		g_ptr_array_add(set->patterns, fv);
+		TRY {
+			if (!contains_data(fv, &data[i], &lens[i])) {
+				usable = FALSE;
+			}
+		}
+		CATCH_ALL {
+			usable = FALSE;
+		}
+		ENDTRY;
+	}
+
+	/* The patterns are constants, so their data stays put */
+	if (usable) {
+		set->mempatterns = ws_mempatterns_new(data, lens, patterns->len);
+	}
+	g_free(data);
+	g_free(lens);
+
+	return set;
+}
+
+const GPtrArray*
+fvalue_contains_set_patterns(const fvalue_contains_set_t *set)
+{
+	return set->patterns;
+}
+
+void
+fvalue_contains_set_free(fvalue_contains_set_t *set)
+{
+	guint i;
+
+	for (i = 0; i < set->patterns->len; i++) {
+		FVALUE_FREE((fvalue_t *)g_ptr_array_index(set->patterns, i));
+	}
+	g_ptr_array_free(set->patterns, TRUE);
+	ws_mempatterns_free(set->mempatterns);
+	g_free(set);
+}
+
+gboolean
+fvalue_contains_any(const fvalue_t *a, const fvalue_contains_set_t *set)
+{
+	volatile gboolean contains = FALSE;
+	volatile gboolean searched = FALSE;
+	const guint8 *data;
+	size_t len;
+	guint i;
+
+	if (set->mempatterns) {
+		TRY {
+			if (contains_data(a, &data, &len)) {
+				searched = TRUE;
+				if (ws_mempatterns_exec(set->mempatterns, data, len, NULL)) {
+					contains = TRUE;
+				}
+			}
+		}
+		CATCH_ALL {
+			/* Same as cmp_contains: no data, no match */
+			searched = TRUE;
+		}
+		ENDTRY;
+	}
+
+	if (searched) {
+		return contains;
+	}
+
+	for (i = 0; i < set->patterns->len; i++) {
+		if (fvalue_contains(a, (const fvalue_t *)g_ptr_array_index(set->patterns, i))) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
 /*
  * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
  *
@@ -188,6 +188,11 @@ WS_DLL_PUBLIC
 gboolean
 ftype_can_matches(enum ftenum ftype);
 
+/* Can several "contains" operands for fields of this type be searched
+ * for together, with fvalue_contains_any()? */
+gboolean
+ftype_can_contains_any(enum ftenum ftype);
+
 /* ---------------- FVALUE ----------------- */
 
 #include <epan/ipv4.h>
@@ -204,6 +209,9 @@ typedef struct _protocol_value_t
 	gchar		*proto_string;
 } protocol_value_t;
 
+/* A compiled FT_PCRE pattern; see ftype-pcre.c */
+typedef struct _fvalue_regex_t fvalue_regex_t;
+
 typedef struct _fvalue_t {
 	ftype_t	*ftype;
 	union {
@@ -222,7 +230,7 @@ typedef struct _fvalue_t {
 		e_guid_t		guid;
 		nstime_t		time;
         protocol_value_t protocol;
-		GRegex			*re;
+		fvalue_regex_t		*re;
 		guint16			sfloat_ieee_11073;
 		guint32			float_ieee_11073;
 	} value;
@@ -354,6 +362,27 @@ fvalue_contains(const fvalue_t *a, const fvalue_t *b);
 gboolean
 fvalue_matches(const fvalue_t *a, const fvalue_t *b);
 
+/* A set of "contains" operands that are searched for in one pass over
+ * the field value. */
+typedef struct _fvalue_contains_set_t fvalue_contains_set_t;
+
+/* Make a set from a GPtrArray of fvalue_t's, all of a type for which
+ * ftype_can_contains_any() is TRUE.  The set takes ownership of the
+ * fvalue_t's, but not of the array. */
+fvalue_contains_set_t*
+fvalue_contains_set_new(GPtrArray *patterns);
+
+/* The fvalue_t's in the set, in the order they were given. */
+const GPtrArray*
+fvalue_contains_set_patterns(const fvalue_contains_set_t *set);
+
+void
+fvalue_contains_set_free(fvalue_contains_set_t *set);
+
+/* Same as fvalue_contains(a, b) being TRUE for any b in the set. */
+gboolean
+fvalue_contains_any(const fvalue_t *a, const fvalue_contains_set_t *set);
+
 guint
 fvalue_length(fvalue_t *fv);
 
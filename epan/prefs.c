@@ -2667,6 +2667,15 @@ prefs_register_modules(void)
             "without menu path (only the part of the name after last '/' character.)",
             &prefs.st_sort_showfullname);
 
+    prefs_register_uint_preference(stats_module, "st_max_children",
+            "Maximum number of items per stats_tree node (0 = unlimited)",
+            "If non-zero, nodes of statistics based on the stats_tree system keep at "
+            "most this many dynamically created items; the least counted item is "
+            "replaced when a new one is seen, and the number of distinct items is "
+            "estimated. This bounds the memory used on very large captures, at the "
+            "cost of approximate counts for the items that are shown.",
+            10,&prefs.st_max_children);
+
     /* Protocols */
     protocols_module = prefs_register_module(NULL, "protocols", "Protocols",
                                              "Protocols", NULL, TRUE);
@@ -3172,6 +3181,7 @@ pre_init_prefs(void)
     prefs.st_sort_defcolflag = ST_SORT_COL_COUNT;
     prefs.st_sort_defdescending = TRUE;
     prefs.st_sort_showfullname = FALSE;
+    prefs.st_max_children = 0;
     prefs.display_hidden_proto_items = FALSE;
     prefs.display_byte_fields_with_spaces = FALSE;
 }
@@ -236,6 +236,7 @@ typedef struct _e_prefs {
   gint         st_sort_defcolflag;
   gboolean     st_sort_defdescending;
   gboolean     st_sort_showfullname;
+  guint        st_max_children;
 #ifdef HAVE_EXTCAP
   gboolean     extcap_save_on_start;
 #endif
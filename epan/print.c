@@ -35,6 +35,7 @@
 #include <epan/packet-range.h>
 #include <epan/print.h>
 #include <epan/charsets.h>
+#include <epan/ipv4.h>
 #include <wsutil/filesystem.h>
 #include <ws_version_info.h>
 #include <wsutil/utf8_entities.h>
@@ -67,6 +68,36 @@ typedef struct {
     epan_dissect_t  *edt;
 } write_field_data_t;
 
+/*
+ * Column types of the columnar field output, as written to the file.
+ * Values are little-endian; addresses are in network byte order and
+ * times are nanoseconds (since the epoch for absolute times).
+ */
+typedef enum {
+    FIELD_COL_STRING   = 0,   /* 32-bit index into the column's dictionary */
+    FIELD_COL_UINT     = 1,   /* 64-bit unsigned integer */
+    FIELD_COL_INT      = 2,   /* 64-bit signed integer */
+    FIELD_COL_DOUBLE   = 3,   /* IEEE 754 double */
+    FIELD_COL_IPV4     = 4,   /* 4 bytes */
+    FIELD_COL_IPV6     = 5,   /* 16 bytes */
+    FIELD_COL_ETHER    = 6,   /* 6 bytes */
+    FIELD_COL_ABS_TIME = 7,   /* 64-bit signed integer */
+    FIELD_COL_REL_TIME = 8    /* 64-bit signed integer */
+} field_col_type_e;
+
+/* Number of rows in each record batch of the columnar field output */
+#define FIELD_COL_BATCH_ROWS 8192
+
+typedef struct {
+    field_col_type_e type;
+    guint        width;       /* bytes per value */
+    gboolean     set;         /* a value was stored for the current row */
+    GByteArray  *values;      /* width bytes for each row of the batch */
+    GByteArray  *present;     /* one bit for each row of the batch */
+    GHashTable  *dict;        /* string -> index + 1, for FIELD_COL_STRING */
+    GPtrArray   *dict_new;    /* strings added to the dictionary in this batch */
+} field_column_t;
+
 struct _output_fields {
     gboolean     print_bom;
     gboolean     print_header;
@@ -78,6 +109,10 @@ struct _output_fields {
     GPtrArray  **field_values;
     gchar        quote;
     gboolean     includes_col_fields;
+    gboolean     columnar;
+    field_column_t *columns;
+    guint32      batch_rows;
+    guint64      total_rows;
 };
 
 static gchar *get_field_hex_value(GSList *src_list, field_info *fi);
@@ -1039,6 +1074,20 @@ void output_fields_free(output_fields_t* fields)
             g_free(fields->field_values);
         }
 
+        if (NULL != fields->columns) {
+            for(i = 0; i < fields->fields->len; ++i) {
+                field_column_t *column = &fields->columns[i];
+
+                g_byte_array_free(column->values, TRUE);
+                g_byte_array_free(column->present, TRUE);
+                if (column->dict) {
+                    g_hash_table_destroy(column->dict);
+                    g_ptr_array_free(column->dict_new, TRUE);
+                }
+            }
+            g_free(fields->columns);
+        }
+
         for(i = 0; i < fields->fields->len; ++i) {
             gchar* field = (gchar *)g_ptr_array_index(fields->fields,i);
             g_free(field);
@@ -1200,6 +1249,19 @@ gboolean output_fields_set_option(output_fields_t *info, gchar *option)
         }
         return TRUE;
     }
+    else if (0 == strcmp(option_name, "format")) {
+        switch (*option_value) {
+        case 't':
+            info->columnar = FALSE;
+            break;
+        case 'c':
+            info->columnar = TRUE;
+            break;
+        default:
+            return FALSE;
+        }
+        return TRUE;
+    }
     else if (0 == strcmp(option_name, "bom")) {
         switch (*option_value) {
         case 'n':
@@ -1226,6 +1288,7 @@ void output_fields_list_options(FILE *fh)
     fputs("occurrence=f|l|a  Select the occurrence of a field to use;\n     \"f\" = first, \"l\" = last, \"a\" = all (def: a: all)\n", fh);
     fputs("aggregator=,|/s|<character>   Set the aggregator to use;\n     \",\" = comma, \"/s\" = space (def: ,: comma)\n", fh);
     fputs("quote=d|s|n   Print either d: double-quotes, s: single quotes or \n     n: no quotes around field values (def: n: none)\n", fh);
+    fputs("format=text|columnar   Write the fields as text, or as typed binary\n     columns in record batches (def: text)\n", fh);
 }
 
 gboolean output_fields_has_cols(output_fields_t* fields)
@@ -1234,6 +1297,333 @@ gboolean output_fields_has_cols(output_fields_t* fields)
     return fields->includes_col_fields;
 }
 
+gboolean output_fields_is_columnar(output_fields_t* fields)
+{
+    g_assert(fields);
+    return fields->columnar;
+}
+
+/*
+ * Columnar field output.
+ *
+ * The file starts with a header:
+ *   "WSFC", version (1 byte, 1), 3 reserved bytes,
+ *   number of columns (32 bits),
+ *   for each column: type (1 byte, field_col_type_e), value width in
+ *   bytes (1 byte), name length (16 bits), name (the -e field).
+ * Then come record batches of up to FIELD_COL_BATCH_ROWS rows (packets):
+ *   "WSFB", number of rows (32 bits),
+ *   for each column:
+ *     for FIELD_COL_STRING columns, the strings added to the column's
+ *     dictionary by this batch: their number (32 bits), then for each the
+ *     length (32 bits) and the UTF-8 bytes; dictionary indexes are given
+ *     in order of addition, from 0, and hold for the rest of the file,
+ *     a bitmap with a bit set for each row that has a value (row n is bit
+ *     n%8 of byte n/8),
+ *     the values, width bytes per row (zero for rows without a value).
+ * The file ends with "WSFE" and the total number of rows (64 bits).
+ * All integers are little-endian.
+ *
+ * Each row holds one value per column: the first occurrence of the field
+ * in the packet, or the last one with occurrence=l.  Fields whose type has
+ * no column type of its own are written as strings.
+ */
+
+static void
+field_col_put_le(GByteArray *buf, guint offset, guint64 value, guint width)
+{
+    guint i;
+
+    for (i = 0; i < width; i++) {
+        buf->data[offset + i] = (guint8)(value >> (8 * i));
+    }
+}
+
+static void
+field_col_write_le(FILE *fh, guint64 value, guint width)
+{
+    guint8 buf[8];
+    guint i;
+
+    for (i = 0; i < width; i++) {
+        buf[i] = (guint8)(value >> (8 * i));
+    }
+    fwrite(buf, 1, width, fh);
+}
+
+static field_col_type_e
+field_col_type_for_ftype(ftenum_t type)
+{
+    switch (type) {
+    case FT_UINT8:
+    case FT_UINT16:
+    case FT_UINT24:
+    case FT_UINT32:
+    case FT_UINT40:
+    case FT_UINT48:
+    case FT_UINT56:
+    case FT_UINT64:
+    case FT_BOOLEAN:
+    case FT_FRAMENUM:
+        return FIELD_COL_UINT;
+    case FT_INT8:
+    case FT_INT16:
+    case FT_INT24:
+    case FT_INT32:
+    case FT_INT40:
+    case FT_INT48:
+    case FT_INT56:
+    case FT_INT64:
+        return FIELD_COL_INT;
+    case FT_FLOAT:
+    case FT_DOUBLE:
+        return FIELD_COL_DOUBLE;
+    case FT_IPv4:
+        return FIELD_COL_IPV4;
+    case FT_IPv6:
+        return FIELD_COL_IPV6;
+    case FT_ETHER:
+        return FIELD_COL_ETHER;
+    case FT_ABSOLUTE_TIME:
+        return FIELD_COL_ABS_TIME;
+    case FT_RELATIVE_TIME:
+        return FIELD_COL_REL_TIME;
+    default:
+        return FIELD_COL_STRING;
+    }
+}
+
+/* The column type for a field; fields registered more than once under
+   the same name with types of different column types become strings. */
+static field_col_type_e
+field_col_type_for_field(const gchar *field)
+{
+    header_field_info *hfinfo = proto_registrar_get_byname(field);
+    field_col_type_e type;
+
+    if (!hfinfo) {
+        /* _ws.col.* */
+        return FIELD_COL_STRING;
+    }
+
+    while (hfinfo->same_name_prev_id != -1) {
+        hfinfo = proto_registrar_get_nth(hfinfo->same_name_prev_id);
+    }
+    type = field_col_type_for_ftype(hfinfo->type);
+    for (hfinfo = hfinfo->same_name_next; hfinfo; hfinfo = hfinfo->same_name_next) {
+        if (field_col_type_for_ftype(hfinfo->type) != type) {
+            return FIELD_COL_STRING;
+        }
+    }
+    return type;
+}
+
+static guint
+field_col_width(field_col_type_e type)
+{
+    switch (type) {
+    case FIELD_COL_STRING:
+    case FIELD_COL_IPV4:
+        return 4;
+    case FIELD_COL_IPV6:
+        return 16;
+    case FIELD_COL_ETHER:
+        return FT_ETHER_LEN;
+    default:
+        return 8;
+    }
+}
+
+static void
+write_columnar_preamble(output_fields_t *fields, FILE *fh)
+{
+    gsize i;
+
+    fields->columns = g_new0(field_column_t, fields->fields->len);
+
+    fwrite("WSFC\1\0\0\0", 1, 8, fh);
+    field_col_write_le(fh, fields->fields->len, 4);
+
+    for (i = 0; i < fields->fields->len; i++) {
+        const gchar *field = (const gchar *)g_ptr_array_index(fields->fields, i);
+        field_column_t *column = &fields->columns[i];
+        size_t name_len = strlen(field);
+
+        column->type = field_col_type_for_field(field);
+        column->width = field_col_width(column->type);
+        column->values = g_byte_array_sized_new(FIELD_COL_BATCH_ROWS * column->width);
+        column->present = g_byte_array_sized_new(FIELD_COL_BATCH_ROWS / 8);
+        if (column->type == FIELD_COL_STRING) {
+            column->dict = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+            column->dict_new = g_ptr_array_new();
+        }
+
+        fputc(column->type, fh);
+        fputc(column->width, fh);
+        field_col_write_le(fh, name_len, 2);
+        fwrite(field, 1, name_len, fh);
+    }
+}
+
+static void
+write_columnar_batch(output_fields_t *fields, FILE *fh)
+{
+    gsize i;
+    guint j;
+
+    if (fields->batch_rows == 0) {
+        return;
+    }
+
+    fwrite("WSFB", 1, 4, fh);
+    field_col_write_le(fh, fields->batch_rows, 4);
+
+    for (i = 0; i < fields->fields->len; i++) {
+        field_column_t *column = &fields->columns[i];
+
+        if (column->type == FIELD_COL_STRING) {
+            field_col_write_le(fh, column->dict_new->len, 4);
+            for (j = 0; j < column->dict_new->len; j++) {
+                const gchar *str = (const gchar *)g_ptr_array_index(column->dict_new, j);
+                size_t len = strlen(str);
+
+                field_col_write_le(fh, len, 4);
+                fwrite(str, 1, len, fh);
+            }
+            g_ptr_array_set_size(column->dict_new, 0);
+        }
+        fwrite(column->present->data, 1, column->present->len, fh);
+        fwrite(column->values->data, 1, column->values->len, fh);
+
+        g_byte_array_set_size(column->present, 0);
+        g_byte_array_set_size(column->values, 0);
+    }
+
+    fields->total_rows += fields->batch_rows;
+    fields->batch_rows = 0;
+}
+
+static void
+columnar_begin_row(output_fields_t *fields)
+{
+    gsize i;
+
+    for (i = 0; i < fields->fields->len; i++) {
+        field_column_t *column = &fields->columns[i];
+        guint offset = column->values->len;
+
+        column->set = FALSE;
+        g_byte_array_set_size(column->values, offset + column->width);
+        memset(column->values->data + offset, 0, column->width);
+        if (fields->batch_rows % 8 == 0) {
+            g_byte_array_set_size(column->present, column->present->len + 1);
+            column->present->data[column->present->len - 1] = 0;
+        }
+    }
+}
+
+static void
+columnar_set_string(field_column_t *column, guint offset, const gchar *str)
+{
+    gpointer idx = g_hash_table_lookup(column->dict, str);
+
+    if (!idx) {
+        gchar *copy = g_strdup(str);
+
+        idx = GUINT_TO_POINTER(g_hash_table_size(column->dict) + 1);
+        g_hash_table_insert(column->dict, copy, idx);
+        g_ptr_array_add(column->dict_new, copy);
+    }
+    field_col_put_le(column->values, offset, GPOINTER_TO_UINT(idx) - 1, 4);
+}
+
+static void
+columnar_field_value(output_fields_t *fields, gpointer field_index, field_info *fi, epan_dissect_t *edt)
+{
+    /* Unwrap change made to disambiguiate zero / null */
+    field_column_t *column = &fields->columns[GPOINTER_TO_UINT(field_index) - 1];
+    guint offset = fields->batch_rows * column->width;
+    ftenum_t ftype = fi->hfinfo->type;
+    union {
+        gdouble d;
+        guint64 u;
+    } dbl;
+    const nstime_t *ts;
+
+    if (column->set && fields->occurrence != 'l') {
+        return;
+    }
+
+    switch (column->type) {
+    case FIELD_COL_UINT:
+        if (ftype == FT_UINT40 || ftype == FT_UINT48 || ftype == FT_UINT56 ||
+            ftype == FT_UINT64 || ftype == FT_BOOLEAN) {
+            field_col_put_le(column->values, offset, fvalue_get_uinteger64(&fi->value), 8);
+        } else {
+            field_col_put_le(column->values, offset, fvalue_get_uinteger(&fi->value), 8);
+        }
+        break;
+    case FIELD_COL_INT:
+        if (ftype == FT_INT40 || ftype == FT_INT48 || ftype == FT_INT56 || ftype == FT_INT64) {
+            field_col_put_le(column->values, offset, (guint64)fvalue_get_sinteger64(&fi->value), 8);
+        } else {
+            field_col_put_le(column->values, offset, (guint64)(gint64)fvalue_get_sinteger(&fi->value), 8);
+        }
+        break;
+    case FIELD_COL_DOUBLE:
+        dbl.d = fvalue_get_floating(&fi->value);
+        field_col_put_le(column->values, offset, dbl.u, 8);
+        break;
+    case FIELD_COL_IPV4:
+    {
+        guint32 addr = ipv4_get_net_order_addr((ipv4_addr_and_mask *)fvalue_get(&fi->value));
+
+        memcpy(column->values->data + offset, &addr, 4);
+        break;
+    }
+    case FIELD_COL_IPV6:
+    case FIELD_COL_ETHER:
+        memcpy(column->values->data + offset, fvalue_get(&fi->value), column->width);
+        break;
+    case FIELD_COL_ABS_TIME:
+    case FIELD_COL_REL_TIME:
+        ts = (const nstime_t *)fvalue_get(&fi->value);
+        field_col_put_le(column->values, offset,
+                (guint64)((gint64)ts->secs * 1000000000 + ts->nsecs), 8);
+        break;
+    case FIELD_COL_STRING:
+        if (IS_FT_STRING(ftype)) {
+            /* the string as it is, without quoting or escaping */
+            columnar_set_string(column, offset, (const gchar *)fvalue_get(&fi->value));
+        } else {
+            gchar *str = get_node_field_value(fi, edt);
+
+            if (!str) {
+                return;
+            }
+            columnar_set_string(column, offset, str);
+            g_free(str);
+        }
+        break;
+    }
+
+    column->set = TRUE;
+    column->present->data[fields->batch_rows / 8] |= 1 << (fields->batch_rows % 8);
+}
+
+static void
+columnar_column_value(output_fields_t *fields, gpointer field_index, const gchar *str)
+{
+    field_column_t *column = &fields->columns[GPOINTER_TO_UINT(field_index) - 1];
+
+    if (column->set && fields->occurrence != 'l') {
+        return;
+    }
+    columnar_set_string(column, fields->batch_rows * column->width, str);
+    column->set = TRUE;
+    column->present->data[fields->batch_rows / 8] |= 1 << (fields->batch_rows % 8);
+}
+
 void write_fields_preamble(output_fields_t* fields, FILE *fh)
 {
     gsize i;
@@ -1242,6 +1632,11 @@ void write_fields_preamble(output_fields_t* fields, FILE *fh)
     g_assert(fh);
     g_assert(fields->fields);
 
+    if (fields->columnar) {
+        write_columnar_preamble(fields, fh);
+        return;
+    }
+
     if (fields->print_bom) {
         fputs(UTF8_BOM, fh);
     }
@@ -1320,9 +1715,13 @@ static void proto_tree_get_node_field_values(proto_node *node, gpointer data)
 
     field_index = g_hash_table_lookup(call_data->fields->field_indicies, fi->hfinfo->abbrev);
     if (NULL != field_index) {
-        format_field_values(call_data->fields, field_index,
-                            get_node_field_value(fi, call_data->edt) /* g_ alloc'd string */
-            );
+        if (call_data->fields->columnar) {
+            columnar_field_value(call_data->fields, field_index, fi, call_data->edt);
+        } else {
+            format_field_values(call_data->fields, field_index,
+                                get_node_field_value(fi, call_data->edt) /* g_ alloc'd string */
+                );
+        }
     }
 
     /* Recurse here. */
@@ -1364,6 +1763,30 @@ void write_fields_proto_tree(output_fields_t *fields, epan_dissect_t *edt, colum
         }
     }
 
+    if (fields->columnar) {
+        columnar_begin_row(fields);
+
+        proto_tree_children_foreach(edt->tree, proto_tree_get_node_field_values,
+                                    &data);
+
+        if (fields->includes_col_fields) {
+            for (col = 0; col < cinfo->num_cols; col++) {
+                col_name = g_strdup_printf("%s%s", COLUMN_FIELD_FILTER, cinfo->columns[col].col_title);
+                field_index = g_hash_table_lookup(fields->field_indicies, col_name);
+                g_free(col_name);
+
+                if (NULL != field_index) {
+                    columnar_column_value(fields, field_index, cinfo->columns[col].col_data);
+                }
+            }
+        }
+
+        if (++fields->batch_rows == FIELD_COL_BATCH_ROWS) {
+            write_columnar_batch(fields, fh);
+        }
+        return;
+    }
+
     /* Array buffer to store values for this packet              */
     /*  Allocate an array for the 'GPtrarray *' the first time   */
     /*   ths function is invoked for a file;                     */
@@ -1417,9 +1840,13 @@ void write_fields_proto_tree(output_fields_t *fields, epan_dissect_t *edt, colum
     }
 }
 
-void write_fields_finale(output_fields_t* fields _U_ , FILE *fh _U_)
+void write_fields_finale(output_fields_t* fields, FILE *fh)
 {
-    /* Nothing to do */
+    if (fields->columnar) {
+        write_columnar_batch(fields, fh);
+        fwrite("WSFE", 1, 4, fh);
+        field_col_write_le(fh, fields->total_rows, 8);
+    }
 }
 
 /* Returns an g_malloced string */
@@ -1521,6 +1948,10 @@ output_fields_t* output_fields_new(void)
     fields->field_values        = NULL;
     fields->quote               ='\0';
     fields->includes_col_fields = FALSE;
+    fields->columnar            = FALSE;
+    fields->columns             = NULL;
+    fields->batch_rows          = 0;
+    fields->total_rows          = 0;
     return fields;
 }
 
@@ -93,6 +93,7 @@ WS_DLL_PUBLIC gsize output_fields_num_fields(output_fields_t* info);
 WS_DLL_PUBLIC gboolean output_fields_set_option(output_fields_t* info, gchar* option);
 WS_DLL_PUBLIC void output_fields_list_options(FILE *fh);
 WS_DLL_PUBLIC gboolean output_fields_has_cols(output_fields_t* info);
+WS_DLL_PUBLIC gboolean output_fields_is_columnar(output_fields_t* info);
 
 /*
  * Higher-level packet-printing code.
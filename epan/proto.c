@@ -292,6 +292,7 @@ static expert_field ei_number_string_decoding_erange_error = EI_INIT;
 static void register_number_string_decoding_error(void);
 
 static int proto_register_field_init(header_field_info *hfinfo, const int parent);
+static void tmp_fld_check_types(header_field_info *hfinfo);
 
 /* special-case header field used within proto.c */
 static header_field_info hfi_text_only =
@@ -363,6 +364,9 @@ static header_field_info *same_name_hfinfo;
 static char *last_field_name = NULL;
 static header_field_info *last_hfinfo;
 
+/* TRUE while proto_init() registers fields; see tmp_fld_check_assert() */
+static gboolean fld_checks_deferred = FALSE;
+
 static void save_same_name_hfinfo(gpointer data)
 {
 	same_name_hfinfo = (header_field_info*)data;
@@ -487,6 +491,8 @@ proto_init(void (register_all_protocols_func)(register_cb cb, gpointer client_da
 	   register_cb cb,
 	   gpointer client_data)
 {
+	guint i;
+
 	proto_cleanup();
 
 	proto_names        = g_hash_table_new_full(g_int_hash, g_int_equal, g_free, NULL);
@@ -506,6 +512,8 @@ proto_init(void (register_all_protocols_func)(register_cb cb, gpointer client_da
 	/* Initialize the addres type subsystem */
 	address_types_initialize();
 
+	fld_checks_deferred = TRUE;
+
 	/* Register one special-case FT_TEXT_ONLY field for use when
 	   converting wireshark to new-style proto_tree. These fields
 	   are merely strings on the GUI tree; they are not filterable */
@@ -543,6 +551,18 @@ proto_init(void (register_all_protocols_func)(register_cb cb, gpointer client_da
 	g_slist_foreach(dissector_plugins, reg_handoff_dissector_plugin, NULL);
 #endif
 
+	/* Check the types and displays of all the fields registered
+	   above, unless the user would rather start up faster; fields
+	   registered from now on, by plugins such as mate or by Lua,
+	   are checked as they're registered. */
+	fld_checks_deferred = FALSE;
+	if (getenv("WIRESHARK_SKIP_FIELD_CHECKS") == NULL) {
+		for (i = 0; i < gpa_hfinfo.len; i++) {
+			if (gpa_hfinfo.hfi[i] != NULL)
+				tmp_fld_check_types(gpa_hfinfo.hfi[i]);
+		}
+	}
+
 	/* sort the protocols by protocol name */
 	protocols = g_list_sort(protocols, proto_compare_name);
 
@@ -6354,8 +6374,6 @@ display_to_port_type(field_display_e e)
 static void
 tmp_fld_check_assert(header_field_info *hfinfo)
 {
-	gchar* tmp_str;
-
 	/* The field must have a name (with length > 0) */
 	if (!hfinfo->name || !hfinfo->name[0]) {
 		if (hfinfo->abbrev)
@@ -6371,6 +6389,17 @@ tmp_fld_check_assert(header_field_info *hfinfo)
 	if (!hfinfo->abbrev || !hfinfo->abbrev[0])
 		g_error("Field '%s' does not have an abbreviation\n", hfinfo->name);
 
+	/* The type and display checks of the fields registered by
+	   proto_init() are done in one pass once they're all registered. */
+	if (!fld_checks_deferred)
+		tmp_fld_check_types(hfinfo);
+}
+
+static void
+tmp_fld_check_types(header_field_info *hfinfo)
+{
+	gchar* tmp_str;
+
 	/*  These types of fields are allowed to have value_strings,
 	 *  true_false_strings or a protocol_t struct
 	 */
@@ -192,6 +192,29 @@ void rtd_table_dissector_init(register_rtd_t* rtd, rtd_stat_table* table, rtd_gu
         gui_callback(table, callback_data);
 }
 
+void merge_rtd_table_data(rtd_stat_table* table, const rtd_stat_table* src)
+{
+    guint i, j;
+
+    g_assert(table->num_rtds == src->num_rtds);
+
+    for (i = 0; i < table->num_rtds; i++)
+    {
+        rtd_timestat *ts = &table->time_stats[i];
+        const rtd_timestat *src_ts = &src->time_stats[i];
+
+        g_assert(ts->num_timestat == src_ts->num_timestat);
+
+        for (j = 0; j < ts->num_timestat; j++)
+            time_stat_merge(&ts->rtd[j], &src_ts->rtd[j]);
+
+        ts->open_req_num += src_ts->open_req_num;
+        ts->disc_rsp_num += src_ts->disc_rsp_num;
+        ts->req_dup_num += src_ts->req_dup_num;
+        ts->rsp_dup_num += src_ts->rsp_dup_num;
+    }
+}
+
 void rtd_table_iterate_tables(GFunc func, gpointer user_data)
 {
     g_slist_foreach(registered_rtd_tables, func, user_data);
@@ -170,6 +170,16 @@ WS_DLL_PUBLIC void rtd_table_dissector_init(register_rtd_t* rtd, rtd_stat_table*
  */
 WS_DLL_PUBLIC gchar* rtd_table_get_tap_string(register_rtd_t* rtd);
 
+/** Add the data of one RTD table to another, e.g. to combine the results
+ * of taps run over different parts of a capture or over different files.
+ * Both tables must have been created by rtd_table_dissector_init() for the
+ * same registered RTD.
+ *
+ * @param table the table to add the data to
+ * @param src the table whose data is added
+ */
+WS_DLL_PUBLIC void merge_rtd_table_data(rtd_stat_table* table, const rtd_stat_table* src);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
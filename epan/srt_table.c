@@ -304,6 +304,32 @@ add_srt_table_data(srt_stat_table *rst, int indx, const nstime_t *req_time, pack
     time_stat_update(&rp->stats, &delta, pinfo);
 }
 
+void
+merge_srt_table_data(GArray* srt_array, GArray* src_array)
+{
+    guint i;
+    int j;
+
+    g_assert(srt_array->len == src_array->len);
+
+    for (i = 0; i < src_array->len; i++)
+    {
+        srt_stat_table *rst = g_array_index(srt_array, srt_stat_table*, i);
+        srt_stat_table *src = g_array_index(src_array, srt_stat_table*, i);
+
+        for (j = 0; j < src->num_procs; j++)
+        {
+            if (src->procedures[j].stats.num == 0)
+                continue;
+
+            if (j >= rst->num_procs || rst->procedures[j].procedure == NULL)
+                init_srt_table_row(rst, j, src->procedures[j].procedure);
+
+            time_stat_merge(&rst->procedures[j].stats, &src->procedures[j].stats);
+        }
+    }
+}
+
 /*
  * Editor modelines
  *
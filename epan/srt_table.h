@@ -220,6 +220,16 @@ WS_DLL_PUBLIC void init_srt_table_row(srt_stat_table *rst, int index, const char
  */
 WS_DLL_PUBLIC void add_srt_table_data(srt_stat_table *rst, int index, const nstime_t *req_time, packet_info *pinfo);
 
+/** Add the data of one set of srt tables to another, e.g. to combine the
+ * results of taps run over different parts of a capture or over different
+ * files. Both sets must have been created by srt_table_dissector_init() for
+ * the same registered SRT; procedures only known to src are added to dst.
+ *
+ * @param srt_array the tables to add the data to
+ * @param src_array the tables whose data is added
+ */
+WS_DLL_PUBLIC void merge_srt_table_data(GArray* srt_array, GArray* src_array);
+
 
 #ifdef __cplusplus
 }
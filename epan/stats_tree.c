@@ -41,6 +41,7 @@
 #include <string.h>
 
 #include "strutil.h"
+#include "to_str.h"
 #include "stats_tree.h"
 
 enum _stat_tree_columns {
@@ -59,16 +60,199 @@ enum _stat_tree_columns {
 /* used to contain the registered stat trees */
 static GHashTable *registry = NULL;
 
+/* number of HyperLogLog registers (of one byte each) is 2^ST_HLL_BITS */
+#define ST_HLL_BITS 10
+#define ST_HLL_REGISTERS (1 << ST_HLL_BITS)
+
+/*
+ * The dynamically created children of a node with bounded children: only
+ * max_children of them are kept, and when a new one is seen the leaf with
+ * the lowest counter is handed over to it, keeping its counter as the
+ * Space-Saving algorithm does (so the counts of the items shown are upper
+ * bounds).  The leaves that can be replaced are kept in a binary min-heap
+ * on their counters, so the lowest one is always at the top.  The number
+ * of distinct children ever seen is estimated with a HyperLogLog, whose
+ * registers can simply be merged by taking the maximum.
+ */
+struct _st_node_sketch {
+    guint      max_children;
+    guint      num_children;
+    guint64    replaced;
+    GPtrArray *heap;
+    guint8     registers[ST_HLL_REGISTERS];
+};
+
+static void
+st_heap_set(GPtrArray *heap, guint pos, stat_node *node)
+{
+    g_ptr_array_index(heap, pos) = node;
+    node->heap_pos = (gint)pos;
+}
+
+/* restores the heap order after the counter of node has changed */
+static void
+st_heap_update(st_node_sketch *sk, stat_node *node)
+{
+    GPtrArray *heap = sk->heap;
+    guint pos = (guint)node->heap_pos;
+    guint up, child;
+    stat_node *other;
+
+    while (pos > 0) {
+        up = (pos - 1) / 2;
+        other = (stat_node *)g_ptr_array_index(heap, up);
+        if (other->counter <= node->counter)
+            break;
+        st_heap_set(heap, pos, other);
+        pos = up;
+    }
+
+    for (;;) {
+        child = 2 * pos + 1;
+        if (child >= heap->len)
+            break;
+        if (child + 1 < heap->len &&
+            ((stat_node *)g_ptr_array_index(heap, child + 1))->counter <
+            ((stat_node *)g_ptr_array_index(heap, child))->counter)
+            child++;
+        other = (stat_node *)g_ptr_array_index(heap, child);
+        if (node->counter <= other->counter)
+            break;
+        st_heap_set(heap, pos, other);
+        pos = child;
+    }
+
+    st_heap_set(heap, pos, node);
+}
+
+static void
+st_heap_push(st_node_sketch *sk, stat_node *node)
+{
+    g_ptr_array_add(sk->heap, node);
+    node->heap_pos = sk->heap->len - 1;
+    st_heap_update(sk, node);
+}
+
+static guint64
+st_mix64(guint64 h)
+{
+    /* MurmurHash3 finalizer */
+    h ^= h >> 33;
+    h *= G_GUINT64_CONSTANT(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= G_GUINT64_CONSTANT(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h;
+}
+
+static guint64
+st_child_hash(const gchar *name, stat_node_key_type key_type, guint64 key)
+{
+    guint64 h;
+
+    if (key_type != ST_KEY_NONE)
+        return st_mix64(key);
+
+    /* FNV-1a */
+    h = G_GUINT64_CONSTANT(0xcbf29ce484222325);
+    while (*name) {
+        h ^= (guint8)*name++;
+        h *= G_GUINT64_CONSTANT(0x100000001b3);
+    }
+    return st_mix64(h);
+}
+
+static void
+st_sketch_add(st_node_sketch *sk, guint64 hash)
+{
+    guint idx = (guint)(hash >> (64 - ST_HLL_BITS));
+    guint64 rest = hash << ST_HLL_BITS;
+    guint8 rank = 1;
+
+    while (rank <= 64 - ST_HLL_BITS && !(rest & G_GUINT64_CONSTANT(0x8000000000000000))) {
+        rest <<= 1;
+        rank++;
+    }
+    if (sk->registers[idx] < rank)
+        sk->registers[idx] = rank;
+}
+
+static guint64
+st_sketch_estimate(const st_node_sketch *sk)
+{
+    const double m = ST_HLL_REGISTERS;
+    double sum = 0.0;
+    double estimate;
+    guint zeros = 0;
+    guint i;
+
+    for (i = 0; i < ST_HLL_REGISTERS; i++) {
+        sum += ldexp(1.0, -sk->registers[i]);
+        if (!sk->registers[i])
+            zeros++;
+    }
+    estimate = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros) {
+        /* small range correction (linear counting) */
+        estimate = m * log(m / zeros);
+    }
+    return (guint64)(estimate + 0.5);
+}
+
+static gchar*
+format_node_key(stat_node_key_type key_type, guint64 key)
+{
+    guint32 addr;
+    gchar buf[MAX_IP_STR_LEN];
+
+    switch (key_type) {
+        case ST_KEY_HEX:
+            return g_strdup_printf("0x%" G_GINT64_MODIFIER "x", key);
+        case ST_KEY_IPV4:
+            addr = g_htonl((guint32)key);
+            ip_to_str_buf((const guint8 *)&addr, buf, (int)sizeof(buf));
+            return g_strdup(buf);
+        default:
+            return g_strdup_printf("%" G_GINT64_MODIFIER "u", key);
+    }
+}
+
+extern const gchar*
+stats_tree_node_name(const stat_node *node)
+{
+    if (!node->name) {
+        /* a node created by key, not displayed before */
+        ((stat_node *)node)->name = format_node_key(node->key_type, node->key);
+    }
+    return node->name;
+}
+
+extern guint64
+stats_tree_node_distinct_children(const stat_node *node)
+{
+    guint64 estimate;
+
+    if (!node->sketch)
+        return 0;
+
+    /* exact as long as nothing was dropped */
+    if (!node->sketch->replaced)
+        return node->sketch->num_children;
+
+    estimate = st_sketch_estimate(node->sketch);
+    return estimate > node->sketch->num_children ? estimate : node->sketch->num_children;
+}
+
 /* a text representation of a node
 if buffer is NULL returns a newly allocated string */
 extern gchar*
 stats_tree_node_to_str(const stat_node *node, gchar *buffer, guint len)
 {
     if (buffer) {
-        g_snprintf(buffer,len,"%s: %i",node->name, node->counter);
+        g_snprintf(buffer,len,"%s: %i",stats_tree_node_name(node), node->counter);
         return buffer;
     } else {
-        return g_strdup_printf("%s: %i",node->name, node->counter);
+        return g_strdup_printf("%s: %i",stats_tree_node_name(node), node->counter);
     }
 }
 
@@ -89,12 +273,12 @@ stats_tree_branch_max_namelen(const stat_node *node, guint indent)
     }
 
     if (node->st_flags&ST_FLG_ROOTCHILD) {
-        gchar *display_name= stats_tree_get_displayname(node->name);
+        gchar *display_name= stats_tree_get_displayname((gchar *)stats_tree_node_name(node));
         len = (guint) strlen(display_name) + indent;
         g_free(display_name);
     }
     else {
-    len = (guint) strlen(node->name) + indent;
+    len = (guint) strlen(stats_tree_node_name(node)) + indent;
     }
     maxlen = len > maxlen ? len : maxlen;
 
@@ -118,6 +302,7 @@ free_stat_node(stat_node *node)
     }
 
     if (node->hash) g_hash_table_destroy(node->hash);
+    if (node->key_hash) g_hash_table_destroy(node->key_hash);
 
     while (node->bh) {
         bucket = node->bh;
@@ -125,6 +310,10 @@ free_stat_node(stat_node *node)
         g_free(bucket);
     }
 
+    if (node->sketch) {
+        g_ptr_array_free(node->sketch->heap, TRUE);
+        g_free(node->sketch);
+    }
     g_free(node->rng);
     g_free(node->name);
     g_free(node);
@@ -184,6 +373,14 @@ reset_stat_node(stat_node *node)
     node->max_burst = 0;
     node->burst_time = -1.0;
 
+    if (node->sketch) {
+        /* the children that are kept are the distinct ones seen so far */
+        node->sketch->replaced = 0;
+        memset(node->sketch->registers, 0, sizeof(node->sketch->registers));
+        for (child = node->children; child; child = child->next )
+            st_sketch_add(node->sketch, st_child_hash(child->name, child->key_type, child->key));
+    }
+
     if (node->children) {
         for (child = node->children; child; child = child->next )
             reset_stat_node(child);
@@ -426,13 +623,15 @@ stats_tree_presentation(void (*registry_iterator)(gpointer,gpointer,gpointer),
 
 
 /* creates a stat_tree node
-*    name: the name of the stats_tree node
+*    name: the name of the stats_tree node (unused if key_type isn't ST_KEY_NONE)
+*    key_type, key: the key of the node, if it is to be looked up by key
 *    parent_name: the name of the ALREADY REGISTERED parent
 *    with_hash: whether or not it should keep a hash with its children names
 *    as_named_node: whether or not it has to be registered in the root namespace
 */
 static stat_node*
-new_stat_node(stats_tree *st, const gchar *name, int parent_id,
+new_keyed_stat_node(stats_tree *st, const gchar *name,
+          stat_node_key_type key_type, guint64 key, int parent_id,
           gboolean with_hash, gboolean as_parent_node)
 {
 
@@ -446,11 +645,25 @@ new_stat_node(stats_tree *st, const gchar *name, int parent_id,
     node->bh = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
     node->bt = node->bh;
     node->burst_time = -1.0;
-
-    node->name = g_strdup(name);
+    node->heap_pos = -1;
+
+    node->key_type = key_type;
+    node->key = key;
+    if (key_type == ST_KEY_NONE) {
+        node->name = g_strdup(name);
+    } else if (as_parent_node) {
+        /* st->names needs the name right away */
+        node->name = format_node_key(key_type, key);
+    }
     node->st = (stats_tree*) st;
     node->hash = with_hash ? g_hash_table_new(g_str_hash,g_str_equal) : NULL;
 
+    if (with_hash && prefs.st_max_children) {
+        node->sketch = g_new0(st_node_sketch, 1);
+        node->sketch->max_children = prefs.st_max_children;
+        node->sketch->heap = g_ptr_array_new();
+    }
+
     if (as_parent_node) {
         g_hash_table_insert(st->names,
                             node->name,
@@ -484,10 +697,20 @@ new_stat_node(stats_tree *st, const gchar *name, int parent_id,
         node->parent->children = node;
     }
 
-    if(node->parent->hash) {
+    if (key_type != ST_KEY_NONE) {
+        if (!node->parent->key_hash) {
+            node->parent->key_hash = g_hash_table_new(g_int64_hash,g_int64_equal);
+        }
+        g_hash_table_insert(node->parent->key_hash,&node->key,node);
+    } else if(node->parent->hash) {
         g_hash_table_insert(node->parent->hash,node->name,node);
     }
 
+    if (node->parent->sketch) {
+        node->parent->sketch->num_children++;
+        st_sketch_add(node->parent->sketch, st_child_hash(name, key_type, key));
+    }
+
     if (st->cfg->setup_node_pr) {
         st->cfg->setup_node_pr(node);
     } else {
@@ -496,6 +719,14 @@ new_stat_node(stats_tree *st, const gchar *name, int parent_id,
 
     return node;
 }
+
+static stat_node*
+new_stat_node(stats_tree *st, const gchar *name, int parent_id,
+          gboolean with_hash, gboolean as_parent_node)
+{
+    return new_keyed_stat_node(st, name, ST_KEY_NONE, 0, parent_id,
+                               with_hash, as_parent_node);
+}
 /***/
 
 extern int
@@ -605,14 +836,72 @@ update_burst_calc(stat_node *node, gint value)
 }
 
 /*
- * Increases by delta the counter of the node whose name is given
- * if the node does not exist yet it's created (with counter=1)
- * using parent_name as parent node.
- * with_hash=TRUE to indicate that the created node will have a parent
+ * Hands the leaf child with the lowest counter of a parent whose children
+ * are bounded over to a new name or key.  The counter is kept (it is the
+ * most the new child could have been counted while it wasn't there); all
+ * the rest starts anew.  Returns NULL if no child can be replaced.
  */
-extern int
-stats_tree_manip_node(manip_node_mode mode, stats_tree *st, const char *name,
-              int parent_id, gboolean with_hash, gint value)
+static stat_node*
+replace_min_child(stat_node *parent, const gchar *name,
+          stat_node_key_type key_type, guint64 key)
+{
+    stat_node *node;
+    burst_bucket *bucket;
+
+    /* children that are parents or ranges are never in the heap */
+    if (!parent->sketch->heap->len)
+        return NULL;
+    node = (stat_node *)g_ptr_array_index(parent->sketch->heap, 0);
+
+    if (node->key_type != ST_KEY_NONE) {
+        g_hash_table_remove(parent->key_hash,&node->key);
+    } else if (parent->hash) {
+        g_hash_table_remove(parent->hash,node->name);
+    }
+    g_free(node->name);
+    node->name = NULL;
+
+    node->key_type = key_type;
+    node->key = key;
+    if (key_type != ST_KEY_NONE) {
+        if (!parent->key_hash) {
+            parent->key_hash = g_hash_table_new(g_int64_hash,g_int64_equal);
+        }
+        g_hash_table_insert(parent->key_hash,&node->key,node);
+    } else {
+        node->name = g_strdup(name);
+        if (parent->hash) {
+            g_hash_table_insert(parent->hash,node->name,node);
+        }
+    }
+
+    node->total = 0;
+    node->minvalue = G_MAXINT;
+    node->maxvalue = G_MININT;
+    node->st_flags &= ~ST_FLG_AVERAGE;
+
+    while (node->bh) {
+        bucket = node->bh;
+        node->bh = bucket->next;
+        g_free(bucket);
+    }
+    node->bh = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
+    node->bt = node->bh;
+    node->bcount = 0;
+    node->max_burst = 0;
+    node->burst_time = -1.0;
+
+    parent->sketch->replaced++;
+    st_sketch_add(parent->sketch, st_child_hash(name, key_type, key));
+
+    return node;
+}
+
+/* finds the node with the given name or key, creating it if needed */
+static stat_node*
+get_stat_node(stats_tree *st, const gchar *name,
+          stat_node_key_type key_type, guint64 key, int parent_id,
+          gboolean with_hash)
 {
     stat_node *node = NULL;
     stat_node *parent = NULL;
@@ -621,15 +910,32 @@ stats_tree_manip_node(manip_node_mode mode, stats_tree *st, const char *name,
 
     parent = (stat_node *)g_ptr_array_index(st->parents,parent_id);
 
-    if( parent->hash ) {
+    if (key_type != ST_KEY_NONE) {
+        if (parent->key_hash) {
+            node = (stat_node *)g_hash_table_lookup(parent->key_hash,&key);
+        }
+    } else if( parent->hash ) {
         node = (stat_node *)g_hash_table_lookup(parent->hash,name);
     } else {
         node = (stat_node *)g_hash_table_lookup(st->names,name);
     }
 
-    if ( node == NULL )
-        node = new_stat_node(st,name,parent_id,with_hash,with_hash);
+    if ( node == NULL && !with_hash && parent->sketch &&
+         parent->sketch->num_children >= parent->sketch->max_children )
+        node = replace_min_child(parent,name,key_type,key);
 
+    if ( node == NULL ) {
+        node = new_keyed_stat_node(st,name,key_type,key,parent_id,with_hash,with_hash);
+        if (!with_hash && parent->sketch)
+            st_heap_push(parent->sketch, node);
+    }
+
+    return node;
+}
+
+static int
+manip_stat_node(manip_node_mode mode, stat_node *node, gint value)
+{
     switch (mode) {
         case MN_INCREASE:
             node->counter += value;
@@ -658,12 +964,132 @@ stats_tree_manip_node(manip_node_mode mode, stats_tree *st, const char *name,
             break;
     }
 
-    if (node)
-        return node->id;
-    else
-        return -1;
+    if (node->heap_pos >= 0)
+        st_heap_update(node->parent->sketch, node);
+
+    return node->id;
+}
+
+/*
+ * Increases by delta the counter of the node whose name is given
+ * if the node does not exist yet it's created (with counter=1)
+ * using parent_name as parent node.
+ * with_hash=TRUE to indicate that the created node will have a parent
+ */
+extern int
+stats_tree_manip_node(manip_node_mode mode, stats_tree *st, const char *name,
+              int parent_id, gboolean with_hash, gint value)
+{
+    return manip_stat_node(mode,
+                           get_stat_node(st,name,ST_KEY_NONE,0,parent_id,with_hash),
+                           value);
+}
+
+extern int
+stats_tree_manip_node_by_key(manip_node_mode mode, stats_tree *st,
+              stat_node_key_type key_type, guint64 key,
+              int parent_id, gboolean with_hash, gint value)
+{
+    g_assert(key_type != ST_KEY_NONE);
+
+    return manip_stat_node(mode,
+                           get_stat_node(st,NULL,key_type,key,parent_id,with_hash),
+                           value);
+}
+
+
+/* finds the child of parent that corresponds to the given node of another tree */
+static stat_node*
+get_merge_child(stats_tree *st, stat_node *parent, const stat_node *src)
+{
+    stat_node *node = NULL;
+
+    if (src->key_type != ST_KEY_NONE) {
+        if (parent->key_hash) {
+            node = (stat_node *)g_hash_table_lookup(parent->key_hash,&src->key);
+        }
+    } else if (parent->hash) {
+        node = (stat_node *)g_hash_table_lookup(parent->hash,src->name);
+    } else {
+        for (node = parent->children; node; node = node->next) {
+            if (node->key_type == ST_KEY_NONE && strcmp(node->name,src->name) == 0)
+                break;
+        }
+    }
+
+    if ( node == NULL && src->id == -1 && !src->children && !src->rng &&
+         parent->sketch && parent->sketch->num_children >= parent->sketch->max_children )
+        node = replace_min_child(parent,src->name,src->key_type,src->key);
+
+    if ( node == NULL ) {
+        node = new_keyed_stat_node(st,src->name,src->key_type,src->key,parent->id,
+                                   src->hash != NULL,src->id != -1);
+        if (src->rng) {
+            node->rng = (range_pair_t *)g_memdup(src->rng,sizeof(range_pair_t));
+        } else if (src->id == -1 && !src->children && parent->sketch) {
+            st_heap_push(parent->sketch, node);
+        }
+    }
+
+    return node;
 }
 
+static void
+merge_stat_node(stats_tree *st, stat_node *node, const stat_node *src)
+{
+    const stat_node *src_child;
+    guint i;
+
+    node->counter += src->counter;
+    if (node->heap_pos >= 0)
+        st_heap_update(node->parent->sketch, node);
+    node->total += src->total;
+    if (node->minvalue > src->minvalue) {
+        node->minvalue = src->minvalue;
+    }
+    if (node->maxvalue < src->maxvalue) {
+        node->maxvalue = src->maxvalue;
+    }
+    node->st_flags |= src->st_flags;
+
+    /* the bursts of both are not known to overlap, so keep the larger one */
+    if (node->max_burst < src->max_burst) {
+        node->max_burst = src->max_burst;
+        node->burst_time = src->burst_time;
+    }
+
+    for (src_child = src->children; src_child; src_child = src_child->next) {
+        merge_stat_node(st, get_merge_child(st, node, src_child), src_child);
+    }
+
+    if (node->sketch && src->sketch) {
+        /* the HyperLogLog of the union */
+        for (i = 0; i < ST_HLL_REGISTERS; i++) {
+            if (node->sketch->registers[i] < src->sketch->registers[i])
+                node->sketch->registers[i] = src->sketch->registers[i];
+        }
+        node->sketch->replaced += src->sketch->replaced;
+    }
+}
+
+extern void
+stats_tree_merge(stats_tree *st, const stats_tree *src)
+{
+    const stat_node *src_child;
+
+    g_assert(st->cfg == src->cfg);
+
+    if (src->start >= 0.0 && (st->start < 0.0 || src->start < st->start))
+        st->start = src->start;
+    if (src->now > st->now)
+        st->now = src->now;
+    st->elapsed = st->start < 0.0 ? 0.0 : st->now - st->start;
+
+    st->root.counter += src->root.counter;
+    for (src_child = src->root.children; src_child; src_child = src_child->next) {
+        merge_stat_node(st, get_merge_child(st, &st->root, src_child), src_child);
+    }
+}
 
 extern char*
 stats_tree_get_abbr(const char *opt_arg)
@@ -1003,7 +1429,15 @@ stats_tree_get_values_from_node (const stat_node* node)
 {
     gchar **values = (gchar**) g_malloc0(sizeof(gchar*)*(node->st->num_columns));
 
-    values[COL_NAME]= (node->st_flags&ST_FLG_ROOTCHILD)?stats_tree_get_displayname(node->name):g_strdup(node->name);
+    values[COL_NAME]= (node->st_flags&ST_FLG_ROOTCHILD)?
+                stats_tree_get_displayname((gchar *)stats_tree_node_name(node)):
+                g_strdup(stats_tree_node_name(node));
+    if (node->sketch && node->sketch->replaced) {
+        gchar *name = values[COL_NAME];
+        values[COL_NAME]= g_strdup_printf("%s (~%" G_GINT64_MODIFIER "u distinct)",
+                name, stats_tree_node_distinct_children(node));
+        g_free(name);
+    }
     values[COL_COUNT]= g_strdup_printf("%u",node->counter);
     values[COL_AVERAGE]= ((node->st_flags&ST_FLG_AVERAGE)||node->rng)?
                 (node->counter?g_strdup_printf("%.2f",((float)node->total)/node->counter):g_strdup("-")):
@@ -1030,6 +1464,24 @@ stats_tree_get_values_from_node (const stat_node* node)
     return values;
 }
 
+/* ranges by range, nodes keyed alike by key and the others by name */
+static gint
+compare_node_names (const stat_node *a, const stat_node *b)
+{
+    if  (a->rng&&b->rng) {
+        return a->rng->floor - b->rng->floor;
+    }
+    else if (a->key_type!=ST_KEY_NONE && a->key_type==b->key_type) {
+        return (a->key>b->key)?1:((a->key<b->key)?-1:0);
+    }
+    else if (prefs.st_sort_casesensitve) {
+        return strcmp(stats_tree_node_name(a),stats_tree_node_name(b));
+    }
+    else {
+        return g_ascii_strcasecmp(stats_tree_node_name(a),stats_tree_node_name(b));
+    }
+}
+
 extern gint
 stats_tree_sort_compare (const stat_node *a, const stat_node *b, gint sort_column,
                     gboolean sort_descending)
@@ -1048,15 +1500,7 @@ stats_tree_sort_compare (const stat_node *a, const stat_node *b, gint sort_colum
 
     switch (sort_column) {
         case COL_NAME:
-            if  (a->rng&&b->rng) {
-                result = a->rng->floor - b->rng->floor;
-            }
-            else if (prefs.st_sort_casesensitve) {
-                result = strcmp(a->name,b->name);
-            }
-            else {
-                result = g_ascii_strcasecmp(a->name,b->name);
-            }
+            result = compare_node_names(a,b);
             break;
 
         case COL_RATE:
@@ -1106,15 +1550,7 @@ stats_tree_sort_compare (const stat_node *a, const stat_node *b, gint sort_colum
             result = a->counter - b->counter;
         }
         else {
-            if  (a->rng&&b->rng) {
-                result = a->rng->floor - b->rng->floor;
-            }
-            else if (prefs.st_sort_casesensitve) {
-                result = strcmp(a->name,b->name);
-            }
-            else {
-                result = g_ascii_strcasecmp(a->name,b->name);
-            }
+            result = compare_node_names(a,b);
         }
     }
 
@@ -237,6 +237,40 @@ WS_DLL_PUBLIC int stats_tree_manip_node(manip_node_mode mode,
 #define stat_node_clear_flags(st,name,parent_id,with_children,flags)    \
     (stats_tree_manip_node(MN_CLEAR_FLAGS,(st),(name),(parent_id),(with_children),flags))
 
+/*
+ * Nodes can also be looked up by an integer key instead of by name, e.g.
+ * an address or a port number; the name of such a node is only formatted
+ * (according to the key type) when the tree is displayed, rather than for
+ * every packet.  Keyed and named children can be mixed under one parent.
+ */
+typedef enum _stat_node_key_type {
+    ST_KEY_NONE,    /* the node is looked up by name */
+    ST_KEY_UINT,    /* shown as an unsigned decimal number */
+    ST_KEY_HEX,     /* shown as a hexadecimal number */
+    ST_KEY_IPV4     /* shown as an IPv4 address; the key is in host byte order */
+} stat_node_key_type;
+
+/*
+ * manipulates the value of the node with the given key under parent_id
+ * if the node does not exist yet it's created as for stats_tree_manip_node()
+ */
+WS_DLL_PUBLIC int stats_tree_manip_node_by_key(manip_node_mode mode,
+                                               stats_tree *st,
+                                               stat_node_key_type key_type,
+                                               guint64 key,
+                                               int parent_id,
+                                               gboolean with_children,
+                                               gint value);
+
+#define increase_stat_node_by_key(st,key_type,key,parent_id,with_children,value) \
+    (stats_tree_manip_node_by_key(MN_INCREASE,(st),(key_type),(key),(parent_id),(with_children),(value)))
+
+#define tick_stat_node_by_key(st,key_type,key,parent_id,with_children)  \
+    (stats_tree_manip_node_by_key(MN_INCREASE,(st),(key_type),(key),(parent_id),(with_children),1))
+
+#define avg_stat_node_add_value_by_key(st,key_type,key,parent_id,with_children,value) \
+    (stats_tree_manip_node_by_key(MN_AVERAGE,(st),(key_type),(key),(parent_id),(with_children),value))
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -50,6 +50,9 @@ typedef struct _tree_cfg_pres tree_cfg_pres;
 typedef struct _stat_node stat_node;
 typedef struct _stats_tree_cfg stats_tree_cfg;
 
+/** bounded set of children of a node, defined in stats_tree.c */
+typedef struct _st_node_sketch st_node_sketch;
+
 typedef struct _range_pair {
 	gint floor;
 	gint ceil;
@@ -85,6 +88,22 @@ struct _stat_node {
 	/** children nodes by name */
 	GHashTable		*hash;
 
+	/** the key of a node created by key; its name is NULL until
+	 *  stats_tree_node_name() formats it */
+	stat_node_key_type	key_type;
+	guint64			key;
+
+	/** children nodes by key */
+	GHashTable		*key_hash;
+
+	/** top children and distinct count if the number of dynamically
+	 *  created children is bounded (st_max_children preference) */
+	st_node_sketch	*sketch;
+
+	/** position in the min-heap of the parent's sketch,
+	 *  -1 if the node can't be replaced */
+	gint			heap_pos;
+
 	/** the owner of this node */
 	stats_tree		*st;
 
@@ -182,6 +201,11 @@ WS_DLL_PUBLIC stats_tree *stats_tree_new(stats_tree_cfg *cfg, tree_pres *pr, con
 /** callback for taps */
 WS_DLL_PUBLIC int  stats_tree_packet(void*, packet_info*, epan_dissect_t*, const void *);
 
+/** adds the nodes and counters of src to st, e.g. to combine the results
+    of taps run over different parts of a capture or over different files;
+    both must have been created from the same cfg */
+WS_DLL_PUBLIC void stats_tree_merge(stats_tree *st, const stats_tree *src);
+
 /** callback for reset */
 WS_DLL_PUBLIC void stats_tree_reset(void *p_st);
 
@@ -205,6 +229,14 @@ WS_DLL_PUBLIC GList *stats_tree_get_cfg_list(void);
 /** used to calcuate the size of the indentation and the longest string */
 WS_DLL_PUBLIC guint stats_tree_branch_max_namelen(const stat_node *node, guint indent);
 
+/** the name of a node; for nodes created by key it is formatted
+   (and kept) the first time this is called */
+WS_DLL_PUBLIC const gchar *stats_tree_node_name(const stat_node *node);
+
+/** number of distinct children that were added to a node with bounded
+   children; an estimate once some of them had to be dropped */
+WS_DLL_PUBLIC guint64 stats_tree_node_distinct_children(const stat_node *node);
+
 /** a text representation of a node,
    if buffer is NULL returns a newly allocated string */
 WS_DLL_PUBLIC gchar *stats_tree_node_to_str(const stat_node *node,
@@ -0,0 +1,345 @@
+/* stats_tree_test.c
+ * Tests for keyed stats_tree nodes, bounded children and merging
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <glib.h>
+
+#include "prefs.h"
+#include "stats_tree_priv.h"
+
+static stats_tree_cfg test_cfg;
+
+static stats_tree *
+test_tree_new(guint max_children)
+{
+    prefs.st_max_children = max_children;
+    return stats_tree_new(&test_cfg, NULL, "");
+}
+
+static stat_node *
+parent_node(stats_tree *st, int id)
+{
+    return (stat_node *)g_ptr_array_index(st->parents, id);
+}
+
+static stat_node *
+keyed_child(stat_node *parent, guint64 key)
+{
+    if (!parent->key_hash)
+        return NULL;
+    return (stat_node *)g_hash_table_lookup(parent->key_hash, &key);
+}
+
+static guint
+num_children(const stat_node *parent)
+{
+    const stat_node *child;
+    guint n = 0;
+
+    for (child = parent->children; child; child = child->next)
+        n++;
+    return n;
+}
+
+static void
+stats_tree_test_keyed(void)
+{
+    stats_tree *st = test_tree_new(0);
+    int hosts = stats_tree_create_node(st, "hosts", 0, TRUE);
+    int ports = stats_tree_create_node(st, "ports", 0, TRUE);
+    stat_node *parent = parent_node(st, hosts);
+    stat_node *node;
+
+    tick_stat_node_by_key(st, ST_KEY_IPV4, 0x0a000001, hosts, FALSE);
+    tick_stat_node_by_key(st, ST_KEY_IPV4, 0xc0a80001, hosts, FALSE);
+    increase_stat_node_by_key(st, ST_KEY_IPV4, 0x0a000001, hosts, FALSE, 4);
+    tick_stat_node_by_key(st, ST_KEY_HEX, 0x1f, ports, FALSE);
+    tick_stat_node_by_key(st, ST_KEY_UINT, 80, ports, FALSE);
+
+    /* one node per key, whatever the number of packets */
+    g_assert_cmpuint(num_children(parent), ==, 2);
+    node = keyed_child(parent, 0x0a000001);
+    g_assert(node != NULL);
+    g_assert_cmpint(node->counter, ==, 5);
+
+    /* the name is only formatted when it's asked for */
+    g_assert(node->name == NULL);
+    g_assert_cmpstr(stats_tree_node_name(node), ==, "10.0.0.1");
+    g_assert_cmpstr(stats_tree_node_name(keyed_child(parent, 0xc0a80001)), ==, "192.168.0.1");
+
+    parent = parent_node(st, ports);
+    g_assert_cmpstr(stats_tree_node_name(keyed_child(parent, 0x1f)), ==, "0x1f");
+    g_assert_cmpstr(stats_tree_node_name(keyed_child(parent, 80)), ==, "80");
+
+    /* named and keyed children can share a parent */
+    tick_stat_node(st, "other", ports, FALSE);
+    g_assert_cmpuint(num_children(parent), ==, 3);
+
+    stats_tree_free(st);
+}
+
+static void
+stats_tree_test_eviction(void)
+{
+    stats_tree *st = test_tree_new(4);
+    int hosts = stats_tree_create_node(st, "hosts", 0, TRUE);
+    stat_node *parent = parent_node(st, hosts);
+    stat_node *node;
+
+    increase_stat_node_by_key(st, ST_KEY_UINT, 1, hosts, FALSE, 5);
+    increase_stat_node_by_key(st, ST_KEY_UINT, 2, hosts, FALSE, 1);
+    increase_stat_node_by_key(st, ST_KEY_UINT, 3, hosts, FALSE, 3);
+    increase_stat_node_by_key(st, ST_KEY_UINT, 4, hosts, FALSE, 2);
+    g_assert_cmpuint(num_children(parent), ==, 4);
+
+    /* key 2 has the lowest count and is handed over, keeping its count */
+    tick_stat_node_by_key(st, ST_KEY_UINT, 5, hosts, FALSE);
+    g_assert_cmpuint(num_children(parent), ==, 4);
+    g_assert(keyed_child(parent, 2) == NULL);
+    node = keyed_child(parent, 5);
+    g_assert(node != NULL);
+    g_assert_cmpint(node->counter, ==, 2);
+    g_assert_cmpstr(stats_tree_node_name(node), ==, "5");
+
+    /* raising a count moves the node away from eviction */
+    increase_stat_node_by_key(st, ST_KEY_UINT, 4, hosts, FALSE, 10);
+    tick_stat_node_by_key(st, ST_KEY_UINT, 6, hosts, FALSE);
+    g_assert(keyed_child(parent, 5) == NULL);
+    g_assert(keyed_child(parent, 4) != NULL);
+    g_assert_cmpint(keyed_child(parent, 6)->counter, ==, 3);
+
+    /* named children are evicted as well */
+    tick_stat_node(st, "named", hosts, FALSE);
+    g_assert_cmpuint(num_children(parent), ==, 4);
+    g_assert(g_hash_table_lookup(parent->hash, "named") != NULL);
+
+    stats_tree_free(st);
+}
+
+static void
+stats_tree_test_eviction_min(void)
+{
+    stats_tree *st = test_tree_new(64);
+    int hosts = stats_tree_create_node(st, "hosts", 0, TRUE);
+    stat_node *parent = parent_node(st, hosts);
+    stat_node *child;
+    GRand *rand = g_rand_new_with_seed(20161018);
+    guint64 key;
+    gint value, min;
+    int i;
+
+    /* a new key always takes over the count of the lowest child */
+    for (i = 0; i < 20000; i++) {
+        key = g_rand_int_range(rand, 0, 1000);
+        value = g_rand_int_range(rand, 1, 10);
+        if (keyed_child(parent, key) || num_children(parent) < 64) {
+            increase_stat_node_by_key(st, ST_KEY_UINT, key, hosts, FALSE, value);
+            continue;
+        }
+        min = G_MAXINT;
+        for (child = parent->children; child; child = child->next)
+            min = MIN(min, child->counter);
+        increase_stat_node_by_key(st, ST_KEY_UINT, key, hosts, FALSE, value);
+        g_assert_cmpint(keyed_child(parent, key)->counter, ==, min + value);
+        g_assert_cmpuint(num_children(parent), ==, 64);
+    }
+
+    g_rand_free(rand);
+    stats_tree_free(st);
+}
+
+static void
+stats_tree_test_distinct(void)
+{
+    stats_tree *st = test_tree_new(16);
+    int hosts = stats_tree_create_node(st, "hosts", 0, TRUE);
+    stat_node *parent = parent_node(st, hosts);
+    guint64 estimate;
+    guint64 key;
+
+    /* exact as long as nothing was dropped */
+    for (key = 0; key < 16; key++)
+        tick_stat_node_by_key(st, ST_KEY_IPV4, key, hosts, FALSE);
+    g_assert_cmpuint(stats_tree_node_distinct_children(parent), ==, 16);
+
+    /* repeated keys aren't counted twice */
+    for (key = 0; key < 20000; key++)
+        tick_stat_node_by_key(st, ST_KEY_IPV4, key % 10000, hosts, FALSE);
+    g_assert_cmpuint(num_children(parent), ==, 16);
+
+    /* 1024 registers give a standard error of about 3% */
+    estimate = stats_tree_node_distinct_children(parent);
+    g_assert_cmpuint(estimate, >, 9000);
+    g_assert_cmpuint(estimate, <, 11000);
+
+    stats_tree_free(st);
+}
+
+/* the same packets, ticked into a tree */
+static void
+tick_packets(stats_tree *st, int hosts, guint32 seed, int from, int to)
+{
+    GRand *rand = g_rand_new_with_seed(seed);
+    guint64 key;
+    gint value;
+    int i;
+
+    for (i = 0; i < to; i++) {
+        key = g_rand_int_range(rand, 0, 3000);
+        value = g_rand_int_range(rand, 1, 1500);
+        if (i < from)
+            continue;
+        tick_stat_node(st, "packets", 0, FALSE);
+        avg_stat_node_add_value_by_key(st, ST_KEY_IPV4, key, hosts, FALSE, value);
+        if (key % 7 == 0)
+            tick_stat_node(st, "sevens", hosts, FALSE);
+    }
+
+    g_rand_free(rand);
+}
+
+static stat_node *
+merged_child(stat_node *parent, const stat_node *child)
+{
+    stat_node *node;
+
+    if (child->key_type != ST_KEY_NONE)
+        return keyed_child(parent, child->key);
+    for (node = parent->children; node; node = node->next) {
+        if (node->key_type == ST_KEY_NONE && strcmp(node->name, child->name) == 0)
+            break;
+    }
+    return node;
+}
+
+static void
+check_same_nodes(stat_node *merged, const stat_node *whole)
+{
+    const stat_node *child;
+
+    g_assert_cmpint(merged->counter, ==, whole->counter);
+    g_assert_cmpint(merged->total, ==, whole->total);
+    g_assert_cmpint(merged->minvalue, ==, whole->minvalue);
+    g_assert_cmpint(merged->maxvalue, ==, whole->maxvalue);
+    g_assert_cmpuint(num_children(merged), ==, num_children(whole));
+
+    for (child = whole->children; child; child = child->next) {
+        stat_node *node = merged_child(merged, child);
+
+        g_assert(node != NULL);
+        check_same_nodes(node, child);
+    }
+}
+
+static void
+stats_tree_test_merge(void)
+{
+    stats_tree *whole = test_tree_new(0);
+    stats_tree *part1 = test_tree_new(0);
+    stats_tree *part2 = test_tree_new(0);
+    int hosts_whole = stats_tree_create_node(whole, "hosts", 0, TRUE);
+    int hosts1 = stats_tree_create_node(part1, "hosts", 0, TRUE);
+    int hosts2 = stats_tree_create_node(part2, "hosts", 0, TRUE);
+
+    stats_tree_create_node(whole, "packets", 0, FALSE);
+    stats_tree_create_node(part1, "packets", 0, FALSE);
+    stats_tree_create_node(part2, "packets", 0, FALSE);
+
+    tick_packets(whole, hosts_whole, 38, 0, 20000);
+    tick_packets(part1, hosts1, 38, 0, 7000);
+    tick_packets(part2, hosts2, 38, 7000, 20000);
+
+    /* merging two parts gives what a single pass over both gives */
+    stats_tree_merge(part1, part2);
+    check_same_nodes(&part1->root, &whole->root);
+
+    stats_tree_free(whole);
+    stats_tree_free(part1);
+    stats_tree_free(part2);
+}
+
+static void
+stats_tree_test_merge_distinct(void)
+{
+    stats_tree *whole = test_tree_new(32);
+    stats_tree *part1 = test_tree_new(32);
+    stats_tree *part2 = test_tree_new(32);
+    int hosts_whole = stats_tree_create_node(whole, "hosts", 0, TRUE);
+    int hosts1 = stats_tree_create_node(part1, "hosts", 0, TRUE);
+    int hosts2 = stats_tree_create_node(part2, "hosts", 0, TRUE);
+    stat_node *hosts;
+
+    stats_tree_create_node(whole, "packets", 0, FALSE);
+    stats_tree_create_node(part1, "packets", 0, FALSE);
+    stats_tree_create_node(part2, "packets", 0, FALSE);
+
+    tick_packets(whole, hosts_whole, 38, 0, 20000);
+    tick_packets(part1, hosts1, 38, 0, 12000);
+    tick_packets(part2, hosts2, 38, 12000, 20000);
+
+    /* the sketch of the union is the union of the sketches */
+    stats_tree_merge(part1, part2);
+    hosts = parent_node(part1, hosts1);
+    g_assert_cmpuint(num_children(hosts), ==, 32);
+    g_assert_cmpuint(stats_tree_node_distinct_children(hosts), ==,
+                     stats_tree_node_distinct_children(parent_node(whole, hosts_whole)));
+
+    stats_tree_free(whole);
+    stats_tree_free(part1);
+    stats_tree_free(part2);
+}
+
+int
+main(int argc, char **argv)
+{
+    int result;
+
+    g_test_init(&argc, &argv, NULL);
+
+    test_cfg.name = "Test";
+
+    g_test_add_func("/stats_tree/keyed", stats_tree_test_keyed);
+    g_test_add_func("/stats_tree/eviction", stats_tree_test_eviction);
+    g_test_add_func("/stats_tree/eviction/min", stats_tree_test_eviction_min);
+    g_test_add_func("/stats_tree/distinct", stats_tree_test_distinct);
+    g_test_add_func("/stats_tree/merge", stats_tree_test_merge);
+    g_test_add_func("/stats_tree/merge/distinct", stats_tree_test_merge_distinct);
+
+    result = g_test_run();
+
+    return result;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -105,6 +105,9 @@ typedef struct _tap_listener_t {
 } tap_listener_t;
 static volatile tap_listener_t *tap_listener_queue=NULL;
 
+/* if set, only this listener (and dissector helpers) get tapped packets */
+static void *exclusive_tapdata=NULL;
+
 #ifdef HAVE_PLUGINS
 
 #include <gmodule.h>
@@ -356,6 +359,10 @@ tap_push_tapped_queue(epan_dissect_t *edt)
 	   for all packets that match the filter. */
 	for(i=0;i<tap_packet_index;i++){
 		for(tl=tap_listener_queue;tl;tl=tl->next){
+			if(exclusive_tapdata && tl->tapdata!=exclusive_tapdata
+			    && !(tl->flags & TL_IS_DISSECTOR_HELPER)){
+				continue;
+			}
 			tp=&tap_packet_array[i];
 			/* Don't tap the packet if it's an "error" unless the listener tells us to */
 			if (!(tp->flags & TAP_PACKET_IS_ERROR_PACKET) || (tl->flags & TL_REQUIRES_ERROR_PACKETS))
@@ -649,6 +656,10 @@ remove_tap_listener(void *tapdata)
 {
 	volatile tap_listener_t *tl=NULL,*tl2;
 
+	if(exclusive_tapdata==tapdata){
+		exclusive_tapdata=NULL;
+	}
+
 	if(!tap_listener_queue){
 		return;
 	}
@@ -669,6 +680,15 @@ remove_tap_listener(void *tapdata)
 	free_tap_listener(tl);
 }
 
+/* this function makes tap_push_tapped_queue() call only the listener with
+ * this tapdata (and any dissector helpers); NULL calls all of them again
+ */
+void
+set_tap_listener_exclusive(void *tapdata)
+{
+	exclusive_tapdata=tapdata;
+}
+
 /*
  * Return TRUE if we have one or more tap listeners that require dissection,
  * FALSE otherwise.
@@ -224,6 +224,14 @@ WS_DLL_PUBLIC void tap_listeners_dfilter_recompile(void);
 /** this function removes a tap listener */
 WS_DLL_PUBLIC void remove_tap_listener(void *tapdata);
 
+/**
+ * Deliver tapped packets only to the listener registered with tapdata (and
+ * to TL_IS_DISSECTOR_HELPER listeners), e.g. while re-dissecting a few
+ * packets for it outside of a retap, so that other listeners don't see them
+ * a second time. Pass NULL to deliver them to all listeners again.
+ */
+WS_DLL_PUBLIC void set_tap_listener_exclusive(void *tapdata);
+
 /**
  * Return TRUE if we have one or more tap listeners that require dissection,
  * FALSE otherwise.
@@ -68,6 +68,31 @@ time_stat_update(timestat_t *stats, const nstime_t *delta, packet_info *pinfo)
 	stats->num++;
 }
 
+/* Add the samples of one timestat_t struct to another */
+void
+time_stat_merge(timestat_t *stats, const timestat_t *src)
+{
+	if(src->num==0){
+		return;
+	}
+
+	if( (stats->num==0)
+	||(nstime_cmp(&src->min, &stats->min) < 0) ){
+		stats->min=src->min;
+		stats->min_num=src->min_num;
+	}
+
+	if( (stats->num==0)
+	||(nstime_cmp(&src->max, &stats->max) > 0) ){
+		stats->max=src->max;
+		stats->max_num=src->max_num;
+	}
+
+	nstime_add(&stats->tot, &src->tot);
+
+	stats->num+=src->num;
+}
+
 /*
  * get_average - function
  *
@@ -51,6 +51,10 @@ WS_DLL_PUBLIC void time_stat_init(timestat_t *stats);
 /* Update a timestat_t struct with a new sample */
 WS_DLL_PUBLIC void time_stat_update(timestat_t *stats, const nstime_t *delta, packet_info *pinfo);
 
+/* Add the samples of src to stats, as if they had been passed to
+   time_stat_update() for stats as well */
+WS_DLL_PUBLIC void time_stat_merge(timestat_t *stats, const timestat_t *src);
+
 WS_DLL_PUBLIC gdouble get_average(const nstime_t *sum, guint32 num);
 
 #ifdef __cplusplus
@@ -0,0 +1,565 @@
+/* timestats_test.c
+ * Tests for merging timestats, the SRT and RTD tables built on them,
+ * conversation and endpoint tables, and IO graph items
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <glib.h>
+
+#include "packet_info.h"
+#include "timestats.h"
+#include "srt_table.h"
+#include "rtd_table.h"
+#include "conversation_table.h"
+#include "epan_dissect.h"
+
+#include "ui/io_graph_item.h"
+
+#define NUM_SAMPLES 10000
+#define SPLIT       3777
+#define NUM_PROCS   5
+#define NUM_TABLES  2
+#define NUM_TIMESTATS 3
+#define NUM_HOSTS   7
+#define NUM_IO_ITEMS 20
+#define IO_COMBINE  4
+
+/* A reproducible sample: the frame it came from and a response time */
+typedef struct {
+    guint32  num;
+    nstime_t delta;
+    int      table;
+    int      indx;
+} sample_t;
+
+static sample_t samples[NUM_SAMPLES];
+
+static void
+make_samples(void)
+{
+    GRand *rand = g_rand_new_with_seed(4242);
+    int i;
+
+    for (i = 0; i < NUM_SAMPLES; i++) {
+        samples[i].num = i + 1;
+        samples[i].delta.secs = g_rand_int_range(rand, 0, 3);
+        samples[i].delta.nsecs = g_rand_int_range(rand, 0, 1000000000);
+        samples[i].table = g_rand_int_range(rand, 0, NUM_TABLES);
+        /* the last procedure is only seen after the split */
+        samples[i].indx = g_rand_int_range(rand, 0, i < SPLIT ? NUM_PROCS : NUM_PROCS + 1);
+    }
+
+    g_rand_free(rand);
+}
+
+static void
+check_same_timestat(const timestat_t *merged, const timestat_t *whole)
+{
+    g_assert_cmpuint(merged->num, ==, whole->num);
+    g_assert_cmpint(nstime_cmp(&merged->min, &whole->min), ==, 0);
+    g_assert_cmpint(nstime_cmp(&merged->max, &whole->max), ==, 0);
+    g_assert_cmpint(nstime_cmp(&merged->tot, &whole->tot), ==, 0);
+    g_assert_cmpuint(merged->min_num, ==, whole->min_num);
+    g_assert_cmpuint(merged->max_num, ==, whole->max_num);
+}
+
+static void
+update_timestat(timestat_t *stats, int from, int to)
+{
+    packet_info pinfo;
+    int i;
+
+    memset(&pinfo, 0, sizeof(pinfo));
+    for (i = from; i < to; i++) {
+        pinfo.num = samples[i].num;
+        time_stat_update(stats, &samples[i].delta, &pinfo);
+    }
+}
+
+static void
+timestats_test_merge(void)
+{
+    timestat_t whole, part1, part2, empty;
+
+    time_stat_init(&whole);
+    time_stat_init(&part1);
+    time_stat_init(&part2);
+    time_stat_init(&empty);
+
+    update_timestat(&whole, 0, NUM_SAMPLES);
+    update_timestat(&part1, 0, SPLIT);
+    update_timestat(&part2, SPLIT, NUM_SAMPLES);
+
+    /* merging two parts gives what a single pass over both gives */
+    time_stat_merge(&part1, &part2);
+    check_same_timestat(&part1, &whole);
+
+    /* and nothing is added by an empty part, on either side */
+    time_stat_merge(&part1, &empty);
+    check_same_timestat(&part1, &whole);
+    time_stat_merge(&empty, &whole);
+    check_same_timestat(&empty, &whole);
+}
+
+static GArray *
+srt_tables_new(void)
+{
+    GArray *srt_array = g_array_new(FALSE, TRUE, sizeof(srt_stat_table*));
+    int i;
+
+    for (i = 0; i < NUM_TABLES; i++)
+        init_srt_table("Test", NULL, srt_array, NUM_PROCS, NULL, "test.proc", NULL, NULL, NULL);
+    return srt_array;
+}
+
+static void
+srt_tables_free(GArray *srt_array)
+{
+    guint i;
+
+    for (i = 0; i < srt_array->len; i++) {
+        srt_stat_table *rst = g_array_index(srt_array, srt_stat_table*, i);
+
+        free_srt_table_data(rst);
+        g_free(rst);
+    }
+    g_array_free(srt_array, TRUE);
+}
+
+static void
+update_srt_tables(GArray *srt_array, int from, int to)
+{
+    packet_info pinfo;
+    nstime_t req_time;
+    gchar *procedure;
+    int i;
+
+    memset(&pinfo, 0, sizeof(pinfo));
+    nstime_set_zero(&req_time);
+    for (i = from; i < to; i++) {
+        srt_stat_table *rst = g_array_index(srt_array, srt_stat_table*, samples[i].table);
+
+        /* as dissectors do, name a procedure when it's first seen */
+        if (samples[i].indx >= rst->num_procs || !rst->procedures[samples[i].indx].procedure) {
+            procedure = g_strdup_printf("Proc %d", samples[i].indx);
+            init_srt_table_row(rst, samples[i].indx, procedure);
+            g_free(procedure);
+        }
+        pinfo.num = samples[i].num;
+        pinfo.abs_ts = samples[i].delta;
+        add_srt_table_data(rst, samples[i].indx, &req_time, &pinfo);
+    }
+}
+
+static void
+srt_table_test_merge(void)
+{
+    GArray *whole = srt_tables_new();
+    GArray *part1 = srt_tables_new();
+    GArray *part2 = srt_tables_new();
+    guint i;
+    int j;
+
+    update_srt_tables(whole, 0, NUM_SAMPLES);
+    update_srt_tables(part1, 0, SPLIT);
+    update_srt_tables(part2, SPLIT, NUM_SAMPLES);
+
+    /* a procedure only seen by the second part is added to the first */
+    merge_srt_table_data(part1, part2);
+
+    for (i = 0; i < whole->len; i++) {
+        srt_stat_table *merged = g_array_index(part1, srt_stat_table*, i);
+        srt_stat_table *rst = g_array_index(whole, srt_stat_table*, i);
+
+        g_assert_cmpint(merged->num_procs, ==, rst->num_procs);
+        for (j = 0; j < rst->num_procs; j++) {
+            g_assert_cmpstr(merged->procedures[j].procedure, ==, rst->procedures[j].procedure);
+            check_same_timestat(&merged->procedures[j].stats, &rst->procedures[j].stats);
+        }
+    }
+
+    srt_tables_free(whole);
+    srt_tables_free(part1);
+    srt_tables_free(part2);
+}
+
+static void
+rtd_table_init(rtd_stat_table *table)
+{
+    guint i;
+
+    table->filter = NULL;
+    table->num_rtds = NUM_TABLES;
+    table->time_stats = g_new0(rtd_timestat, NUM_TABLES);
+    for (i = 0; i < NUM_TABLES; i++) {
+        table->time_stats[i].num_timestat = NUM_TIMESTATS;
+        table->time_stats[i].rtd = g_new0(timestat_t, NUM_TIMESTATS);
+    }
+}
+
+static void
+update_rtd_table(rtd_stat_table *table, int from, int to)
+{
+    packet_info pinfo;
+    int i;
+
+    memset(&pinfo, 0, sizeof(pinfo));
+    for (i = from; i < to; i++) {
+        rtd_timestat *ts = &table->time_stats[samples[i].table];
+
+        pinfo.num = samples[i].num;
+        time_stat_update(&ts->rtd[samples[i].indx % NUM_TIMESTATS], &samples[i].delta, &pinfo);
+        switch (samples[i].indx) {
+        case 0:
+            ts->open_req_num++;
+            break;
+        case 1:
+            ts->disc_rsp_num++;
+            break;
+        case 2:
+            ts->req_dup_num++;
+            break;
+        case 3:
+            ts->rsp_dup_num++;
+            break;
+        }
+    }
+}
+
+static void
+rtd_table_test_merge(void)
+{
+    rtd_stat_table whole, part1, part2;
+    guint i, j;
+
+    rtd_table_init(&whole);
+    rtd_table_init(&part1);
+    rtd_table_init(&part2);
+
+    update_rtd_table(&whole, 0, NUM_SAMPLES);
+    update_rtd_table(&part1, 0, SPLIT);
+    update_rtd_table(&part2, SPLIT, NUM_SAMPLES);
+
+    merge_rtd_table_data(&part1, &part2);
+
+    for (i = 0; i < NUM_TABLES; i++) {
+        const rtd_timestat *merged = &part1.time_stats[i];
+        const rtd_timestat *ts = &whole.time_stats[i];
+
+        for (j = 0; j < NUM_TIMESTATS; j++)
+            check_same_timestat(&merged->rtd[j], &ts->rtd[j]);
+        g_assert_cmpuint(merged->open_req_num, ==, ts->open_req_num);
+        g_assert_cmpuint(merged->disc_rsp_num, ==, ts->disc_rsp_num);
+        g_assert_cmpuint(merged->req_dup_num, ==, ts->req_dup_num);
+        g_assert_cmpuint(merged->rsp_dup_num, ==, ts->rsp_dup_num);
+    }
+
+    free_rtd_table(&whole, NULL, NULL);
+    free_rtd_table(&part1, NULL, NULL);
+    free_rtd_table(&part2, NULL, NULL);
+}
+
+/* The addresses and ports of a sample: a few hosts talking, in both
+   directions, to a few servers on one of two ports */
+static void
+sample_endpoints(int i, guint32 *src_ip, guint32 *dst_ip, guint32 *src_port, guint32 *dst_port)
+{
+    guint32 client = g_htonl(0x0A000001 + samples[i].indx % NUM_HOSTS);
+    guint32 server = g_htonl(0x0A000101 + samples[i].table);
+    guint32 client_port = 1024 + samples[i].indx;
+    guint32 server_port = samples[i].num % 2 ? 80 : 443;
+
+    if (samples[i].num % 3) {
+        *src_ip = client;
+        *dst_ip = server;
+        *src_port = client_port;
+        *dst_port = server_port;
+    } else {
+        *src_ip = server;
+        *dst_ip = client;
+        *src_port = server_port;
+        *dst_port = client_port;
+    }
+}
+
+static void
+update_conversations(conv_hash_t *ch, int from, int to)
+{
+    address src, dst;
+    guint32 src_ip, dst_ip, src_port, dst_port;
+    nstime_t ts, abs_ts;
+    int i;
+
+    for (i = from; i < to; i++) {
+        sample_endpoints(i, &src_ip, &dst_ip, &src_port, &dst_port);
+        set_address(&src, AT_IPv4, 4, &src_ip);
+        set_address(&dst, AT_IPv4, 4, &dst_ip);
+        /* samples are in time order, a millisecond apart */
+        ts.secs = samples[i].num / 1000;
+        ts.nsecs = (samples[i].num % 1000) * 1000000;
+        abs_ts = ts;
+        abs_ts.secs += 1000000000;
+        add_conversation_table_data(ch, &src, &dst, src_port, dst_port, 1,
+                (int)samples[i].delta.nsecs % 1500, &ts, &abs_ts, NULL, PT_TCP);
+    }
+}
+
+static void
+conversation_table_test_merge(void)
+{
+    conv_hash_t whole, part1, part2, empty;
+    address src, dst;
+    guint32 src_ip = g_htonl(0x0A0000FE), dst_ip = g_htonl(0x0A0001FE);
+    guint i;
+
+    memset(&whole, 0, sizeof(whole));
+    memset(&part1, 0, sizeof(part1));
+    memset(&part2, 0, sizeof(part2));
+    memset(&empty, 0, sizeof(empty));
+
+    update_conversations(&whole, 0, NUM_SAMPLES);
+    update_conversations(&part1, 0, SPLIT);
+    update_conversations(&part2, SPLIT, NUM_SAMPLES);
+
+    /* a conversation without time stamps, only seen by the second part */
+    set_address(&src, AT_IPv4, 4, &src_ip);
+    set_address(&dst, AT_IPv4, 4, &dst_ip);
+    add_conversation_table_data(&whole, &src, &dst, 7, 9, 2, 100, NULL, NULL, NULL, PT_UDP);
+    add_conversation_table_data(&part2, &src, &dst, 7, 9, 2, 100, NULL, NULL, NULL, PT_UDP);
+
+    merge_conversation_table_data(&part1, &part2);
+    merge_conversation_table_data(&part1, &empty);
+
+    /* the second part's new conversations come after the first part's,
+       as they would after reading both parts in one go */
+    g_assert_cmpuint(part1.conv_array->len, ==, whole.conv_array->len);
+    for (i = 0; i < whole.conv_array->len; i++) {
+        const conv_item_t *merged = &g_array_index(part1.conv_array, conv_item_t, i);
+        const conv_item_t *conv = &g_array_index(whole.conv_array, conv_item_t, i);
+
+        g_assert(addresses_equal(&merged->src_address, &conv->src_address));
+        g_assert(addresses_equal(&merged->dst_address, &conv->dst_address));
+        g_assert_cmpuint(merged->src_port, ==, conv->src_port);
+        g_assert_cmpuint(merged->dst_port, ==, conv->dst_port);
+        g_assert_cmpuint(merged->ptype, ==, conv->ptype);
+        g_assert_cmpuint(merged->tx_frames, ==, conv->tx_frames);
+        g_assert_cmpuint(merged->rx_frames, ==, conv->rx_frames);
+        g_assert_cmpuint(merged->tx_bytes, ==, conv->tx_bytes);
+        g_assert_cmpuint(merged->rx_bytes, ==, conv->rx_bytes);
+        g_assert_cmpint(nstime_is_unset(&merged->start_time), ==, nstime_is_unset(&conv->start_time));
+        if (!nstime_is_unset(&conv->start_time)) {
+            g_assert_cmpint(nstime_cmp(&merged->start_time, &conv->start_time), ==, 0);
+            g_assert_cmpint(nstime_cmp(&merged->stop_time, &conv->stop_time), ==, 0);
+            g_assert_cmpint(nstime_cmp(&merged->start_abs_time, &conv->start_abs_time), ==, 0);
+        }
+    }
+
+    /* merging into an empty table copies it */
+    merge_conversation_table_data(&empty, &whole);
+    g_assert_cmpuint(empty.conv_array->len, ==, whole.conv_array->len);
+
+    reset_conversation_table_data(&whole);
+    reset_conversation_table_data(&part1);
+    reset_conversation_table_data(&part2);
+    reset_conversation_table_data(&empty);
+}
+
+static void
+update_hostlist(conv_hash_t *ch, int from, int to)
+{
+    address src, dst;
+    guint32 src_ip, dst_ip, src_port, dst_port;
+    int bytes, i;
+
+    for (i = from; i < to; i++) {
+        sample_endpoints(i, &src_ip, &dst_ip, &src_port, &dst_port);
+        set_address(&src, AT_IPv4, 4, &src_ip);
+        set_address(&dst, AT_IPv4, 4, &dst_ip);
+        bytes = (int)samples[i].delta.nsecs % 1500;
+        add_hostlist_table_data(ch, &src, src_port, TRUE, 1, bytes, NULL, PT_TCP);
+        add_hostlist_table_data(ch, &dst, dst_port, FALSE, 1, bytes, NULL, PT_TCP);
+    }
+}
+
+static void
+hostlist_table_test_merge(void)
+{
+    conv_hash_t whole, part1, part2;
+    guint i;
+
+    memset(&whole, 0, sizeof(whole));
+    memset(&part1, 0, sizeof(part1));
+    memset(&part2, 0, sizeof(part2));
+
+    update_hostlist(&whole, 0, NUM_SAMPLES);
+    update_hostlist(&part1, 0, SPLIT);
+    update_hostlist(&part2, SPLIT, NUM_SAMPLES);
+
+    merge_hostlist_table_data(&part1, &part2);
+
+    g_assert_cmpuint(part1.conv_array->len, ==, whole.conv_array->len);
+    for (i = 0; i < whole.conv_array->len; i++) {
+        const hostlist_talker_t *merged = &g_array_index(part1.conv_array, hostlist_talker_t, i);
+        const hostlist_talker_t *host = &g_array_index(whole.conv_array, hostlist_talker_t, i);
+
+        g_assert(addresses_equal(&merged->myaddress, &host->myaddress));
+        g_assert_cmpuint(merged->port, ==, host->port);
+        g_assert_cmpuint(merged->tx_frames, ==, host->tx_frames);
+        g_assert_cmpuint(merged->rx_frames, ==, host->rx_frames);
+        g_assert_cmpuint(merged->tx_bytes, ==, host->tx_bytes);
+        g_assert_cmpuint(merged->rx_bytes, ==, host->rx_bytes);
+    }
+
+    reset_hostlist_table_data(&whole);
+    reset_hostlist_table_data(&part1);
+    reset_hostlist_table_data(&part2);
+}
+
+/* Count a sample in an IO graph item, as update_io_graph_item() does for
+   frames with an integer and a relative time field */
+static void
+update_io_graph_item_sample(io_graph_item_t *item, int i)
+{
+    gint64 new_int = samples[i].indx - NUM_PROCS / 2;
+
+    if (item->first_frame_in_invl == 0)
+        item->first_frame_in_invl = samples[i].num;
+    item->last_frame_in_invl = samples[i].num;
+    item->frames++;
+    item->bytes += samples[i].delta.nsecs % 1500;
+
+    /* only some frames have the field */
+    if (samples[i].table == 0)
+        return;
+    if (new_int > item->int_max || item->fields == 0)
+        item->int_max = new_int;
+    if (new_int < item->int_min || item->fields == 0)
+        item->int_min = new_int;
+    item->int_tot += new_int;
+    if (nstime_cmp(&samples[i].delta, &item->time_max) > 0 || item->fields == 0)
+        item->time_max = samples[i].delta;
+    if (nstime_cmp(&samples[i].delta, &item->time_min) < 0 || item->fields == 0)
+        item->time_min = samples[i].delta;
+    nstime_add(&item->time_tot, &samples[i].delta);
+    item->fields++;
+}
+
+/* Samples go in NUM_IO_ITEMS intervals, or in IO_COMBINE times fewer */
+static void
+update_io_graph_items(io_graph_item_t *items, int from, int to, int per_item)
+{
+    int i;
+
+    for (i = from; i < to; i++)
+        update_io_graph_item_sample(&items[i / per_item], i);
+}
+
+static void
+check_same_io_graph_items(const io_graph_item_t *merged, const io_graph_item_t *whole, gsize count)
+{
+    gsize i;
+
+    for (i = 0; i < count; i++) {
+        g_assert_cmpuint(merged[i].frames, ==, whole[i].frames);
+        g_assert_cmpuint(merged[i].bytes, ==, whole[i].bytes);
+        g_assert_cmpuint(merged[i].fields, ==, whole[i].fields);
+        g_assert_cmpint(merged[i].int_max, ==, whole[i].int_max);
+        g_assert_cmpint(merged[i].int_min, ==, whole[i].int_min);
+        g_assert_cmpint(merged[i].int_tot, ==, whole[i].int_tot);
+        g_assert_cmpint(nstime_cmp(&merged[i].time_max, &whole[i].time_max), ==, 0);
+        g_assert_cmpint(nstime_cmp(&merged[i].time_min, &whole[i].time_min), ==, 0);
+        g_assert_cmpint(nstime_cmp(&merged[i].time_tot, &whole[i].time_tot), ==, 0);
+        g_assert_cmpuint(merged[i].first_frame_in_invl, ==, whole[i].first_frame_in_invl);
+        g_assert_cmpuint(merged[i].last_frame_in_invl, ==, whole[i].last_frame_in_invl);
+    }
+}
+
+static void
+io_graph_item_test_merge(void)
+{
+    int per_item = (NUM_SAMPLES + NUM_IO_ITEMS - 1) / NUM_IO_ITEMS;
+    io_graph_item_t whole[NUM_IO_ITEMS], part1[NUM_IO_ITEMS], part2[NUM_IO_ITEMS];
+    io_graph_item_t coarse[NUM_IO_ITEMS / IO_COMBINE], combined[NUM_IO_ITEMS / IO_COMBINE];
+
+    reset_io_graph_items(whole, NUM_IO_ITEMS);
+    reset_io_graph_items(part1, NUM_IO_ITEMS);
+    reset_io_graph_items(part2, NUM_IO_ITEMS);
+
+    update_io_graph_items(whole, 0, NUM_SAMPLES, per_item);
+    update_io_graph_items(part1, 0, SPLIT, per_item);
+    update_io_graph_items(part2, SPLIT, NUM_SAMPLES, per_item);
+
+    /* Most intervals are only in one of the parts, so this merges empty
+       items into full ones and full ones into empty ones as well as the
+       interval the split is in, whose first frame comes from the first
+       part and last frame from the second. */
+    g_assert((SPLIT % per_item) != 0);
+    merge_io_graph_items(part1, part2, NUM_IO_ITEMS);
+    check_same_io_graph_items(part1, whole, NUM_IO_ITEMS);
+
+    /* and the other way round */
+    reset_io_graph_items(part1, NUM_IO_ITEMS);
+    update_io_graph_items(part1, 0, SPLIT, per_item);
+    merge_io_graph_items(part2, part1, NUM_IO_ITEMS);
+    check_same_io_graph_items(part2, whole, NUM_IO_ITEMS);
+
+    /* Combining intervals gives what tapping with the longer one gives */
+    reset_io_graph_items(coarse, NUM_IO_ITEMS / IO_COMBINE);
+    update_io_graph_items(coarse, 0, NUM_SAMPLES, per_item * IO_COMBINE);
+    combine_io_graph_items(combined, whole, NUM_IO_ITEMS, IO_COMBINE);
+    check_same_io_graph_items(combined, coarse, NUM_IO_ITEMS / IO_COMBINE);
+}
+
+int
+main(int argc, char **argv)
+{
+    int result;
+
+    g_test_init(&argc, &argv, NULL);
+
+    make_samples();
+
+    g_test_add_func("/timestats/merge", timestats_test_merge);
+    g_test_add_func("/srt_table/merge", srt_table_test_merge);
+    g_test_add_func("/rtd_table/merge", rtd_table_test_merge);
+    g_test_add_func("/conversation_table/merge", conversation_table_test_merge);
+    g_test_add_func("/hostlist_table/merge", hostlist_table_test_merge);
+    g_test_add_func("/io_graph_item/merge", io_graph_item_test_merge);
+
+    result = g_test_run();
+
+    return result;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,466 @@
+/* wmem_allocator_block_pool.c
+ * Wireshark Memory Manager Recycling Block Allocator
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "wmem_core.h"
+#include "wmem_allocator.h"
+#include "wmem_allocator_block_pool.h"
+
+/* This allocator is a variant of the BLOCK_FAST allocator intended for the
+ * packet scope. BLOCK_FAST hands every block but the first one (and every
+ * jumbo allocation) back to the OS in free_all, so a capture full of large
+ * packets pays for a fresh round of g_malloc/g_free on every single packet.
+ *
+ * Here nothing is handed back in free_all. Used blocks are simply moved to a
+ * spare list and reused by the next packet, so the pool settles at the
+ * high-water mark of the busiest packet seen so far. Jumbo allocations are
+ * rounded up to a power of two and cached in per-size-class free lists for the
+ * same reason. Memory only goes back to the OS in gc, which the scope
+ * management code calls when it knows we are idle (e.g. on closing a file).
+ *
+ * Requests are also rounded up to a small set of size classes, which lets
+ * explicit frees push chunks on a per-class free list where the next
+ * allocation of that class can pick them up, instead of being no-ops as they
+ * are in BLOCK_FAST.
+ */
+
+/* See the comment in wmem_allocator_block_fast.c */
+#define WMEM_ALIGN_AMOUNT (2 * sizeof (gsize))
+#define WMEM_ALIGN_SIZE(SIZE) ((~(WMEM_ALIGN_AMOUNT-1)) & \
+        ((SIZE) + (WMEM_ALIGN_AMOUNT-1)))
+
+#define WMEM_CHUNK_TO_DATA(CHUNK) ((void*)((guint8*)(CHUNK) + WMEM_CHUNK_HEADER_SIZE))
+#define WMEM_DATA_TO_CHUNK(DATA) ((wmem_block_pool_chunk_t*)((guint8*)(DATA) - WMEM_CHUNK_HEADER_SIZE))
+
+#define WMEM_JUMBO_TO_CHUNK(JUMBO) ((wmem_block_pool_chunk_t*)((guint8*)(JUMBO) + WMEM_JUMBO_HEADER_SIZE))
+#define WMEM_CHUNK_TO_JUMBO(CHUNK) ((wmem_block_pool_jumbo_t*)((guint8*)(CHUNK) - WMEM_JUMBO_HEADER_SIZE))
+
+/* Same block size as BLOCK_FAST, for the same reasons. */
+#define WMEM_BLOCK_SIZE (2 * 1024 * 1024)
+
+/* Small size classes: 16-byte steps up to 512 bytes (which covers the vast
+ * majority of allocations made while dissecting: tree items, field_info,
+ * short strings), then powers of two up to 64kB. Anything bigger is a jumbo
+ * allocation. */
+#define WMEM_CLASS_STEP        16
+#define WMEM_CLASS_LINEAR_MAX  512
+#define WMEM_CLASS_LINEAR_NUM  (WMEM_CLASS_LINEAR_MAX / WMEM_CLASS_STEP)
+#define WMEM_CLASS_POW2_MIN    10  /* 1kB */
+#define WMEM_CLASS_POW2_MAX    16  /* 64kB */
+#define WMEM_CLASS_NUM         (WMEM_CLASS_LINEAR_NUM + \
+        WMEM_CLASS_POW2_MAX - WMEM_CLASS_POW2_MIN + 1)
+#define WMEM_CLASS_MAX_SIZE    (1 << WMEM_CLASS_POW2_MAX)
+
+/* Jumbo size classes are simply powers of two, indexed by bit width. */
+#define WMEM_JUMBO_CLASS_NUM   (sizeof(gsize) * 8)
+
+/* Don't hang on to more than this many bytes of freed jumbo allocations
+ * between garbage collections. A single pathological packet (a huge
+ * reassembly, say) shouldn't pin its memory for the rest of the session. */
+#define WMEM_JUMBO_CACHE_MAX   (64 * 1024 * 1024)
+
+#define WMEM_JUMBO_MAGIC 0xFFFFFFFF
+
+/* The header for an entire OS-level 'block' of memory */
+typedef struct _wmem_block_pool_hdr {
+    struct _wmem_block_pool_hdr *next;
+
+    gint32 pos;
+} wmem_block_pool_hdr_t;
+#define WMEM_BLOCK_HEADER_SIZE WMEM_ALIGN_SIZE(sizeof(wmem_block_pool_hdr_t))
+
+typedef struct {
+    guint32 len;
+    guint32 cls;
+} wmem_block_pool_chunk_t;
+#define WMEM_CHUNK_HEADER_SIZE WMEM_ALIGN_SIZE(sizeof(wmem_block_pool_chunk_t))
+
+typedef struct _wmem_block_pool_jumbo {
+    struct _wmem_block_pool_jumbo *prev, *next;
+
+    gsize cls;
+} wmem_block_pool_jumbo_t;
+#define WMEM_JUMBO_HEADER_SIZE WMEM_ALIGN_SIZE(sizeof(wmem_block_pool_jumbo_t))
+
+/* Freed small chunks are chained through their (now unused) data area. */
+typedef struct _wmem_block_pool_free {
+    struct _wmem_block_pool_free *next;
+} wmem_block_pool_free_t;
+
+typedef struct {
+    /* blocks currently being allocated from; the head is the active one */
+    wmem_block_pool_hdr_t   *block_list;
+    /* blocks retained from earlier rounds, ready for reuse */
+    wmem_block_pool_hdr_t   *spare_list;
+
+    wmem_block_pool_free_t  *free_lists[WMEM_CLASS_NUM];
+
+    /* live jumbo allocations, and cached ones indexed by size class */
+    wmem_block_pool_jumbo_t *jumbo_list;
+    wmem_block_pool_jumbo_t *jumbo_cache[WMEM_JUMBO_CLASS_NUM];
+    gsize                    jumbo_cached;
+} wmem_block_pool_allocator_t;
+
+static inline guint32
+wmem_block_pool_class(const size_t size)
+{
+    if (size <= WMEM_CLASS_LINEAR_MAX) {
+        return (guint32) ((size + WMEM_CLASS_STEP - 1) / WMEM_CLASS_STEP) - 1;
+    }
+
+    return WMEM_CLASS_LINEAR_NUM +
+        (g_bit_storage((gulong) (size - 1)) - WMEM_CLASS_POW2_MIN);
+}
+
+static inline gsize
+wmem_block_pool_class_size(const guint32 cls)
+{
+    if (cls < WMEM_CLASS_LINEAR_NUM) {
+        return (gsize) (cls + 1) * WMEM_CLASS_STEP;
+    }
+
+    return (gsize) 1 << (cls - WMEM_CLASS_LINEAR_NUM + WMEM_CLASS_POW2_MIN);
+}
+
+/* Makes a fresh block the active one, reusing a spare block if possible. */
+static inline void
+wmem_block_pool_new_block(wmem_block_pool_allocator_t *allocator)
+{
+    wmem_block_pool_hdr_t *block;
+
+    if (allocator->spare_list) {
+        block = allocator->spare_list;
+        allocator->spare_list = block->next;
+    }
+    else {
+        block = (wmem_block_pool_hdr_t *)wmem_alloc(NULL, WMEM_BLOCK_SIZE);
+    }
+
+    block->pos  = WMEM_BLOCK_HEADER_SIZE;
+    block->next = allocator->block_list;
+
+    allocator->block_list = block;
+}
+
+static void *
+wmem_block_pool_alloc_jumbo(wmem_block_pool_allocator_t *allocator,
+        const size_t size)
+{
+    wmem_block_pool_jumbo_t *block;
+    wmem_block_pool_chunk_t *chunk;
+    gsize                    cls;
+
+    cls = g_bit_storage((gulong) (size - 1));
+
+    if (allocator->jumbo_cache[cls]) {
+        block = allocator->jumbo_cache[cls];
+        allocator->jumbo_cache[cls] = block->next;
+        allocator->jumbo_cached -= (gsize) 1 << cls;
+    }
+    else {
+        block = (wmem_block_pool_jumbo_t *)wmem_alloc(NULL,
+                ((gsize) 1 << cls) + WMEM_JUMBO_HEADER_SIZE + WMEM_CHUNK_HEADER_SIZE);
+        block->cls = cls;
+    }
+
+    block->prev = NULL;
+    block->next = allocator->jumbo_list;
+    if (block->next) {
+        block->next->prev = block;
+    }
+    allocator->jumbo_list = block;
+
+    chunk = WMEM_JUMBO_TO_CHUNK(block);
+    chunk->len = WMEM_JUMBO_MAGIC;
+    chunk->cls = WMEM_JUMBO_MAGIC;
+
+    return WMEM_CHUNK_TO_DATA(chunk);
+}
+
+/* Puts a jumbo block (already unlinked from the live list) in the cache, or
+ * gives it back to the OS if the cache is full. */
+static void
+wmem_block_pool_release_jumbo(wmem_block_pool_allocator_t *allocator,
+        wmem_block_pool_jumbo_t *block)
+{
+    gsize cap = (gsize) 1 << block->cls;
+
+    if (allocator->jumbo_cached + cap > WMEM_JUMBO_CACHE_MAX) {
+        wmem_free(NULL, block);
+        return;
+    }
+
+    block->prev = NULL;
+    block->next = allocator->jumbo_cache[block->cls];
+    allocator->jumbo_cache[block->cls] = block;
+    allocator->jumbo_cached += cap;
+}
+
+static void
+wmem_block_pool_unlink_jumbo(wmem_block_pool_allocator_t *allocator,
+        wmem_block_pool_jumbo_t *block)
+{
+    if (block->prev) {
+        block->prev->next = block->next;
+    }
+    else {
+        allocator->jumbo_list = block->next;
+    }
+    if (block->next) {
+        block->next->prev = block->prev;
+    }
+}
+
+/* API */
+
+static void *
+wmem_block_pool_alloc(void *private_data, const size_t size)
+{
+    wmem_block_pool_allocator_t *allocator = (wmem_block_pool_allocator_t*) private_data;
+    wmem_block_pool_chunk_t     *chunk;
+    wmem_block_pool_free_t      *free_chunk;
+    guint32                      cls;
+    gint32                       real_size;
+
+    if (size > WMEM_CLASS_MAX_SIZE) {
+        return wmem_block_pool_alloc_jumbo(allocator, size);
+    }
+
+    cls = wmem_block_pool_class(size);
+
+    /* Reuse a previously freed chunk of the same class if there is one. */
+    free_chunk = allocator->free_lists[cls];
+    if (free_chunk) {
+        allocator->free_lists[cls] = free_chunk->next;
+        chunk = WMEM_DATA_TO_CHUNK(free_chunk);
+        chunk->len = (guint32) size;
+        return free_chunk;
+    }
+
+    real_size = (gint32)(wmem_block_pool_class_size(cls) + WMEM_CHUNK_HEADER_SIZE);
+
+    /* Move on to a new block if necessary. */
+    if (!allocator->block_list ||
+            (WMEM_BLOCK_SIZE - allocator->block_list->pos) < real_size) {
+        wmem_block_pool_new_block(allocator);
+    }
+
+    chunk = (wmem_block_pool_chunk_t *) ((guint8 *) allocator->block_list + allocator->block_list->pos);
+    /* safe to cast, size no larger than WMEM_CLASS_MAX_SIZE */
+    chunk->len = (guint32) size;
+    chunk->cls = cls;
+
+    allocator->block_list->pos += real_size;
+
+    /* and return the user's pointer */
+    return WMEM_CHUNK_TO_DATA(chunk);
+}
+
+static void
+wmem_block_pool_free(void *private_data, void *ptr)
+{
+    wmem_block_pool_allocator_t *allocator = (wmem_block_pool_allocator_t*) private_data;
+    wmem_block_pool_chunk_t     *chunk;
+    wmem_block_pool_free_t      *free_chunk;
+
+    chunk = WMEM_DATA_TO_CHUNK(ptr);
+
+    if (chunk->cls == WMEM_JUMBO_MAGIC) {
+        wmem_block_pool_jumbo_t *block = WMEM_CHUNK_TO_JUMBO(chunk);
+
+        wmem_block_pool_unlink_jumbo(allocator, block);
+        wmem_block_pool_release_jumbo(allocator, block);
+        return;
+    }
+
+    free_chunk = (wmem_block_pool_free_t *) ptr;
+    free_chunk->next = allocator->free_lists[chunk->cls];
+    allocator->free_lists[chunk->cls] = free_chunk;
+}
+
+static void *
+wmem_block_pool_realloc(void *private_data, void *ptr, const size_t size)
+{
+    wmem_block_pool_allocator_t *allocator = (wmem_block_pool_allocator_t*) private_data;
+    wmem_block_pool_chunk_t     *chunk;
+    void                        *newptr;
+
+    chunk = WMEM_DATA_TO_CHUNK(ptr);
+
+    if (chunk->cls == WMEM_JUMBO_MAGIC) {
+        wmem_block_pool_jumbo_t *block = WMEM_CHUNK_TO_JUMBO(chunk);
+        gsize                    cls;
+
+        /* Jumbo allocations never shrink into the small classes; the memory
+         * is going to be recycled anyway. */
+        if (size <= ((gsize) 1 << block->cls)) {
+            return ptr;
+        }
+
+        cls   = g_bit_storage((gulong) (size - 1));
+        block = (wmem_block_pool_jumbo_t*)wmem_realloc(NULL, block,
+                ((gsize) 1 << cls) + WMEM_JUMBO_HEADER_SIZE + WMEM_CHUNK_HEADER_SIZE);
+        block->cls = cls;
+
+        if (block->prev) {
+            block->prev->next = block;
+        }
+        else {
+            allocator->jumbo_list = block;
+        }
+        if (block->next) {
+            block->next->prev = block;
+        }
+        return WMEM_CHUNK_TO_DATA(WMEM_JUMBO_TO_CHUNK(block));
+    }
+
+    if (size <= wmem_block_pool_class_size(chunk->cls)) {
+        /* still fits in the space we rounded up to */
+        chunk->len = (guint32) size;
+        return ptr;
+    }
+
+    /* grow */
+    newptr = wmem_block_pool_alloc(private_data, size);
+    memcpy(newptr, ptr, chunk->len);
+    wmem_block_pool_free(private_data, ptr);
+
+    return newptr;
+}
+
+static void
+wmem_block_pool_free_all(void *private_data)
+{
+    wmem_block_pool_allocator_t *allocator = (wmem_block_pool_allocator_t*) private_data;
+    wmem_block_pool_hdr_t       *cur, *nxt;
+    wmem_block_pool_jumbo_t     *cur_jum, *nxt_jum;
+
+    /* keep the active block, reinitializing it, and move all the others to the
+     * spare list so the next round can reuse them */
+    cur = allocator->block_list;
+
+    if (cur) {
+        cur->pos = WMEM_BLOCK_HEADER_SIZE;
+        nxt = cur->next;
+        cur->next = NULL;
+        cur = nxt;
+    }
+
+    while (cur) {
+        nxt = cur->next;
+        cur->next = allocator->spare_list;
+        allocator->spare_list = cur;
+        cur = nxt;
+    }
+
+    /* every chunk on the free lists lived in one of those blocks */
+    memset(allocator->free_lists, 0, sizeof(allocator->free_lists));
+
+    /* now do the jumbo blocks, caching as many as we are allowed to */
+    cur_jum = allocator->jumbo_list;
+    while (cur_jum) {
+        nxt_jum = cur_jum->next;
+        wmem_block_pool_release_jumbo(allocator, cur_jum);
+        cur_jum = nxt_jum;
+    }
+    allocator->jumbo_list = NULL;
+}
+
+static void
+wmem_block_pool_gc(void *private_data)
+{
+    wmem_block_pool_allocator_t *allocator = (wmem_block_pool_allocator_t*) private_data;
+    wmem_block_pool_hdr_t       *cur, *nxt;
+    wmem_block_pool_jumbo_t     *cur_jum, *nxt_jum;
+    gsize                        i;
+
+    /* give back everything that isn't currently in use */
+    cur = allocator->spare_list;
+    while (cur) {
+        nxt = cur->next;
+        wmem_free(NULL, cur);
+        cur = nxt;
+    }
+    allocator->spare_list = NULL;
+
+    for (i = 0; i < WMEM_JUMBO_CLASS_NUM; i++) {
+        cur_jum = allocator->jumbo_cache[i];
+        while (cur_jum) {
+            nxt_jum = cur_jum->next;
+            wmem_free(NULL, cur_jum);
+            cur_jum = nxt_jum;
+        }
+        allocator->jumbo_cache[i] = NULL;
+    }
+    allocator->jumbo_cached = 0;
+}
+
+static void
+wmem_block_pool_allocator_cleanup(void *private_data)
+{
+    wmem_block_pool_allocator_t *allocator = (wmem_block_pool_allocator_t*) private_data;
+
+    /* wmem guarantees that free_all() is called directly before this, so
+     * everything but the first block is either spare or cached */
+    wmem_block_pool_gc(private_data);
+    wmem_free(NULL, allocator->block_list);
+
+    /* then just free the allocator structs */
+    wmem_free(NULL, private_data);
+}
+
+void
+wmem_block_pool_allocator_init(wmem_allocator_t *allocator)
+{
+    wmem_block_pool_allocator_t *block_allocator;
+
+    block_allocator = wmem_new0(NULL, wmem_block_pool_allocator_t);
+
+    allocator->walloc   = &wmem_block_pool_alloc;
+    allocator->wrealloc = &wmem_block_pool_realloc;
+    allocator->wfree    = &wmem_block_pool_free;
+
+    allocator->free_all = &wmem_block_pool_free_all;
+    allocator->gc       = &wmem_block_pool_gc;
+    allocator->cleanup  = &wmem_block_pool_allocator_cleanup;
+
+    allocator->private_data = (void*) block_allocator;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -33,6 +33,7 @@
 #include "wmem_allocator_simple.h"
 #include "wmem_allocator_block.h"
 #include "wmem_allocator_block_fast.h"
+#include "wmem_allocator_block_pool.h"
 #include "wmem_allocator_strict.h"
 
 /* Set according to the WIRESHARK_DEBUG_WMEM_OVERRIDE environment variable in
@@ -168,6 +169,9 @@ wmem_allocator_new(const wmem_allocator_type_t type)
         case WMEM_ALLOCATOR_STRICT:
             wmem_strict_allocator_init(allocator);
             break;
+        case WMEM_ALLOCATOR_BLOCK_POOL:
+            wmem_block_pool_allocator_init(allocator);
+            break;
         default:
             g_assert_not_reached();
             /* This is necessary to squelch MSVC errors; is there
@@ -198,6 +202,9 @@ wmem_init(void)
         if (strncmp(override_env, "simple", strlen("simple")) == 0) {
             override_type = WMEM_ALLOCATOR_SIMPLE;
         }
+        else if (strncmp(override_env, "block_pool", strlen("block_pool")) == 0) {
+            override_type = WMEM_ALLOCATOR_BLOCK_POOL;
+        }
         else if (strncmp(override_env, "block", strlen("block")) == 0) {
             override_type = WMEM_ALLOCATOR_BLOCK;
         }
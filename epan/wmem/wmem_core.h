@@ -65,11 +65,17 @@ typedef enum _wmem_allocator_type_t {
                 memory usage via things like canaries and scrubbing freed
                 memory. Valgrind is the better choice on platforms that support
                 it. */
-    WMEM_ALLOCATOR_BLOCK_FAST /**< A block allocator like WMEM_ALLOCATOR_BLOCK
+    WMEM_ALLOCATOR_BLOCK_FAST, /**< A block allocator like WMEM_ALLOCATOR_BLOCK
                 but even faster by tracking absolutely minimal metadata and
                 making 'free' a no-op. Useful only for very short-lived scopes
                 where there's no reason to free individual allocations because
                 the next free_all is always just around the corner. */
+    WMEM_ALLOCATOR_BLOCK_POOL /**< A block allocator like WMEM_ALLOCATOR_BLOCK_FAST
+                that serves requests from size classes and recycles its blocks
+                and jumbo allocations across calls to free_all instead of
+                returning them to the OS. Memory is only released by
+                wmem_gc(). Intended for the packet scope, where the same
+                pattern of allocations repeats for every packet. */
 } wmem_allocator_type_t;
 
 /** Allocate the requested amount of memory in the given pool.
@@ -135,7 +135,7 @@ wmem_init_scopes(void)
     g_assert(file_scope   == NULL);
     g_assert(epan_scope   == NULL);
 
-    packet_scope = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK_FAST);
+    packet_scope = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK_POOL);
     file_scope   = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK);
     epan_scope   = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK);
 
@@ -31,6 +31,7 @@
 #include "wmem_allocator.h"
 #include "wmem_allocator_block.h"
 #include "wmem_allocator_block_fast.h"
+#include "wmem_allocator_block_pool.h"
 #include "wmem_allocator_simple.h"
 #include "wmem_allocator_strict.h"
 
@@ -38,6 +39,8 @@
 #define MAX_ALLOC_SIZE          (1024*64)
 #define MAX_SIMULTANEOUS_ALLOCS  1024
 #define CONTAINER_ITERS          10000
+#define TRACE_SLOTS              4096
+#define TRACE_PACKETS            5000
 
 typedef void (*wmem_verify_func)(wmem_allocator_t *allocator);
 
@@ -67,6 +70,9 @@ wmem_allocator_force_new(const wmem_allocator_type_t type)
         case WMEM_ALLOCATOR_STRICT:
             wmem_strict_allocator_init(allocator);
             break;
+        case WMEM_ALLOCATOR_BLOCK_POOL:
+            wmem_block_pool_allocator_init(allocator);
+            break;
         default:
             g_assert_not_reached();
             /* This is necessary to squelch MSVC errors; is there
@@ -362,6 +368,38 @@ wmem_test_allocator_block_fast(void)
     wmem_test_allocator_jumbo(WMEM_ALLOCATOR_BLOCK, NULL);
 }
 
+static void
+wmem_test_allocator_block_pool(void)
+{
+    wmem_allocator_t *allocator;
+    char *ptr, *ptr1;
+
+    wmem_test_allocator(WMEM_ALLOCATOR_BLOCK_POOL, NULL,
+            MAX_SIMULTANEOUS_ALLOCS*64);
+    wmem_test_allocator_jumbo(WMEM_ALLOCATOR_BLOCK_POOL, NULL);
+
+    allocator = wmem_allocator_force_new(WMEM_ALLOCATOR_BLOCK_POOL);
+
+    /* freed chunks are handed out again to requests of the same class */
+    ptr = (char *)wmem_alloc0(allocator, 40);
+    wmem_free(allocator, ptr);
+    ptr1 = (char *)wmem_alloc0(allocator, 48);
+    g_assert(ptr == ptr1);
+
+    /* as are jumbo allocations, even across free_all, until we gc */
+    ptr = (char *)wmem_alloc0(allocator, 3*1024*1024);
+    wmem_free_all(allocator);
+    ptr1 = (char *)wmem_alloc0(allocator, 3*1024*1024 + 1);
+    g_assert(ptr == ptr1);
+    ptr1 = (char *)wmem_realloc(allocator, ptr1, 4*1024*1024);
+    g_assert(ptr == ptr1);
+    memset(ptr1, 0, 4*1024*1024);
+    wmem_free_all(allocator);
+    wmem_gc(allocator);
+
+    wmem_destroy_allocator(allocator);
+}
+
 static void
 wmem_test_allocator_simple(void)
 {
@@ -378,6 +416,195 @@ wmem_test_allocator_strict(void)
     wmem_test_allocator_jumbo(WMEM_ALLOCATOR_STRICT, &wmem_strict_check_canaries);
 }
 
+/* ALLOCATOR BENCHMARKS (/wmem/allocator/trace, only with -m perf) */
+
+/* An allocation trace is a sequence of operations on numbered slots, with a
+ * marker at the end of every packet where the pool gets freed, e.g.:
+ *
+ *   a 12 64      allocate 64 bytes into slot 12
+ *   r 12 128     reallocate slot 12 to 128 bytes
+ *   f 12         free slot 12
+ *   p            end of packet, wmem_free_all()
+ *
+ * Lines starting with '#' are ignored. A trace recorded from real dissection
+ * can be replayed by pointing the WMEM_TEST_TRACE environment variable at it;
+ * otherwise a synthetic trace with the same general shape (lots of small tree
+ * and string allocations plus the occasional large reassembly buffer) is
+ * generated. */
+typedef struct {
+    gchar   op;
+    guint32 slot;
+    guint32 size;
+} wmem_trace_op_t;
+
+static GArray *
+wmem_test_trace_load(const char *path)
+{
+    GArray          *trace;
+    FILE            *fp;
+    char             line[128];
+    wmem_trace_op_t  op;
+
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    trace = g_array_new(FALSE, FALSE, sizeof(wmem_trace_op_t));
+    while (fgets(line, sizeof line, fp) != NULL) {
+        op.slot = 0;
+        op.size = 0;
+        switch (line[0]) {
+            case 'a':
+            case 'r':
+                if (sscanf(line + 1, "%u %u", &op.slot, &op.size) != 2) {
+                    continue;
+                }
+                break;
+            case 'f':
+                if (sscanf(line + 1, "%u", &op.slot) != 1) {
+                    continue;
+                }
+                break;
+            case 'p':
+                break;
+            default:
+                continue;
+        }
+        op.op    = line[0];
+        op.slot %= TRACE_SLOTS;
+        g_array_append_val(trace, op);
+    }
+    fclose(fp);
+
+    return trace;
+}
+
+static GArray *
+wmem_test_trace_generate(void)
+{
+    GArray          *trace;
+    wmem_trace_op_t  op;
+    int              i, j, n;
+
+    trace = g_array_new(FALSE, FALSE, sizeof(wmem_trace_op_t));
+    for (i=0; i<TRACE_PACKETS; i++) {
+        n = g_test_rand_int_range(100, 600);
+        for (j=0; j<n && j<TRACE_SLOTS; j++) {
+            op.op   = 'a';
+            op.slot = j;
+            /* mostly tree items and short strings */
+            op.size = g_test_rand_int_range(0, 16) ?
+                g_test_rand_int_range(8, 160) : g_test_rand_int_range(160, 4096);
+            g_array_append_val(trace, op);
+
+            if (g_test_rand_int_range(0, 32) == 0) {
+                /* string buffers growing */
+                op.op   = 'r';
+                op.size = op.size * 2;
+                g_array_append_val(trace, op);
+            }
+            else if (g_test_rand_int_range(0, 32) == 0) {
+                op.op = 'f';
+                g_array_append_val(trace, op);
+            }
+        }
+        if (g_test_rand_int_range(0, 8) == 0) {
+            /* large payload being reassembled */
+            op.op   = 'a';
+            op.slot = TRACE_SLOTS - 1;
+            op.size = g_test_rand_int_range(64*1024, 1024*1024);
+            g_array_append_val(trace, op);
+            op.op   = 'r';
+            op.size = op.size + g_test_rand_int_range(64*1024, 4*1024*1024);
+            g_array_append_val(trace, op);
+        }
+        op.op   = 'p';
+        op.slot = 0;
+        op.size = 0;
+        g_array_append_val(trace, op);
+    }
+
+    return trace;
+}
+
+static double
+wmem_test_trace_replay(wmem_allocator_type_t type, const GArray *trace)
+{
+    wmem_allocator_t *allocator;
+    void            **slots;
+    guint             i;
+    double            elapsed;
+
+    allocator = wmem_allocator_force_new(type);
+    slots     = g_new0(void *, TRACE_SLOTS);
+
+    g_test_timer_start();
+    for (i=0; i<trace->len; i++) {
+        const wmem_trace_op_t *op = &g_array_index(trace, wmem_trace_op_t, i);
+
+        switch (op->op) {
+            case 'a':
+                slots[op->slot] = wmem_alloc(allocator, op->size);
+                break;
+            case 'r':
+                slots[op->slot] = wmem_realloc(allocator, slots[op->slot], op->size);
+                break;
+            case 'f':
+                wmem_free(allocator, slots[op->slot]);
+                slots[op->slot] = NULL;
+                break;
+            case 'p':
+                wmem_free_all(allocator);
+                memset(slots, 0, TRACE_SLOTS * sizeof(void *));
+                break;
+        }
+    }
+    elapsed = g_test_timer_elapsed();
+
+    g_free(slots);
+    wmem_destroy_allocator(allocator);
+
+    return elapsed;
+}
+
+static void
+wmem_test_allocator_trace(void)
+{
+    GArray     *trace = NULL;
+    const char *path;
+    double      elapsed;
+    guint       i;
+    static const struct {
+        wmem_allocator_type_t  type;
+        const char            *name;
+    } types[] = {
+        { WMEM_ALLOCATOR_SIMPLE,     "simple"     },
+        { WMEM_ALLOCATOR_BLOCK,      "block"      },
+        { WMEM_ALLOCATOR_BLOCK_FAST, "block_fast" },
+        { WMEM_ALLOCATOR_BLOCK_POOL, "block_pool" },
+    };
+
+    path = g_getenv("WMEM_TEST_TRACE");
+    if (path) {
+        trace = wmem_test_trace_load(path);
+        if (trace == NULL) {
+            g_test_message("Unable to read trace %s", path);
+        }
+    }
+    if (trace == NULL) {
+        trace = wmem_test_trace_generate();
+    }
+
+    g_test_message("Replaying %u operations", trace->len);
+    for (i=0; i<G_N_ELEMENTS(types); i++) {
+        elapsed = wmem_test_trace_replay(types[i].type, trace);
+        g_test_minimized_result(elapsed, "%-10s %.3fs", types[i].name, elapsed);
+    }
+
+    g_array_free(trace, TRUE);
+}
+
 /* UTILITY TESTING FUNCTIONS (/wmem/utils/) */
 
 static void
@@ -1144,9 +1371,13 @@ main(int argc, char **argv)
 
     g_test_add_func("/wmem/allocator/block",     wmem_test_allocator_block);
     g_test_add_func("/wmem/allocator/blk_fast",  wmem_test_allocator_block_fast);
+    g_test_add_func("/wmem/allocator/blk_pool",  wmem_test_allocator_block_pool);
     g_test_add_func("/wmem/allocator/simple",    wmem_test_allocator_simple);
     g_test_add_func("/wmem/allocator/strict",    wmem_test_allocator_strict);
     g_test_add_func("/wmem/allocator/callbacks", wmem_test_allocator_callbacks);
+    if (g_test_perf()) {
+        g_test_add_func("/wmem/allocator/trace", wmem_test_allocator_trace);
+    }
 
     g_test_add_func("/wmem/utils/misc",    wmem_test_miscutls);
     g_test_add_func("/wmem/utils/strings", wmem_test_strutls);
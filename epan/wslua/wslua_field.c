@@ -77,91 +77,128 @@ WSLUA_METAMETHOD FieldInfo__unm(lua_State* L) {
     return 1;
 }
 
-/* WSLUA_ATTRIBUTE FieldInfo_value RO The value of this field. */
-WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
-    /*
-       Obtain the Value of the field.
+/*
+ * The userdata types a field value can be pushed as.  Each of these pushes
+ * the value at stack index reuse, and returns its contents to be
+ * overwritten, if reuse is non-zero and holds an object of that class;
+ * otherwise it pushes a new, empty one.
+ */
+static Address reuse_Address(lua_State* L, int reuse) {
+    Address addr;
+
+    if (reuse && isAddress(L,reuse)) {
+        addr = toAddress(L,reuse);
+        free_address(addr);
+        lua_pushvalue(L,reuse);
+        return addr;
+    }
 
-       Previous to 1.11.4, this function retrieved the value for most field types,
-       but for `ftypes.UINT_BYTES` it retrieved the `ByteArray` of the field's entire `TvbRange`.
-       In other words, it returned a `ByteArray` that included the leading length byte(s),
-       instead of just the *value* bytes. That was a bug, and has been changed in 1.11.4.
-       Furthermore, it retrieved an `ftypes.GUID` as a `ByteArray`, which is also incorrect.
+    addr = (Address)g_malloc(sizeof(address));
+    clear_address(addr);
+    pushAddress(L,addr);
+    return addr;
+}
 
-       If you wish to still get a `ByteArray` of the `TvbRange`, use `FieldInfo:get_range()`
-       to get the `TvbRange`, and then use `Tvb:bytes()` to convert it to a `ByteArray`.
-       */
-    FieldInfo fi = checkFieldInfo(L,1);
+static NSTime reuse_NSTime(lua_State* L, int reuse) {
+    NSTime nstime;
+
+    if (reuse && isNSTime(L,reuse)) {
+        lua_pushvalue(L,reuse);
+        return toNSTime(L,reuse);
+    }
+
+    nstime = (NSTime)g_malloc0(sizeof(nstime_t));
+    pushNSTime(L,nstime);
+    return nstime;
+}
+
+static Int64* reuse_Int64(lua_State* L, int reuse) {
+    if (reuse && isInt64(L,reuse)) {
+        lua_pushvalue(L,reuse);
+        return (Int64*)lua_touserdata(L,reuse);
+    }
 
-    switch(fi->ws_fi->hfinfo->type) {
+    return pushInt64(L,0);
+}
+
+static UInt64* reuse_UInt64(lua_State* L, int reuse) {
+    if (reuse && isUInt64(L,reuse)) {
+        lua_pushvalue(L,reuse);
+        return (UInt64*)lua_touserdata(L,reuse);
+    }
+
+    return pushUInt64(L,0);
+}
+
+static ByteArray reuse_ByteArray(lua_State* L, int reuse) {
+    ByteArray ba;
+
+    if (reuse && isByteArray(L,reuse)) {
+        ba = toByteArray(L,reuse);
+        g_byte_array_set_size(ba,0);
+        lua_pushvalue(L,reuse);
+        return ba;
+    }
+
+    ba = g_byte_array_new();
+    pushByteArray(L,ba);
+    return ba;
+}
+
+/* Pushes the value of a field, as FieldInfo.value and Field.values() return it. */
+static int push_field_value(lua_State* L, field_info* fi, int reuse) {
+    switch(fi->hfinfo->type) {
         case FT_BOOLEAN:
-                lua_pushboolean(L,(int)fvalue_get_uinteger64(&(fi->ws_fi->value)));
+                lua_pushboolean(L,(int)fvalue_get_uinteger64(&(fi->value)));
                 return 1;
         case FT_UINT8:
         case FT_UINT16:
         case FT_UINT24:
         case FT_UINT32:
         case FT_FRAMENUM:
-                lua_pushnumber(L,(lua_Number)(fvalue_get_uinteger(&(fi->ws_fi->value))));
+                lua_pushnumber(L,(lua_Number)(fvalue_get_uinteger(&(fi->value))));
                 return 1;
         case FT_INT8:
         case FT_INT16:
         case FT_INT24:
         case FT_INT32:
-                lua_pushnumber(L,(lua_Number)(fvalue_get_sinteger(&(fi->ws_fi->value))));
+                lua_pushnumber(L,(lua_Number)(fvalue_get_sinteger(&(fi->value))));
                 return 1;
         case FT_FLOAT:
         case FT_DOUBLE:
-                lua_pushnumber(L,(lua_Number)(fvalue_get_floating(&(fi->ws_fi->value))));
+                lua_pushnumber(L,(lua_Number)(fvalue_get_floating(&(fi->value))));
                 return 1;
         case FT_INT64: {
-                pushInt64(L,(Int64)(fvalue_get_sinteger64(&(fi->ws_fi->value))));
+                *reuse_Int64(L,reuse) = (Int64)(fvalue_get_sinteger64(&(fi->value)));
                 return 1;
             }
         case FT_UINT64: {
-                pushUInt64(L,fvalue_get_uinteger64(&(fi->ws_fi->value)));
+                *reuse_UInt64(L,reuse) = fvalue_get_uinteger64(&(fi->value));
                 return 1;
             }
-        case FT_ETHER: {
-                Address eth = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,eth,AT_ETHER,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
-                pushAddress(L,eth);
+        case FT_ETHER:
+                alloc_address_tvb(NULL,reuse_Address(L,reuse),AT_ETHER,fi->length,fi->ds_tvb,fi->start);
                 return 1;
-            }
-        case FT_IPv4:{
-                Address ipv4 = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,ipv4,AT_IPv4,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
-                pushAddress(L,ipv4);
+        case FT_IPv4:
+                alloc_address_tvb(NULL,reuse_Address(L,reuse),AT_IPv4,fi->length,fi->ds_tvb,fi->start);
                 return 1;
-            }
-        case FT_IPv6: {
-                Address ipv6 = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,ipv6,AT_IPv6,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
-                pushAddress(L,ipv6);
+        case FT_IPv6:
+                alloc_address_tvb(NULL,reuse_Address(L,reuse),AT_IPv6,fi->length,fi->ds_tvb,fi->start);
                 return 1;
-            }
-        case FT_FCWWN: {
-                Address fcwwn = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,fcwwn,AT_FCWWN,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
-                pushAddress(L,fcwwn);
+        case FT_FCWWN:
+                alloc_address_tvb(NULL,reuse_Address(L,reuse),AT_FCWWN,fi->length,fi->ds_tvb,fi->start);
                 return 1;
-            }
-        case FT_IPXNET:{
-                Address ipx = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,ipx,AT_IPX,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
-                pushAddress(L,ipx);
+        case FT_IPXNET:
+                alloc_address_tvb(NULL,reuse_Address(L,reuse),AT_IPX,fi->length,fi->ds_tvb,fi->start);
                 return 1;
-            }
         case FT_ABSOLUTE_TIME:
         case FT_RELATIVE_TIME: {
-                NSTime nstime = (NSTime)g_malloc(sizeof(nstime_t));
-                *nstime = *(NSTime)fvalue_get(&(fi->ws_fi->value));
-                pushNSTime(L,nstime);
+                *reuse_NSTime(L,reuse) = *(NSTime)fvalue_get(&(fi->value));
                 return 1;
             }
         case FT_STRING:
         case FT_STRINGZ: {
-                gchar* repr = fvalue_to_string_repr(NULL, &fi->ws_fi->value,FTREPR_DISPLAY,BASE_NONE);
+                gchar* repr = fvalue_to_string_repr(NULL, &fi->value,FTREPR_DISPLAY,BASE_NONE);
                 if (repr)
                 {
                     lua_pushstring(L, repr);
@@ -174,10 +211,10 @@ WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
                 return 1;
             }
         case FT_NONE:
-                if (fi->ws_fi->length > 0 && fi->ws_fi->rep) {
+                if (fi->length > 0 && fi->rep) {
                     /* it has a length, but calling fvalue_get() on an FT_NONE asserts,
                        so get the label instead (it's a FT_NONE, so a label is what it basically is) */
-                    lua_pushstring(L, fi->ws_fi->rep->representation);
+                    lua_pushstring(L, fi->rep->representation);
                     return 1;
                 }
                 return 0;
@@ -187,19 +224,15 @@ WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
         case FT_SYSTEM_ID:
         case FT_OID:
             {
-                ByteArray ba = g_byte_array_new();
-                g_byte_array_append(ba, (const guint8 *) fvalue_get(&fi->ws_fi->value),
-                                    fvalue_length(&fi->ws_fi->value));
-                pushByteArray(L,ba);
+                g_byte_array_append(reuse_ByteArray(L,reuse), (const guint8 *) fvalue_get(&fi->value),
+                                    fvalue_length(&fi->value));
                 return 1;
             }
         case FT_PROTOCOL:
             {
-                ByteArray ba = g_byte_array_new();
-                tvbuff_t* tvb = (tvbuff_t *) fvalue_get(&fi->ws_fi->value);
-                g_byte_array_append(ba, (const guint8 *)tvb_memdup(wmem_packet_scope(), tvb, 0,
+                tvbuff_t* tvb = (tvbuff_t *) fvalue_get(&fi->value);
+                g_byte_array_append(reuse_ByteArray(L,reuse), (const guint8 *)tvb_memdup(wmem_packet_scope(), tvb, 0,
                                             tvb_captured_length(tvb)), tvb_captured_length(tvb));
-                pushByteArray(L,ba);
                 return 1;
             }
 
@@ -210,6 +243,25 @@ WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
     }
 }
 
+/* WSLUA_ATTRIBUTE FieldInfo_value RO The value of this field. */
+WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
+    /*
+       Obtain the Value of the field.
+
+       Previous to 1.11.4, this function retrieved the value for most field types,
+       but for `ftypes.UINT_BYTES` it retrieved the `ByteArray` of the field's entire `TvbRange`.
+       In other words, it returned a `ByteArray` that included the leading length byte(s),
+       instead of just the *value* bytes. That was a bug, and has been changed in 1.11.4.
+       Furthermore, it retrieved an `ftypes.GUID` as a `ByteArray`, which is also incorrect.
+
+       If you wish to still get a `ByteArray` of the `TvbRange`, use `FieldInfo:get_range()`
+       to get the `TvbRange`, and then use `Tvb:bytes()` to convert it to a `ByteArray`.
+       */
+    FieldInfo fi = checkFieldInfo(L,1);
+
+    return push_field_value(L,fi->ws_fi,0);
+}
+
 /* WSLUA_ATTRIBUTE FieldInfo_label RO The string representing this field. */
 WSLUA_METAMETHOD FieldInfo__tostring(lua_State* L) {
     /* The string representation of the field. */
@@ -532,6 +584,9 @@ WSLUA_CLASS_DEFINE(Field,FAIL_ON_NULL("Field"),NOP);
 static GPtrArray* wanted_fields = NULL;
 static dfilter_t* wslua_dfilter = NULL;
 
+/* The objects last returned by Field.values(), by Field, to be reused */
+static int field_values_ref = LUA_NOREF;
+
 /* We use a fake dfilter for Lua field extractors, so that
  * epan_dissect_run() will populate the fields.  This won't happen
  * if the passed-in edt->tree is NULL, which it will be if the
@@ -766,6 +821,89 @@ WSLUA_METAMETHOD Field__call (lua_State* L) {
     WSLUA_RETURN(items_found); /* All the values of this field */
 }
 
+WSLUA_CONSTRUCTOR Field_values(lua_State* L) {
+    /* Obtain the values of several fields at once, without creating a
+       `FieldInfo` object for any of them.
+
+       For each `Field` argument, the value of its first occurrence in the
+       packet (as `FieldInfo.value` would give it) is returned, or `nil` if the
+       field is not in the packet. So a tap or dissector can read, e.g.,
+       `local src, dst, len = Field.values(f_ip_src, f_ip_dst, f_ip_len)`.
+
+       Numbers, booleans and strings are returned as Lua values. Values that
+       are objects (`Address`, `NSTime`, `Int64`, `UInt64` and `ByteArray`)
+       are reused: the object returned for a `Field` is updated in place by the
+       next call to `Field.values()` that is given that `Field`, rather than a
+       new object being created for every packet. Copy such a value (e.g.,
+       using `tostring()`) if it is needed after the next call.
+
+       @since 2.1.0
+     */
+#define WSLUA_ARG_Field_values_FIELD 1 /* A `Field`, followed by any number of others. */
+    int nfields = lua_gettop(L);
+    int cache;
+    int i;
+
+    if (! lua_pinfo ) {
+        WSLUA_ERROR(Field_values,"Fields cannot be used outside dissectors or taps");
+        return 0;
+    }
+
+    if (nfields < 1) {
+        WSLUA_ARG_ERROR(Field_values,FIELD,"must be given at least one Field");
+        return 0;
+    }
+
+    luaL_checkstack(L, nfields + 4, "Unable to grow stack\n");
+
+    lua_rawgeti(L, LUA_REGISTRYINDEX, field_values_ref);
+    cache = lua_gettop(L);
+
+    for (i = 1; i <= nfields; i++) {
+        Field f = checkField(L,i);
+        header_field_info* in = *f;
+        field_info* fi = NULL;
+        int reuse;
+
+        if (! in) {
+            luaL_error(L,"invalid field");
+            return 0;
+        }
+
+        while (in && !fi) {
+            GPtrArray* found = proto_get_finfo_ptr_array(lua_tree->tree, in->id);
+            if (found && found->len > 0) {
+                fi = (field_info *) g_ptr_array_index(found,0);
+            }
+            in = (in->same_name_prev_id != -1) ? proto_registrar_get_nth(in->same_name_prev_id) : NULL;
+        }
+
+        if (!fi) {
+            lua_pushnil(L);
+            continue;
+        }
+
+        /* the object returned for this Field last time, if any */
+        lua_pushvalue(L,i);
+        lua_rawget(L,cache);
+        reuse = lua_gettop(L);
+
+        if (push_field_value(L,fi,reuse) == 0) {
+            lua_pushnil(L);
+        } else if (lua_isuserdata(L,-1) && !lua_rawequal(L,-1,reuse)) {
+            lua_pushvalue(L,i);
+            lua_pushvalue(L,-2);
+            lua_rawset(L,cache);
+        }
+
+        lua_remove(L,reuse);
+    }
+
+    lua_remove(L,cache);
+
+    WSLUA_RETURN(nfields); /* The value of each field, or `nil`. */
+}
+
 WSLUA_METAMETHOD Field__tostring(lua_State* L) {
     /* Obtain a string with the field filter name. */
     Field f = checkField(L,1);
@@ -794,6 +932,7 @@ WSLUA_ATTRIBUTES Field_attributes[] = {
 WSLUA_METHODS Field_methods[] = {
     WSLUA_CLASS_FNREG(Field,new),
     WSLUA_CLASS_FNREG(Field,list),
+    WSLUA_CLASS_FNREG(Field,values),
     { NULL, NULL }
 };
 
@@ -811,6 +950,9 @@ int Field_register(lua_State* L) {
     WSLUA_REGISTER_ATTRIBUTES(Field);
     outstanding_FieldInfo = g_ptr_array_new();
 
+    lua_newtable(L);
+    field_values_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
     return 0;
 }
 
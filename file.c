@@ -33,6 +33,7 @@
 #include <wsutil/tempfile.h>
 #include <wsutil/file_util.h>
 #include <wsutil/filesystem.h>
+#include <wsutil/ws_memmem.h>
 #include <ws_version_info.h>
 
 #include <wiretap/merge.h>
@@ -110,15 +111,7 @@ static match_result match_protocol_tree(capture_file *cf, frame_data *fdata,
 static void match_subtree_text(proto_node *node, gpointer data);
 static match_result match_summary_line(capture_file *cf, frame_data *fdata,
     void *criterion);
-static match_result match_narrow_and_wide(capture_file *cf, frame_data *fdata,
-    void *criterion);
-static match_result match_narrow(capture_file *cf, frame_data *fdata,
-    void *criterion);
-static match_result match_wide(capture_file *cf, frame_data *fdata,
-    void *criterion);
-static match_result match_binary(capture_file *cf, frame_data *fdata,
-    void *criterion);
-static match_result match_regex(capture_file *cf, frame_data *fdata,
+static match_result match_packet_data(capture_file *cf, frame_data *fdata,
     void *criterion);
 static match_result match_dfilter(capture_file *cf, frame_data *fdata,
     void *criterion);
@@ -138,6 +131,11 @@ static void cf_open_failure_alert_box(const char *filename, int err,
 static void cf_rename_failure_alert_box(const char *filename, int err);
 static void cf_close_failure_alert_box(const char *filename, int err);
 static void ref_time_packets(capture_file *cf);
+
+typedef struct _cached_dissection cached_dissection_t;
+static cached_dissection_t *dissection_cache_lookup(capture_file *cf, const frame_data *fdata);
+static cached_dissection_t *dissection_cache_add(capture_file *cf, frame_data *fdata);
+static void dissection_cache_release(capture_file *cf, epan_dissect_t *old_edt);
 /* Update the progress bar this many times when reading a file. */
 #define N_PROGBAR_UPDATES   100
 /* We read around 200k/100ms don't update the progress bar more often than that */
@@ -287,18 +285,13 @@ ws_epan_new(capture_file *cf)
   return epan;
 }
 
-cf_status_t
-cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_tempfile, int *err)
+/*
+ * Close whatever capture file we had open, and fill in the information
+ * for the one we just opened as wth.
+ */
+static void
+cf_open_wth(capture_file *cf, wtap *wth, const char *fname, unsigned int type, gboolean is_tempfile)
 {
-  wtap  *wth;
-  gchar *err_info;
-
-  wth = wtap_open_offline(fname, type, err, &err_info, TRUE);
-  if (wth == NULL)
-    goto fail;
-
-  /* The open succeeded.  Close whatever capture file we had open,
-     and fill in the information for this file. */
   cf_close(cf);
 
   /* Initialize the packet header. */
@@ -370,12 +363,50 @@ cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_temp
 
   wtap_set_cb_new_ipv4(cf->wth, add_ipv4_name);
   wtap_set_cb_new_ipv6(cf->wth, (wtap_new_ipv6_callback_t) add_ipv6_name);
+}
+
+cf_status_t
+cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_tempfile, int *err)
+{
+  wtap  *wth;
+  gchar *err_info;
+
+  wth = wtap_open_offline(fname, type, err, &err_info, TRUE);
+  if (wth == NULL) {
+    cf_open_failure_alert_box(fname, *err, err_info, FALSE, 0);
+    return CF_ERROR;
+  }
 
+  /* The open succeeded. */
+  cf_open_wth(cf, wth, fname, type, is_tempfile);
   return CF_OK;
+}
 
-fail:
-  cf_open_failure_alert_box(fname, *err, err_info, FALSE, 0);
-  return CF_ERROR;
+cf_status_t
+cf_open_set(capture_file *cf, const char *const *filenames, guint count, unsigned int type, int *err)
+{
+  wtap  *wth;
+  gchar *err_info;
+  guint  i;
+
+  if (count == 1)
+    return cf_open(cf, filenames[0], type, FALSE, err);
+
+  wth = wtap_open_offline_set(filenames, count, type, err, &err_info, TRUE);
+  if (wth == NULL) {
+    cf_open_failure_alert_box(filenames[0], *err, err_info, FALSE, 0);
+    return CF_ERROR;
+  }
+
+  /* The set goes by the name of its first file; remember the others,
+     so that we can reload the set, and so that we don't save the set
+     by just copying that file. */
+  cf_open_wth(cf, wth, filenames[0], type, FALSE);
+  cf->set_filenames = g_new(gchar *, count + 1);
+  for (i = 0; i < count; i++)
+    cf->set_filenames[i] = g_strdup(filenames[i]);
+  cf->set_filenames[count] = NULL;
+  return CF_OK;
 }
 
 /*
@@ -422,6 +453,8 @@ cf_close(capture_file *cf)
     g_free(cf->filename);
     cf->filename = NULL;
   }
+  g_strfreev(cf->set_filenames);
+  cf->set_filenames = NULL;
   /* ...which means we have no changes to that file to save. */
   cf->unsaved_changes = FALSE;
 
@@ -451,6 +484,11 @@ cf_close(capture_file *cf)
     cf->frames_user_comments = NULL;
   }
   cf_unselect_packet(cf);   /* nothing to select */
+  cf_invalidate_dissection_cache(cf, NULL);
+  if (cf->dissection_cache) {
+    g_queue_free(cf->dissection_cache);
+    cf->dissection_cache = NULL;
+  }
   cf->first_displayed = 0;
   cf->last_displayed = 0;
 
@@ -478,6 +516,7 @@ cf_close(capture_file *cf)
 
   epan_free(cf->epan);
   cf->epan = NULL;
+  cf->dissection_generation++;
 
   /* We have no file open. */
   cf->state = FILE_CLOSED;
@@ -1481,6 +1520,7 @@ void
 cf_reftime_packets(capture_file *cf)
 {
   ref_time_packets(cf);
+  cf_times_changed(cf);
 }
 
 void
@@ -1609,6 +1649,10 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
      screen updates while it happens. */
   packet_list_freeze();
 
+  /* The protocol trees we kept for recently selected packets depend on
+     the preferences and on which frames are displayed. */
+  cf_invalidate_dissection_cache(cf, NULL);
+
   if (redissect) {
     /* We need to re-initialize all the state information that protocols
        keep, because some preference that controls a dissector has changed,
@@ -1621,6 +1665,7 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
 
     /* 'reset' dissection session */
     epan_free(cf->epan);
+    cf->dissection_generation++;
     if (cf->edt && cf->edt->pi.fd) {
       /* All pointers in "per frame proto data" for the currently selected
          packet are allocated in wmem_file_scope() and deallocated in epan_free().
@@ -3008,11 +3053,324 @@ match_summary_line(capture_file *cf, frame_data *fdata, void *criterion)
   return result;
 }
 
+typedef struct _cbs_t cbs_t;
+
+/* Look for the search string in a packet's data; on success, *pos is
+ * the offset of the last byte of the match and *len its length. */
+typedef gboolean (*data_match_func)(const cbs_t *info, const guint8 *pd,
+    guint32 buf_len, guint32 *pos, guint32 *len);
+
+struct _cbs_t {
+    const guint8    *data;
+    size_t           data_len;
+    gboolean         case_type;  /* TRUE if case-insensitive (data is upper case) */
+    GRegex          *regex;
+    data_match_func  match;
+};    /* "Counted byte string", and how to search for it */
+
+static gboolean data_match_narrow_and_wide(const cbs_t *info, const guint8 *pd,
+    guint32 buf_len, guint32 *pos, guint32 *len);
+static gboolean data_match_narrow(const cbs_t *info, const guint8 *pd,
+    guint32 buf_len, guint32 *pos, guint32 *len);
+static gboolean data_match_wide(const cbs_t *info, const guint8 *pd,
+    guint32 buf_len, guint32 *pos, guint32 *len);
+static gboolean data_match_binary(const cbs_t *info, const guint8 *pd,
+    guint32 buf_len, guint32 *pos, guint32 *len);
+static gboolean data_match_regex(const cbs_t *info, const guint8 *pd,
+    guint32 buf_len, guint32 *pos, guint32 *len);
+
+/*
+ * Searching raw packet data (not dissected packets, which can't be done
+ * in parallel) in a large file is split between worker threads, each
+ * with its own wtap handle for the file.  The frames to search, in
+ * search order, are split into chunks that the workers take in order;
+ * the nearest match is the first one in the lowest chunk with a match,
+ * so once a chunk has one, later chunks aren't searched.
+ */
+#if GLIB_CHECK_VERSION(2,36,0)
+#define PARALLEL_SEARCH
+#endif
+
+#ifdef PARALLEL_SEARCH
+#define PARALLEL_SEARCH_MIN_FRAMES   20000
+#define PARALLEL_SEARCH_CHUNK_FRAMES 4096
+#define PARALLEL_SEARCH_MAX_THREADS  8
+
+typedef struct {
+  volatile gint  done;
+  guint32        hit;          /* first matching frame, or 0 */
+  guint32        hit_pos;
+  guint32        hit_len;
+  GArray        *hits;         /* all matching frames, when finding all */
+} search_chunk_t;
+
 typedef struct {
-    const guint8 *data;
-    size_t        data_len;
-} cbs_t;    /* "Counted byte string" */
+  capture_file     *cf;
+  const cbs_t      *info;
+  guint32           start;      /* frame the search starts after */
+  guint32           nframes;    /* number of frames to search */
+  search_direction  dir;
+  gboolean          find_all;
+  search_chunk_t   *chunks;
+  gint              num_chunks;
+  volatile gint     next_chunk;
+  volatile gint     hit_chunk;  /* lowest chunk with a match so far */
+  volatile gint     frames_done;
+  volatile gint     cancel;
+  volatile gint     err;        /* first read error, or 0 */
+} parallel_search_t;
+
+typedef struct {
+  parallel_search_t *ps;
+  wtap              *wth;
+} search_worker_t;
+
+/* The frame number "step" frames after (or before) the start frame */
+static guint32
+search_step_frame(const parallel_search_t *ps, guint32 step)
+{
+  guint32 count = ps->cf->count;
+
+  if (ps->dir == SD_BACKWARD)
+    return (ps->start - 1 + count - step % count) % count + 1;
+  return (ps->start - 1 + step) % count + 1;
+}
+
+static gpointer
+parallel_search_worker(gpointer data)
+{
+  search_worker_t   *worker = (search_worker_t *)data;
+  parallel_search_t *ps = worker->ps;
+  struct wtap_pkthdr phdr;
+  Buffer             buf;
+  const guint8      *pd;
+  frame_data        *fdata;
+  search_chunk_t    *chunk;
+  gint               c;
+  guint32            step, last_step;
+  guint32            pos, len;
+  int                err;
+  gchar             *err_info;
+
+  wtap_phdr_init(&phdr);
+  ws_buffer_init(&buf, 1500);
+
+  while ((c = g_atomic_int_add(&ps->next_chunk, 1)) < ps->num_chunks) {
+    chunk = &ps->chunks[c];
+    step = (guint32)c * PARALLEL_SEARCH_CHUNK_FRAMES + 1;
+    last_step = MIN(step + PARALLEL_SEARCH_CHUNK_FRAMES - 1, ps->nframes);
+    for (; step <= last_step; step++) {
+      if (g_atomic_int_get(&ps->cancel) ||
+          (!ps->find_all && c > g_atomic_int_get(&ps->hit_chunk)))
+        break;
+      fdata = frame_data_sequence_find(ps->cf->frames, search_step_frame(ps, step));
+      g_atomic_int_inc(&ps->frames_done);
+      if (!fdata->flags.passed_dfilter)
+        continue;
+
+      if (!wtap_seek_read_ptr(worker->wth, fdata->file_off, &phdr, &buf,
+                              &pd, &err, &err_info)) {
+        g_free(err_info);
+        g_atomic_int_compare_and_exchange(&ps->err, 0, err);
+        g_atomic_int_set(&ps->cancel, 1);
+        break;
+      }
+      if (pd == NULL)
+        pd = ws_buffer_start_ptr(&buf);
+
+      if ((*ps->info->match)(ps->info, pd, fdata->cap_len, &pos, &len)) {
+        if (ps->find_all) {
+          g_array_append_val(chunk->hits, fdata->num);
+          continue;
+        }
+        chunk->hit = fdata->num;
+        chunk->hit_pos = pos;
+        chunk->hit_len = len;
+        /* Stop everybody searching further away than this */
+        for (;;) {
+          gint hit_chunk = g_atomic_int_get(&ps->hit_chunk);
+          if (hit_chunk <= c ||
+              g_atomic_int_compare_and_exchange(&ps->hit_chunk, hit_chunk, c))
+            break;
+        }
+        break;
+      }
+    }
+    g_atomic_int_set(&chunk->done, 1);
+  }
+
+  ws_buffer_free(&buf);
+  wtap_phdr_cleanup(&phdr);
+  return NULL;
+}
+
+/*
+ * Search nframes frames, starting after frame "start", in direction dir,
+ * in parallel.  When finding all matches, hit_cb is called for each of
+ * them in search order, as the chunks they're in complete, and the
+ * number of them is put in *hits; otherwise the nearest match is put
+ * in *hit_fd, or NULL if there's none.  Returns FALSE, having done
+ * nothing, if this file can't be searched in parallel.
+ */
+static gboolean
+find_packet_parallel(capture_file *cf, const cbs_t *info, guint32 start,
+                     guint32 nframes, search_direction dir,
+                     void (*hit_cb)(capture_file *, frame_data *, void *),
+                     void *user_data, guint32 *hits, frame_data **hit_fd)
+{
+  parallel_search_t  ps;
+  search_worker_t   *workers;
+  GThread          **threads;
+  guint              num_threads, i;
+  gint               c, flushed = 0;
+  gboolean           finished = FALSE;
+  progdlg_t         *progbar = NULL;
+  GTimeVal           start_time;
+  gchar              status_str[100];
+  float              progbar_val = 0.0f;
+  int                err;
+  gchar             *err_info;
+  gchar             *display_basename;
+  guint              j;
+
+  num_threads = MIN(g_get_num_processors(), PARALLEL_SEARCH_MAX_THREADS);
+
+  /* Each worker needs its own handle for the file, and random access to
+     the file; compressed files are slow to seek in without the seek
+     points built up by the sequential read, edited frames aren't
+     in the file, and some formats, such as pcapng with interface
+     description blocks after the first packet, can't read a record
+     with a handle that hasn't read the file up to it. */
+  if (num_threads < 2 || nframes < PARALLEL_SEARCH_MIN_FRAMES ||
+      cf->state != FILE_READ_DONE || cf->filename == NULL ||
+      cf->set_filenames != NULL ||
+      !wtap_seek_read_is_standalone(cf->cd_t) ||
+      cf->wth == NULL || wtap_iscompressed(cf->wth))
+    return FALSE;
+#ifdef WANT_PACKET_EDITOR
+  if (cf->edited_frames != NULL && g_tree_nnodes(cf->edited_frames) != 0)
+    return FALSE;
+#endif
+
+  workers = g_new0(search_worker_t, num_threads);
+  for (i = 0; i < num_threads; i++) {
+    workers[i].ps = &ps;
+    workers[i].wth = wtap_open_offline(cf->filename, WTAP_TYPE_AUTO, &err,
+                                       &err_info, TRUE);
+    if (workers[i].wth == NULL ||
+        wtap_file_type_subtype(workers[i].wth) != cf->cd_t) {
+      /* Search as usual, and let that report any problems with the file */
+      if (workers[i].wth == NULL)
+        g_free(err_info);
+      for (j = 0; j <= i; j++) {
+        if (workers[j].wth != NULL)
+          wtap_close(workers[j].wth);
+      }
+      g_free(workers);
+      return FALSE;
+    }
+  }
+
+  ps.cf = cf;
+  ps.info = info;
+  ps.start = start;
+  ps.nframes = nframes;
+  ps.dir = dir;
+  ps.find_all = (hit_cb != NULL);
+  ps.num_chunks = (nframes + PARALLEL_SEARCH_CHUNK_FRAMES - 1) / PARALLEL_SEARCH_CHUNK_FRAMES;
+  ps.chunks = g_new0(search_chunk_t, ps.num_chunks);
+  if (ps.find_all) {
+    for (c = 0; c < ps.num_chunks; c++)
+      ps.chunks[c].hits = g_array_new(FALSE, FALSE, sizeof(guint32));
+  }
+  ps.next_chunk = 0;
+  ps.hit_chunk = G_MAXINT;
+  ps.frames_done = 0;
+  ps.cancel = 0;
+  ps.err = 0;
+
+  threads = g_new(GThread *, num_threads);
+  for (i = 0; i < num_threads; i++)
+    threads[i] = g_thread_new("Packet search", parallel_search_worker, &workers[i]);
+
+  if (hits != NULL)
+    *hits = 0;
+  cf->stop_flag = FALSE;
+  g_get_current_time(&start_time);
+
+  while (!finished) {
+    g_usleep(G_USEC_PER_SEC / 50);
+
+    if (progbar == NULL)
+      progbar = delayed_create_progress_dlg(cf->window, "Searching",
+        cf->sfilter ? cf->sfilter : "", FALSE, &cf->stop_flag, &start_time,
+        progbar_val);
+    progbar_val = (gfloat) g_atomic_int_get(&ps.frames_done) / nframes;
+    if (progbar != NULL) {
+      g_snprintf(status_str, sizeof(status_str), "%4u of %u packets",
+                 (guint32) g_atomic_int_get(&ps.frames_done), nframes);
+      update_progress_dlg(progbar, progbar_val, status_str);
+    }
+    if (cf->stop_flag)
+      g_atomic_int_set(&ps.cancel, 1);
+
+    /* Hand out the hits of the chunks that are complete, in order */
+    while (flushed < ps.num_chunks && g_atomic_int_get(&ps.chunks[flushed].done)) {
+      if (ps.find_all && !g_atomic_int_get(&ps.cancel)) {
+        GArray *chunk_hits = ps.chunks[flushed].hits;
+        for (j = 0; j < chunk_hits->len; j++) {
+          (*hit_cb)(cf, frame_data_sequence_find(cf->frames,
+                        g_array_index(chunk_hits, guint32, j)), user_data);
+        }
+        *hits += chunk_hits->len;
+      }
+      flushed++;
+    }
+
+    /* Done once everything up to the nearest match has been searched */
+    if (flushed == ps.num_chunks || flushed > g_atomic_int_get(&ps.hit_chunk) ||
+        g_atomic_int_get(&ps.cancel)) {
+      g_atomic_int_set(&ps.cancel, 1);
+      finished = TRUE;
+    }
+  }
+
+  for (i = 0; i < num_threads; i++) {
+    g_thread_join(threads[i]);
+    wtap_close(workers[i].wth);
+  }
+  g_free(threads);
+  g_free(workers);
+
+  if (progbar != NULL)
+    destroy_progress_dlg(progbar);
 
+  if (hit_fd != NULL) {
+    *hit_fd = NULL;
+    /* Only a match with no nearer frames left unsearched counts */
+    if (ps.hit_chunk != G_MAXINT && flushed > ps.hit_chunk && !cf->stop_flag) {
+      search_chunk_t *chunk = &ps.chunks[ps.hit_chunk];
+      *hit_fd = frame_data_sequence_find(cf->frames, chunk->hit);
+      cf->search_pos = chunk->hit_pos;
+      cf->search_len = chunk->hit_len;
+    }
+  }
+
+  if (ps.find_all) {
+    for (c = 0; c < ps.num_chunks; c++)
+      g_array_free(ps.chunks[c].hits, TRUE);
+  }
+  g_free(ps.chunks);
+
+  if (ps.err != 0 && (hit_fd == NULL || *hit_fd == NULL)) {
+    display_basename = g_filename_display_basename(cf->filename);
+    simple_error_message_box("An error occurred while reading from the file \"%s\": %s.",
+                             display_basename, wtap_strerror(ps.err));
+    g_free(display_basename);
+  }
+  return TRUE;
+}
+#endif /* PARALLEL_SEARCH */
 
 /*
  * The current match_* routines only support ASCII case insensitivity and don't
@@ -3024,101 +3382,103 @@ typedef struct {
  * significantly better.
  */
 
-gboolean
-cf_find_packet_data(capture_file *cf, const guint8 *string, size_t string_size,
-                    search_direction dir)
+static void
+cf_init_packet_data_search(capture_file *cf, cbs_t *info, const guint8 *string,
+                           size_t string_size)
 {
-  cbs_t info;
-
-  info.data = string;
-  info.data_len = string_size;
+  info->data = string;
+  info->data_len = string_size;
+  info->case_type = cf->case_type;
+  info->regex = cf->regex;
 
   /* Regex, String or hex search? */
   if (cf->regex) {
     /* Regular Expression search */
-    return find_packet(cf, match_regex, NULL, dir);
+    info->match = data_match_regex;
   } else if (cf->string) {
     /* String search - what type of string? */
     switch (cf->scs_type) {
 
     case SCS_NARROW_AND_WIDE:
-      return find_packet(cf, match_narrow_and_wide, &info, dir);
+      info->match = data_match_narrow_and_wide;
+      break;
 
     case SCS_NARROW:
-      return find_packet(cf, match_narrow, &info, dir);
+      info->match = data_match_narrow;
+      break;
 
     case SCS_WIDE:
-      return find_packet(cf, match_wide, &info, dir);
+      info->match = data_match_wide;
+      break;
 
     default:
       g_assert_not_reached();
-      return FALSE;
+      break;
     }
   } else
-    return find_packet(cf, match_binary, &info, dir);
+    info->match = data_match_binary;
 }
 
-static match_result
-match_narrow_and_wide(capture_file *cf, frame_data *fdata, void *criterion)
+gboolean
+cf_find_packet_data(capture_file *cf, const guint8 *string, size_t string_size,
+                    search_direction dir)
 {
-  cbs_t        *info       = (cbs_t *)criterion;
-  const guint8 *ascii_text = info->data;
-  size_t        textlen    = info->data_len;
-  match_result  result;
-  guint32       buf_len;
-  guint8       *pd;
-  guint32       i;
-  guint8        c_char;
-  size_t        c_match    = 0;
+  cbs_t info;
 
-  /* Load the frame's data. */
-  if (!cf_read_record(cf, fdata)) {
-    /* Attempt to get the packet failed. */
-    return MR_ERROR;
-  }
+  cf_init_packet_data_search(cf, &info, string, string_size);
+  return find_packet(cf, match_packet_data, &info, dir);
+}
 
-  result = MR_NOTMATCHED;
-  buf_len = fdata->cap_len;
-  pd = ws_buffer_start_ptr(&cf->buf);
-  i = 0;
-  while (i < buf_len) {
-    c_char = pd[i];
-    if (cf->case_type)
-      c_char = g_ascii_toupper(c_char);
-    if (c_char != '\0') {
-      if (c_char == ascii_text[c_match]) {
-        c_match += 1;
-        if (c_match == textlen) {
-          result = MR_MATCHED;
-          cf->search_pos = i; /* Save the position of the last character
-                                 for highlighting the field. */
-          cf->search_len = (guint32)textlen;
-          break;
-        }
-      }
-      else {
-        g_assert(i>=c_match);
-        i -= (guint32)c_match;
-        c_match = 0;
-      }
+guint32
+cf_find_all_packet_data(capture_file *cf, const guint8 *string,
+                        size_t string_size,
+                        void (*hit_cb)(capture_file *, frame_data *, void *),
+                        void *user_data)
+{
+  cbs_t        info;
+  guint32      framenum;
+  frame_data  *fdata;
+  guint32      hits = 0;
+
+  if (cf->count == 0)
+    return 0;
+
+  cf_init_packet_data_search(cf, &info, string, string_size);
+
+#ifdef PARALLEL_SEARCH
+  /* Searching "after" the last frame, forward, covers all of them. */
+  if (find_packet_parallel(cf, &info, cf->count, cf->count, SD_FORWARD,
+                           hit_cb, user_data, &hits, NULL))
+    return hits;
+#endif
+
+  cf->stop_flag = FALSE;
+  for (framenum = 1; framenum <= cf->count && !cf->stop_flag; framenum++) {
+    fdata = frame_data_sequence_find(cf->frames, framenum);
+    if (!fdata->flags.passed_dfilter)
+      continue;
+    switch (match_packet_data(cf, fdata, &info)) {
+
+    case MR_MATCHED:
+      hits++;
+      (*hit_cb)(cf, fdata, user_data);
+      break;
+
+    case MR_ERROR:
+      return hits;
+
+    default:
+      break;
     }
-    i += 1;
   }
-  return result;
+  return hits;
 }
 
 static match_result
-match_narrow(capture_file *cf, frame_data *fdata, void *criterion)
+match_packet_data(capture_file *cf, frame_data *fdata, void *criterion)
 {
-  guint8       *pd;
-  cbs_t        *info       = (cbs_t *)criterion;
-  const guint8 *ascii_text = info->data;
-  size_t        textlen    = info->data_len;
-  match_result  result;
-  guint32       buf_len;
-  guint32       i;
-  guint8        c_char;
-  size_t        c_match    = 0;
+  cbs_t   *info = (cbs_t *)criterion;
+  guint32  pos, len;
 
   /* Load the frame's data. */
   if (!cf_read_record(cf, fdata)) {
@@ -3126,148 +3486,134 @@ match_narrow(capture_file *cf, frame_data *fdata, void *criterion)
     return MR_ERROR;
   }
 
-  result = MR_NOTMATCHED;
-  buf_len = fdata->cap_len;
-  pd = ws_buffer_start_ptr(&cf->buf);
-  i = 0;
-  while (i < buf_len) {
-    c_char = pd[i];
-    if (cf->case_type)
-      c_char = g_ascii_toupper(c_char);
-    if (c_char == ascii_text[c_match]) {
-      c_match += 1;
-      if (c_match == textlen) {
-        result = MR_MATCHED;
-        cf->search_pos = i; /* Save the position of the last character
-                               for highlighting the field. */
-        cf->search_len = (guint32)textlen;
-        break;
-      }
-    }
-    else {
-      g_assert(i>=c_match);
-      i -= (guint32)c_match;
-      c_match = 0;
-    }
-    i += 1;
+  if ((*info->match)(info, ws_buffer_start_ptr(&cf->buf), fdata->cap_len,
+                     &pos, &len)) {
+    cf->search_pos = pos; /* Save the position of the last character
+                             for highlighting the field. */
+    cf->search_len = len;
+    return MR_MATCHED;
   }
-
-  return result;
+  return MR_NOTMATCHED;
 }
 
-static match_result
-match_wide(capture_file *cf, frame_data *fdata, void *criterion)
+/* What may come between the characters of a string being searched for */
+typedef enum {
+  STRING_GAP_NONE,  /* nothing; ASCII */
+  STRING_GAP_ONE,   /* one byte; UCS-2 */
+  STRING_GAP_NULS   /* any number of NULs; either */
+} string_gap_t;
+
+/*
+ * Look for the string in info in pd.  Every starting offset is tried in
+ * turn, so a partial match that fails can't hide a match that overlaps
+ * it.  *pos is set to the offset of the last byte of the match, and
+ * *len to the number of bytes it spans.
+ */
+static gboolean
+data_match_string(const cbs_t *info, const guint8 *pd, guint32 buf_len,
+                  string_gap_t gap, guint32 *pos, guint32 *len)
 {
-  cbs_t        *info       = (cbs_t *)criterion;
   const guint8 *ascii_text = info->data;
   size_t        textlen    = info->data_len;
-  match_result  result;
-  guint32       buf_len;
-  guint8       *pd;
-  guint32       i;
+  const guint8 *found;
+  guint32       start, i;
   guint8        c_char;
-  size_t        c_match    = 0;
+  size_t        c_match;
 
-  /* Load the frame's data. */
-  if (!cf_read_record(cf, fdata)) {
-    /* Attempt to get the packet failed. */
-    return MR_ERROR;
+  if (textlen == 0)
+    return FALSE;
+
+  if (gap == STRING_GAP_NONE && !info->case_type) {
+    /* A plain substring search */
+    found = ws_memmem(pd, buf_len, ascii_text, textlen);
+    if (found == NULL)
+      return FALSE;
+    *pos = (guint32)(found - pd + textlen - 1);
+    *len = (guint32)textlen;
+    return TRUE;
   }
 
-  result = MR_NOTMATCHED;
-  buf_len = fdata->cap_len;
-  pd = ws_buffer_start_ptr(&cf->buf);
-  i = 0;
-  while (i < buf_len) {
-    c_char = pd[i];
-    if (cf->case_type)
-      c_char = g_ascii_toupper(c_char);
-    if (c_char == ascii_text[c_match]) {
-      c_match += 1;
-      if (c_match == textlen) {
-        result = MR_MATCHED;
-        cf->search_pos = i; /* Save the position of the last character
-                               for highlighting the field. */
-        cf->search_len = (guint32)textlen;
+  for (start = 0; start < buf_len; start++) {
+    i = start;
+    c_match = 0;
+    for (;;) {
+      c_char = pd[i];
+      if (info->case_type)
+        c_char = g_ascii_toupper(c_char);
+      if (c_char != ascii_text[c_match])
         break;
+      if (++c_match == textlen) {
+        *pos = i;
+        *len = i - start + 1;
+        return TRUE;
       }
-      i += 1;
-    }
-    else {
-      g_assert(i>=(c_match*2));
-      i -= (guint32)c_match*2;
-      c_match = 0;
+      i++;
+      if (gap == STRING_GAP_ONE) {
+        i++;
+      } else if (gap == STRING_GAP_NULS) {
+        while (i < buf_len && pd[i] == '\0')
+          i++;
+      }
+      if (i >= buf_len)
+        break;
     }
-    i += 1;
   }
-  return result;
+  return FALSE;
 }
 
-static match_result
-match_binary(capture_file *cf, frame_data *fdata, void *criterion)
+static gboolean
+data_match_narrow_and_wide(const cbs_t *info, const guint8 *pd,
+                           guint32 buf_len, guint32 *pos, guint32 *len)
 {
-  cbs_t        *info        = (cbs_t *)criterion;
-  const guint8 *binary_data = info->data;
-  size_t        datalen     = info->data_len;
-  match_result  result;
-  guint32       buf_len;
-  guint8       *pd;
-  guint32       i;
-  size_t        c_match     = 0;
+  return data_match_string(info, pd, buf_len, STRING_GAP_NULS, pos, len);
+}
 
-  /* Load the frame's data. */
-  if (!cf_read_record(cf, fdata)) {
-    /* Attempt to get the packet failed. */
-    return MR_ERROR;
-  }
+static gboolean
+data_match_narrow(const cbs_t *info, const guint8 *pd, guint32 buf_len,
+                  guint32 *pos, guint32 *len)
+{
+  return data_match_string(info, pd, buf_len, STRING_GAP_NONE, pos, len);
+}
 
-  result = MR_NOTMATCHED;
-  buf_len = fdata->cap_len;
-  pd = ws_buffer_start_ptr(&cf->buf);
-  i = 0;
-  while (i < buf_len) {
-    if (pd[i] == binary_data[c_match]) {
-      c_match += 1;
-      if (c_match == datalen) {
-        result = MR_MATCHED;
-        cf->search_pos = i; /* Save the position of the last character
-                               for highlighting the field. */
-        cf->search_len = (guint32)datalen;
-        break;
-      }
-    }
-    else {
-      g_assert(i>=c_match);
-      i -= (guint32)c_match;
-      c_match = 0;
-    }
-    i += 1;
-  }
-  return result;
+static gboolean
+data_match_wide(const cbs_t *info, const guint8 *pd, guint32 buf_len,
+                guint32 *pos, guint32 *len)
+{
+  return data_match_string(info, pd, buf_len, STRING_GAP_ONE, pos, len);
 }
 
-static match_result
-match_regex(capture_file *cf, frame_data *fdata, void *criterion _U_)
+static gboolean
+data_match_binary(const cbs_t *info, const guint8 *pd, guint32 buf_len,
+                  guint32 *pos, guint32 *len)
 {
-    match_result  result = MR_NOTMATCHED;
-    GMatchInfo   *match_info = NULL;
+  const guint8 *found;
 
-    /* Load the frame's data. */
-    if (!cf_read_record(cf, fdata)) {
-        /* Attempt to get the packet failed. */
-        return MR_ERROR;
-    }
+  found = ws_memmem(pd, buf_len, info->data, info->data_len);
+  if (found == NULL)
+    return FALSE;
+  *pos = (guint32)(found - pd + info->data_len - 1);
+  *len = (guint32)info->data_len;
+  return TRUE;
+}
 
-    if (g_regex_match_full(cf->regex, ws_buffer_start_ptr(&cf->buf), fdata->cap_len,
-                           0, (GRegexMatchFlags) 0, &match_info, NULL))
-    {
-        gint start_pos = 0, end_pos = 0;
-        g_match_info_fetch_pos (match_info, 0, &start_pos, &end_pos);
-        cf->search_pos = end_pos - 1;
-        cf->search_len = end_pos - start_pos;
-        result = MR_MATCHED;
-    }
-    return result;
+static gboolean
+data_match_regex(const cbs_t *info, const guint8 *pd, guint32 buf_len,
+                 guint32 *pos, guint32 *len)
+{
+  GMatchInfo *match_info = NULL;
+  gboolean    matched = FALSE;
+  gint        start_pos = 0, end_pos = 0;
+
+  if (g_regex_match_full(info->regex, (const gchar *)pd, buf_len,
+                         0, (GRegexMatchFlags) 0, &match_info, NULL))
+  {
+    g_match_info_fetch_pos (match_info, 0, &start_pos, &end_pos);
+    *pos = end_pos - 1;
+    *len = end_pos - start_pos;
+    matched = TRUE;
+  }
+  g_match_info_free(match_info);
+  return matched;
 }
 
 gboolean
@@ -3367,9 +3713,41 @@ find_packet(capture_file *cf,
   int          progbar_quantum;
   const char  *title;
   match_result result;
+  gboolean     searched = FALSE;
 
   start_fd = cf->current_frame;
-  if (start_fd != NULL)  {
+#ifdef PARALLEL_SEARCH
+  if (start_fd != NULL && match_function == match_packet_data) {
+    guint32 nframes;
+
+    if (prefs.gui_find_wrap)
+      nframes = cf->count;
+    else if (dir == SD_BACKWARD)
+      nframes = start_fd->num - 1;
+    else
+      nframes = cf->count - start_fd->num;
+    searched = find_packet_parallel(cf, (const cbs_t *)criterion,
+                                    start_fd->num, nframes, dir,
+                                    NULL, NULL, NULL, &new_fd);
+    if (searched) {
+      if (cf->stop_flag) {
+        /* The user decided to abort the search.  Go back to the
+           frame where we started. */
+        new_fd = start_fd;
+      } else if (new_fd == NULL) {
+        if (!prefs.gui_find_wrap)
+          statusbar_push_temporary_msg(dir == SD_BACKWARD ?
+            "Search reached the beginning." : "Search reached the end.");
+      } else if (dir == SD_BACKWARD ? new_fd->num >= start_fd->num :
+                                      new_fd->num <= start_fd->num) {
+        statusbar_push_temporary_msg(dir == SD_BACKWARD ?
+          "Search reached the beginning. Continuing at end." :
+          "Search reached the end. Continuing at beginning.");
+      }
+    }
+  }
+#endif
+  if (start_fd != NULL && !searched)  {
     /* Iterate through the list of packets, starting at the packet we've
        picked, calling a routine to run the filter on the packet, see if
        it matches, and stop if so.  */
@@ -3596,12 +3974,169 @@ cf_goto_framenum(capture_file *cf)
   return FALSE;
 }
 
+/*
+ * Dissections of recently selected packets, so that going back and
+ * forth between related packets doesn't read and dissect them again
+ * every time.  Each one has its own copy of the packet data, which its
+ * tvbuffs refer to.
+ */
+#define MAX_CACHED_DISSECTIONS 16
+
+struct _cached_dissection {
+  guint32             frame_num;
+  guint32             count;    /* cf->count when it was dissected */
+  gboolean            valid;    /* FALSE if it mustn't be reused */
+  epan_dissect_t     *edt;
+  struct wtap_pkthdr  phdr;
+  Buffer              buf;
+};
+
+static void
+cached_dissection_free(cached_dissection_t *cd)
+{
+  epan_dissect_free(cd->edt);
+  g_free(cd->phdr.opt_comment);
+  wtap_phdr_cleanup(&cd->phdr);
+  ws_buffer_free(&cd->buf);
+  g_free(cd);
+}
+
+/* Free a cached dissection, unless it's the one for the selected packet,
+   in which case it is freed when that packet is unselected. */
+static void
+dissection_cache_remove(capture_file *cf, GList *link)
+{
+  cached_dissection_t *cd = (cached_dissection_t *) link->data;
+
+  if (cd->edt == cf->edt) {
+    cd->valid = FALSE;
+    return;
+  }
+  g_queue_delete_link(cf->dissection_cache, link);
+  cached_dissection_free(cd);
+}
+
+static cached_dissection_t *
+dissection_cache_lookup(capture_file *cf, const frame_data *fdata)
+{
+  GList *link;
+
+  if (cf->dissection_cache == NULL)
+    return NULL;
+
+  for (link = cf->dissection_cache->head; link != NULL; link = link->next) {
+    cached_dissection_t *cd = (cached_dissection_t *) link->data;
+
+    /* Frames added since (e.g. while capturing) might have completed a
+       reassembly or a request/response pair, changing the tree. */
+    if (cd->valid && cd->frame_num == fdata->num && cd->count == cf->count) {
+      g_queue_unlink(cf->dissection_cache, link);
+      g_queue_push_head_link(cf->dissection_cache, link);
+      return cd;
+    }
+  }
+  return NULL;
+}
+
+/* Dissect fdata, which has just been read into cf->phdr and cf->buf,
+   and add the dissection to the cache. */
+static cached_dissection_t *
+dissection_cache_add(capture_file *cf, frame_data *fdata)
+{
+  cached_dissection_t *cd;
+  GList               *link, *prev;
+
+  cd = g_new0(cached_dissection_t, 1);
+  cd->frame_num = fdata->num;
+  cd->count = cf->count;
+  cd->valid = TRUE;
+
+  /* cf->phdr and cf->buf are reused for every record we read, so the
+     tree needs a copy of its own; the comment and file-type specific
+     data belong to whatever read the record (the edited frame, with
+     the packet editor), so copy those too. */
+  cd->phdr = cf->phdr;
+  cd->phdr.opt_comment = g_strdup(cf->phdr.opt_comment);
+  ws_buffer_init(&cd->phdr.ft_specific_data, 0);
+  ws_buffer_append_buffer(&cd->phdr.ft_specific_data, &cf->phdr.ft_specific_data);
+  ws_buffer_init(&cd->buf, cf->phdr.caplen);
+  ws_buffer_append(&cd->buf, ws_buffer_start_ptr(&cf->buf), cf->phdr.caplen);
+
+  /* Create the logical protocol tree. */
+  /* We don't need the columns here. */
+  cd->edt = epan_dissect_new(cf->epan, TRUE, TRUE);
+
+  tap_build_interesting(cd->edt);
+  epan_dissect_run(cd->edt, cf->cd_t, &cd->phdr, frame_tvbuff_new_buffer(fdata, &cd->buf),
+                   fdata, NULL);
+
+  if (cf->dissection_cache == NULL)
+    cf->dissection_cache = g_queue_new();
+  g_queue_push_head(cf->dissection_cache, cd);
+
+  /* Evict the least recently selected ones. */
+  for (link = cf->dissection_cache->tail;
+       link != NULL && cf->dissection_cache->length > MAX_CACHED_DISSECTIONS;
+       link = prev) {
+    prev = link->prev;
+    if (((cached_dissection_t *) link->data)->edt != cf->edt)
+      dissection_cache_remove(cf, link);
+  }
+
+  return cd;
+}
+
+/* A packet was unselected; free its dissection if it can't be reused. */
+static void
+dissection_cache_release(capture_file *cf, epan_dissect_t *old_edt)
+{
+  GList *link;
+
+  if (old_edt == NULL || old_edt == cf->edt || cf->dissection_cache == NULL)
+    return;
+
+  for (link = cf->dissection_cache->head; link != NULL; link = link->next) {
+    cached_dissection_t *cd = (cached_dissection_t *) link->data;
+
+    if (cd->edt == old_edt) {
+      if (!cd->valid || cf->dissection_cache->length > MAX_CACHED_DISSECTIONS)
+        dissection_cache_remove(cf, link);
+      return;
+    }
+  }
+}
+
+void
+cf_invalidate_dissection_cache(capture_file *cf, const frame_data *fdata)
+{
+  GList *link, *next;
+
+  if (cf->dissection_cache == NULL)
+    return;
+
+  for (link = cf->dissection_cache->head; link != NULL; link = next) {
+    cached_dissection_t *cd = (cached_dissection_t *) link->data;
+
+    next = link->next;
+    if (fdata == NULL || cd->frame_num == fdata->num)
+      dissection_cache_remove(cf, link);
+  }
+}
+
+void
+cf_times_changed(capture_file *cf)
+{
+  cf_invalidate_dissection_cache(cf, NULL);
+  cf_callback_invoke(cf_cb_file_times_changed, cf);
+}
+
 /* Select the packet on a given row. */
 void
 cf_select_packet(capture_file *cf, int row)
 {
-  epan_dissect_t *old_edt;
-  frame_data     *fdata;
+  epan_dissect_t      *old_edt;
+  frame_data          *fdata;
+  cached_dissection_t *cd;
 
   /* Get the frame data struct pointer for this frame */
   fdata = packet_list_get_row_data(row);
@@ -3647,25 +4182,24 @@ cf_select_packet(capture_file *cf, int row)
     return;
   }
 
+  /* Reuse the protocol tree if this frame was selected recently,
+     otherwise create it. */
+  cd = dissection_cache_lookup(cf, fdata);
+  if (cd == NULL)
+    cd = dissection_cache_add(cf, fdata);
+
   /* Record that this frame is the current frame. */
   cf->current_frame = fdata;
   cf->current_row = row;
 
   old_edt = cf->edt;
-  /* Create the logical protocol tree. */
-  /* We don't need the columns here. */
-  cf->edt = epan_dissect_new(cf->epan, TRUE, TRUE);
-
-  tap_build_interesting(cf->edt);
-  epan_dissect_run(cf->edt, cf->cd_t, &cf->phdr, frame_tvbuff_new_buffer(cf->current_frame, &cf->buf),
-                   cf->current_frame, NULL);
+  cf->edt = cd->edt;
 
   dfilter_macro_build_ftv_cache(cf->edt->tree);
 
   cf_callback_invoke(cf_cb_packet_selected, cf);
 
-  if (old_edt != NULL)
-    epan_dissect_free(old_edt);
+  dissection_cache_release(cf, old_edt);
 
 }
 
@@ -3686,9 +4220,9 @@ cf_unselect_packet(capture_file *cf)
   /* No protocol tree means no selected field. */
   cf_unselect_field(cf);
 
-  /* Destroy the epan_dissect_t for the unselected packet. */
-  if (old_edt != NULL)
-    epan_dissect_free(old_edt);
+  /* Keep the epan_dissect_t for the unselected packet, if we may
+     reuse it. */
+  dissection_cache_release(cf, old_edt);
 }
 
 /* Unset the selected protocol tree field, if any. */
@@ -3707,6 +4241,7 @@ void
 cf_mark_frame(capture_file *cf, frame_data *frame)
 {
   if (! frame->flags.marked) {
+    cf_invalidate_dissection_cache(cf, frame);
     frame->flags.marked = TRUE;
     if (cf->count > cf->marked_count)
       cf->marked_count++;
@@ -3720,6 +4255,7 @@ void
 cf_unmark_frame(capture_file *cf, frame_data *frame)
 {
   if (frame->flags.marked) {
+    cf_invalidate_dissection_cache(cf, frame);
     frame->flags.marked = FALSE;
     if (cf->marked_count > 0)
       cf->marked_count--;
@@ -3733,6 +4269,7 @@ void
 cf_ignore_frame(capture_file *cf, frame_data *frame)
 {
   if (! frame->flags.ignored) {
+    cf_invalidate_dissection_cache(cf, frame);
     frame->flags.ignored = TRUE;
     if (cf->count > cf->ignored_count)
       cf->ignored_count++;
@@ -3746,6 +4283,7 @@ void
 cf_unignore_frame(capture_file *cf, frame_data *frame)
 {
   if (frame->flags.ignored) {
+    cf_invalidate_dissection_cache(cf, frame);
     frame->flags.ignored = FALSE;
     if (cf->ignored_count > 0)
       cf->ignored_count--;
@@ -3853,6 +4391,7 @@ cf_set_user_packet_comment(capture_file *cf, frame_data *fd, const gchar *new_co
     cf->packet_comment_count++;
 
   fd->flags.has_user_comment = TRUE;
+  cf_invalidate_dissection_cache(cf, fd);
 
   if (!cf->frames_user_comments)
     cf->frames_user_comments = g_tree_new_full(frame_cmp, NULL, NULL, g_free);
@@ -3920,6 +4459,7 @@ cf_set_frame_edited(capture_file *cf, frame_data *fd,
                                         modified_frame_data_free);
   g_tree_insert(cf->edited_frames, GINT_TO_POINTER(fd->num), mfd);
   fd->file_off = -1;
+  cf_invalidate_dissection_cache(cf, fd);
 
   /* Mark the file as having unsaved changes */
   cf->unsaved_changes = TRUE;
@@ -4214,6 +4754,10 @@ rescan_file(capture_file *cf, const char *fname, gboolean is_tempfile, int *err)
      in any case. */
   cf->filename = g_strdup(fname);
 
+  /* It's a single file now, even if we saved it from a file set. */
+  g_strfreev(cf->set_filenames);
+  cf->set_filenames = NULL;
+
   /* Indicate whether it's a permanent or temporary file. */
   cf->is_tempfile = is_tempfile;
 
@@ -4408,9 +4952,10 @@ cf_save_records(capture_file *cf, const char *fname, guint save_format,
   addr_lists = get_addrinfo_list();
 
   if (save_format == cf->cd_t && compressed == cf->iscompressed
+      && cf->set_filenames == NULL
       && !discard_comments && !cf->unsaved_changes
       && !(addr_lists && wtap_dump_has_name_resolution(save_format))) {
-    /* We're saving in the format it's already in, and we're
+    /* We're saving a single file in the format it's already in, and we're
        not discarding comments, and there are no changes we have
        in memory that aren't saved to the file, and we have no name
        resolution blocks to write, so we can just move or copy the raw data. */
@@ -5048,9 +5593,11 @@ cf_close_failure_alert_box(const char *filename, int err)
 /* Reload the current capture file. */
 void
 cf_reload(capture_file *cf) {
-  gchar    *filename;
-  gboolean  is_tempfile;
-  int       err;
+  gchar      *filename;
+  gchar     **set_filenames;
+  gboolean    is_tempfile;
+  cf_status_t status;
+  int         err;
 
   /* If the file could be opened, "cf_open()" calls "cf_close()"
      to get rid of state for the old capture file before filling in state
@@ -5063,9 +5610,15 @@ cf_reload(capture_file *cf) {
      Also, "cf_close()" will free "cf->filename", so we must make
      a copy of it first. */
   filename = g_strdup(cf->filename);
+  set_filenames = g_strdupv(cf->set_filenames);
   is_tempfile = cf->is_tempfile;
   cf->is_tempfile = FALSE;
-  if (cf_open(cf, filename, cf->open_type, is_tempfile, &err) == CF_OK) {
+  if (set_filenames != NULL)
+    status = cf_open_set(cf, (const char *const *)set_filenames,
+                         g_strv_length(set_filenames), cf->open_type, &err);
+  else
+    status = cf_open(cf, filename, cf->open_type, is_tempfile, &err);
+  if (status == CF_OK) {
     switch (cf_read(cf, TRUE)) {
 
     case CF_READ_OK:
@@ -5081,6 +5634,7 @@ cf_reload(capture_file *cf) {
          string and return (without changing the last containing
          directory). */
       g_free(filename);
+      g_strfreev(set_filenames);
       return;
     }
   } else {
@@ -5095,6 +5649,7 @@ cf_reload(capture_file *cf) {
   /* "cf_open()" made a copy of the file name we handed it, so
      we should free up our copy. */
   g_free(filename);
+  g_strfreev(set_filenames);
 }
 
 /*
@@ -73,6 +73,7 @@ typedef enum {
     cf_cb_file_rescan_finished,
     cf_cb_file_retap_started,
     cf_cb_file_retap_finished,
+    cf_cb_file_times_changed,
     cf_cb_file_fast_save_finished,
     cf_cb_packet_selected,
     cf_cb_packet_unselected,
@@ -133,6 +134,19 @@ cf_callback_remove(cf_callback_t func, gpointer user_data);
  */
 cf_status_t cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_tempfile, int *err);
 
+/**
+ * Open the files of a file set, such as the files written by a ring
+ * buffer, as a single capture file, merging their packets in time order.
+ *
+ * @param cf the capture file to be opened
+ * @param filenames the names of the files of the set, in set order
+ * @param count the number of entries in filenames
+ * @param type WTAP_TYPE_AUTO for automatic or index to direct open routine
+ * @param err error code
+ * @return one of cf_status_t
+ */
+cf_status_t cf_open_set(capture_file *cf, const char *const *filenames, guint count, unsigned int type, int *err);
+
 /**
  * Close a capture file.
  *
@@ -507,6 +521,24 @@ gboolean cf_find_packet_summary_line(capture_file *cf, const char *string,
 gboolean cf_find_packet_data(capture_file *cf, const guint8 *string,
                              size_t string_size, search_direction dir);
 
+/**
+ * Find all displayed packets whose data contains a specified byte string,
+ * searched for as cf_find_packet_data() does.  Large files are searched
+ * in parallel; the matching packets are passed to hit_cb as they are
+ * found, in frame number order.
+ *
+ * @param cf the capture file
+ * @param string the string to find
+ * @param string_size the size of the string to find
+ * @param hit_cb called for each matching packet
+ * @param user_data passed to hit_cb
+ * @return the number of matching packets
+ */
+guint32 cf_find_all_packet_data(capture_file *cf, const guint8 *string,
+                                size_t string_size,
+                                void (*hit_cb)(capture_file *cf, frame_data *fdata, void *user_data),
+                                void *user_data);
+
 /**
  * Find packet that matches a compiled display filter.
  *
@@ -596,6 +628,25 @@ void cf_select_packet(capture_file *cf, int row);
  */
 void cf_unselect_packet(capture_file *cf);
 
+/**
+ * Discard the kept dissections of recently selected packets, so that
+ * they are dissected again the next time they're selected.
+ *
+ * @param cf the capture file
+ * @param fdata the frame whose dissection should be discarded, or NULL
+ * to discard all of them
+ */
+void cf_invalidate_dissection_cache(capture_file *cf, const frame_data *fdata);
+
+/**
+ * The timestamps of the packets have changed, e.g. by a time shift or
+ * a time reference change. Discard the cached dissections and notify
+ * the UI.
+ *
+ * @param cf the capture file
+ */
+void cf_times_changed(capture_file *cf);
+
 /**
  * Unselect all protocol tree fields, if any.
  *
@@ -383,6 +383,30 @@ fileset_get_previous(void)
 }
 
 
+/* get the full names of all files in the set, in set order, as a
+ * NULL-terminated array suitable for wtap_open_offline_set();
+ * free it with g_strfreev() */
+gchar **
+fileset_get_filenames(guint *count)
+{
+    GList         *le;
+    gchar        **filenames;
+    guint          i = 0;
+
+
+    filenames = g_new(gchar *, g_list_length(set.entries) + 1);
+    for(le = g_list_first(set.entries); le != NULL; le = g_list_next(le)) {
+        filenames[i++] = g_strdup(((fileset_entry *)le->data)->fullname);
+    }
+    filenames[i] = NULL;
+
+    if(count) {
+        *count = i;
+    }
+    return filenames;
+}
+
+
 /* delete a single entry */
 static void fileset_entry_delete(gpointer data, gpointer user_data _U_)
 {
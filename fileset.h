@@ -50,6 +50,10 @@ extern const char *fileset_get_dirname(void);
 extern fileset_entry *fileset_get_next(void);
 extern fileset_entry *fileset_get_previous(void);
 
+/* get the names of all files in the set, e.g. to open them with
+ * wtap_open_offline_set() (g_strfreev() the result) */
+extern gchar **fileset_get_filenames(guint *count);
+
 
 
 /* this file is a part of the current file set */
@@ -36,7 +36,8 @@
 struct tvb_frame {
 	struct tvbuff tvb;
 
-	Buffer *buf;         /* Packet data */
+	Buffer *buf;         /* Packet data, if we had to copy it */
+	const guint8 *data;  /* Packet data, wherever it is */
 
 	wtap *wth;           /**< Wiretap session */
 	gint64 file_off;     /**< File offset */
@@ -45,7 +46,8 @@ struct tvb_frame {
 };
 
 static gboolean
-frame_read(struct tvb_frame *frame_tvb, struct wtap_pkthdr *phdr, Buffer *buf)
+frame_read(struct tvb_frame *frame_tvb, struct wtap_pkthdr *phdr, Buffer *buf,
+    const guint8 **data)
 {
 	int    err;
 	gchar *err_info;
@@ -57,7 +59,7 @@ frame_read(struct tvb_frame *frame_tvb, struct wtap_pkthdr *phdr, Buffer *buf)
 	/* XXX, what if phdr->caplen isn't equal to
 	 * frame_tvb->tvb.length + frame_tvb->offset?
 	 */
-	if (!wtap_seek_read(frame_tvb->wth, frame_tvb->file_off, phdr, buf, &err, &err_info)) {
+	if (!wtap_seek_read_ptr(frame_tvb->wth, frame_tvb->file_off, phdr, buf, data, &err, &err_info)) {
 		/* XXX - report error! */
 		switch (err) {
 			case WTAP_ERR_BAD_FILE:
@@ -76,17 +78,28 @@ frame_cache(struct tvb_frame *frame_tvb)
 
 	wtap_phdr_init(&phdr);
 
-	if (frame_tvb->buf == NULL) {
+	if (frame_tvb->data == NULL) {
 		frame_tvb->buf = (struct Buffer *) g_malloc(sizeof(struct Buffer));
 
 		/* XXX, register frame_tvb to some list which frees from time to time not used buffers :] */
 		ws_buffer_init(frame_tvb->buf, frame_tvb->tvb.length + frame_tvb->offset);
 
-		if (!frame_read(frame_tvb, &phdr, frame_tvb->buf))
-			{ /* TODO: THROW(???); */ }
+		if (!frame_read(frame_tvb, &phdr, frame_tvb->buf, &frame_tvb->data)) {
+			/* TODO: THROW(???); */
+			frame_tvb->data = ws_buffer_start_ptr(frame_tvb->buf);
+		} else if (frame_tvb->data != ws_buffer_start_ptr(frame_tvb->buf)) {
+			/*
+			 * The data is in the file's memory mapping, which
+			 * lasts as long as the file is open; we don't need
+			 * a copy.
+			 */
+			ws_buffer_free(frame_tvb->buf);
+			g_free(frame_tvb->buf);
+			frame_tvb->buf = NULL;
+		}
 	}
 
-	frame_tvb->tvb.real_data = ws_buffer_start_ptr(frame_tvb->buf) + frame_tvb->offset;
+	frame_tvb->tvb.real_data = frame_tvb->data + frame_tvb->offset;
 
 	wtap_phdr_cleanup(&phdr);
 }
@@ -226,6 +239,7 @@ frame_tvbuff_new(const frame_data *fd, const guint8 *buf)
 		frame_tvb->wth = NULL;
 
 	frame_tvb->buf = NULL;
+	frame_tvb->data = NULL;
 
 	return tvb;
 }
@@ -269,6 +283,7 @@ frame_clone(tvbuff_t *tvb, guint abs_offset, guint abs_length)
 	cloned_frame_tvb->file_off = frame_tvb->file_off;
 	cloned_frame_tvb->offset = abs_offset;
 	cloned_frame_tvb->buf = NULL;
+	cloned_frame_tvb->data = NULL;
 
 	return cloned_tvb;
 }
@@ -331,6 +346,7 @@ file_tvbuff_new(const frame_data *fd, const guint8 *buf)
 		frame_tvb->wth = NULL;
 
 	frame_tvb->buf = NULL;
+	frame_tvb->data = NULL;
 
 	return tvb;
 }
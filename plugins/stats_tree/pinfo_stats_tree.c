@@ -28,6 +28,7 @@
 #include <epan/prefs.h>
 #include <epan/uat-int.h>
 #include <epan/to_str.h>
+#include <wsutil/pint.h>
 
 #include "pinfo_stats_tree.h"
 
@@ -118,10 +119,18 @@ static void ipv6_hosts_stats_tree_init(stats_tree *st) {
 	st_node_ipv6 = stats_tree_create_node(st, st_str_ipv6, 0, TRUE);
 }
 
+/* IPv4 addresses are used as keys rather than formatted for every packet */
+static void tick_ip_host_node(stats_tree *st, packet_info *pinfo, const address *addr, int st_node) {
+	if (addr->type == AT_IPv4 && addr->len == 4)
+		tick_stat_node_by_key(st, ST_KEY_IPV4, pntoh32(addr->data), st_node, FALSE);
+	else
+		tick_stat_node(st, address_to_str(pinfo->pool, addr), st_node, FALSE);
+}
+
 static int ip_hosts_stats_tree_packet(stats_tree *st, packet_info *pinfo, int st_node, const gchar *st_str) {
 	tick_stat_node(st, st_str, 0, FALSE);
-	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_src), st_node, FALSE);
-	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_dst), st_node, FALSE);
+	tick_ip_host_node(st, pinfo, &pinfo->net_src, st_node);
+	tick_ip_host_node(st, pinfo, &pinfo->net_dst, st_node);
 	return 1;
 }
 
@@ -171,10 +180,10 @@ static int ip_srcdst_stats_tree_packet(stats_tree *st, packet_info *pinfo,
 				int st_node_dst, const gchar *st_str_dst) {
 	/* update source branch */
 	tick_stat_node(st, st_str_src, 0, FALSE);
-	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_src), st_node_src, FALSE);
+	tick_ip_host_node(st, pinfo, &pinfo->net_src, st_node_src);
 	/* update destination branch */
 	tick_stat_node(st, st_str_dst, 0, FALSE);
-	tick_stat_node(st, address_to_str(pinfo->pool, &pinfo->net_dst), st_node_dst, FALSE);
+	tick_ip_host_node(st, pinfo, &pinfo->net_dst, st_node_dst);
 	return 1;
 }
 
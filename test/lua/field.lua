@@ -69,6 +69,7 @@ local f_udp_srcport = Field.new("udp.srcport")
 local f_udp_dstport = Field.new("udp.dstport")
 local f_bootp_hw    = Field.new("bootp.hw.mac_addr")
 local f_bootp_opt   = Field.new("bootp.option.type")
+local f_tcp_srcport = Field.new("tcp.srcport")
 
 test("Field__tostring-1", tostring(f_frame_proto) == "frame.protocols")
 
@@ -87,6 +88,9 @@ test("Field.type-5", f_bootp_opt.type == ftypes.UINT8)
 -- make sure can't create a FieldInfo outside tap
 test("Field__call-1",not pcall(makeFieldInfo,f_eth_src))
 
+-- nor get values
+test("Field.values-1",not pcall(Field.values,f_eth_src))
+
 local tap = Listener.new()
 
 --------------------------
@@ -164,6 +168,19 @@ function tap.packet(pinfo,tvb)
     test("FieldInfo.len-1", fi_eth_src.len == 6)
     test("FieldInfo.len-2",not pcall(setFieldInfo,fi_eth_src,"len",6))
 
+    testing("Field.values")
+
+    local v_ip_src, v_udp_srcport, v_eth_src, v_tcp_srcport =
+        Field.values(f_ip_src, f_udp_srcport, f_eth_src, f_tcp_srcport)
+    test("Field.values-2", v_udp_srcport == finfo_udp_srcport.value)
+    test("Field.values-3", tostring(v_ip_src) == tostring(f_ip_src().value))
+    test("Field.values-4", tostring(v_eth_src) == tostring(fi_eth_src.value))
+    test("Field.values-5", v_tcp_srcport == nil)
+    test("Field.values-6", select('#', Field.values(f_tcp_srcport, f_ip_src)) == 2)
+    -- the Address object is updated in place, not created again
+    test("Field.values-7", rawequal(v_eth_src, (Field.values(f_eth_src))))
+    test("Field.values-8",not pcall(Field.values))
+
     if packet_count == 4 then
         print("\n-----------------------------\n")
         print("All tests passed!\n\n")
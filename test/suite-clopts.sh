@@ -355,6 +355,29 @@ clopts_suite_tshark_capture_options() {
 	test_step_add  "Invalid TShark capture interface index 0" clopts_step_tshark_invalid_interfaces_index
 }
 
+# check the header and trailer of the columnar field output
+clopts_step_columnar_fields() {
+	$TSHARK -r "${CAPTURE_DIR}dhcp.pcap" -Tfields -E format=columnar \
+		-e frame.number -e ip.src -e frame.time -e bootp.option.hostname \
+		> ./testout.txt 2> ./testout2.txt
+	RETURNVALUE=$?
+	if [ ! $RETURNVALUE -eq $EXIT_OK ]; then
+		test_step_failed "exit status: $RETURNVALUE"
+		cat ./testout2.txt
+		return
+	fi
+	MAGIC=`head -c 4 ./testout.txt`
+	# "WSFE" followed by the number of rows (4) as 64 bits little-endian
+	TRAILER=`tail -c 12 ./testout.txt | od -An -tx1 | tr -d ' \n'`
+	if [ "$MAGIC" != "WSFC" ]; then
+		test_step_failed "missing WSFC header"
+	elif [ "$TRAILER" != "575346450400000000000000" ]; then
+		test_step_failed "unexpected trailer $TRAILER"
+	else
+		test_step_ok
+	fi
+}
+
 clopts_post_step() {
 	rm -f ./testout.txt ./testout2.txt
 }
@@ -372,6 +395,7 @@ clopt_suite() {
 	test_suite_add "Capture filter/interface options tests" clopts_suite_tshark_capture_options
 	test_suite_add "Dump glossaries" clopts_suite_dump_glossaries
 	test_step_add  "Valid name resolution options -N (1s)" clopts_step_valid_name_resolving
+	test_step_add  "Columnar field output -E format=columnar" clopts_step_columnar_fields
 	#test_remark_add "Options currently unchecked: S, V, l, n, p, q and x"
 }
 
@@ -142,6 +142,57 @@ io_step_rawshark_pcap_stdin() {
 	test_step_ok
 }
 
+# Read a capture split into a file set as one capture
+io_step_file_set() {
+	# Split a capture the way a ring buffer would
+	$EDITCAP -c 20 "${CAPTURE_DIR}many_interfaces.pcapng.1" ./testset.pcapng > ./testout.txt 2>&1
+	RETURNVALUE=$?
+	if [ ! $RETURNVALUE -eq $EXIT_OK ]; then
+		echo
+		cat ./testout.txt
+		test_step_failed "exit status of editcap: $RETURNVALUE"
+		return
+	fi
+
+	$MERGECAP -w ./testout.pcap ./testset_*.pcapng > ./testout.txt 2>&1
+	RETURNVALUE=$?
+	if [ ! $RETURNVALUE -eq $EXIT_OK ]; then
+		echo
+		cat ./testout.txt
+		test_step_failed "exit status of mergecap: $RETURNVALUE"
+		return
+	fi
+
+	SET_ARGS=""
+	for SET_FILE in ./testset_*.pcapng ; do
+		SET_ARGS="$SET_ARGS -r $SET_FILE"
+	done
+	$DUT $SET_ARGS -T fields -e frame.time_epoch -e frame.len -e frame.protocols > ./testout.txt 2>&1
+	RETURNVALUE=$?
+	if [ ! $RETURNVALUE -eq $EXIT_OK ]; then
+		echo
+		cat ./testout.txt
+		test_step_failed "exit status of $DUT reading the file set: $RETURNVALUE"
+		return
+	fi
+	$DUT -r ./testout.pcap -T fields -e frame.time_epoch -e frame.len -e frame.protocols > ./testout2.txt 2>&1
+
+	# The set must give the frames of the merged file, in the same order
+	diff -u --strip-trailing-cr ./testout2.txt ./testout.txt > $DIFF_OUT 2>&1
+	RETURNVALUE=$?
+	if [ ! $RETURNVALUE -eq $EXIT_OK ]; then
+		cat $DIFF_OUT
+		test_step_failed "Frames of the file set differ from those of the merged file"
+		return
+	fi
+	FRAME_COUNT=`wc -l < ./testout.txt`
+	if [ $FRAME_COUNT -ne 64 ]; then
+		test_step_failed "Read $FRAME_COUNT frames from the file set, expected 64"
+		return
+	fi
+	test_step_ok
+}
+
 
 wireshark_io_suite() {
 	# Q: quit after cap, k: start capture immediately
@@ -159,6 +210,7 @@ tshark_io_suite() {
 	DUT=$TSHARK
 	test_step_add "Input file" io_step_input_file
 	test_step_add "Output piping" io_step_output_piping
+	test_step_add "File set input" io_step_file_set
 	#test_step_add "Piping" io_step_input_piping
 }
 
@@ -178,6 +230,7 @@ io_cleanup_step() {
 	rm -f ./testout2.txt
 	rm -f ./testout.pcap
 	rm -f ./testout2.pcap
+	rm -f ./testset_*.pcapng
 	rm -f $IO_RAWSHARK_DHCP_PCAP_TESTOUT
 }
 
@@ -34,9 +34,11 @@ unittests_step_test() {
 
 TOOL_SEARCH_PATHS="
 	$WS_BIN_PATH
+	$SOURCE_DIR/codecs
 	$SOURCE_DIR/epan
 	$SOURCE_DIR/epan/wmem
 	$SOURCE_DIR/tools
+	$SOURCE_DIR/wiretap
 "
 
 check_dut() {
@@ -64,6 +66,12 @@ check_dut() {
 	fi
 }
 
+unittests_step_codecs_test() {
+	check_dut codecs_test
+	ARGS=--verbose
+	unittests_step_test
+}
+
 unittests_step_exntest() {
 	check_dut exntest
 	ARGS=
@@ -82,6 +90,24 @@ unittests_step_reassemble_test() {
 	unittests_step_test
 }
 
+unittests_step_stats_tree_test() {
+	check_dut stats_tree_test
+	ARGS=
+	unittests_step_test
+}
+
+unittests_step_timestats_test() {
+	check_dut timestats_test
+	ARGS=
+	unittests_step_test
+}
+
+unittests_step_addr_resolv_test() {
+	check_dut addr_resolv_test
+	ARGS=
+	unittests_step_test
+}
+
 unittests_step_tvbtest() {
 	check_dut tvbtest
 	ARGS=
@@ -94,6 +120,12 @@ unittests_step_wmem_test() {
 	unittests_step_test
 }
 
+unittests_step_wtap_ranges_test() {
+	check_dut wtap_ranges_test
+	ARGS="--verbose ${CAPTURE_DIR}segmented_fpm.pcap ${CAPTURE_DIR}many_interfaces.pcapng.1 ${CAPTURE_DIR}late_idb.pcapng"
+	unittests_step_test
+}
+
 unittests_step_ftsanity() {
 	check_dut ftsanity.py
 	ARGS=$TSHARK_PATH
@@ -113,11 +145,16 @@ unittests_cleanup_step() {
 unittests_suite() {
 	test_step_set_pre unittests_cleanup_step
 	test_step_set_post unittests_cleanup_step
+	test_step_add "codecs_test" unittests_step_codecs_test
 	test_step_add "exntest" unittests_step_exntest
 	test_step_add "oids_test" unittests_step_oids_test
 	test_step_add "reassemble_test" unittests_step_reassemble_test
+	test_step_add "stats_tree_test" unittests_step_stats_tree_test
+	test_step_add "timestats_test" unittests_step_timestats_test
+	test_step_add "addr_resolv_test" unittests_step_addr_resolv_test
 	test_step_add "tvbtest" unittests_step_tvbtest
 	test_step_add "wmem_test" unittests_step_wmem_test
+	test_step_add "wtap_ranges_test" unittests_step_wtap_ranges_test
 	test_step_add "ftsanity.py" unittests_step_ftsanity
 	test_step_add "field count" unittests_step_fieldcount
 }
@@ -35,6 +35,11 @@
 
 #include <errno.h>
 
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
 #ifndef HAVE_GETOPT_LONG
 #include "wsutil/wsgetopt.h"
 #endif
@@ -1328,6 +1333,13 @@ main(int argc, char *argv[])
         return 1;
   }
 
+#ifdef _WIN32
+  if (WRITE_FIELDS == output_action && output_fields_is_columnar(output_fields)) {
+    /* Binary output; don't turn LF into CR LF */
+    _setmode(_fileno(stdout), _O_BINARY);
+  }
+#endif
+
   /* If no capture filter or display filter has been specified, and there are
      still command-line arguments, treat them as the tokens of a capture
      filter (if no "-r" flag was specified) or a display filter (if a "-r"
@@ -2491,7 +2503,8 @@ print_packet(capture_file *cf, epan_dissect_t *edt)
       return !ferror(stdout);
     case WRITE_FIELDS:
       write_fields_proto_tree(output_fields, edt, &cf->cinfo, stdout);
-      printf("\n");
+      if (!output_fields_is_columnar(output_fields))
+        printf("\n");
       return !ferror(stdout);
     }
   }
@@ -70,4 +70,16 @@ class testTVB(dftest.DFTest):
         dfilter = 'http contains "HEAD"'
         self.assertDFilterCount(dfilter, 1)
 
+    def test_contains_any_1(self):
+        dfilter = 'eth contains ff:ff:ff or eth contains 09:6b:88'
+        self.assertDFilterCount(dfilter, 1)
+
+    def test_contains_any_2(self):
+        dfilter = 'eth contains ff:ff:ff or eth contains 0f:0f:0f'
+        self.assertDFilterCount(dfilter, 0)
+
+    def test_contains_any_3(self):
+        dfilter = 'http contains "POST" or ip.ttl == 1 or http contains "HEAD"'
+        self.assertDFilterCount(dfilter, 1)
+
 
@@ -38,6 +38,9 @@
 
 #ifndef _WIN32
 #include <signal.h>
+#else
+#include <io.h>
+#include <fcntl.h>
 #endif
 
 #ifdef HAVE_LIBCAP
@@ -337,7 +340,8 @@ print_usage(FILE *output)
 #endif
   /*fprintf(output, "\n");*/
   fprintf(output, "Input file:\n");
-  fprintf(output, "  -r <infile>              set the filename to read from (- to read from stdin)\n");
+  fprintf(output, "  -r <infile>              set the filename to read from (- to read from stdin);\n");
+  fprintf(output, "                           if given more than once, read the files as one file set\n");
 
   fprintf(output, "\n");
   fprintf(output, "Processing:\n");
@@ -963,6 +967,7 @@ main(int argc, char *argv[])
   int                  gdp_open_errno, gdp_read_errno;
   int                  dp_open_errno, dp_read_errno;
   int                  cf_open_errno;
+  cf_status_t          open_status;
   int                  err;
   volatile int         exit_status = 0;
 #ifdef HAVE_LIBPCAP
@@ -983,6 +988,7 @@ main(int argc, char *argv[])
   volatile gboolean    out_file_name_res = FALSE;
   volatile int         in_file_type = WTAP_TYPE_AUTO;
   gchar               *volatile cf_name = NULL;
+  GPtrArray           *cf_names = g_ptr_array_new();
   gchar               *rfilter = NULL;
   gchar               *dfilter = NULL;
 #ifdef HAVE_PCAP_OPEN_DEAD
@@ -1572,7 +1578,10 @@ main(int argc, char *argv[])
       really_quiet = TRUE;
       break;
     case 'r':        /* Read capture file x */
-      cf_name = g_strdup(optarg);
+      /* If we're given more than one, read them as the files of a set;
+         the first one names the capture. */
+      g_ptr_array_add(cf_names, g_strdup(optarg));
+      cf_name = (gchar *)g_ptr_array_index(cf_names, 0);
       break;
     case 'R':        /* Read file filter */
       rfilter = optarg;
@@ -1768,6 +1777,13 @@ main(int argc, char *argv[])
         return 1;
   }
 
+#ifdef _WIN32
+  if (WRITE_FIELDS == output_action && output_fields_is_columnar(output_fields)) {
+    /* Binary output; don't turn LF into CR LF */
+    _setmode(_fileno(stdout), _O_BINARY);
+  }
+#endif
+
   /* If no capture filter or display filter has been specified, and there are
      still command-line arguments, treat them as the tokens of a capture
      filter (if no "-r" flag was specified) or a display filter (if a "-r"
@@ -2253,7 +2269,11 @@ main(int argc, char *argv[])
     /*
      * We're reading a capture file.
      */
-    if (cf_open(&cfile, cf_name, in_file_type, FALSE, &err) != CF_OK) {
+    if (cf_names->len > 1)
+      open_status = cf_open_set(&cfile, (const char *const *)cf_names->pdata, cf_names->len, in_file_type, &err);
+    else
+      open_status = cf_open(&cfile, cf_name, in_file_type, FALSE, &err);
+    if (open_status != CF_OK) {
       epan_cleanup();
       return 2;
     }
@@ -2405,7 +2425,8 @@ main(int argc, char *argv[])
 #endif
   }
 
-  g_free(cf_name);
+  g_ptr_array_foreach(cf_names, (GFunc)g_free, NULL);
+  g_ptr_array_free(cf_names, TRUE);
 
   if (cfile.frames != NULL) {
     free_frame_data_sequence(cfile.frames);
@@ -4222,7 +4243,8 @@ print_packet(capture_file *cf, epan_dissect_t *edt)
       return !ferror(stdout);
     case WRITE_FIELDS:
       write_fields_proto_tree(output_fields, edt, &cf->cinfo, stdout);
-      printf("\n");
+      if (!output_fields_is_columnar(output_fields))
+        printf("\n");
       return !ferror(stdout);
     }
   }
@@ -4264,19 +4286,10 @@ write_finale(void)
   }
 }
 
-cf_status_t
-cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_tempfile, int *err)
+/* Fill in the information for the file we just opened as wth. */
+static void
+cf_open_wth(capture_file *cf, wtap *wth, const char *fname, unsigned int type, gboolean is_tempfile)
 {
-  wtap  *wth;
-  gchar *err_info;
-  char   err_msg[2048+1];
-
-  wth = wtap_open_offline(fname, type, err, &err_info, perform_two_pass_analysis);
-  if (wth == NULL)
-    goto fail;
-
-  /* The open succeeded.  Fill in the information for this file. */
-
   /* Create new epan session for dissection. */
   epan_free(cf->epan);
   cf->epan = tshark_epan_new(cf);
@@ -4316,14 +4329,47 @@ cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_temp
 
   wtap_set_cb_new_ipv4(cf->wth, add_ipv4_name);
   wtap_set_cb_new_ipv6(cf->wth, (wtap_new_ipv6_callback_t) add_ipv6_name);
+}
+
+cf_status_t
+cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_tempfile, int *err)
+{
+  wtap  *wth;
+  gchar *err_info;
+  char   err_msg[2048+1];
 
+  wth = wtap_open_offline(fname, type, err, &err_info, perform_two_pass_analysis);
+  if (wth == NULL) {
+    g_snprintf(err_msg, sizeof err_msg,
+               cf_open_error_message(*err, err_info, FALSE, cf->cd_t), fname);
+    cmdarg_err("%s", err_msg);
+    return CF_ERROR;
+  }
+
+  /* The open succeeded. */
+  cf_open_wth(cf, wth, fname, type, is_tempfile);
   return CF_OK;
+}
 
-fail:
-  g_snprintf(err_msg, sizeof err_msg,
-             cf_open_error_message(*err, err_info, FALSE, cf->cd_t), fname);
-  cmdarg_err("%s", err_msg);
-  return CF_ERROR;
+cf_status_t
+cf_open_set(capture_file *cf, const char *const *filenames, guint count, unsigned int type, int *err)
+{
+  wtap  *wth;
+  gchar *err_info;
+  char   err_msg[2048+1];
+
+  wth = wtap_open_offline_set(filenames, count, type, err, &err_info,
+                              perform_two_pass_analysis);
+  if (wth == NULL) {
+    g_snprintf(err_msg, sizeof err_msg,
+               cf_open_error_message(*err, err_info, FALSE, cf->cd_t), filenames[0]);
+    cmdarg_err("%s", err_msg);
+    return CF_ERROR;
+  }
+
+  /* The set goes by the name of its first file. */
+  cf_open_wth(cf, wth, filenames[0], type, FALSE);
+  return CF_OK;
 }
 
 static void
@@ -73,10 +73,18 @@ hosts_draw(void *dummy _U_)
 
 	GHashTable *ipv4_hash_table;
 	GHashTable *ipv6_hash_table;
+	host_cache_stats_t cache_stats;
+
+	get_host_cache_stats(&cache_stats);
 
 	printf("# TShark hosts output\n");
 	printf("#\n");
 	printf("# Host data gathered from %s\n", cfile.filename);
+	printf("#\n");
+	printf("# Host cache: %u addresses, %" G_GINT64_MODIFIER "u hits, %" G_GINT64_MODIFIER "u misses,\n",
+	       cache_stats.entries, cache_stats.hits, cache_stats.misses);
+	printf("# %" G_GINT64_MODIFIER "u evictions, %" G_GINT64_MODIFIER "u expirations\n",
+	       cache_stats.evictions, cache_stats.expirations);
 	printf("\n");
 
 	ipv4_hash_table = get_ipv4_hash_table();
@@ -36,20 +36,224 @@
 #include <wiretap/wtap.h>
 
 #include <wsutil/file_util.h>
+#include <wsutil/tempfile.h>
 
 #include <ui/alert_box.h>
 
 #include "export_object.h"
 
+/*
+ * Object payloads can add up to more than fits in memory, so they're
+ * appended to a temporary "spool" file as they're found, and each entry
+ * remembers where its pieces went. The file is shared by all export object
+ * lists and removed once the last entry using it has been freed.
+ */
+typedef struct {
+    gint64 offset;          /* Offset in the object */
+    gint64 spool_offset;    /* Offset in the spool file */
+    gint64 len;
+} eo_extent_t;
+
+#define EO_COPY_BUF_SIZE    65536
+
+static int spool_fd = -1;
+static char *spool_path = NULL;
+static gint64 spool_len = 0;
+static guint spool_entries = 0;
+
+/*
+ * Write len bytes to fd in chunks that ws_write() can take. Returns 0
+ * on success, otherwise an errno or WTAP_ERR_SHORT_WRITE.
+ *
+ * The third argument to _write() on Windows is an unsigned int,
+ * so, on Windows, that's the size of the third argument to
+ * ws_write().
+ *
+ * The third argument to write() on UN*X is a size_t, although
+ * the return value is an ssize_t, so one probably shouldn't
+ * write more than the max value of an ssize_t.
+ *
+ * In either case, there's no guarantee that a gint64 such as
+ * payload_len can be passed to ws_write(), so we write in
+ * chunks of, at most 2^31 bytes.
+ */
+static int
+eo_write_data(int fd, const guint8 *ptr, gint64 len)
+{
+    int bytes_to_write;
+    ssize_t bytes_written;
+
+    while (len != 0) {
+        if (len > 0x40000000)
+            bytes_to_write = 0x40000000;
+        else
+            bytes_to_write = (int)len;
+        bytes_written = ws_write(fd, ptr, bytes_to_write);
+        if (bytes_written <= 0)
+            return bytes_written < 0 ? errno : WTAP_ERR_SHORT_WRITE;
+        len -= bytes_written;
+        ptr += bytes_written;
+    }
+    return 0;
+}
+
+static gboolean
+spool_open(void)
+{
+    char *tmpname;
+
+    if (spool_fd != -1)
+        return TRUE;
+
+    spool_fd = create_tempfile(&tmpname, "wireshark_eo", NULL);
+    if (spool_fd == -1)
+        return FALSE;
+    spool_path = g_strdup(tmpname);
+    spool_len = 0;
+    return TRUE;
+}
+
+static void
+spool_release(void)
+{
+    if (spool_entries == 0 || --spool_entries > 0)
+        return;
+
+    ws_close(spool_fd);
+    ws_unlink(spool_path);
+    g_free(spool_path);
+    spool_path = NULL;
+    spool_fd = -1;
+    spool_len = 0;
+}
+
+gboolean
+eo_entry_write(export_object_entry_t *entry, gint64 offset, const guint8 *data, gint64 len)
+{
+    eo_extent_t extent;
+    gint64 end = offset + len;
+    guint8 *new_data;
+
+    if (len <= 0)
+        return TRUE;
+
+    if (!entry->payload_data && !entry->payload_extents && spool_open()) {
+        entry->payload_extents = g_array_new(FALSE, FALSE, sizeof(eo_extent_t));
+        spool_entries++;
+    }
+
+    if (entry->payload_extents) {
+        /* A failed write leaves spool_len alone, so the next one overwrites it */
+        if (ws_lseek64(spool_fd, spool_len, SEEK_SET) < 0 ||
+            eo_write_data(spool_fd, data, len) != 0)
+            return FALSE;
+
+        extent.offset = offset;
+        extent.spool_offset = spool_len;
+        extent.len = len;
+        g_array_append_val(entry->payload_extents, extent);
+        spool_len += len;
+    } else {
+        /* No spool file; keep the payload in memory. */
+        if (end > entry->payload_len || !entry->payload_data) {
+            /*
+             * The argument to g_try_realloc() is a gsize, the
+             * maximum value of which is G_MAXSIZE.
+             */
+            if ((guint64)end > G_MAXSIZE)
+                return FALSE;
+            new_data = (guint8 *)g_try_realloc(entry->payload_data, (gsize)MAX(end, entry->payload_len));
+            if (!new_data)
+                return FALSE;
+            if (end > entry->payload_len)
+                memset(new_data + entry->payload_len, 0, (size_t)(end - entry->payload_len));
+            entry->payload_data = new_data;
+        }
+        memcpy(entry->payload_data + offset, data, (size_t)len);
+    }
+
+    if (end > entry->payload_len)
+        entry->payload_len = end;
+    return TRUE;
+}
+
+void
+eo_entry_clear_payload(export_object_entry_t *entry)
+{
+    g_free(entry->payload_data);
+    entry->payload_data = NULL;
+    if (entry->payload_extents) {
+        g_array_free(entry->payload_extents, TRUE);
+        entry->payload_extents = NULL;
+        spool_release();
+    }
+    entry->payload_len = 0;
+}
+
+void
+eo_free_entry(export_object_entry_t *entry)
+{
+    if (!entry)
+        return;
+
+    g_free(entry->hostname);
+    g_free(entry->content_type);
+    g_free(entry->filename);
+    eo_entry_clear_payload(entry);
+    g_free(entry);
+}
+
+/*
+ * Copy a spooled payload to to_fd one extent at a time, so that only
+ * EO_COPY_BUF_SIZE bytes of it are in memory at once. Returns 0 on
+ * success, otherwise an errno or WTAP_ERR_SHORT_WRITE, with *read_err
+ * set if it was reading the spool file that failed.
+ */
+static int
+eo_copy_extents(int to_fd, export_object_entry_t *entry, gboolean *read_err)
+{
+    guint8 *buf = (guint8 *)g_malloc(EO_COPY_BUF_SIZE);
+    guint i;
+    int err = 0;
+
+    *read_err = FALSE;
+    for (i = 0; err == 0 && i < entry->payload_extents->len; i++) {
+        eo_extent_t *extent = &g_array_index(entry->payload_extents, eo_extent_t, i);
+        gint64 done = 0;
+
+        while (err == 0 && done < extent->len) {
+            int chunk = (int)MIN(extent->len - done, EO_COPY_BUF_SIZE);
+            ssize_t bytes_read;
+
+            if (ws_lseek64(spool_fd, extent->spool_offset + done, SEEK_SET) < 0) {
+                err = errno;
+                *read_err = TRUE;
+                break;
+            }
+            bytes_read = ws_read(spool_fd, buf, chunk);
+            if (bytes_read != chunk) {
+                err = bytes_read < 0 ? errno : EIO;
+                *read_err = TRUE;
+                break;
+            }
+            if (ws_lseek64(to_fd, extent->offset + done, SEEK_SET) < 0) {
+                err = errno;
+                break;
+            }
+            err = eo_write_data(to_fd, buf, chunk);
+            done += chunk;
+        }
+    }
+    g_free(buf);
+    return err;
+}
+
 gboolean
 eo_save_entry(const gchar *save_as_filename, export_object_entry_t *entry, gboolean show_err)
 {
     int to_fd;
-    gint64 bytes_left;
-    int bytes_to_write;
-    ssize_t bytes_written;
-    guint8 *ptr;
     int err;
+    gboolean read_err = FALSE;
 
     to_fd = ws_open(save_as_filename, O_WRONLY | O_CREAT | O_EXCL |
              O_BINARY, 0644);
@@ -59,39 +263,19 @@ eo_save_entry(const gchar *save_as_filename, export_object_entry_t *entry, gbool
         return FALSE;
     }
 
-    /*
-     * The third argument to _write() on Windows is an unsigned int,
-     * so, on Windows, that's the size of the third argument to
-     * ws_write().
-     *
-     * The third argument to write() on UN*X is a size_t, although
-     * the return value is an ssize_t, so one probably shouldn't
-     * write more than the max value of an ssize_t.
-     *
-     * In either case, there's no guarantee that a gint64 such as
-     * payload_len can be passed to ws_write(), so we write in
-     * chunks of, at most 2^31 bytes.
-     */
-    ptr = entry->payload_data;
-    bytes_left = entry->payload_len;
-    while (bytes_left != 0) {
-        if (bytes_left > 0x40000000)
-            bytes_to_write = 0x40000000;
-        else
-            bytes_to_write = (int)bytes_left;
-        bytes_written = ws_write(to_fd, ptr, bytes_to_write);
-        if(bytes_written <= 0) {
-            if (bytes_written < 0)
-                err = errno;
+    if (entry->payload_extents)
+        err = eo_copy_extents(to_fd, entry, &read_err);
+    else
+        err = eo_write_data(to_fd, entry->payload_data, entry->payload_len);
+    if (err != 0) {
+        if (show_err) {
+            if (read_err)
+                read_failure_alert_box(spool_path, err);
             else
-                err = WTAP_ERR_SHORT_WRITE;
-            if (show_err)
                 write_failure_alert_box(save_as_filename, err);
-            ws_close(to_fd);
-            return FALSE;
         }
-        bytes_left -= bytes_written;
-        ptr += bytes_written;
+        ws_close(to_fd);
+        return FALSE;
     }
     if (ws_close(to_fd) < 0) {
         if (show_err)
@@ -42,12 +42,30 @@ typedef struct _export_object_entry_t {
     /* We need to store a 64 bit integer to hold a file length
       (was guint payload_len;) */
     gint64 payload_len;
+    /* NULL if the payload has been written to the spool file; see
+       eo_entry_write() */
     guint8 *payload_data;
+    GArray *payload_extents;
 } export_object_entry_t;
 
 void object_list_add_entry(export_object_list_t *object_list, export_object_entry_t *entry);
 export_object_entry_t *object_list_get_entry(export_object_list_t *object_list, int row);
 
+/** Store len bytes of an object's payload at the given offset into it,
+ * growing payload_len as needed. Later writes replace overlapping parts
+ * of earlier ones and any gaps are saved as zeroes.
+ *
+ * Payloads are written to a temporary file shared by all entries rather
+ * than kept in memory, unless that file can't be created.
+ *
+ * @return FALSE if the data couldn't be stored.
+ */
+gboolean eo_entry_write(export_object_entry_t *entry, gint64 offset, const guint8 *data, gint64 len);
+/** Discard an entry's payload and set its length to 0. */
+void eo_entry_clear_payload(export_object_entry_t *entry);
+/** Free an entry and everything it holds. */
+void eo_free_entry(export_object_entry_t *entry);
+
 gboolean eo_save_entry(const gchar *save_as_filename, export_object_entry_t *entry, gboolean show_err);
 GString *eo_massage_str(const gchar *in_str, gsize maxlen, int dup);
 const char *ct2ext(const char *content_type);
@@ -48,14 +48,19 @@ eo_dicom_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt _U_,
            Still, the values will be freed when the export Object window is closed.
            Therefore, strings and buffers must be copied
         */
-        entry = (export_object_entry_t *)g_malloc(sizeof(export_object_entry_t));
+        entry = g_new0(export_object_entry_t, 1);
 
         entry->pkt_num = pinfo->num;
         entry->hostname = eo_info->hostname;
         entry->content_type = eo_info->content_type;
         entry->filename = g_strdup(g_path_get_basename(eo_info->filename));
-        entry->payload_len  = eo_info->payload_len;
-        entry->payload_data = eo_info->payload_data;
+        if (!eo_entry_write(entry, 0, eo_info->payload_data, eo_info->payload_len)) {
+            /* We couldn't store the payload; drop the object */
+            g_free(eo_info->payload_data);
+            eo_free_entry(entry);
+            return FALSE;
+        }
+        g_free(eo_info->payload_data);
 
         object_list_add_entry(object_list, entry);
 
@@ -43,15 +43,17 @@ eo_http_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt _U_,
     if(eo_info) { /* We have data waiting for us */
         /* These values will be freed when the Export Object window
          * is closed. */
-        entry = (export_object_entry_t *)g_malloc(sizeof(export_object_entry_t));
+        entry = g_new0(export_object_entry_t, 1);
 
         entry->pkt_num = pinfo->num;
         entry->hostname = g_strdup(eo_info->hostname);
         entry->content_type = g_strdup(eo_info->content_type);
         entry->filename = g_strdup(g_path_get_basename(eo_info->filename));
-        entry->payload_len = eo_info->payload_len;
-        entry->payload_data = (guint8 *)g_memdup(eo_info->payload_data,
-                           eo_info->payload_len);
+        if (!eo_entry_write(entry, 0, eo_info->payload_data, eo_info->payload_len)) {
+            /* We couldn't store the payload; drop the object */
+            eo_free_entry(entry);
+            return FALSE;
+        }
 
         object_list_add_entry(object_list, entry);
 
@@ -117,9 +117,6 @@ insert_chunk(active_file   *file, export_object_entry_t *entry, const smb_eo_t *
     guint64     chunk_offset     = eo_info->smb_file_offset;
     guint64     chunk_length     = eo_info->payload_len;
     guint64     chunk_end_offset = chunk_offset + chunk_length-1;
-/* Size of file in memory */
-    guint64     calculated_size  = chunk_offset + chunk_length;
-    gpointer    dest_memory_addr;
 
     /* Let's recalculate the file length and data gathered */
     if ((file->data_gathered == 0) && (nfreechunks == 0)) {
@@ -196,61 +193,12 @@ insert_chunk(active_file   *file, export_object_entry_t *entry, const smb_eo_t *
         }
     }
 
-    /* Now, let's insert the data chunk into memory
-       ...first, we shall be able to allocate the memory */
-    if (!entry->payload_data) {
-        /* This is a New file */
-        if (calculated_size > G_MAXSIZE) {
-            /*
-             * The argument to g_try_malloc() is
-             * a gsize, the maximum value of which is
-             * G_MAXSIZE.  If the calculated size is
-             * bigger than that, we just say the attempt
-             * to allocate memory failed.
-             */
-            entry->payload_data = NULL;
-        } else {
-            entry->payload_data = (guint8 *)g_try_malloc((gsize)calculated_size);
-            entry->payload_len  = calculated_size;
-        }
-        if (!entry->payload_data) {
-            /* Memory error */
-            file->is_out_of_memory = TRUE;
-        }
-    } else {
-        /* This is an existing file in memory */
-        if (calculated_size > (guint64) entry->payload_len &&
-            !file->is_out_of_memory) {
-            /* We need more memory */
-            if (calculated_size > G_MAXSIZE) {
-                /*
-                 * As for g_try_malloc(), so for
-                 * g_try_realloc().
-                 */
-                dest_memory_addr = NULL;
-            } else {
-                dest_memory_addr = g_try_realloc(
-                    entry->payload_data,
-                    (gsize)calculated_size);
-            }
-            if (!dest_memory_addr) {
-                /* Memory error */
-                file->is_out_of_memory = TRUE;
-                /* We don't have memory for this file.
-                   Free the current file content from memory */
-                g_free(entry->payload_data);
-                entry->payload_data = NULL;
-                entry->payload_len = 0;
-            } else {
-                entry->payload_data = (guint8 *)dest_memory_addr;
-                entry->payload_len = calculated_size;
-            }
-        }
-    }
-    /* ...then, put the chunk of the file in the right place */
-    if (!file->is_out_of_memory) {
-        dest_memory_addr = entry->payload_data + chunk_offset;
-        memmove(dest_memory_addr, eo_info->payload_data, eo_info->payload_len);
+    /* Now, let's put the chunk of the file in the right place */
+    if (!file->is_out_of_memory &&
+        !eo_entry_write(entry, chunk_offset, eo_info->payload_data, eo_info->payload_len)) {
+        /* We couldn't store it. Drop what we have of this file */
+        file->is_out_of_memory = TRUE;
+        eo_entry_clear_payload(entry);
     }
 }
 
@@ -350,9 +298,7 @@ eo_smb_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt _U_, const
 
     if (active_row == -1) { /* This is a new-tracked file */
         /* Construct the entry in the list of active files */
-        entry = (export_object_entry_t *)g_malloc(sizeof(export_object_entry_t));
-        entry->payload_data = NULL;
-        entry->payload_len = 0;
+        entry = g_new0(export_object_entry_t, 1);
         new_file = (active_file *)g_malloc(sizeof(active_file));
         new_file->tid = incoming_file.tid;
         new_file->uid = incoming_file.uid;
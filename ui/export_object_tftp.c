@@ -52,11 +52,11 @@ eo_tftp_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt _U_,
     export_object_entry_t *entry;
 
     GSList *block_iterator;
-    guint  payload_data_offset = 0;
+    gint64 payload_data_offset = 0;
     eo_info_dynamic_t *dynamic_info;
 
     /* These values will be freed when the Export Object window is closed. */
-    entry = (export_object_entry_t*)g_malloc(sizeof(export_object_entry_t));
+    entry = g_new0(export_object_entry_t, 1);
 
     /* Remember which frame had the last block of the file */
     entry->pkt_num = pinfo->num;
@@ -64,21 +64,24 @@ eo_tftp_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt _U_,
     /* Copy filename */
     entry->filename = g_strdup(g_path_get_basename(eo_info->filename));
 
-    /* Iterate over list of blocks and concatenate into contiguous memory */
-    entry->payload_len = eo_info->payload_len;
-    entry->payload_data = (guint8 *)g_try_malloc((gsize)entry->payload_len);
+    /* These 2 fields not used */
+    entry->hostname = NULL;
+    entry->content_type = NULL;
+
+    /* Iterate over list of blocks and store them one after the other */
     for (block_iterator = eo_info->block_list; block_iterator; block_iterator = block_iterator->next) {
         file_block_t *block = (file_block_t*)block_iterator->data;
-        memcpy(entry->payload_data + payload_data_offset,
-               block->data,
-               block->length);
+        if (!eo_entry_write(entry, payload_data_offset,
+                            (const guint8 *)block->data,
+                            block->length)) {
+            /* We couldn't store this block; drop the object */
+            eo_free_entry(entry);
+            entry = NULL;
+            break;
+        }
         payload_data_offset += block->length;
     }
 
-    /* These 2 fields not used */
-    entry->hostname = NULL;
-    entry->content_type = NULL;
-
     /* Add to list of entries to be cleaned up.  eo_info is only packet scope, so
        need to make list only of block list now */
     dynamic_info = (eo_info_dynamic_t*)g_malloc(sizeof(eo_info_dynamic_t));
@@ -86,6 +89,9 @@ eo_tftp_packet(void *tapdata, packet_info *pinfo, epan_dissect_t *edt _U_,
     dynamic_info->block_list = eo_info->block_list;
     s_dynamic_info_list = g_slist_append(s_dynamic_info_list, (eo_info_dynamic_t*)dynamic_info);
 
+    if (!entry)
+        return FALSE; /* State unchanged - no window updates needed */
+
     /* Pass out entry to the GUI */
     object_list_add_entry(object_list, entry);
 
@@ -2046,7 +2046,8 @@ init_ct_table_page(conversations_table *conversations, GtkWidget *vbox, gboolean
     gtk_tree_view_set_reorderable (conversations->table, TRUE);
 
     conversations->hash.conv_array = NULL;
-    conversations->hash.hashtable = NULL;
+    conversations->hash.hash_slots = NULL;
+    conversations->hash.num_hash_slots = 0;
     conversations->hash.user_data = conversations;
 
     sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(conversations->table));
@@ -111,14 +111,8 @@ eo_win_destroy_cb(GtkWindow *win _U_, gpointer data)
 	/* Free the GSList attributes */
 	while(slist) {
 		entry = (export_object_entry_t *)slist->data;
-
-		g_free(entry->hostname);
-		g_free(entry->content_type);
-		g_free(entry->filename);
-		g_free(entry->payload_data);
-
 		slist = slist->next;
-		g_free(entry);
+		eo_free_entry(entry);
 	}
 
 	/* Free the GSList elements */
@@ -261,6 +255,13 @@ static void
 eo_reset(void *tapdata)
 {
 	export_object_list_t *object_list = (export_object_list_t *)tapdata;
+	GSList *slist;
+
+	/* Free the entries of the previous pass; this also releases
+	   their payloads in the spool file */
+	for (slist = object_list->entries; slist; slist = slist->next)
+		eo_free_entry((export_object_entry_t *)slist->data);
+	g_slist_free(object_list->entries);
 
 	object_list->entries = NULL;
 	object_list->iter = NULL;
@@ -997,7 +997,8 @@ init_hostlist_table_page(hostlist_table *hosttable, GtkWidget *vbox, gboolean hi
     gtk_tree_view_set_reorderable (hosttable->table, TRUE);
 
     hosttable->hash.conv_array = NULL;
-    hosttable->hash.hashtable = NULL;
+    hosttable->hash.hash_slots = NULL;
+    hosttable->hash.num_hash_slots = 0;
     hosttable->hash.user_data = hosttable;
 
     sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(hosttable->table));
@@ -1308,6 +1308,7 @@ resolv_update_cb(gpointer data _U_)
 {
     /* Anything new show up? */
     if (host_name_lookup_process()) {
+        cf_invalidate_dissection_cache(&cfile, NULL);
         if (gtk_widget_get_window(pkt_scrollw))
             gdk_window_invalidate_rect(gtk_widget_get_window(pkt_scrollw), NULL, TRUE);
         if (gtk_widget_get_window(tv_scrollw))
@@ -1830,6 +1831,9 @@ main_cf_callback(gint event, gpointer data, gpointer user_data _U_)
     case(cf_cb_file_retap_finished):
         g_log(LOG_DOMAIN_MAIN, G_LOG_LEVEL_DEBUG, "Callback: Retap finished");
         break;
+    case(cf_cb_file_times_changed):
+        g_log(LOG_DOMAIN_MAIN, G_LOG_LEVEL_DEBUG, "Callback: Times changed");
+        break;
     case(cf_cb_file_fast_save_finished):
         g_log(LOG_DOMAIN_MAIN, G_LOG_LEVEL_DEBUG, "Callback: Fast save finished");
         main_cf_cb_file_rescan_finished(cf);
@@ -4126,6 +4126,7 @@ name_resolution_cb(GtkWidget *w, gpointer d _U_, gboolean* res_flag)
         *res_flag = FALSE;
     }
 
+    cf_invalidate_dissection_cache(&cfile, NULL);
     packet_list_recreate();
     redraw_packet_bytes_all();
 }
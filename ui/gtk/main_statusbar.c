@@ -1038,6 +1038,8 @@ statusbar_cf_callback(gint event, gpointer data, gpointer user_data _U_)
         break;
     case(cf_cb_file_retap_finished):
         break;
+    case(cf_cb_file_times_changed):
+        break;
     case(cf_cb_file_fast_save_finished):
         break;
     case(cf_cb_packet_selected):
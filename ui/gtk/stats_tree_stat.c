@@ -117,11 +117,11 @@ draw_gtk_node(stat_node* node)
 		}
 	}
 	if (node->st->pr->store && node->pr->iter) {
-		/* skip reserved columns and first entry in the stats_tree values */
-		/* list (the node name). These should already be set and static.  */
+		/* skip reserved columns. The node name is set again as well: */
+		/* nodes with bounded children may have been given another one. */
 		gtk_tree_store_set_valuesv(node->st->pr->store, node->pr->iter,
-				   columns+N_RESERVED_COL+1, values+N_RESERVED_COL+1,
-				   num_columns-N_RESERVED_COL-1);
+				   columns+N_RESERVED_COL, values+N_RESERVED_COL,
+				   num_columns-N_RESERVED_COL);
 	}
 
 	for (count = 0; count<num_columns; count++) {
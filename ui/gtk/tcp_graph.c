@@ -1754,6 +1754,7 @@ static void graph_destroy(struct gtk_graph *g)
     g_free(g->y_axis);
     g_free((gpointer )(g->title));
     graph_segment_list_free(&g->tg);
+    graph_stream_frames_free(&g->tg);
     graph_element_lists_free(g);
 
     g_free(g);
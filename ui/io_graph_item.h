@@ -101,6 +101,94 @@ reset_io_graph_items(io_graph_item_t *items, gsize count) {
     }
 }
 
+/** Add the values of one array of io_graph_item_t to another, e.g. to
+ * combine the results of taps run over different parts of a capture.
+ * Both arrays must use the same interval and time reference.
+ *
+ * @param items [in,out] Array containing the items to add to.
+ * @param src_items [in] Array containing the items to add.
+ * @param count [in] The number of items in the arrays.
+ */
+static inline void
+merge_io_graph_items(io_graph_item_t *items, const io_graph_item_t *src_items, gsize count) {
+    io_graph_item_t *item;
+    const io_graph_item_t *src;
+    gsize i;
+
+    for (i = 0; i < count; i++) {
+        item = &items[i];
+        src = &src_items[i];
+
+        /* If fields == 0 no min/max values have been seen yet. */
+        if (src->fields) {
+            if ((src->int_max > item->int_max) || (item->fields == 0)) {
+                item->int_max = src->int_max;
+            }
+            if ((src->int_min < item->int_min) || (item->fields == 0)) {
+                item->int_min = src->int_min;
+            }
+            if ((src->float_max > item->float_max) || (item->fields == 0)) {
+                item->float_max = src->float_max;
+            }
+            if ((src->float_min < item->float_min) || (item->fields == 0)) {
+                item->float_min = src->float_min;
+            }
+            if ((src->double_max > item->double_max) || (item->fields == 0)) {
+                item->double_max = src->double_max;
+            }
+            if ((src->double_min < item->double_min) || (item->fields == 0)) {
+                item->double_min = src->double_min;
+            }
+            if ((nstime_cmp(&src->time_max, &item->time_max) > 0) || (item->fields == 0)) {
+                item->time_max = src->time_max;
+            }
+            if ((nstime_cmp(&src->time_min, &item->time_min) < 0) || (item->fields == 0)) {
+                item->time_min = src->time_min;
+            }
+        }
+        item->int_tot    += src->int_tot;
+        item->float_tot  += src->float_tot;
+        item->double_tot += src->double_tot;
+        /* time_tot is also used for IOG_ITEM_UNIT_CALC_LOAD, where it can
+         * be set in intervals without frames. */
+        nstime_add(&item->time_tot, &src->time_tot);
+        item->fields     += src->fields;
+
+        if ((src->first_frame_in_invl != 0) &&
+            ((item->first_frame_in_invl == 0) ||
+             (src->first_frame_in_invl < item->first_frame_in_invl))) {
+            item->first_frame_in_invl = src->first_frame_in_invl;
+        }
+        if (src->last_frame_in_invl > item->last_frame_in_invl) {
+            item->last_frame_in_invl = src->last_frame_in_invl;
+        }
+
+        item->frames += src->frames;
+        item->bytes  += src->bytes;
+    }
+}
+
+/** Combine the items of one interval into those of a coarser one, e.g. to
+ * change the interval of a graph without retapping. Each item of dst_items
+ * holds the values of factor consecutive items of src_items, so the coarser
+ * interval must be a multiple of the finer one.
+ *
+ * @param dst_items [out] Array to hold the combined items. Must have room
+ *                  for (src_count + factor - 1) / factor items.
+ * @param src_items [in] Array containing the items to combine.
+ * @param src_count [in] The number of items in src_items.
+ * @param factor [in] The coarser interval divided by the finer one.
+ */
+static inline void
+combine_io_graph_items(io_graph_item_t *dst_items, const io_graph_item_t *src_items, gsize src_count, gsize factor) {
+    gsize i;
+
+    reset_io_graph_items(dst_items, (src_count + factor - 1) / factor);
+    for (i = 0; i < src_count; i++) {
+        merge_io_graph_items(&dst_items[i / factor], &src_items[i], 1);
+    }
+}
+
 /** Get the interval (array index) for a packet
  *
  * It is up to the caller to determine if the return value is valid.
@@ -213,6 +213,10 @@ void CaptureFile::captureFileEvent(int event, gpointer data)
         emit captureFileFlushTapsData();
         emit captureFileRetapFinished();
         break;
+    case(cf_cb_file_times_changed):
+        g_log(LOG_DOMAIN_MAIN, G_LOG_LEVEL_DEBUG, "Callback: Times changed");
+        emit captureFileTimesChanged();
+        break;
 
     case(cf_cb_file_fast_save_finished):
         // Ignored for now
@@ -95,6 +95,7 @@ signals:
     void captureFileRescanFinished() const;
     void captureFileRetapStarted() const;
     void captureFileRetapFinished() const;
+    void captureFileTimesChanged() const;
     void captureFileClosing() const;
     void captureFileClosed() const;
     void captureFileSaveStarted(const QString &file_path) const;
@@ -99,7 +99,9 @@ ConversationDialog::ConversationDialog(QWidget &parent, CaptureFile &cf, int cli
     updateWidgets();
     itemSelectionChanged();
 
-    cap_file_.delayedRetapPackets();
+    if (!loadCachedTables()) {
+        cap_file_.delayedRetapPackets();
+    }
 }
 
 ConversationDialog::~ConversationDialog()
@@ -510,6 +512,9 @@ public:
 ConversationTreeWidget::ConversationTreeWidget(QWidget *parent, register_ct_t* table) :
     TrafficTableTreeWidget(parent, table)
 {
+    merge_table_ = merge_conversation_table_data;
+    reset_table_ = reset_conversation_table_data;
+
     setColumnCount(CONV_NUM_COLUMNS);
 
     for (int i = 0; i < CONV_NUM_COLUMNS; i++) {
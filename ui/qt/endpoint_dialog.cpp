@@ -89,7 +89,9 @@ EndpointDialog::EndpointDialog(QWidget &parent, CaptureFile &cf, int cli_proto_i
 #endif
     itemSelectionChanged();
 
-    cap_file_.delayedRetapPackets();
+    if (!loadCachedTables()) {
+        cap_file_.delayedRetapPackets();
+    }
 }
 
 EndpointDialog::~EndpointDialog()
@@ -420,6 +422,9 @@ EndpointTreeWidget::EndpointTreeWidget(QWidget *parent, register_ct_t *table) :
   , has_geoip_data_(false)
 #endif
 {
+    merge_table_ = merge_hostlist_table_data;
+    reset_table_ = reset_hostlist_table_data;
+
     setColumnCount(ENDP_NUM_COLUMNS);
 
     for (int i = 0; i < ENDP_NUM_COLUMNS; i++) {
@@ -125,9 +125,14 @@ ExportObjectDialog::ExportObjectDialog(QWidget &parent, CaptureFile &cf, ObjectT
 
 ExportObjectDialog::~ExportObjectDialog()
 {
-    delete eo_ui_;
+    QTreeWidgetItem *item;
+
     export_object_list_.eod = NULL;
     removeTapListeners();
+    for (int i = 0; (item = eo_ui_->objectTree->topLevelItem(i)) != NULL; i++) {
+        eo_free_entry(item->data(0, Qt::UserRole).value<export_object_entry_t *>());
+    }
+    delete eo_ui_;
 }
 
 void ExportObjectDialog::addObjectEntry(export_object_entry_t *entry)
@@ -78,6 +78,10 @@ FollowStreamDialog::FollowStreamDialog(QWidget &parent, CaptureFile &cf, follow_
     client_packet_count_(0),
     server_packet_count_(0),
     turns_(0),
+    next_record_(NULL),
+    global_client_pos_(0),
+    global_server_pos_(0),
+    reading_page_(false),
     save_as_(false),
     use_regex_find_(false)
 {
@@ -137,6 +141,8 @@ FollowStreamDialog::FollowStreamDialog(QWidget &parent, CaptureFile &cf, follow_
             this, SLOT(fillHintLabel(int)));
     connect(ui->teStreamContent, SIGNAL(mouseClickedOnTextCursorPosition(int)),
             this, SLOT(goToPacketForTextPos(int)));
+    connect(ui->teStreamContent->verticalScrollBar(), SIGNAL(valueChanged(int)),
+            this, SLOT(contentScrolled(int)));
     connect(&cap_file_, SIGNAL(captureFileClosing()), this, SLOT(captureFileClosing()));
 
     fillHintLabel(-1);
@@ -153,8 +159,10 @@ void FollowStreamDialog::printStream()
 #ifndef QT_NO_PRINTER
     QPrinter printer(QPrinter::HighResolution);
     QPrintDialog dialog(&printer, this);
-    if (dialog.exec() == QDialog::Accepted)
+    if (dialog.exec() == QDialog::Accepted) {
+        readAllStream();
         ui->teStreamContent->print(&printer);
+    }
 #endif
 }
 
@@ -210,6 +218,19 @@ void FollowStreamDialog::goToPacketForTextPos(int text_pos)
     }
 }
 
+// Show the next page of the stream once the user scrolls to within a
+// screenful of the end of what's shown so far.
+void FollowStreamDialog::contentScrolled(int value)
+{
+    QScrollBar *sb = ui->teStreamContent->verticalScrollBar();
+
+    if (!next_record_ || reading_page_ || value < sb->maximum() - sb->pageStep()) {
+        return;
+    }
+
+    readStreamPage();
+}
+
 void FollowStreamDialog::updateWidgets(bool follow_in_progress)
 {
     bool enable = !follow_in_progress;
@@ -243,17 +264,22 @@ void FollowStreamDialog::findText(bool go_back)
 {
     if (ui->leFind->text().isEmpty()) return;
 
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 3, 0))
     bool found;
-    if (use_regex_find_) {
-        QRegExp regex(ui->leFind->text());
-        found = ui->teStreamContent->find(regex);
-    } else {
-        found = ui->teStreamContent->find(ui->leFind->text());
-    }
+    forever {
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 3, 0))
+        if (use_regex_find_) {
+            QRegExp regex(ui->leFind->text());
+            found = ui->teStreamContent->find(regex);
+        } else {
+            found = ui->teStreamContent->find(ui->leFind->text());
+        }
 #else
-    bool found = ui->teStreamContent->find(ui->leFind->text());
+        found = ui->teStreamContent->find(ui->leFind->text());
 #endif
+        // Look in the parts of the stream that haven't been shown yet.
+        if (found || !next_record_) break;
+        readStreamPage();
+    }
 
     if (found) {
         ui->teStreamContent->setFocus();
@@ -287,6 +313,9 @@ void FollowStreamDialog::saveAs()
         save_as_ = false;
 
         file_.close();
+
+        // Saving wrote the stream to the file instead of the text box.
+        readStream();
     }
 }
 
@@ -365,6 +394,7 @@ void FollowStreamDialog::resetStream()
 {
     GList *cur;
 
+    next_record_ = NULL;
     filter_out_filter_.clear();
     text_pos_to_packet_.clear();
     if (!data_out_filename_.isEmpty()) {
@@ -379,22 +409,45 @@ void FollowStreamDialog::resetStream()
     }
     g_list_free(follow_info_.payload);
     follow_info_.payload = NULL;
+    follow_info_.payload_last = NULL;
     follow_info_.client_port = 0;
 }
 
 frs_return_t
 FollowStreamDialog::readStream()
 {
+    next_record_ = NULL;
     ui->teStreamContent->clear();
     truncated_ = false;
     frs_return_t ret;
 
     client_buffer_count_ = 0;
     server_buffer_count_ = 0;
-    client_packet_count_ = 0;
-    server_packet_count_ = 0;
     last_packet_ = 0;
-    turns_ = 0;
+    global_client_pos_ = 0;
+    global_server_pos_ = 0;
+    next_record_ = follow_info_.payload;
+    countPackets();
+
+    ret = readStreamPage();
+    ui->teStreamContent->moveCursor(QTextCursor::Start);
+    return ret;
+}
+
+// Show the records from next_record_ on until another page_length_
+// characters have been added, or all of them if we're saving.
+frs_return_t
+FollowStreamDialog::readStreamPage()
+{
+    frs_return_t ret;
+
+    if (!next_record_) {
+        return FRS_OK;
+    }
+
+    reading_page_ = true;
+    QTextCursor text_cursor = ui->teStreamContent->textCursor();
+    int scroll_pos = ui->teStreamContent->verticalScrollBar()->value();
 
     switch(follow_type_) {
 
@@ -413,10 +466,74 @@ FollowStreamDialog::readStream()
         ret = (frs_return_t)0;
         break;
     }
-    ui->teStreamContent->moveCursor(QTextCursor::Start);
+
+    if (truncated_) {
+        next_record_ = NULL;
+    } else {
+        // addText moves the cursor to the end.
+        ui->teStreamContent->setTextCursor(text_cursor);
+        ui->teStreamContent->verticalScrollBar()->setValue(scroll_pos);
+    }
+    reading_page_ = false;
     return ret;
 }
 
+void FollowStreamDialog::readAllStream()
+{
+    while (next_record_ && !dialogClosed()) {
+        if (readStreamPage() != FRS_OK) break;
+    }
+}
+
+// The packet and turn counts in the hint cover the whole stream, not
+// just the pages shown so far.
+void FollowStreamDialog::countPackets()
+{
+    guint32 last_packet = 0;
+    gboolean last_from_server = FALSE;
+
+    client_packet_count_ = 0;
+    server_packet_count_ = 0;
+    turns_ = 0;
+
+    for (GList *cur = follow_info_.payload; cur; cur = g_list_next(cur)) {
+        gboolean is_from_server;
+        guint32 packet_num;
+
+        if (follow_type_ == FOLLOW_SSL) {
+            SslDecryptedRecord *rec = (SslDecryptedRecord *) cur->data;
+            is_from_server = rec->is_from_server;
+            packet_num = rec->packet_num;
+        } else {
+            follow_record_t *follow_record = (follow_record_t *) cur->data;
+            is_from_server = follow_record->is_server;
+            packet_num = follow_record->packet_num;
+        }
+
+        if ((is_from_server && follow_info_.show_stream == FROM_CLIENT) ||
+                (!is_from_server && follow_info_.show_stream == FROM_SERVER)) {
+            continue;
+        }
+
+        if (last_packet == 0) {
+            last_from_server = is_from_server;
+        }
+
+        if (packet_num != last_packet) {
+            last_packet = packet_num;
+            if (is_from_server) {
+                server_packet_count_++;
+            } else {
+                client_packet_count_++;
+            }
+            if (last_from_server != is_from_server) {
+                last_from_server = is_from_server;
+                turns_++;
+            }
+        }
+    }
+}
+
 /*
  * XXX - the routine pointed to by "print_line_fcn_p" doesn't get handed lines,
  * it gets handed bufferfuls.  That's fine for "follow_write_raw()"
@@ -437,26 +554,27 @@ FollowStreamDialog::readStream()
 frs_return_t
 FollowStreamDialog::readSslStream()
 {
-    guint32      global_client_pos = 0, global_server_pos = 0;
     guint32 *    global_pos;
     GList *      cur;
     frs_return_t frs_return;
     QElapsedTimer elapsed_timer;
+    int          page_end = ui->teStreamContent->document()->characterCount() + page_length_;
 
     elapsed_timer.start();
 
-    for (cur = follow_info_.payload; cur; cur = g_list_next(cur)) {
+    for (cur = next_record_; cur; cur = g_list_next(cur)) {
         if (dialogClosed()) break;
+        if (!save_as_ && ui->teStreamContent->document()->characterCount() >= page_end) break;
 
         SslDecryptedRecord * rec = (SslDecryptedRecord*) cur->data;
         gboolean             include_rec = FALSE;
 
         if (rec->is_from_server) {
-            global_pos = &global_server_pos;
+            global_pos = &global_server_pos_;
             include_rec = (follow_info_.show_stream == BOTH_HOSTS) ||
                     (follow_info_.show_stream == FROM_SERVER);
         } else {
-            global_pos = &global_client_pos;
+            global_pos = &global_client_pos_;
             include_rec = (follow_info_.show_stream == BOTH_HOSTS) ||
                     (follow_info_.show_stream == FROM_CLIENT);
         }
@@ -470,8 +588,10 @@ FollowStreamDialog::readSslStream()
 
             frs_return = showBuffer(buffer.data(), nchars,
                                      rec->is_from_server, rec->packet_num, global_pos);
-            if (frs_return == FRS_PRINT_ERROR)
+            if (frs_return == FRS_PRINT_ERROR) {
+                next_record_ = NULL;
                 return frs_return;
+            }
             if (elapsed_timer.elapsed() > info_update_freq_) {
                 fillHintLabel(ui->teStreamContent->textCursor().position());
                 wsApp->processEvents();
@@ -479,6 +599,7 @@ FollowStreamDialog::readSslStream()
             }
         }
     }
+    next_record_ = cur;
 
     return FRS_OK;
 }
@@ -490,6 +611,7 @@ FollowStreamDialog::followStream()
 }
 
 const int FollowStreamDialog::max_document_length_ = 500 * 1000 * 1000; // Just a guess
+const int FollowStreamDialog::page_length_ = 256 * 1000; // Also a guess
 void FollowStreamDialog::addText(QString text, gboolean is_from_server, guint32 packet_num)
 {
     if (save_as_ == true)
@@ -784,22 +906,7 @@ FollowStreamDialog::showBuffer(char *buffer, size_t nchars, gboolean is_from_ser
     }
     }
 
-    if (last_packet_ == 0) {
-        last_from_server_ = is_from_server;
-    }
-
-    if (packet_num != last_packet_) {
-        last_packet_ = packet_num;
-        if (is_from_server) {
-            server_packet_count_++;
-        } else {
-            client_packet_count_++;
-        }
-        if (last_from_server_ != is_from_server) {
-            last_from_server_ = is_from_server;
-            turns_++;
-        }
-    }
+    last_packet_ = packet_num;
 
     return FRS_OK;
 }
@@ -992,28 +1099,29 @@ void FollowStreamDialog::captureFileClosing()
 frs_return_t
 FollowStreamDialog::readFollowStream()
 {
-    guint32 global_client_pos = 0, global_server_pos = 0;
     guint32 *global_pos;
     gboolean skip;
     GList* cur;
     frs_return_t frs_return;
     follow_record_t *follow_record;
     QElapsedTimer elapsed_timer;
+    int page_end = ui->teStreamContent->document()->characterCount() + page_length_;
 
     elapsed_timer.start();
 
-    for (cur = follow_info_.payload; cur; cur = g_list_next(cur)) {
+    for (cur = next_record_; cur; cur = g_list_next(cur)) {
         if (dialogClosed()) break;
+        if (!save_as_ && ui->teStreamContent->document()->characterCount() >= page_end) break;
 
         follow_record = (follow_record_t *)cur->data;
         skip = FALSE;
         if (!follow_record->is_server) {
-            global_pos = &global_client_pos;
+            global_pos = &global_client_pos_;
             if(follow_info_.show_stream == FROM_SERVER) {
                 skip = TRUE;
             }
         } else {
-            global_pos = &global_server_pos;
+            global_pos = &global_server_pos_;
             if (follow_info_.show_stream == FROM_CLIENT) {
                 skip = TRUE;
             }
@@ -1031,8 +1139,10 @@ FollowStreamDialog::readFollowStream()
                         follow_record->is_server,
                         follow_record->packet_num,
                         global_pos);
-            if(frs_return == FRS_PRINT_ERROR)
+            if(frs_return == FRS_PRINT_ERROR) {
+                next_record_ = NULL;
                 return frs_return;
+            }
             if (elapsed_timer.elapsed() > info_update_freq_) {
                 fillHintLabel(ui->teStreamContent->textCursor().position());
                 wsApp->processEvents();
@@ -1041,6 +1151,8 @@ FollowStreamDialog::readFollowStream()
         }
     }
 
+    next_record_ = cur;
+
     return FRS_OK;
 }
 
@@ -77,6 +77,7 @@ private slots:
     void printStream();
     void fillHintLabel(int text_pos);
     void goToPacketForTextPos(int text_pos);
+    void contentScrolled(int value);
 
     void on_streamNumberSpinBox_valueChanged(int stream_num);
 
@@ -96,8 +97,11 @@ private:
                 guint32 packet_num, guint32 *global_pos);
 
     frs_return_t readStream();
+    frs_return_t readStreamPage();
+    void readAllStream();
     frs_return_t readFollowStream();
     frs_return_t readSslStream();
+    void countPackets();
 
     void followStream();
     void addText(QString text, gboolean is_from_server, guint32 packet_num);
@@ -115,6 +119,7 @@ private:
     show_type_t             show_type_;
     QString                 data_out_filename_;
     static const int        max_document_length_;
+    static const int        page_length_;
     bool                    truncated_;
     QString                 filter_out_filter_;
     int                     client_buffer_count_;
@@ -122,10 +127,15 @@ private:
     int                     client_packet_count_;
     int                     server_packet_count_;
     guint32                 last_packet_;
-    gboolean                last_from_server_;
     int                     turns_;
     QMap<int,guint32>       text_pos_to_packet_;
 
+    // Records are shown a page at a time as the user scrolls down.
+    GList                   *next_record_;
+    guint32                 global_client_pos_;
+    guint32                 global_server_pos_;
+    bool                    reading_page_;
+
     bool                    save_as_;
     bool                    use_regex_find_;
     QFile                   file_;
@@ -60,7 +60,7 @@
 //   http://www.qcustomplot.com/index.php/support/forum/62
 // - You can't manually set a graph color other than manually editing the io_graphs
 //   UAT. We should add a "graph color" preference.
-// - We retap and redraw more than we should.
+// - We redraw more than we should.
 // - Smoothing doesn't seem to match GTK+
 
 // To do:
@@ -405,7 +405,6 @@ void IOGraphDialog::syncGraphSettings(QTreeWidgetItem *item)
     if (!iog) return;
 
     bool visible = item->checkState(name_col_) == Qt::Checked;
-    bool retap = !iog->visible() && visible;
 
     iog->setName(item->text(name_col_));
 
@@ -420,6 +419,10 @@ void IOGraphDialog::syncGraphSettings(QTreeWidgetItem *item)
 
     iog->setInterval(ui->intervalComboBox->itemData(ui->intervalComboBox->currentIndex()).toInt());
 
+    // Graphs are tapped while hidden, so showing one only needs a retap if
+    // its settings changed since then.
+    bool retap = iog->needsRetap();
+
     ui->graphTreeWidget->blockSignals(true); // setFlags emits itemChanged
     if (!iog->configError().isEmpty()) {
         hint_err_ = iog->configError();
@@ -1169,6 +1172,8 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
     int interval = ui->intervalComboBox->itemData(ui->intervalComboBox->currentIndex()).toInt();
     bool need_retap = false;
 
+    // Coarser intervals are combined from the data we already have. Finer
+    // ones need a retap.
     for (int i = 0; i < ui->graphTreeWidget->topLevelItemCount(); i++) {
         QTreeWidgetItem *item = ui->graphTreeWidget->topLevelItem(i);
         IOGraph *iog = NULL;
@@ -1176,7 +1181,7 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
             iog = item->data(name_col_, Qt::UserRole).value<IOGraph *>();
             if (iog) {
                 iog->setInterval(interval);
-                if (iog->visible()) {
+                if (iog->visible() && iog->needsRetap()) {
                     need_retap = true;
                 }
             }
@@ -1185,6 +1190,8 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 
     if (need_retap) {
         scheduleRetap(true);
+    } else {
+        scheduleRecalc(true);
     }
 
     updateLegend();
@@ -1644,7 +1651,12 @@ IOGraph::IOGraph(QCustomPlot *parent) :
     graph_(NULL),
     bars_(NULL),
     hf_index_(-1),
-    cur_idx_(-1)
+    interval_(0),
+    cur_idx_(-1),
+    tap_interval_(0),
+    tap_truncated_(false),
+    tap_stale_(true),
+    interval_items_stale_(true)
 {
     Q_ASSERT(parent_ != NULL);
     graph_ = parent_->addGraph(parent_->xAxis, parent_->yAxis);
@@ -1725,6 +1737,10 @@ void IOGraph::setFilter(const QString &filter)
         g_string_free(error_string, TRUE);
         return;
     } else {
+        if (full_filter != tap_filter_) {
+            tap_filter_ = full_filter;
+            tap_stale_ = true;
+        }
         if (filter_.compare(filter) && visible_) {
             emit requestRetap();
         }
@@ -1858,6 +1874,11 @@ void IOGraph::setValueUnits(int val_units)
         val_units_ = (io_graph_item_unit_t)val_units;
 
         if (old_val_units != val_units) {
+            // LOAD spreads each value over the intervals it spans. Other
+            // units don't, so switching to or from it needs new tap data.
+            if (old_val_units == IOG_ITEM_UNIT_CALC_LOAD || val_units == IOG_ITEM_UNIT_CALC_LOAD) {
+                tap_stale_ = true;
+            }
             setFilter(filter_); // Check config & prime vu field
             if (val_units < IOG_ITEM_UNIT_CALC_SUM) {
                 emit requestRecalc();
@@ -1919,8 +1940,8 @@ double IOGraph::startOffset()
 int IOGraph::packetFromTime(double ts)
 {
     int idx = ts * 1000 / interval_;
-    if (idx >= 0 && idx < (int) cur_idx_) {
-        return items_[idx].last_frame_in_invl;
+    if (idx >= 0 && idx < maxInterval()) {
+        return intervalItems()[idx].last_frame_in_invl;
     }
     return -1;
 }
@@ -1929,6 +1950,8 @@ void IOGraph::clearAllData()
 {
     cur_idx_ = -1;
     reset_io_graph_items(items_, max_io_items_);
+    interval_items_.clear();
+    interval_items_stale_ = true;
     if (graph_) {
         graph_->clearData();
     }
@@ -2002,7 +2025,9 @@ void IOGraph::recalcGraphData(capture_file *cap_file)
         x_axis = bars_->keyAxis();
     }
 
-    if (moving_avg_period_ > 0 && cur_idx_ >= 0) {
+    int max_idx = maxInterval();
+
+    if (moving_avg_period_ > 0 && max_idx >= 0) {
         /* "Warm-up phase" - calculate average on some data not displayed;
          * just to make sure average on leftmost and rightmost displayed
          * values is as reliable as possible
@@ -2018,7 +2043,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file)
         mavg_in_average_count++;
         for (warmup_interval = interval_;
             ((warmup_interval < (0 + (moving_avg_period_ / 2) * (guint64)interval_)) &&
-             (warmup_interval <= (cur_idx_ * (guint64)interval_)));
+             (warmup_interval <= (max_idx * (guint64)interval_)));
              warmup_interval += interval_) {
 
             mavg_cumulated += getItemValue((int)warmup_interval / interval_, cap_file);
@@ -2028,7 +2053,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file)
         mavg_to_add = warmup_interval;
     }
 
-    for (int i = 0; i <= cur_idx_; i++) {
+    for (int i = 0; i <= max_idx; i++) {
         double ts = (double) i * interval_ / 1000;
         if (x_axis && x_axis->tickLabelType() == QCPAxis::ltDateTime) {
             ts += start_time_;
@@ -2044,7 +2069,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file)
                     mavg_cumulated -= getItemValue((int)mavg_to_remove / interval_, cap_file);
                     mavg_to_remove += interval_;
                 }
-                if (mavg_to_add <= (unsigned int) cur_idx_ * interval_) {
+                if (mavg_to_add <= (unsigned int) max_idx * interval_) {
                     mavg_in_average_count++;
                     mavg_cumulated += getItemValue((int)mavg_to_add / interval_, cap_file);
                     mavg_to_add += interval_;
@@ -2082,9 +2107,68 @@ void IOGraph::reloadValueUnitField()
 
 void IOGraph::setInterval(int interval)
 {
+    if (interval != interval_) {
+        interval_items_stale_ = true;
+    }
     interval_ = interval;
 }
 
+// Our tap data can be shown at any multiple of the interval it was tapped
+// with, unless packets were dropped because there were too many intervals.
+bool IOGraph::needsRetap() const
+{
+    if (tap_stale_ || intervalFactor() < 1) {
+        return true;
+    }
+    return intervalFactor() > 1 && tap_truncated_;
+}
+
+int IOGraph::maxInterval() const
+{
+    int factor = intervalFactor();
+
+    if (cur_idx_ < 0 || factor < 1) {
+        return -1;
+    }
+    return cur_idx_ / factor;
+}
+
+// The number of tapped items in each item at the current interval, or 0
+// if they can't be combined into it.
+int IOGraph::intervalFactor() const
+{
+    if (tap_interval_ <= 0 || interval_ < tap_interval_ || interval_ % tap_interval_ != 0) {
+        return 0;
+    }
+    return interval_ / tap_interval_;
+}
+
+const io_graph_item_t *IOGraph::intervalItems() const
+{
+    if (intervalFactor() > 1) {
+        combineIntervalItems();
+        return interval_items_.constData();
+    }
+    return items_;
+}
+
+void IOGraph::combineIntervalItems() const
+{
+    int factor = intervalFactor();
+
+    if (!interval_items_stale_) {
+        return;
+    }
+    interval_items_stale_ = false;
+
+    if (factor <= 1 || cur_idx_ < 0) {
+        interval_items_.clear();
+        return;
+    }
+    interval_items_.resize(cur_idx_ / factor + 1);
+    combine_io_graph_items(interval_items_.data(), items_, cur_idx_ + 1, factor);
+}
+
 // Get the value at the given interval (idx) for the current value unit.
 // Adapted from get_it_value in gtk/io_stat.c.
 double IOGraph::getItemValue(int idx, const capture_file *cap_file) const
@@ -2094,9 +2178,9 @@ double IOGraph::getItemValue(int idx, const capture_file *cap_file) const
     const io_graph_item_t *item;
     guint32    interval;
 
-    g_assert(idx < max_io_items_);
+    g_assert(idx <= maxInterval());
 
-    item = &items_[idx];
+    item = &intervalItems()[idx];
 
     // Basic units
     switch (val_units_) {
@@ -2221,7 +2305,7 @@ double IOGraph::getItemValue(int idx, const capture_file *cap_file) const
             }
             break;
         case IOG_ITEM_UNIT_CALC_LOAD:
-            if (idx == (int)cur_idx_ && cap_file) {
+            if (idx == maxInterval() && cap_file) {
                 interval = (guint32)((cap_file->elapsed_time.secs*1000) +
                        ((cap_file->elapsed_time.nsecs+500000)/1000000));
                 interval -= (interval_ * idx);
@@ -2248,6 +2332,9 @@ void IOGraph::tapReset(void *iog_ptr)
 
 //    qDebug() << "=tapReset" << iog->name_;
     iog->clearAllData();
+    iog->tap_interval_ = iog->interval_;
+    iog->tap_truncated_ = false;
+    iog->tap_stale_ = false;
 }
 
 // "tap_packet" callback for register_tap_listener
@@ -2258,12 +2345,14 @@ gboolean IOGraph::tapPacket(void *iog_ptr, packet_info *pinfo, epan_dissect_t *e
         return FALSE;
     }
 
-    int idx = get_io_graph_index(pinfo, iog->interval_);
+    int idx = get_io_graph_index(pinfo, iog->tap_interval_);
     bool recalc = false;
 
     /* some sanity checks */
     if ((idx < 0) || (idx >= max_io_items_)) {
         iog->cur_idx_ = max_io_items_ - 1;
+        iog->tap_truncated_ = true;
+        iog->interval_items_stale_ = true;
         return FALSE;
     }
 
@@ -2287,7 +2376,8 @@ gboolean IOGraph::tapPacket(void *iog_ptr, packet_info *pinfo, epan_dissect_t *e
         adv_edt = edt;
     }
 
-    if (!update_io_graph_item(iog->items_, idx, pinfo, adv_edt, iog->hf_index_, iog->val_units_, iog->interval_)) {
+    iog->interval_items_stale_ = true;
+    if (!update_io_graph_item(iog->items_, idx, pinfo, adv_edt, iog->hf_index_, iog->val_units_, iog->tap_interval_)) {
         return FALSE;
     }
 
@@ -35,6 +35,7 @@
 #include <QIcon>
 #include <QMenu>
 #include <QTextStream>
+#include <QVector>
 
 class QComboBox;
 class QLineEdit;
@@ -78,6 +79,7 @@ public:
     void setValueUnitField(const QString &vu_field);
     unsigned int movingAveragePeriod() { return moving_avg_period_; }
     void setInterval(int interval);
+    bool needsRetap() const;
     bool addToLegend();
     bool removeFromLegend();
     QCPGraph *graph() { return graph_; }
@@ -85,7 +87,7 @@ public:
     double startOffset();
     int packetFromTime(double ts);
     double getItemValue(int idx, const capture_file *cap_file) const;
-    int maxInterval () const { return cur_idx_; }
+    int maxInterval () const;
 
     void clearAllData();
 
@@ -111,6 +113,10 @@ private:
     static gboolean tapPacket(void *iog_ptr, packet_info *pinfo, epan_dissect_t *edt, const void *data);
     static void tapDraw(void *iog_ptr);
 
+    int intervalFactor() const;
+    const io_graph_item_t *intervalItems() const;
+    void combineIntervalItems() const;
+
     QCustomPlot *parent_;
     QString config_err_;
     QString name_;
@@ -129,6 +135,14 @@ private:
     // much as is feasible.
     io_graph_item_t items_[max_io_items_];
     int cur_idx_;
+    // items_ hold the data at the interval we last tapped with. Any multiple
+    // of that interval is shown by combining them into interval_items_.
+    QString tap_filter_;
+    int tap_interval_;
+    bool tap_truncated_; // Packets past max_io_items_ were dropped.
+    bool tap_stale_; // The filter or value units changed since the last tap.
+    mutable QVector<io_graph_item_t> interval_items_;
+    mutable bool interval_items_stale_;
 };
 
 namespace Ui {
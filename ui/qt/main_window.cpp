@@ -437,6 +437,8 @@ MainWindow::MainWindow(QWidget *parent) :
     packet_list_->setProtoTree(proto_tree_);
     packet_list_->setByteViewTab(byte_view_tab_);
     packet_list_->installEventFilter(this);
+    connect(main_ui_->searchFrame, SIGNAL(framesMarked()),
+            packet_list_, SLOT(redrawMarkedFrames()));
 
     main_welcome_ = main_ui_->welcomePage;
 
@@ -2123,6 +2125,7 @@ void MainWindow::setMenusForFileSet(bool enable_list_files) {
     main_ui_->actionFileSetListFiles->setEnabled(enable_list_files);
     main_ui_->actionFileSetNextFile->setEnabled(enable_next);
     main_ui_->actionFileSetPreviousFile->setEnabled(enable_prev);
+    main_ui_->actionFileSetOpenAll->setEnabled(enable_next || enable_prev);
 }
 
 void MainWindow::setWindowIcon(const QIcon &icon) {
@@ -368,6 +368,7 @@ private slots:
     void on_actionFileSetListFiles_triggered();
     void on_actionFileSetNextFile_triggered();
     void on_actionFileSetPreviousFile_triggered();
+    void on_actionFileSetOpenAll_triggered();
     void on_actionFileExportPackets_triggered();
     void on_actionFileExportAsPlainText_triggered();
     // We're dropping PostScript exports
@@ -1667,6 +1667,28 @@ void MainWindow::on_actionFileSetPreviousFile_triggered()
     }
 }
 
+void MainWindow::on_actionFileSetOpenAll_triggered()
+{
+    guint count;
+    int err;
+    // Copy the names now; closing the current file deletes the set.
+    gchar **filenames = fileset_get_filenames(&count);
+
+    if (count > 0 && testCaptureFileClose(tr(" before opening the file set"))) {
+        CaptureFile::globalCapFile()->window = this;
+        if (cf_open_set(CaptureFile::globalCapFile(), (const char *const *)filenames, count, WTAP_TYPE_AUTO, &err) == CF_OK) {
+            if (cf_read(CaptureFile::globalCapFile(), FALSE) == CF_READ_ABORTED) {
+                capture_file_.setCapFile(NULL);
+            } else {
+                main_ui_->statusBar->showExpert();
+            }
+        } else {
+            CaptureFile::globalCapFile()->window = NULL;
+        }
+    }
+    g_strfreev(filenames);
+}
+
 void MainWindow::on_actionFileExportPackets_triggered()
 {
     exportSelectedPackets();
@@ -2229,6 +2251,9 @@ void MainWindow::setNameResolution()
     gbl_resolv_flags.network_name = main_ui_->actionViewNameResolutionNetwork->isChecked() ? TRUE : FALSE;
     gbl_resolv_flags.transport_name = main_ui_->actionViewNameResolutionTransport->isChecked() ? TRUE : FALSE;
 
+    if (capture_file_.capFile()) {
+        cf_invalidate_dissection_cache(capture_file_.capFile(), NULL);
+    }
     if (packet_list_) {
         packet_list_->resetColumns();
     }
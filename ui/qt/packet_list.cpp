@@ -380,7 +380,7 @@ PacketList::PacketList(QWidget *parent) :
 
     connect(packet_list_model_, SIGNAL(goToPacket(int)), this, SLOT(goToPacket(int)));
     connect(packet_list_model_, SIGNAL(itemHeightChanged(const QModelIndex&)), this, SLOT(updateRowHeights(const QModelIndex&)));
-    connect(wsApp, SIGNAL(addressResolutionChanged()), this, SLOT(redrawVisiblePackets()));
+    connect(wsApp, SIGNAL(addressResolutionChanged()), this, SLOT(addressesResolved()));
 
     header()->setContextMenuPolicy(Qt::CustomContextMenu);
     connect(header(), SIGNAL(customContextMenuRequested(QPoint)),
@@ -701,6 +701,15 @@ void PacketList::redrawVisiblePackets() {
     drawCurrentPacket();
 }
 
+// New names arrived. Cached dissections still show the old ones.
+void PacketList::addressesResolved()
+{
+    if (cap_file_) {
+        cf_invalidate_dissection_cache(cap_file_, NULL);
+    }
+    redrawVisiblePackets();
+}
+
 void PacketList::resetColumns()
 {
     packet_list_model_->resetColumns();
@@ -1128,6 +1137,16 @@ void PacketList::markAllDisplayedFrames(bool set)
     packets_bar_update();
 }
 
+// Frames were marked elsewhere, e.g. by the search bar.
+void PacketList::redrawMarkedFrames()
+{
+    if (!cap_file_) return;
+
+    create_far_overlay_ = true;
+    packets_bar_update();
+    redrawVisiblePackets();
+}
+
 void PacketList::ignoreFrame()
 {
     if (!cap_file_ || !packet_list_model_) return;
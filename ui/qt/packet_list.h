@@ -150,6 +150,7 @@ public slots:
     void goToPacket(int packet, int hf_id);
     void markFrame();
     void markAllDisplayedFrames(bool set);
+    void redrawMarkedFrames();
     void ignoreFrame();
     void ignoreAllDisplayedFrames(bool set);
     void setTimeReference();
@@ -172,6 +173,7 @@ private slots:
     void vScrollBarActionTriggered(int);
     void drawFarOverlay();
     void drawNearOverlay();
+    void addressesResolved();
 };
 
 #endif // PACKET_LIST_H
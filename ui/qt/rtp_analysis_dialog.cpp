@@ -80,12 +80,12 @@ enum { rtp_analysis_type_ = 1000 };
 class RtpAnalysisTreeWidgetItem : public QTreeWidgetItem
 {
 public:
-    RtpAnalysisTreeWidgetItem(QTreeWidget *tree, tap_rtp_stat_t *statinfo, packet_info *pinfo, const struct _rtp_info *rtpinfo) :
+    RtpAnalysisTreeWidgetItem(QTreeWidget *tree, tap_rtp_stat_t *statinfo, const rtp_packet_index_t *pkt) :
         QTreeWidgetItem(tree, rtp_analysis_type_)
     {
-        frame_num_ = pinfo->num;
-        sequence_num_ = rtpinfo->info_seq_num;
-        pkt_len_ = pinfo->fd->pkt_len;
+        frame_num_ = pkt->frame_num;
+        sequence_num_ = pkt->seq_num;
+        pkt_len_ = pkt->pkt_len;
         flags_ = statinfo->flags;
         if (flags_ & STAT_FLAG_FIRST) {
             delta_ = 0.0;
@@ -97,7 +97,7 @@ public:
             skew_ = statinfo->skew;
         }
         bandwidth_ = statinfo->bandwidth;
-        marker_ = rtpinfo->info_marker_set ? true : false;
+        marker_ = pkt->marker_set ? true : false;
         ok_ = false;
 
         QColor bg_color = QColor();
@@ -256,7 +256,9 @@ RtpAnalysisDialog::RtpAnalysisDialog(QWidget &parent, CaptureFile &cf, struct _r
     packet_count_rev_(0),
     setup_frame_number_rev_(0),
     num_streams_(0),
-    save_payload_error_(TAP_RTP_NO_ERROR)
+    save_payload_error_(TAP_RTP_NO_ERROR),
+    payloads_saved_(false),
+    tap_payloads_only_(false)
 {
     ui->setupUi(this);
     loadGeometry(parent.width() * 4 / 5, parent.height() * 4 / 5);
@@ -358,6 +360,7 @@ RtpAnalysisDialog::RtpAnalysisDialog(QWidget &parent, CaptureFile &cf, struct _r
         packet_count_fwd_ = stream_fwd->packet_count;
         setup_frame_number_fwd_ = stream_fwd->setup_frame_number;
         nstime_copy(&start_rel_time_fwd_, &stream_fwd->start_rel_time);
+        copyIndex(fwd_index_, stream_fwd);
         num_streams_++;
         if (stream_rev) {
             copy_address(&src_rev_, &(stream_rev->src_addr));
@@ -368,6 +371,7 @@ RtpAnalysisDialog::RtpAnalysisDialog(QWidget &parent, CaptureFile &cf, struct _r
             packet_count_rev_ = stream_rev->packet_count;
             setup_frame_number_rev_ = stream_rev->setup_frame_number;
             nstime_copy(&start_rel_time_rev_, &stream_rev->start_rel_time);
+            copyIndex(rev_index_, stream_rev);
             num_streams_++;
         }
     } else {
@@ -378,9 +382,21 @@ RtpAnalysisDialog::RtpAnalysisDialog(QWidget &parent, CaptureFile &cf, struct _r
         err_str_ = tr("No streams found.");
     }
 
-    registerTapListener("rtp", this, NULL, 0, tapReset, tapPacket, tapDraw);
-    cap_file_.retapPackets();
-    removeTapListeners();
+    // The RTP streams tap has already analysed every packet of the streams
+    // we were given. If its index covers what we would tap, replay it and
+    // leave saving the payloads until they're asked for.
+    if (indexComplete(fwd_index_, packet_count_fwd_) && indexComplete(rev_index_, packet_count_rev_)) {
+        resetStatistics();
+        replayIndex(true);
+        replayIndex(false);
+    } else {
+        registerTapListener("rtp", this, NULL, 0, tapReset, tapPacket, tapDraw);
+        cap_file_.retapPackets();
+        removeTapListeners();
+        payloads_saved_ = true;
+    }
+    fwd_index_.clear();
+    rev_index_.clear();
 
     connect(ui->tabWidget, SIGNAL(currentChanged(int)),
             this, SLOT(updateWidgets()));
@@ -432,8 +448,9 @@ void RtpAnalysisDialog::updateWidgets()
         hint.append(tr(" G: Go to packet, N: Next problem packet"));
     }
 
-    bool enable_save_fwd_audio = fwd_tempfile_->isOpen() && (save_payload_error_ == TAP_RTP_NO_ERROR);
-    bool enable_save_rev_audio = rev_tempfile_->isOpen() && (save_payload_error_ == TAP_RTP_NO_ERROR);
+    bool can_save_payloads = payloads_saved_ || !file_closed_;
+    bool enable_save_fwd_audio = fwd_tempfile_->isOpen() && can_save_payloads && (save_payload_error_ == TAP_RTP_NO_ERROR);
+    bool enable_save_rev_audio = rev_tempfile_->isOpen() && can_save_payloads && (save_payload_error_ == TAP_RTP_NO_ERROR);
     ui->actionSaveAudio->setEnabled(enable_save_fwd_audio && enable_save_rev_audio);
     ui->actionSaveForwardAudio->setEnabled(enable_save_fwd_audio);
     ui->actionSaveReverseAudio->setEnabled(enable_save_rev_audio);
@@ -626,7 +643,11 @@ void RtpAnalysisDialog::tapReset(void *tapinfo_ptr)
     RtpAnalysisDialog *rtp_analysis_dialog = dynamic_cast<RtpAnalysisDialog *>((RtpAnalysisDialog*)tapinfo_ptr);
     if (!rtp_analysis_dialog) return;
 
-    rtp_analysis_dialog->resetStatistics();
+    if (rtp_analysis_dialog->tap_payloads_only_) {
+        rtp_analysis_dialog->resetPayloads();
+    } else {
+        rtp_analysis_dialog->resetStatistics();
+    }
 }
 
 gboolean RtpAnalysisDialog::tapPacket(void *tapinfo_ptr, packet_info *pinfo, epan_dissect_t *, const void *rtpinfo_ptr)
@@ -667,11 +688,88 @@ gboolean RtpAnalysisDialog::tapPacket(void *tapinfo_ptr, packet_info *pinfo, epa
 void RtpAnalysisDialog::tapDraw(void *tapinfo_ptr)
 {
     RtpAnalysisDialog *rtp_analysis_dialog = dynamic_cast<RtpAnalysisDialog *>((RtpAnalysisDialog*)tapinfo_ptr);
-    if (!rtp_analysis_dialog) return;
+    if (!rtp_analysis_dialog || rtp_analysis_dialog->tap_payloads_only_) return;
     rtp_analysis_dialog->updateStatistics();
 }
 
-void RtpAnalysisDialog::resetStatistics()
+void RtpAnalysisDialog::copyIndex(QVector<rtp_packet_index_t> &index, const _rtp_stream_info *stream)
+{
+    index.clear();
+    if (!stream || !stream->packet_index) return;
+
+    const rtp_packet_index_t *pkts = (const rtp_packet_index_t *)stream->packet_index->data;
+    index.reserve(stream->packet_index->len);
+    for (guint i = 0; i < stream->packet_index->len; i++) {
+        index.append(pkts[i]);
+    }
+}
+
+// True if the index holds every packet tapPacket would pick for the
+// stream, i.e. the stream has no non-RTPv2 packets and none of them are
+// hidden by the display filter. An empty stream is trivially complete.
+bool RtpAnalysisDialog::indexComplete(const QVector<rtp_packet_index_t> &index, guint32 packet_count)
+{
+    capture_file *cf = cap_file_.capFile();
+
+    if (!cf || !cf->frames) return false;
+    if ((guint32) index.size() != packet_count) return false;
+
+    foreach (const rtp_packet_index_t &pkt, index) {
+        frame_data *fdata = frame_data_sequence_find(cf->frames, pkt.frame_num);
+        if (!fdata || !fdata->flags.passed_dfilter) return false;
+    }
+    return true;
+}
+
+void RtpAnalysisDialog::replayIndex(bool forward)
+{
+    const QVector<rtp_packet_index_t> &index = forward ? fwd_index_ : rev_index_;
+    tap_rtp_stat_t *statinfo = forward ? &fwd_statinfo_ : &rev_statinfo_;
+    QTreeWidget *tree = forward ? ui->forwardTreeWidget : ui->reverseTreeWidget;
+    QVector<double> &time_vals = forward ? fwd_time_vals_ : rev_time_vals_;
+    QVector<double> &jitter_vals = forward ? fwd_jitter_vals_ : rev_jitter_vals_;
+    QVector<double> &diff_vals = forward ? fwd_diff_vals_ : rev_diff_vals_;
+    QVector<double> &delta_vals = forward ? fwd_delta_vals_ : rev_delta_vals_;
+
+    time_vals.reserve(index.size());
+    jitter_vals.reserve(index.size());
+    diff_vals.reserve(index.size());
+    delta_vals.reserve(index.size());
+
+    for (int i = 0; i < index.size(); i++) {
+        rtp_packet_analyse_index(statinfo, &index[i]);
+        new RtpAnalysisTreeWidgetItem(tree, statinfo, &index[i]);
+
+        time_vals.append(statinfo->time / 1000);
+        jitter_vals.append(statinfo->jitter);
+        diff_vals.append(statinfo->diff);
+        delta_vals.append(statinfo->delta);
+    }
+}
+
+// Fill in the payload temp files. savePayload needs the statistics as
+// they were at each packet, so they're recomputed and the displayed
+// ones put back afterwards.
+void RtpAnalysisDialog::retapPayloads()
+{
+    if (payloads_saved_ || file_closed_) return;
+
+    tap_rtp_stat_t fwd_statinfo = fwd_statinfo_;
+    tap_rtp_stat_t rev_statinfo = rev_statinfo_;
+
+    ui->hintLabel->setText(tr("Saving payloads" UTF8_HORIZONTAL_ELLIPSIS));
+    tap_payloads_only_ = true;
+    registerTapListener("rtp", this, NULL, 0, tapReset, tapPacket, tapDraw);
+    cap_file_.retapPackets();
+    removeTapListeners();
+    tap_payloads_only_ = false;
+    payloads_saved_ = true;
+
+    fwd_statinfo_ = fwd_statinfo;
+    rev_statinfo_ = rev_statinfo;
+}
+
+void RtpAnalysisDialog::resetPayloads()
 {
     memset(&fwd_statinfo_, 0, sizeof(tap_rtp_stat_t));
     memset(&rev_statinfo_, 0, sizeof(tap_rtp_stat_t));
@@ -681,6 +779,14 @@ void RtpAnalysisDialog::resetStatistics()
     fwd_statinfo_.reg_pt = PT_UNDEFINED;
     rev_statinfo_.reg_pt = PT_UNDEFINED;
 
+    fwd_tempfile_->resize(0);
+    rev_tempfile_->resize(0);
+}
+
+void RtpAnalysisDialog::resetStatistics()
+{
+    resetPayloads();
+
     ui->forwardTreeWidget->clear();
     ui->reverseTreeWidget->clear();
 
@@ -696,9 +802,6 @@ void RtpAnalysisDialog::resetStatistics()
     rev_jitter_vals_.clear();
     rev_diff_vals_.clear();
     rev_delta_vals_.clear();
-
-    fwd_tempfile_->resize(0);
-    rev_tempfile_->resize(0);
 }
 
 void RtpAnalysisDialog::addPacket(bool forward, packet_info *pinfo, const _rtp_info *rtpinfo)
@@ -706,9 +809,21 @@ void RtpAnalysisDialog::addPacket(bool forward, packet_info *pinfo, const _rtp_i
     /* add this RTP for future listening using the RTP Player*/
 //    add_rtp_packet(rtpinfo, pinfo);
 
+    if (tap_payloads_only_) {
+        // The rows and graphs are already there; the statistics are only
+        // needed to place the silence between payloads.
+        tap_rtp_stat_t *statinfo = forward ? &fwd_statinfo_ : &rev_statinfo_;
+        rtp_packet_analyse(statinfo, pinfo, rtpinfo);
+        savePayload(forward ? fwd_tempfile_ : rev_tempfile_, statinfo, pinfo, rtpinfo);
+        return;
+    }
+
+    rtp_packet_index_t pkt;
+
     if (forward) {
+        rtp_packet_index_set(&pkt, &fwd_statinfo_, pinfo, rtpinfo);
         rtp_packet_analyse(&fwd_statinfo_, pinfo, rtpinfo);
-        new RtpAnalysisTreeWidgetItem(ui->forwardTreeWidget, &fwd_statinfo_, pinfo, rtpinfo);
+        new RtpAnalysisTreeWidgetItem(ui->forwardTreeWidget, &fwd_statinfo_, &pkt);
 
         fwd_time_vals_.append(fwd_statinfo_.time / 1000);
         fwd_jitter_vals_.append(fwd_statinfo_.jitter);
@@ -717,8 +832,9 @@ void RtpAnalysisDialog::addPacket(bool forward, packet_info *pinfo, const _rtp_i
 
         savePayload(fwd_tempfile_, &fwd_statinfo_, pinfo, rtpinfo);
     } else {
+        rtp_packet_index_set(&pkt, &rev_statinfo_, pinfo, rtpinfo);
         rtp_packet_analyse(&rev_statinfo_, pinfo, rtpinfo);
-        new RtpAnalysisTreeWidgetItem(ui->reverseTreeWidget, &rev_statinfo_, pinfo, rtpinfo);
+        new RtpAnalysisTreeWidgetItem(ui->reverseTreeWidget, &rev_statinfo_, &pkt);
 
         rev_time_vals_.append(rev_statinfo_.time / 1000);
         rev_jitter_vals_.append(rev_statinfo_.jitter);
@@ -1037,6 +1153,14 @@ void RtpAnalysisDialog::showPlayer()
 enum { save_audio_none_, save_audio_au_, save_audio_raw_ };
 void RtpAnalysisDialog::saveAudio(RtpAnalysisDialog::StreamDirection direction)
 {
+    if (!payloads_saved_) {
+        retapPayloads();
+        if (!payloads_saved_ || save_payload_error_ != TAP_RTP_NO_ERROR) {
+            updateWidgets();
+            return;
+        }
+    }
+
     if (!fwd_tempfile_->isOpen() || !rev_tempfile_->isOpen()) return;
 
     QString caption;
@@ -1510,6 +1634,9 @@ void RtpAnalysisDialog::findStreams()
             packet_count_fwd_ = strinfo->packet_count;
             setup_frame_number_fwd_ = strinfo->setup_frame_number;
             nstime_copy(&start_rel_time_fwd_, &strinfo->start_rel_time);
+            if (strinfo->ssrc == ssrc_fwd_) {
+                copyIndex(fwd_index_, strinfo);
+            }
             num_streams_++;
         }
 
@@ -1525,6 +1652,9 @@ void RtpAnalysisDialog::findStreams()
             if (ssrc_rev_ == 0) {
                 ssrc_rev_ = strinfo->ssrc;
             }
+            if (strinfo->ssrc == ssrc_rev_) {
+                copyIndex(rev_index_, strinfo);
+            }
         }
     }
 }
@@ -33,6 +33,7 @@
 
 #include <QAbstractButton>
 #include <QMenu>
+#include <QVector>
 
 #include "wireshark_dialog.h"
 
@@ -111,6 +112,12 @@ private:
 
     int num_streams_;
 
+    // Copies of the RTP streams tap's packet index for each direction.
+    // If they cover every packet we would tap, the analysis is replayed
+    // from them instead of retapping.
+    QVector<rtp_packet_index_t> fwd_index_;
+    QVector<rtp_packet_index_t> rev_index_;
+
     tap_rtp_stat_t fwd_statinfo_;
     tap_rtp_stat_t rev_statinfo_;
 
@@ -134,6 +141,8 @@ private:
     rtpstream_tapinfo_t tapinfo_;
     QString err_str_;
     rtp_error_type_t save_payload_error_;
+    bool payloads_saved_;
+    bool tap_payloads_only_;
 
     QMenu stream_ctx_menu_;
     QMenu graph_ctx_menu_;
@@ -145,6 +154,12 @@ private:
     static gboolean tapPacket(void *tapinfo_ptr, packet_info *pinfo, epan_dissect_t *, const void *rtpinfo_ptr);
     static void tapDraw(void *tapinfo_ptr);
 
+    void copyIndex(QVector<rtp_packet_index_t> &index, const struct _rtp_stream_info *stream);
+    bool indexComplete(const QVector<rtp_packet_index_t> &index, guint32 packet_count);
+    void replayIndex(bool forward);
+    void retapPayloads();
+
+    void resetPayloads();
     void resetStatistics();
     void addPacket(bool forward, packet_info *pinfo, const struct _rtp_info *rtpinfo);
     void savePayload(QTemporaryFile *tmpfile, tap_rtp_stat_t *statinfo, packet_info *pinfo, const struct _rtp_info *rtpinfo);
@@ -41,16 +41,33 @@
 #include <QAudioFormat>
 #include <QAudioOutput>
 #include <QDir>
+#include <QFile>
+#include <QMutexLocker>
+#include <QRunnable>
 #include <QTemporaryFile>
+#include <QThreadPool>
 
 // To do:
 // - Only allow one rtp_stream_info_t per RtpAudioStream?
 
-static spx_int16_t default_audio_sample_rate_ = 8000;
-static const spx_int16_t visual_sample_rate_ = 1000;
+// Waveform intervals per second at the bottom of the pyramid.
+static const int visual_sample_rate_ = 1000;
+
+// Decodes a stream in QThreadPool::globalInstance(), so that each stream
+// gets its own worker.
+class RtpAudioDecodeTask : public QRunnable
+{
+public:
+    RtpAudioDecodeTask(RtpAudioStream *audio_stream) : audio_stream_(audio_stream) {}
+    void run() { audio_stream_->decodePackets(); }
+
+private:
+    RtpAudioStream *audio_stream_;
+};
 
 RtpAudioStream::RtpAudioStream(QObject *parent, _rtp_stream_info *rtp_stream) :
     QObject(parent),
+    playback_file_(NULL),
     decoders_hash_(rtp_decoder_hash_table_new()),
     global_start_rel_time_(0.0),
     start_abs_offset_(0.0),
@@ -62,7 +79,14 @@ RtpAudioStream::RtpAudioStream(QObject *parent, _rtp_stream_info *rtp_stream) :
     max_sample_val_(1),
     color_(0),
     jitter_buffer_size_(50),
-    timing_mode_(RtpAudioStream::JitterBuffer)
+    timing_mode_(RtpAudioStream::JitterBuffer),
+    bucket_samples_(1),
+    bucket_used_(0),
+    bucket_min_(0),
+    bucket_max_(0),
+    decode_sem_(1),
+    decoding_(false),
+    decode_abort_(false)
 {
     copy_address(&src_addr_, &rtp_stream->src_addr);
     src_port_ = rtp_stream->src_port;
@@ -70,20 +94,19 @@ RtpAudioStream::RtpAudioStream(QObject *parent, _rtp_stream_info *rtp_stream) :
     dst_port_ = rtp_stream->dest_port;
     ssrc_ = rtp_stream->ssrc;
 
-    // We keep visual samples in memory. Make fewer of them.
-    visual_resampler_ = speex_resampler_init(1, default_audio_sample_rate_,
-                                                visual_sample_rate_, SPEEX_RESAMPLER_QUALITY_MIN, NULL);
-    speex_resampler_skip_zeros(visual_resampler_);
-
     QString tempname = QString("%1/wireshark_rtp_stream").arg(QDir::tempPath());
     tempfile_ = new QTemporaryFile(tempname, this);
     tempfile_->open();
 
     // RTP_STREAM_DEBUG("Writing to %s", tempname.toUtf8().constData());
+
+    // Emitted from the worker thread, so this is queued.
+    connect(this, SIGNAL(decoded()), this, SLOT(decodeFinished()));
 }
 
 RtpAudioStream::~RtpAudioStream()
 {
+    stopDecoding();
     for (int i = 0; i < rtp_packets_.size(); i++) {
         rtp_packet_t *rtp_packet = rtp_packets_[i];
         g_free(rtp_packet->info);
@@ -92,7 +115,6 @@ RtpAudioStream::~RtpAudioStream()
     }
     g_hash_table_destroy(decoders_hash_);
     if (audio_resampler_) speex_resampler_destroy (audio_resampler_);
-    speex_resampler_destroy (visual_resampler_);
 }
 
 bool RtpAudioStream::isMatch(const _rtp_stream_info *rtp_stream) const
@@ -148,26 +170,40 @@ void RtpAudioStream::addRtpPacket(const struct _packet_info *pinfo, const struct
     rtp_packet->frame_num = pinfo->num;
     rtp_packet->arrive_offset = nstime_to_sec(&pinfo->rel_ts) - start_rel_time_;
 
+    // Done here rather than while decoding, which isn't in the GUI thread.
+    QString payload_name;
+    if (rtp_info->info_payload_type_str) {
+        payload_name = rtp_info->info_payload_type_str;
+    } else {
+        payload_name = try_val_to_str_ext(rtp_info->info_payload_type, &rtp_payload_type_short_vals_ext);
+    }
+    if (!payload_name.isEmpty()) {
+        payload_names_ << payload_name;
+    }
+
     rtp_packets_ << rtp_packet;
 }
 
 void RtpAudioStream::reset(double start_rel_time)
 {
+    stopDecoding();
+    stopPlaying();
+
     global_start_rel_time_ = start_rel_time;
     stop_rel_time_ = start_rel_time_;
     audio_out_rate_ = 0;
     max_sample_val_ = 1;
     packet_timestamps_.clear();
-    visual_samples_.clear();
+    waveform_.clear();
     out_of_seq_timestamps_.clear();
     jitter_drop_timestamps_.clear();
+    wrong_timestamp_timestamps_.clear();
+    silence_timestamps_.clear();
 
     if (audio_resampler_) {
         speex_resampler_reset_mem(audio_resampler_);
     }
-    if (visual_resampler_) {
-        speex_resampler_reset_mem(visual_resampler_);
-    }
+    tempfile_->resize(0);
     tempfile_->seek(0);
 }
 
@@ -176,21 +212,81 @@ static const int sample_bytes_ = sizeof(SAMPLE) / sizeof(char);
  * XXX - is there a better thing to do here?
  */
 static const int max_silence_samples_ = 240000;
+static const int decode_batch_len_ = 256;
 void RtpAudioStream::decode()
 {
     if (rtp_packets_.size() < 1) return;
 
+    // Find our output rate (the first non-zero one wins) up front, so
+    // that we can be played while the rest of the stream is decoded.
+    GHashTable *probe_hash = rtp_decoder_hash_table_new();
+    for (int cur_packet = 0; cur_packet < rtp_packets_.size() && audio_out_rate_ == 0; cur_packet++) {
+        SAMPLE *decode_buff = NULL;
+        unsigned channels = 0;
+        unsigned sample_rate = 0;
+        size_t decoded_bytes = decode_rtp_packet(rtp_packets_[cur_packet], &decode_buff, probe_hash, &channels, &sample_rate);
+
+        if (decoded_bytes > 0 && sample_rate > 0) {
+            audio_out_rate_ = sample_rate;
+            RTP_STREAM_DEBUG("Audio sample rate is %u", audio_out_rate_);
+        }
+        g_free(decode_buff);
+    }
+    g_hash_table_destroy(probe_hash);
+
+    if (audio_out_rate_ == 0) return;
+
+    decode_sem_.acquire();
+    decode_state_mutex_.lock();
+    decoding_ = true;
+    decode_state_mutex_.unlock();
+    QThreadPool::globalInstance()->start(new RtpAudioDecodeTask(this));
+}
+
+bool RtpAudioStream::isDecoding() const
+{
+    QMutexLocker locker(&decode_state_mutex_);
+    return decoding_;
+}
+
+bool RtpAudioStream::decodeAborted() const
+{
+    QMutexLocker locker(&decode_state_mutex_);
+    return decode_abort_;
+}
+
+// Wait for the worker, telling it to give up first.
+void RtpAudioStream::stopDecoding()
+{
+    decode_state_mutex_.lock();
+    decode_abort_ = true;
+    decode_state_mutex_.unlock();
+
+    decode_sem_.acquire();
+    decode_sem_.release();
+
+    decode_state_mutex_.lock();
+    decode_abort_ = false;
+    decode_state_mutex_.unlock();
+}
+
+// Runs in a worker thread. The GUI thread leaves our decoding state
+// alone until decoding_ is cleared, and waits for us in stopDecoding()
+// before touching it.
+void RtpAudioStream::decodePackets()
+{
     // gtk/rtp_player.c:decode_rtp_stream
     // XXX This is more messy than it should be.
 
     gsize resample_buff_len = 0x1000;
     SAMPLE *resample_buff = (SAMPLE *) g_malloc(resample_buff_len);
-    spx_uint32_t cur_in_rate = 0, visual_out_rate = 0;
+    spx_uint32_t cur_in_rate = 0;
     char *write_buff = NULL;
     qint64 write_bytes = 0;
     unsigned channels = 0;
     unsigned sample_rate = 0;
     int last_sequence = 0;
+    bool first_samples = true;
 
     double rtp_time_prev = 0.0;
     double arrive_time_prev = 0.0;
@@ -201,23 +297,23 @@ void RtpAudioStream::decode()
 
     size_t decoded_bytes_prev = 0;
 
+    // Packets are decoded in batches, each a run with the same payload type.
+    SAMPLE *batch_buff = NULL;
+    size_t batch_sizes[decode_batch_len_];
+    int batch_start = 0;
+    int batch_len = 0;
+    size_t batch_offset = 0;
+
+    bucket_samples_ = qMax((int) audio_out_rate_ / visual_sample_rate_, 1);
+    bucket_used_ = 0;
+    waveform_.resize(1);
+
     for (int cur_packet = 0; cur_packet < rtp_packets_.size(); cur_packet++) {
-        SAMPLE *decode_buff = NULL;
-        // XXX The GTK+ UI updates a progress bar here.
         rtp_packet_t *rtp_packet = rtp_packets_[cur_packet];
 
-        stop_rel_time_ = start_rel_time_ + rtp_packet->arrive_offset;
-        speex_resampler_get_rate(visual_resampler_, &cur_in_rate, &visual_out_rate);
+        if (decodeAborted()) break;
 
-        QString payload_name;
-        if (rtp_packet->info->info_payload_type_str) {
-            payload_name = rtp_packet->info->info_payload_type_str;
-        } else {
-            payload_name = try_val_to_str_ext(rtp_packet->info->info_payload_type, &rtp_payload_type_short_vals_ext);
-        }
-        if (!payload_name.isEmpty()) {
-            payload_names_ << payload_name;
-        }
+        stop_rel_time_ = start_rel_time_ + rtp_packet->arrive_offset;
 
         if (cur_packet < 1) { // First packet
             start_timestamp = rtp_packet->info->info_timestamp;
@@ -226,21 +322,28 @@ void RtpAudioStream::decode()
             last_sequence = rtp_packet->info->info_seq_num - 1;
         }
 
-        size_t decoded_bytes = decode_rtp_packet(rtp_packet, &decode_buff, decoders_hash_, &channels, &sample_rate);
+        if (cur_packet >= batch_start + batch_len) {
+            g_free(batch_buff);
+            batch_start = cur_packet;
+            batch_len = (int) decode_rtp_packets(rtp_packets_.data() + cur_packet,
+                                                 (guint) qMin(rtp_packets_.size() - cur_packet, decode_batch_len_),
+                                                 &batch_buff, batch_sizes, decoders_hash_, &channels, &sample_rate);
+            batch_offset = 0;
+        }
+        size_t decoded_bytes = batch_sizes[cur_packet - batch_start];
+        SAMPLE *decode_buff = batch_buff ? (SAMPLE *) ((char *) batch_buff + batch_offset) : NULL;
+        batch_offset += decoded_bytes;
 
         if (decoded_bytes == 0 || sample_rate == 0) {
-            // We didn't decode anything. Clean up and prep for the next packet.
+            // We didn't decode anything. Prep for the next packet.
             last_sequence = rtp_packet->info->info_seq_num;
-            g_free(decode_buff);
             continue;
         }
 
-        if (audio_out_rate_ == 0) { // First non-zero wins
-            audio_out_rate_ = sample_rate;
-            RTP_STREAM_DEBUG("Audio sample rate is %u", audio_out_rate_);
+        if (first_samples) {
+            first_samples = false;
 
             // Prepend silence to match our sibling streams.
-            tempfile_->seek(0);
             int prepend_samples = (start_rel_time_ - global_start_rel_time_) * audio_out_rate_;
             if (prepend_samples > 0) {
                 writeSilence(prepend_samples);
@@ -338,12 +441,11 @@ void RtpAudioStream::decode()
                 // Adjust rates if needed.
                 if (sample_rate != cur_in_rate) {
                     speex_resampler_set_rate(audio_resampler_, sample_rate, audio_out_rate);
-                    speex_resampler_set_rate(visual_resampler_, sample_rate, visual_out_rate);
                     RTP_STREAM_DEBUG("Changed input rate from %u to %u Hz. Out is %u.", cur_in_rate, sample_rate, audio_out_rate_);
                 }
             }
-            spx_uint32_t in_len = (spx_uint32_t)rtp_packet->info->info_payload_len;
-            spx_uint32_t out_len = (audio_out_rate_ * (spx_uint32_t)rtp_packet->info->info_payload_len / sample_rate) + (audio_out_rate_ % sample_rate != 0);
+            spx_uint32_t in_len = (spx_uint32_t)(decoded_bytes / sample_bytes_);
+            spx_uint32_t out_len = (audio_out_rate_ * in_len / sample_rate) + (audio_out_rate_ % sample_rate != 0);
             if (out_len * sample_bytes_ > resample_buff_len) {
                 while ((out_len * sample_bytes_ > resample_buff_len))
                     resample_buff_len *= 2;
@@ -351,33 +453,86 @@ void RtpAudioStream::decode()
             }
 
             speex_resampler_process_int(audio_resampler_, 0, decode_buff, &in_len, resample_buff, &out_len);
-            write_buff = (char *) decode_buff;
+            write_buff = (char *) resample_buff;
             write_bytes = out_len * sample_bytes_;
         }
 
         // Write the decoded, possibly-resampled audio to our temp file.
+        // Flush it so that playback can pick it up right away.
         tempfile_->write(write_buff, write_bytes);
+        tempfile_->flush();
+
+        packet_timestamps_[stop_rel_time_] = rtp_packet->frame_num;
+        addWaveformSamples((const qint16 *) write_buff, (int) (write_bytes / sample_bytes_));
+    }
+    g_free(batch_buff);
+    g_free(resample_buff);
+
+    finishWaveform();
 
-        // Collect our visual samples.
-        spx_uint32_t in_len = (spx_uint32_t)rtp_packet->info->info_payload_len;
-        spx_uint32_t out_len = (visual_out_rate * in_len / sample_rate) + (visual_out_rate % sample_rate != 0);
-        if (out_len * sample_bytes_ > resample_buff_len) {
-            while ((out_len * sample_bytes_ > resample_buff_len))
-                resample_buff_len *= 2;
-            resample_buff = (SAMPLE *) g_realloc(resample_buff, resample_buff_len);
+    decode_state_mutex_.lock();
+    decoding_ = false;
+    decode_state_mutex_.unlock();
+    emit decoded();
+    decode_sem_.release();
+}
+
+// Add samples to level 0 of the waveform pyramid.
+void RtpAudioStream::addWaveformSamples(const qint16 *samples, int count)
+{
+    WaveformLevel &level = waveform_[0];
+
+    for (int i = 0; i < count; i++) {
+        qint16 sample = samples[i];
+
+        if (bucket_used_ == 0) {
+            bucket_min_ = bucket_max_ = sample;
+        } else {
+            if (sample < bucket_min_) bucket_min_ = sample;
+            if (sample > bucket_max_) bucket_max_ = sample;
         }
+        if (qAbs((int) sample) > max_sample_val_) max_sample_val_ = qAbs((int) sample);
 
-        speex_resampler_process_int(visual_resampler_, 0, decode_buff, &in_len, resample_buff, &out_len);
-        for (unsigned i = 0; i < out_len; i++) {
-            packet_timestamps_[stop_rel_time_ + (double) i / visual_out_rate] = rtp_packet->frame_num;
-            if (qAbs(resample_buff[i]) > max_sample_val_) max_sample_val_ = qAbs(resample_buff[i]);
-            visual_samples_.append(resample_buff[i]);
+        if (++bucket_used_ == bucket_samples_) {
+            level.min.append(bucket_min_);
+            level.max.append(bucket_max_);
+            bucket_used_ = 0;
         }
+    }
+}
 
-        // Finally, write the resampled audio to our temp file and clean up.
-        g_free(decode_buff);
+// Flush the partial bucket and build the levels above 0.
+void RtpAudioStream::finishWaveform()
+{
+    if (bucket_used_ > 0) {
+        waveform_[0].min.append(bucket_min_);
+        waveform_[0].max.append(bucket_max_);
+        bucket_used_ = 0;
+    }
+
+    while (waveform_.last().min.size() > 1) {
+        const WaveformLevel &below = waveform_.last();
+        WaveformLevel level;
+        int size = (below.min.size() + 1) / 2;
+
+        level.min.resize(size);
+        level.max.resize(size);
+        for (int i = 0; i < size; i++) {
+            int j = i * 2;
+            int k = qMin(j + 1, below.min.size() - 1);
+            level.min[i] = qMin(below.min[j], below.min[k]);
+            level.max[i] = qMax(below.max[j], below.max[k]);
+        }
+        waveform_.append(level);
+    }
+}
+
+void RtpAudioStream::decodeFinished()
+{
+    // Playback might have caught up with us.
+    if (audio_output_ && audio_output_->state() == QAudio::IdleState) {
+        audio_output_->stop();
     }
-    g_free(resample_buff);
 }
 
 const QStringList RtpAudioStream::payloadNames() const
@@ -387,32 +542,67 @@ const QStringList RtpAudioStream::payloadNames() const
     return payload_names;
 }
 
-const QVector<double> RtpAudioStream::visualTimestamps(bool relative)
-{
-    QVector<double> ts_keys = packet_timestamps_.keys().toVector();
-    if (relative) return ts_keys;
-
-    QVector<double> adj_timestamps;
-    for (int i = 0; i < ts_keys.size(); i++) {
-        adj_timestamps.append(ts_keys[i] + start_abs_offset_);
-    }
-    return adj_timestamps;
-}
-
 // Scale the height of the waveform (max_sample_val_) and adjust its Y
 // offset so that they overlap slightly (stack_offset_).
 
 // XXX This means that waveforms can be misleading with respect to relative
 // amplitude. We might want to add a "global" max_sample_val_.
 static const double stack_offset_ = G_MAXINT16 / 3;
-const QVector<double> RtpAudioStream::visualSamples(int y_offset)
+double RtpAudioStream::waveformStart(bool relative) const
 {
-    QVector<double> adj_samples;
+    return relative ? global_start_rel_time_ : global_start_rel_time_ + start_abs_offset_;
+}
+
+double RtpAudioStream::waveformStop(bool relative) const
+{
+    double duration = 0.0;
+    if (!isDecoding() && !waveform_.isEmpty() && audio_out_rate_ > 0) {
+        duration = (double) waveform_[0].min.size() * bucket_samples_ / audio_out_rate_;
+    }
+    return waveformStart(relative) + duration;
+}
+
+void RtpAudioStream::waveform(double start_time, double stop_time, int min_points, bool relative, int y_offset,
+                              QVector<double> &timestamps, QVector<double> &samples) const
+{
+    timestamps.clear();
+    samples.clear();
+    if (isDecoding() || waveform_.isEmpty() || audio_out_rate_ == 0) return;
+
+    if (!relative) {
+        start_time -= start_abs_offset_;
+        stop_time -= start_abs_offset_;
+    }
+
+    // Use the coarsest level that still gives us min_points intervals.
+    double interval = (double) bucket_samples_ / audio_out_rate_;
+    int level_num = 0;
+    while (level_num + 1 < waveform_.size()
+           && (stop_time - start_time) / (interval * 2) >= min_points) {
+        interval *= 2;
+        level_num++;
+    }
+    const WaveformLevel &level = waveform_[level_num];
+
+    // Include one interval past each edge so that lines run off the plot.
+    double first_pos = qBound(0.0, (start_time - global_start_rel_time_) / interval - 1, (double) level.min.size());
+    double last_pos = qBound(-1.0, (stop_time - global_start_rel_time_) / interval + 1, (double) level.min.size() - 1);
+    int first = (int) first_pos;
+    int last = (int) last_pos;
+    if (first > last) return;
+
+    double time_offset = relative ? global_start_rel_time_ : global_start_rel_time_ + start_abs_offset_;
     double scaled_offset = y_offset * stack_offset_;
-    for (int i = 0; i < visual_samples_.size(); i++) {
-        adj_samples.append(((double)visual_samples_[i] * G_MAXINT16 / max_sample_val_) + scaled_offset);
+    timestamps.reserve((last - first + 1) * 2);
+    samples.reserve((last - first + 1) * 2);
+    for (int i = first; i <= last; i++) {
+        double ts = time_offset + i * interval;
+        // Distinct keys, since QCPDataMap only keeps one value per key.
+        timestamps.append(ts);
+        samples.append(((double)level.min[i] * G_MAXINT16 / max_sample_val_) + scaled_offset);
+        timestamps.append(ts + interval / 2);
+        samples.append(((double)level.max[i] * G_MAXINT16 / max_sample_val_) + scaled_offset);
     }
-    return adj_samples;
 }
 
 const QVector<double> RtpAudioStream::outOfSequenceTimestamps(bool relative)
@@ -501,7 +691,7 @@ const QVector<double> RtpAudioStream::insertedSilenceSamples(int y_offset)
 
 quint32 RtpAudioStream::nearestPacket(double timestamp, bool is_relative)
 {
-    if (packet_timestamps_.keys().count() < 1) return 0;
+    if (isDecoding() || packet_timestamps_.isEmpty()) return 0;
 
     if (!is_relative) timestamp -= start_abs_offset_;
     QMap<double, quint32>::const_iterator it = packet_timestamps_.lowerBound(timestamp);
@@ -517,7 +707,7 @@ QAudio::State RtpAudioStream::outputState() const
 
 void RtpAudioStream::startPlaying()
 {
-    if (audio_output_) return;
+    if (audio_output_ || audio_out_rate_ == 0) return;
 
     QAudioFormat format;
     format.setSampleRate(audio_out_rate_);
@@ -534,8 +724,12 @@ void RtpAudioStream::startPlaying()
     audio_output_->setNotifyInterval(65); // ~15 fps
     connect(audio_output_, SIGNAL(stateChanged(QAudio::State)), this, SLOT(outputStateChanged(QAudio::State)));
     connect(audio_output_, SIGNAL(notify()), this, SLOT(outputNotify()));
-    tempfile_->seek(0);
-    audio_output_->start(tempfile_);
+
+    // Read through our own handle. The decoder might still be writing
+    // through tempfile_.
+    playback_file_ = new QFile(tempfile_->fileName(), this);
+    playback_file_->open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    audio_output_->start(playback_file_);
     emit startedPlaying();
     // QTBUG-6548 StoppedState is not always emitted on error, force a cleanup
     // in case playback fails immediately.
@@ -560,10 +754,8 @@ void RtpAudioStream::writeSilence(int samples)
 
     RTP_STREAM_DEBUG("Writing %u silence samples", samples);
     tempfile_->write(silence_buff, silence_bytes);
+    addWaveformSamples((const qint16 *) silence_buff, samples);
     g_free(silence_buff);
-
-    QVector<qint16> visual_fill(samples * visual_sample_rate_ / audio_out_rate_, 0);
-    visual_samples_ += visual_fill;
 }
 
 void RtpAudioStream::outputStateChanged(QAudio::State new_state)
@@ -579,10 +771,18 @@ void RtpAudioStream::outputStateChanged(QAudio::State new_state)
         audio_output_->disconnect();
         audio_output_->deleteLater();
         audio_output_ = NULL;
+        if (playback_file_) {
+            playback_file_->deleteLater();
+            playback_file_ = NULL;
+        }
         emit finishedPlaying();
         break;
     case QAudio::IdleState:
-        audio_output_->stop();
+        // We might have caught up with the decoder. decodeFinished() stops
+        // us if so.
+        if (!isDecoding()) {
+            audio_output_->stop();
+        }
         break;
     default:
         break;
@@ -33,11 +33,14 @@
 #include <QAudio>
 #include <QColor>
 #include <QMap>
+#include <QMutex>
 #include <QObject>
+#include <QSemaphore>
 #include <QSet>
 #include <QVector>
 
 class QAudioOutput;
+class QFile;
 class QTemporaryFile;
 
 struct _rtp_info;
@@ -57,7 +60,13 @@ public:
     void addRtpStream(const struct _rtp_stream_info *rtp_stream);
     void addRtpPacket(const struct _packet_info *pinfo, const struct _rtp_info *rtp_info);
     void reset(double start_rel_time);
+    /**
+     * @brief Start decoding the stream in a worker thread. decoded() is
+     * emitted when it's done. The stream can be played before that, but
+     * the waveform, packet and error information is only available after.
+     */
     void decode();
+    bool isDecoding() const;
 
     double startRelTime() const { return start_rel_time_; }
     double stopRelTime() const { return stop_rel_time_; }
@@ -65,17 +74,28 @@ public:
     const QStringList payloadNames() const;
 
     /**
-     * @brief Return a list of visual timestamps.
-     * @return A set of timestamps suitable for passing to QCPGraph::setData.
+     * @brief Return the start time of the waveform.
      */
-    const QVector<double> visualTimestamps(bool relative = true);
+    double waveformStart(bool relative = true) const;
     /**
-     * @brief Return a list of visual samples. There will be fewer visual samples
-     * per second (1000) than the actual audio.
+     * @brief Return the end time of the waveform.
+     */
+    double waveformStop(bool relative = true) const;
+    /**
+     * @brief Return the waveform between two times, as the lowest and
+     * highest sample of each of at least min_points intervals (at most
+     * one per millisecond). The intervals come from a precomputed min/max
+     * pyramid, so this is cheap at any zoom level.
+     * @param start_time Start of the range.
+     * @param stop_time End of the range.
+     * @param min_points Number of intervals wanted, e.g. the plot width in pixels.
+     * @param relative Use times relative to the start of the capture.
      * @param y_offset Y axis offset to be used for stacking graphs.
-     * @return A set of values suitable for passing to QCPGraph::setData.
+     * @param timestamps Receives timestamps suitable for passing to QCPGraph::setData.
+     * @param samples Receives the matching values.
      */
-    const QVector<double> visualSamples(int y_offset = 0);
+    void waveform(double start_time, double stop_time, int min_points, bool relative, int y_offset,
+                  QVector<double> &timestamps, QVector<double> &samples) const;
 
     /**
      * @brief Return a list of out-of-sequence timestamps.
@@ -140,6 +160,7 @@ public:
     void setTimingMode(TimingMode timing_mode) { timing_mode_ = timing_mode; }
 
 signals:
+    void decoded();
     void startedPlaying();
     void processedSecs(double secs);
     void finishedPlaying();
@@ -159,6 +180,7 @@ private:
 
     QVector<struct _rtp_packet *>rtp_packets_;
     QTemporaryFile *tempfile_;
+    QFile *playback_file_;
     struct _GHashTable *decoders_hash_;
     QList<const struct _rtp_stream_info *>rtp_streams_;
     double global_start_rel_time_;
@@ -168,10 +190,8 @@ private:
     quint32 audio_out_rate_;
     QSet<QString> payload_names_;
     struct SpeexResamplerState_ *audio_resampler_;
-    struct SpeexResamplerState_ *visual_resampler_;
     QAudioOutput *audio_output_;
     QMap<double, quint32> packet_timestamps_;
-    QVector<qint16> visual_samples_;
     QVector<double> out_of_seq_timestamps_;
     QVector<double> jitter_drop_timestamps_;
     QVector<double> wrong_timestamp_timestamps_;
@@ -182,9 +202,35 @@ private:
     int jitter_buffer_size_;
     TimingMode timing_mode_;
 
+    // Waveform pyramid. Level 0 has the lowest and highest sample of each
+    // millisecond of audio, and each level above it covers twice as long.
+    struct WaveformLevel {
+        QVector<qint16> min;
+        QVector<qint16> max;
+    };
+    QVector<WaveformLevel> waveform_;
+    int bucket_samples_;
+    int bucket_used_;
+    qint16 bucket_min_;
+    qint16 bucket_max_;
+
+    // decode_sem_ is held from decode() until the worker is done, so
+    // acquiring it waits for decoding to finish.
+    QSemaphore decode_sem_;
+    mutable QMutex decode_state_mutex_;
+    bool decoding_;
+    bool decode_abort_;
+
+    friend class RtpAudioDecodeTask;
+    void decodePackets();
+    bool decodeAborted() const;
+    void stopDecoding();
     void writeSilence(int samples);
+    void addWaveformSamples(const qint16 *samples, int count);
+    void finishWaveform();
 
 private slots:
+    void decodeFinished();
     void outputStateChanged(QAudio::State new_state);
     void outputNotify();
 };
@@ -55,7 +55,6 @@ Q_DECLARE_METATYPE(QCPGraph *)
 // - Make streams checkable.
 // - Add silence, drop & jitter indicators to the graph.
 // - How to handle multiple channels?
-// - Threaded decoding?
 // - Play MP3s. As per Zawinski's Law we already read emails.
 // - RTP audio streams are currently keyed on src addr + src port + dst addr
 //   + dst port + ssrc. This means that we can have multiple rtp_stream_info
@@ -106,6 +105,8 @@ RtpPlayerDialog::RtpPlayerDialog(QWidget &parent, CaptureFile &cf) :
 #ifdef QT_MULTIMEDIA_LIB
     , ui(new Ui::RtpPlayerDialog)
     , start_rel_time_(0.0)
+    , plot_pending_(false)
+    , rescale_pending_(false)
 #endif // QT_MULTIMEDIA_LIB
 {
     ui->setupUi(this);
@@ -137,6 +138,8 @@ RtpPlayerDialog::RtpPlayerDialog(QWidget &parent, CaptureFile &cf) :
             this, SLOT(mouseMoved(QMouseEvent*)));
     connect(ui->audioPlot, SIGNAL(mousePress(QMouseEvent*)),
             this, SLOT(graphClicked(QMouseEvent*)));
+    connect(ui->audioPlot->xAxis, SIGNAL(rangeChanged(QCPRange)),
+            this, SLOT(xAxisRangeChanged()));
 
     cur_play_pos_ = new QCPItemStraightLine(ui->audioPlot);
     ui->audioPlot->addItem(cur_play_pos_);
@@ -217,15 +220,11 @@ void RtpPlayerDialog::rescanPackets(bool rescale_axes)
     }
     ui->audioPlot->clearGraphs();
 
-    bool show_legend = false;
-    bool relative_timestamps = !ui->todCheckBox->isChecked();
-
-    ui->audioPlot->xAxis->setTickLabelType(relative_timestamps ? QCPAxis::ltNumber : QCPAxis::ltDateTime);
-
+    // Each stream is decoded by its own worker. We plot them when they're
+    // all done.
     for (int row = 0; row < row_count; row++) {
         QTreeWidgetItem *ti = ui->streamTreeWidget->topLevelItem(row);
         RtpAudioStream *audio_stream = ti->data(stream_data_col_, Qt::UserRole).value<RtpAudioStream*>();
-        int y_offset = row_count - row - 1;
 
         audio_stream->setJitterBufferSize((int) ui->jitterSpinBox->value());
 
@@ -243,8 +242,53 @@ void RtpPlayerDialog::rescanPackets(bool rescale_axes)
         audio_stream->setTimingMode(timing_mode);
 
         audio_stream->decode();
+    }
+
+    plot_pending_ = true;
+    rescale_pending_ |= rescale_axes;
+    streamDecoded();
+
+    updateWidgets();
+}
+
+void RtpPlayerDialog::streamDecoded()
+{
+    if (!plot_pending_) return;
+
+    for (int row = 0; row < ui->streamTreeWidget->topLevelItemCount(); row++) {
+        QTreeWidgetItem *ti = ui->streamTreeWidget->topLevelItem(row);
+        RtpAudioStream *audio_stream = ti->data(stream_data_col_, Qt::UserRole).value<RtpAudioStream*>();
+        if (audio_stream->isDecoding()) return;
+    }
+
+    plot_pending_ = false;
+    plotStreams();
+    if (rescale_pending_) {
+        rescale_pending_ = false;
+        resetXAxis();
+    }
+}
+
+void RtpPlayerDialog::plotStreams()
+{
+    int row_count = ui->streamTreeWidget->topLevelItemCount();
+    for (int row = 0; row < row_count; row++) {
+        QTreeWidgetItem *ti = ui->streamTreeWidget->topLevelItem(row);
+        ti->setData(graph_data_col_, Qt::UserRole, QVariant());
+    }
+    ui->audioPlot->clearGraphs();
+
+    bool show_legend = false;
+    bool relative_timestamps = !ui->todCheckBox->isChecked();
+
+    ui->audioPlot->xAxis->setTickLabelType(relative_timestamps ? QCPAxis::ltNumber : QCPAxis::ltDateTime);
+
+    for (int row = 0; row < row_count; row++) {
+        QTreeWidgetItem *ti = ui->streamTreeWidget->topLevelItem(row);
+        RtpAudioStream *audio_stream = ti->data(stream_data_col_, Qt::UserRole).value<RtpAudioStream*>();
+        int y_offset = row_count - row - 1;
 
-        // Waveform
+        // Waveform. Its data is set by updateWaveforms.
         QCPGraph *audio_graph = ui->audioPlot->addGraph();
         QPen wf_pen(audio_stream->color());
         wf_pen.setWidthF(wf_graph_normal_width_);
@@ -252,10 +296,8 @@ void RtpPlayerDialog::rescanPackets(bool rescale_axes)
         wf_pen.setWidthF(wf_graph_selected_width_);
         audio_graph->setSelectedPen(wf_pen);
         audio_graph->setSelectable(false);
-        audio_graph->setData(audio_stream->visualTimestamps(relative_timestamps), audio_stream->visualSamples(y_offset));
         audio_graph->removeFromLegend();
         ti->setData(graph_data_col_, Qt::UserRole, QVariant::fromValue<QCPGraph *>(audio_graph));
-        RTP_STREAM_DEBUG("Plotting %s, %d samples", ti->text(src_addr_col_).toUtf8().constData(), audio_graph->data()->keys().length());
 
         QString span_str = QString("%1 - %2 (%3)")
                 .arg(QString::number(audio_stream->startRelTime(), 'g', 3))
@@ -331,10 +373,43 @@ void RtpPlayerDialog::rescanPackets(bool rescale_axes)
         ui->streamTreeWidget->resizeColumnToContents(col);
     }
 
+    updateWaveforms();
     ui->audioPlot->replot();
-    if (rescale_axes) resetXAxis();
+}
 
-    updateWidgets();
+// Fetch each waveform at a resolution that suits the plot width, for
+// either the visible range or all of it.
+void RtpPlayerDialog::updateWaveforms(bool full_range)
+{
+    QCPAxis *x_axis = ui->audioPlot->xAxis;
+    bool relative_timestamps = !ui->todCheckBox->isChecked();
+    int row_count = ui->streamTreeWidget->topLevelItemCount();
+    int axis_pixels = qMax(x_axis->axisRect()->width(), 1);
+
+    for (int row = 0; row < row_count; row++) {
+        QTreeWidgetItem *ti = ui->streamTreeWidget->topLevelItem(row);
+        RtpAudioStream *audio_stream = ti->data(stream_data_col_, Qt::UserRole).value<RtpAudioStream*>();
+        QCPGraph *audio_graph = ti->data(graph_data_col_, Qt::UserRole).value<QCPGraph*>();
+        if (!audio_graph) continue;
+
+        double start_time = x_axis->range().lower;
+        double stop_time = x_axis->range().upper;
+        if (full_range) {
+            start_time = audio_stream->waveformStart(relative_timestamps);
+            stop_time = audio_stream->waveformStop(relative_timestamps);
+        }
+
+        QVector<double> timestamps, samples;
+        audio_stream->waveform(start_time, stop_time, axis_pixels, relative_timestamps,
+                               row_count - row - 1, timestamps, samples);
+        audio_graph->setData(timestamps, samples);
+        RTP_STREAM_DEBUG("Plotting %s, %d samples", ti->text(src_addr_col_).toUtf8().constData(), timestamps.size());
+    }
+}
+
+void RtpPlayerDialog::xAxisRangeChanged()
+{
+    updateWaveforms();
 }
 
 void RtpPlayerDialog::addRtpStream(struct _rtp_stream_info *rtp_stream)
@@ -377,6 +452,7 @@ void RtpPlayerDialog::addRtpStream(struct _rtp_stream_info *rtp_stream)
         connect(ui->playButton, SIGNAL(clicked(bool)), audio_stream, SLOT(startPlaying()));
         connect(ui->stopButton, SIGNAL(clicked(bool)), audio_stream, SLOT(stopPlaying()));
 
+        connect(audio_stream, SIGNAL(decoded()), this, SLOT(streamDecoded()));
         connect(audio_stream, SIGNAL(startedPlaying()), this, SLOT(updateWidgets()));
         connect(audio_stream, SIGNAL(finishedPlaying()), this, SLOT(updateWidgets()));
         connect(audio_stream, SIGNAL(processedSecs(double)), this, SLOT(setPlayPosition(double)));
@@ -514,6 +590,7 @@ void RtpPlayerDialog::resetXAxis()
 
     double pixel_pad = 10.0; // per side
 
+    updateWaveforms(true);
     ap->rescaleAxes(true);
 
     double axis_pixels = ap->xAxis->axisRect()->width();
@@ -665,16 +742,14 @@ void RtpPlayerDialog::on_streamTreeWidget_itemSelectionChanged()
     ui->audioPlot->replot();
 }
 
-double RtpPlayerDialog::getLowestTimestamp()
+double RtpPlayerDialog::getLowestTimestamp(bool relative)
 {
     double lowest = QCPRange::maxRange;
 
-    for (int i = 0; i < ui->audioPlot->graphCount(); i++) {
-        QCPGraph *graph = ui->audioPlot->graph(i);
-        if (!graph->visible()) continue;
-        QCPDataMap *dm = graph->data();
-        if (dm->keys().length() < 1) continue;
-        lowest = qMin(lowest, dm->keys().first());
+    for (int row = 0; row < ui->streamTreeWidget->topLevelItemCount(); row++) {
+        QTreeWidgetItem *ti = ui->streamTreeWidget->topLevelItem(row);
+        RtpAudioStream *audio_stream = ti->data(stream_data_col_, Qt::UserRole).value<RtpAudioStream*>();
+        lowest = qMin(lowest, audio_stream->waveformStart(relative));
     }
     return lowest;
 }
@@ -719,14 +794,13 @@ void RtpPlayerDialog::on_timingComboBox_currentIndexChanged(int)
     rescanPackets();
 }
 
-void RtpPlayerDialog::on_todCheckBox_toggled(bool)
+void RtpPlayerDialog::on_todCheckBox_toggled(bool checked)
 {
     QCPAxis *x_axis = ui->audioPlot->xAxis;
-    double old_lowest = getLowestTimestamp();
 
-    rescanPackets();
-    x_axis->moveRange(getLowestTimestamp() - old_lowest);
-    ui->audioPlot->replot();
+    // Only the time base changes, so there's no need to decode again.
+    x_axis->moveRange(getLowestTimestamp(!checked) - getLowestTimestamp(checked));
+    if (!plot_pending_) plotStreams();
 }
 
 void RtpPlayerDialog::on_buttonBox_helpRequested()
@@ -87,9 +87,12 @@ private slots:
      * streams added using ::addRtpStream.
      */
     void retapPackets();
-    /** Clear, decode, and redraw each stream.
+    /** Clear and decode each stream. They're redrawn when decoding
+     * is done.
      */
     void rescanPackets(bool rescale_axes = false);
+    void streamDecoded();
+    void xAxisRangeChanged();
     void updateWidgets();
     void graphClicked(QMouseEvent *event);
     void mouseMoved(QMouseEvent *);
@@ -117,6 +120,8 @@ private:
     QMenu *ctx_menu_;
     double start_rel_time_;
     QCPItemStraightLine *cur_play_pos_;
+    bool plot_pending_;
+    bool rescale_pending_;
 
 //    const QString streamKey(const struct _rtp_stream_info *rtp_stream);
 //    const QString streamKey(const packet_info *pinfo, const struct _rtp_info *rtpinfo);
@@ -127,9 +132,11 @@ private:
     static void tapDraw(void *tapinfo_ptr);
 
     void addPacket(packet_info *pinfo, const struct _rtp_info *rtpinfo);
+    void plotStreams();
+    void updateWaveforms(bool full_range = false);
     void zoomXAxis(bool in);
     void panXAxis(int x_pixels);
-    double getLowestTimestamp();
+    double getLowestTimestamp(bool relative);
     const QString getHoveredTime();
     int getHoveredPacket();
 
@@ -50,6 +50,12 @@ enum {
     wide_chars_
 };
 
+static void
+mark_found_frame(capture_file *cf, frame_data *fdata, void *)
+{
+    cf_mark_frame(cf, fdata);
+}
+
 SearchFrame::SearchFrame(QWidget *parent) :
     AccordionFrame(parent),
     sf_ui_(new Ui::SearchFrame),
@@ -224,11 +230,21 @@ void SearchFrame::updateWidgets()
 
     if (sf_ui_->searchLineEdit->text().isEmpty() || sf_ui_->searchLineEdit->syntaxState() == SyntaxLineEdit::Invalid) {
         sf_ui_->findButton->setEnabled(false);
+        sf_ui_->markAllButton->setEnabled(false);
     } else {
         sf_ui_->findButton->setEnabled(true);
+        // Only searches of the packet bytes can find all matches.
+        sf_ui_->markAllButton->setEnabled(search_type == hex_search_ ||
+                                          ((search_type == string_search_ || search_type == regex_search_) &&
+                                           sf_ui_->searchInComboBox->currentIndex() == in_bytes_));
     }
 }
 
+void SearchFrame::on_searchInComboBox_currentIndexChanged(int)
+{
+    updateWidgets();
+}
+
 void SearchFrame::on_caseCheckBox_toggled(bool)
 {
     regexCompile();
@@ -245,6 +261,17 @@ void SearchFrame::on_searchLineEdit_textChanged(const QString &)
 }
 
 void SearchFrame::on_findButton_clicked()
+{
+    findFrames(false);
+}
+
+void SearchFrame::on_markAllButton_clicked()
+{
+    findFrames(true);
+}
+
+// Find the next matching frame or, if mark_all is true, mark all of them.
+void SearchFrame::findFrames(bool mark_all)
 {
     guint8 *bytes = NULL;
     size_t nbytes;
@@ -342,6 +369,29 @@ void SearchFrame::on_findButton_clicked()
     g_free(cap_file_->sfilter);
     cap_file_->sfilter = g_strdup(sf_ui_->searchLineEdit->text().toUtf8().constData());
 
+    if (mark_all && (cap_file_->hex || (cap_file_->string && cap_file_->packet_data))) {
+        guint32 hits;
+
+        if (cap_file_->hex) {
+            hits = cf_find_all_packet_data(cap_file_, bytes, nbytes, mark_found_frame, NULL);
+        } else if (search_type == regex_search_ && !cap_file_->regex) {
+            g_free(string);
+            emit pushFilterSyntaxStatus(regex_error_);
+            return;
+        } else {
+            hits = cf_find_all_packet_data(cap_file_, (guint8 *) string, strlen(string), mark_found_frame, NULL);
+        }
+        g_free(bytes);
+        g_free(string);
+        if (hits > 0) {
+            emit framesMarked();
+        } else {
+            err_string = tr("No packet contained those bytes.");
+            emit pushFilterSyntaxStatus(err_string);
+        }
+        return;
+    }
+
     if (cap_file_->hex) {
         /* Hex value in packet data */
         found_packet = cf_find_packet_data(cap_file_, bytes, nbytes, cap_file_->dir);
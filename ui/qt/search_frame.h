@@ -50,6 +50,7 @@ public slots:
 
 signals:
     void pushFilterSyntaxStatus(const QString&);
+    void framesMarked();
 
 protected:
     virtual void keyPressEvent(QKeyEvent *event);
@@ -57,6 +58,7 @@ protected:
 private:
     bool regexCompile();
     void updateWidgets();
+    void findFrames(bool mark_all);
 
     Ui::SearchFrame *sf_ui_;
     capture_file *cap_file_;
@@ -64,10 +66,12 @@ private:
     QString regex_error_;
 
 private slots:
+    void on_searchInComboBox_currentIndexChanged(int);
     void on_caseCheckBox_toggled(bool);
     void on_searchTypeComboBox_currentIndexChanged(int);
     void on_searchLineEdit_textChanged(const QString &);
     void on_findButton_clicked();
+    void on_markAllButton_clicked();
     void on_cancelButton_clicked();
     void changeEvent(QEvent* event);
 };
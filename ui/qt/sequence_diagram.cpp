@@ -61,7 +61,7 @@ SequenceDiagram::SequenceDiagram(QCPAxis *keyAxis, QCPAxis *valueAxis, QCPAxis *
     selected_packet_(0),
     selected_key_(-1.0)
 {
-    data_ = new WSCPSeqDataMap();
+    data_ = new WSCPSeqDataVector();
     // xaxis (value): Address
     // yaxis (key): Time
     // yaxis2 (comment): Extra info ("Comment" in GTK+)
@@ -97,6 +97,9 @@ SequenceDiagram::SequenceDiagram(QCPAxis *keyAxis, QCPAxis *valueAxis, QCPAxis *
 
 //    setTickVectorLabels
     //    valueAxis->setTickLabelRotation(30);
+
+    // Time and comment labels are only created for the rows in view.
+    connect(key_axis_, SIGNAL(rangeChanged(QCPRange)), this, SLOT(keyRangeChanged(QCPRange)));
 }
 
 SequenceDiagram::~SequenceDiagram()
@@ -107,45 +110,43 @@ SequenceDiagram::~SequenceDiagram()
 int SequenceDiagram::adjacentPacket(bool next)
 {
     int adjacent_packet = -1;
-    WSCPSeqDataMap::const_iterator it;
+    int cur_key = -1;
 
     if (data_->size() < 1) return adjacent_packet;
 
     if (selected_packet_ < 1) {
-        if (next) {
-            it = data_->constBegin();
-        } else {
-            it = data_->constEnd();
-            --it;
-        }
-        selected_key_ = it.value().key;
-        return it.value().value->frame_number;
+        cur_key = next ? 0 : data_->size() - 1;
+        selected_key_ = cur_key;
+        return data_->at(cur_key).value->frame_number;
     }
 
-    if (next) {
-        for (it = data_->constBegin(); it != data_->constEnd(); ++it) {
-            if (it.value().value->frame_number == selected_packet_) {
-                ++it;
-                if (it != data_->constEnd()) {
-                    adjacent_packet = it.value().value->frame_number;
-                    selected_key_ = it.value().key;
-                }
+    // Start from the selected row if we drew it, otherwise look it up.
+    int selected_key = (int) selected_key_;
+    if (selected_key >= 0 && selected_key < data_->size()
+            && data_->at(selected_key).value->frame_number == selected_packet_) {
+        cur_key = selected_key;
+    } else if (next) {
+        for (int key = 0; key < data_->size(); key++) {
+            if (data_->at(key).value->frame_number == selected_packet_) {
+                cur_key = key;
                 break;
             }
         }
     } else {
-        it = data_->constEnd();
-        --it;
-        while (it != data_->constBegin()) {
-            guint32 prev_frame = it.value().value->frame_number;
-            --it;
-            if (prev_frame == selected_packet_) {
-                adjacent_packet = it.value().value->frame_number;
-                selected_key_ = it.value().key;
+        for (int key = data_->size() - 1; key >= 0; key--) {
+            if (data_->at(key).value->frame_number == selected_packet_) {
+                cur_key = key;
                 break;
             }
         }
     }
+    if (cur_key < 0) return adjacent_packet;
+
+    cur_key += next ? 1 : -1;
+    if (cur_key >= 0 && cur_key < data_->size()) {
+        adjacent_packet = data_->at(cur_key).value->frame_number;
+        selected_key_ = cur_key;
+    }
 
     return adjacent_packet;
 }
@@ -157,26 +158,14 @@ void SequenceDiagram::setData(_seq_analysis_info *sainfo)
     if (!sainfo) return;
 
     double cur_key = 0.0;
-    QVector<double> key_ticks, val_ticks;
-    QVector<QString> key_labels, val_labels, com_labels;
-    QFontMetrics com_fm(comment_axis_->tickLabelFont());
-    int elide_w = com_fm.height() * max_comment_em_width_;
+    QVector<double> val_ticks;
+    QVector<QString> val_labels;
     char* addr_str;
 
     for (GList *cur = g_queue_peek_nth_link(sainfo->items, 0); cur; cur = g_list_next(cur)) {
         seq_analysis_item_t *sai = (seq_analysis_item_t *) cur->data;
         if (sai->display) {
-            WSCPSeqData new_data;
-
-            new_data.key = cur_key;
-            new_data.value = sai;
-            data_->insertMulti(new_data.key, new_data);
-
-            key_ticks.append(cur_key);
-            key_labels.append(sai->time_str);
-
-            com_labels.append(com_fm.elidedText(sai->comment, Qt::ElideRight, elide_w));
-
+            data_->append(WSCPSeqData(cur_key, sai));
             cur_key++;
         }
     }
@@ -191,12 +180,9 @@ void SequenceDiagram::setData(_seq_analysis_info *sainfo)
 
         wmem_free(NULL, addr_str);
     }
-    keyAxis()->setTickVector(key_ticks);
-    keyAxis()->setTickVectorLabels(key_labels);
     valueAxis()->setTickVector(val_ticks);
     valueAxis()->setTickVectorLabels(val_labels);
-    comment_axis_->setTickVector(key_ticks);
-    comment_axis_->setTickVectorLabels(com_labels);
+    keyRangeChanged(key_axis_->range());
 }
 
 void SequenceDiagram::setSelectedPacket(int selected_packet)
@@ -215,7 +201,7 @@ _seq_analysis_item *SequenceDiagram::itemForPosY(int ypos)
     double key_pos = qRound(key_axis_->pixelToCoord(ypos));
 
     if (key_pos >= 0 && key_pos < data_->size()) {
-        return data_->value(key_pos).value;
+        return data_->at((int) key_pos).value;
     }
     return NULL;
 }
@@ -252,10 +238,12 @@ void SequenceDiagram::draw(QCPPainter *painter)
     painter->restore();
     fg_pen = mainPen();
 
-    WSCPSeqDataMap::const_iterator it;
-    for (it = data_->constBegin(); it != data_->constEnd(); ++it) {
-        double cur_key = it.key();
-        seq_analysis_item_t *sai = it.value().value;
+    // Only visit the rows in view. Large VoIP and flow graphs can have
+    // hundreds of thousands of items.
+    int first_key, last_key;
+    visibleKeys(key_axis_->range(), first_key, last_key);
+    for (int cur_key = first_key; cur_key <= last_key; cur_key++) {
+        seq_analysis_item_t *sai = data_->at(cur_key).value;
         QPen fg_pen(mainPen());
         QColor bg_color;
 
@@ -367,18 +355,10 @@ QCPRange SequenceDiagram::getKeyRange(bool &validRange, QCPAbstractPlottable::Si
     QCPRange range;
     bool valid = false;
 
-    WSCPSeqDataMap::const_iterator it = data_->constBegin();
-    while (it != data_->constEnd()) {
-        double cur_key = it.key();
-        if (!valid) {
-            range.lower = range.upper = cur_key;
-            valid = true;
-        } else if (cur_key < range.lower) {
-            range.lower = cur_key;
-        } else if (cur_key > range.upper) {
-            range.upper = cur_key;
-        }
-        ++it;
+    if (data_->size() > 0) {
+        range.lower = data_->first().key;
+        range.upper = data_->last().key;
+        valid = true;
     }
     validRange = valid;
     return range;
@@ -398,6 +378,36 @@ QCPRange SequenceDiagram::getValueRange(bool &validRange, QCPAbstractPlottable::
     return range;
 }
 
+void SequenceDiagram::visibleKeys(const QCPRange &range, int &first_key, int &last_key) const
+{
+    // Each row extends half a key above and below its key.
+    first_key = qMax(0, (int) (range.lower - 0.5));
+    last_key = qMin(data_->size() - 1, (int) (range.upper + 0.5));
+}
+
+void SequenceDiagram::keyRangeChanged(const QCPRange &range)
+{
+    QVector<double> key_ticks;
+    QVector<QString> key_labels, com_labels;
+    QFontMetrics com_fm(comment_axis_->tickLabelFont());
+    int elide_w = com_fm.height() * max_comment_em_width_;
+    int first_key, last_key;
+
+    visibleKeys(range, first_key, last_key);
+    for (int cur_key = first_key; cur_key <= last_key; cur_key++) {
+        seq_analysis_item_t *sai = data_->at(cur_key).value;
+
+        key_ticks.append(cur_key);
+        key_labels.append(sai->time_str);
+        com_labels.append(com_fm.elidedText(sai->comment, Qt::ElideRight, elide_w));
+    }
+
+    key_axis_->setTickVector(key_ticks);
+    key_axis_->setTickVectorLabels(key_labels);
+    comment_axis_->setTickVector(key_ticks);
+    comment_axis_->setTickVectorLabels(com_labels);
+}
+
 /*
  * Editor modelines
  *
@@ -29,7 +29,7 @@
 #include <epan/address.h>
 
 #include <QObject>
-#include <QMultiMap>
+#include <QVector>
 #include "qcustomplot.h"
 
 struct _seq_analysis_info;
@@ -45,7 +45,8 @@ public:
   struct _seq_analysis_item *value;
 };
 
-typedef QMap<double, WSCPSeqData> WSCPSeqDataMap;
+// Keys are contiguous row numbers starting at 0.
+typedef QVector<WSCPSeqData> WSCPSeqDataVector;
 
 class SequenceDiagram : public QCPAbstractPlottable
 {
@@ -83,10 +84,15 @@ private:
     QCPAxis *key_axis_;
     QCPAxis *value_axis_;
     QCPAxis *comment_axis_;
-    WSCPSeqDataMap *data_;
+    WSCPSeqDataVector *data_;
     struct _seq_analysis_info *sainfo_;
     guint32 selected_packet_;
     double selected_key_;
+
+    void visibleKeys(const QCPRange &range, int &first_key, int &last_key) const;
+
+private slots:
+    void keyRangeChanged(const QCPRange &range);
 };
 
 #endif // SEQUENCE_DIAGRAM_H
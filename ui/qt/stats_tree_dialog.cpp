@@ -95,7 +95,8 @@ void StatsTreeDialog::setupNode(stat_node* node)
 
     QTreeWidgetItem *ti = new StatsTreeWidgetItem(), *parent = NULL;
 
-    ti->setText(item_col_, node->name);
+    // The name is set along with the other columns in drawTreeItems, so
+    // that the names of keyed nodes are only formatted when they're shown.
     ti->setData(item_col_, Qt::UserRole, qVariantFromValue(node));
     node->pr = (st_node_pres *) ti;
     if (node->parent && node->parent->pr) {
@@ -107,7 +108,6 @@ void StatsTreeDialog::setupNode(stat_node* node)
     } else {
         st_dlg->statsTreeWidget()->addTopLevelItem(ti);
     }
-    st_dlg->statsTreeWidget()->resizeColumnToContents(item_col_);
 }
 
 void StatsTreeDialog::fillTree()
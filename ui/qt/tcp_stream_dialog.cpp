@@ -33,6 +33,8 @@
 #include "progress_frame.h"
 #include "wireshark_application.h"
 
+#include <algorithm>
+
 #include <QCursor>
 #include <QDir>
 #include <QFileDialog>
@@ -95,6 +97,8 @@ TCPStreamDialog::TCPStreamDialog(QWidget *parent, capture_file *cf, tcp_graph_ty
     struct segment current;
     int graph_idx = -1;
 
+    memset (&graph_, 0, sizeof(graph_));
+
     ui->setupUi(this);
     setAttribute(Qt::WA_DeleteOnClose, true);
 
@@ -157,7 +161,6 @@ TCPStreamDialog::TCPStreamDialog(QWidget *parent, capture_file *cf, tcp_graph_ty
     ctx_menu_.addAction(ui->actionTcptrace);
     ctx_menu_.addAction(ui->actionWindowScaling);
 
-    memset (&graph_, 0, sizeof(graph_));
     graph_.type = graph_type;
     copy_address(&graph_.src_address, &current.ip_src);
     graph_.src_port = current.th_sport;
@@ -223,12 +226,15 @@ TCPStreamDialog::TCPStreamDialog(QWidget *parent, capture_file *cf, tcp_graph_ty
     connect(sp, SIGNAL(axisClick(QCPAxis*,QCPAxis::SelectablePart,QMouseEvent*)),
             this, SLOT(axisClicked(QCPAxis*,QCPAxis::SelectablePart,QMouseEvent*)));
     connect(sp->yAxis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(transformYRange(QCPRange)));
+    connect(sp->xAxis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(xAxisRangeChanged(QCPRange)));
     disconnect(ui->buttonBox, SIGNAL(accepted()), this, SLOT(accept()));
     this->setResult(QDialog::Accepted);
 }
 
 TCPStreamDialog::~TCPStreamDialog()
 {
+    graph_segment_list_free(&graph_);
+    graph_stream_frames_free(&graph_);
     delete ui;
 }
 
@@ -370,6 +376,7 @@ void TCPStreamDialog::fillGraph()
         sp->graph(i)->clearData();
         sp->graph(i)->setVisible(i == 0 ? true : false);
     }
+    graph_data_.clear();
 
     base_graph_->setScatterStyle(QCPScatterStyle(QCPScatterStyle::ssDisc, pkt_point_size_));
 
@@ -521,6 +528,8 @@ void TCPStreamDialog::resetAxes()
     y_axis_xfrm_.reset();
     double pixel_pad = 10.0; // per side
 
+    // Rescale to all of the data, not just what's currently shown.
+    decimateGraphs(true);
     sp->rescaleAxes(true);
     tput_graph_->rescaleValueAxis(false, true);
 //    base_graph_->rescaleAxes(false, true);
@@ -565,7 +574,7 @@ void TCPStreamDialog::fillStevens()
         rel_time.append(ts - ts_offset_);
         seq.append(seg->th_seq - seq_offset_);
     }
-    base_graph_->setData(rel_time, seq);
+    setGraphData(base_graph_, rel_time, seq);
 }
 
 void TCPStreamDialog::fillTcptrace()
@@ -611,10 +620,10 @@ void TCPStreamDialog::fillTcptrace()
             rwin.append(ackno + seg->th_win);
         }
     }
-    base_graph_->setData(seq_time, seq);
-    seg_graph_->setDataValueError(sb_time, sb_center, sb_span);
-    ack_graph_->setData(ackrwin_time, ack);
-    rwin_graph_->setData(ackrwin_time, rwin);
+    setGraphData(base_graph_, seq_time, seq);
+    setGraphData(seg_graph_, sb_time, sb_center, sb_span);
+    setGraphData(ack_graph_, ackrwin_time, ack);
+    setGraphData(rwin_graph_, ackrwin_time, rwin);
 }
 
 void TCPStreamDialog::fillThroughput()
@@ -690,8 +699,8 @@ void TCPStreamDialog::fillThroughput()
             tput_time.append(ts);
         }
     }
-    base_graph_->setData(rel_time, seg_len);
-    tput_graph_->setData(tput_time, tput);
+    setGraphData(base_graph_, rel_time, seg_len);
+    setGraphData(tput_graph_, tput_time, tput);
 }
 
 void TCPStreamDialog::fillRoundTripTime()
@@ -745,7 +754,7 @@ void TCPStreamDialog::fillRoundTripTime()
             }
         }
     }
-    base_graph_->setData(seq_no, rtt);
+    setGraphData(base_graph_, seq_no, rtt);
 }
 
 void TCPStreamDialog::fillWindowScale()
@@ -771,7 +780,7 @@ void TCPStreamDialog::fillWindowScale()
             win_size.append(seg->th_win);
         }
     }
-    base_graph_->setData(rel_time, win_size);
+    setGraphData(base_graph_, rel_time, win_size);
     sp->yAxis->setLabel(window_size_label_);
 }
 
@@ -1023,6 +1032,122 @@ void TCPStreamDialog::transformYRange(const QCPRange &y_range1)
     sp->yAxis2->setRangeLower(yp2.y1());
 }
 
+void TCPStreamDialog::xAxisRangeChanged(const QCPRange &)
+{
+    decimateGraphs();
+}
+
+// Keep the full data for a graph, sorted by key. It's handed to the graph
+// by decimateGraphs, which resetAxes calls.
+void TCPStreamDialog::setGraphData(QCPGraph *graph, const QVector<double> &keys, const QVector<double> &values, const QVector<double> &value_errors)
+{
+    GraphData &gd = graph_data_[graph];
+    bool sorted = true;
+
+    for (int i = 1; i < keys.size(); i++) {
+        if (keys[i] < keys[i - 1]) {
+            sorted = false;
+            break;
+        }
+    }
+
+    if (sorted) {
+        gd.keys = keys;
+        gd.values = values;
+        gd.value_errors = value_errors;
+    } else {
+        // E.g. RTT values, which are keyed by sequence number.
+        QVector<QPair<double, int> > order(keys.size());
+        for (int i = 0; i < keys.size(); i++) {
+            order[i] = qMakePair(keys[i], i);
+        }
+        std::stable_sort(order.begin(), order.end());
+
+        gd.keys.resize(keys.size());
+        gd.values.resize(keys.size());
+        gd.value_errors.resize(value_errors.isEmpty() ? 0 : keys.size());
+        for (int i = 0; i < order.size(); i++) {
+            gd.keys[i] = order[i].first;
+            gd.values[i] = values[order[i].second];
+            if (!value_errors.isEmpty()) {
+                gd.value_errors[i] = value_errors[order[i].second];
+            }
+        }
+    }
+}
+
+// Hand each graph the points in the visible key range (or all of them if
+// full_range is set). If a line graph has more than a few per pixel, keep
+// the first, last, lowest and highest point in each pixel column so that
+// lines and extremes look the same as they would with all of the points,
+// while QCustomPlot only has to store and draw a bounded number of them.
+// Graphs that draw each point (the packet dots and the tcptrace segment
+// bars) get all of their points in the range, as those in between would
+// go missing, and the tracer can only land on points it's given.
+void TCPStreamDialog::decimateGraphs(bool full_range)
+{
+    QCustomPlot *sp = ui->streamPlot;
+    int pixels = qMax(sp->xAxis->axisRect()->width(), min_zoom_pixels_);
+
+    foreach (QCPGraph *graph, graph_data_.keys()) {
+        const GraphData &gd = graph_data_[graph];
+        const QVector<double> &keys = gd.keys;
+        bool has_errors = !gd.value_errors.isEmpty();
+        QCPRange range;
+        int first = 0, last = keys.size();
+
+        if (keys.isEmpty()) {
+            graph->clearData();
+            continue;
+        }
+
+        if (full_range) {
+            range = QCPRange(keys.first(), keys.last());
+        } else {
+            range = sp->xAxis->range();
+            // Include a point on either side of the range so that lines
+            // reach the edges of the plot.
+            first = std::lower_bound(keys.constBegin(), keys.constEnd(), range.lower) - keys.constBegin();
+            last = std::upper_bound(keys.constBegin(), keys.constEnd(), range.upper) - keys.constBegin();
+            if (first > 0) first--;
+            if (last < keys.size()) last++;
+        }
+
+        QVector<double> d_keys, d_values, d_errors;
+        if (last - first <= pixels * 4 || range.size() <= 0.0 ||
+                !graph->scatterStyle().isNone() || has_errors) {
+            d_keys = keys.mid(first, last - first);
+            d_values = gd.values.mid(first, last - first);
+            if (has_errors) d_errors = gd.value_errors.mid(first, last - first);
+        } else {
+            double px_width = range.size() / pixels;
+            int i = first;
+            while (i < last) {
+                double column = floor((keys[i] - range.lower) / px_width);
+                int lo = i, hi = i, j = i + 1;
+                while (j < last && floor((keys[j] - range.lower) / px_width) == column) {
+                    if (gd.values[j] < gd.values[lo]) lo = j;
+                    if (gd.values[j] > gd.values[hi]) hi = j;
+                    j++;
+                }
+                int keep[4] = { i, qMin(lo, hi), qMax(lo, hi), j - 1 };
+                for (int k = 0; k < 4; k++) {
+                    if (k > 0 && keep[k] == keep[k - 1]) continue;
+                    d_keys.append(keys[keep[k]]);
+                    d_values.append(gd.values[keep[k]]);
+                }
+                i = j;
+            }
+        }
+
+        if (has_errors) {
+            graph->setDataValueError(d_keys, d_values, d_errors);
+        } else {
+            graph->setData(d_keys, d_values);
+        }
+    }
+}
+
 void TCPStreamDialog::on_buttonBox_accepted()
 {
     QString file_name, extension;
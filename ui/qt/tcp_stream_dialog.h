@@ -90,6 +90,16 @@ private:
     int num_acks_;
     int num_sack_ranges_;
 
+    // The full data of each graph. QCustomPlot is only handed the part that
+    // is in the visible key range, decimated to a few points per pixel if
+    // it's only drawn as a line.
+    struct GraphData {
+        QVector<double> keys;
+        QVector<double> values;
+        QVector<double> value_errors;
+    };
+    QMap<QCPGraph *, GraphData> graph_data_;
+
     void findStream();
     void fillGraph();
     void zoomAxes(bool in);
@@ -106,6 +116,8 @@ private:
     bool compareHeaders(struct segment *seg);
     void toggleTracerStyle(bool force_default = false);
     QRectF getZoomRanges(QRect zoom_rect);
+    void setGraphData(QCPGraph *graph, const QVector<double> &keys, const QVector<double> &values, const QVector<double> &value_errors = QVector<double>());
+    void decimateGraphs(bool full_range = false);
 
 private slots:
     void graphClicked(QMouseEvent *event);
@@ -113,6 +125,7 @@ private slots:
     void mouseMoved(QMouseEvent *event);
     void mouseReleased(QMouseEvent *event);
     void transformYRange(const QCPRange &y_range1);
+    void xAxisRangeChanged(const QCPRange &x_range);
     void on_buttonBox_accepted();
     void on_graphTypeComboBox_currentIndexChanged(int index);
     void on_resetButton_clicked();
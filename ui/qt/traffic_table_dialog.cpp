@@ -59,7 +59,8 @@ TrafficTableDialog::TrafficTableDialog(QWidget &parent, CaptureFile &cf, const c
     ui(new Ui::TrafficTableDialog),
     cap_file_(cf),
     file_closed_(false),
-    filter_(filter)
+    filter_(filter),
+    table_cache_(TrafficTableCache::instance(cf))
 {
     ui->setupUi(this);
     loadGeometry(parent.width(), parent.height() * 3 / 4);
@@ -126,6 +127,26 @@ void TrafficTableDialog::addProgressFrame(QObject *parent)
     ProgressFrame::addToButtonBox(ui->buttonBox, parent);
 }
 
+const QString TrafficTableDialog::tapFilter() const
+{
+    if (ui->displayFilterCheckBox->isChecked()) {
+        capture_file *cf = cap_file_.capFile();
+        return cf ? QString(cf->dfilter) : QString();
+    }
+    return filter_;
+}
+
+bool TrafficTableDialog::loadCachedTables()
+{
+    QString filter = tapFilter();
+    foreach (TrafficTableTreeWidget *tree, proto_id_to_tree_) {
+        if (!tree->loadCachedTable(table_cache_, filter)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 QDialogButtonBox *TrafficTableDialog::buttonBox() const
 {
     return ui->buttonBox;
@@ -176,7 +197,9 @@ void TrafficTableDialog::on_displayFilterCheckBox_toggled(bool checked)
         set_tap_dfilter(cur_tree->trafficTreeHash(), filter);
     }
 
-    cap_file_.retapPackets();
+    if (!loadCachedTables()) {
+        cap_file_.retapPackets();
+    }
 }
 
 void TrafficTableDialog::retapStarted()
@@ -187,6 +210,11 @@ void TrafficTableDialog::retapStarted()
 void TrafficTableDialog::retapFinished()
 {
     ui->displayFilterCheckBox->setEnabled(true);
+
+    QString filter = tapFilter();
+    foreach (TrafficTableTreeWidget *tree, proto_id_to_tree_) {
+        tree->saveCachedTable(table_cache_, filter);
+    }
 }
 
 void TrafficTableDialog::setTabText(QWidget *tree, const QString &text)
@@ -215,7 +243,7 @@ void TrafficTableDialog::toggleTable()
         ui->trafficTableTabWidget->setCurrentWidget(proto_id_to_tree_[proto_id]);
     }
 
-    if (new_table) {
+    if (new_table && !proto_id_to_tree_[proto_id]->loadCachedTable(table_cache_, tapFilter())) {
         cap_file_.retapPackets();
     }
 }
@@ -298,6 +326,8 @@ TrafficTableTreeWidget::TrafficTableTreeWidget(QWidget *parent, register_ct_t *t
     QTreeWidget(parent),
     table_(table),
     hash_(),
+    merge_table_(NULL),
+    reset_table_(NULL),
     resolve_names_(false)
 {
     setRootIsDecorated(false);
@@ -335,6 +365,33 @@ QList<QVariant> TrafficTableTreeWidget::rowData(int row) const
     return row_data;
 }
 
+bool TrafficTableTreeWidget::loadCachedTable(TrafficTableCache *cache, const QString &filter)
+{
+    if (!merge_table_ || !reset_table_) {
+        return false;
+    }
+
+    QString key = QString("%1 %2 %3").arg(metaObject()->className()).arg(get_conversation_proto_id(table_)).arg(filter);
+
+    // Our items point into the table.
+    clear();
+    if (!cache->load(key, &hash_, merge_table_, reset_table_)) {
+        return false;
+    }
+    updateItems(false);
+    return true;
+}
+
+void TrafficTableTreeWidget::saveCachedTable(TrafficTableCache *cache, const QString &filter)
+{
+    if (!merge_table_ || !reset_table_) {
+        return;
+    }
+
+    QString key = QString("%1 %2 %3").arg(metaObject()->className()).arg(get_conversation_proto_id(table_)).arg(filter);
+    cache->save(key, &hash_, merge_table_, reset_table_);
+}
+
 void TrafficTableTreeWidget::setNameResolutionEnabled(bool enable)
 {
     if (resolve_names_ != enable) {
@@ -360,6 +417,93 @@ void TrafficTableTreeWidget::updateItemsForSettingChange()
     updateItems(true);
 }
 
+TrafficTableCache::TrafficTableCache(CaptureFile &cf) :
+    QObject(&cf),
+    cap_file_(cf),
+    count_(0)
+{
+    // Anything that changes the packets or how they're dissected
+    // invalidates our tables.
+    connect(&cap_file_, SIGNAL(captureFileReadStarted()), this, SLOT(clear()));
+    connect(&cap_file_, SIGNAL(captureFileReloadStarted()), this, SLOT(clear()));
+    connect(&cap_file_, SIGNAL(captureFileRescanStarted()), this, SLOT(clear()));
+    connect(&cap_file_, SIGNAL(captureFileTimesChanged()), this, SLOT(clear()));
+    connect(&cap_file_, SIGNAL(captureFileClosing()), this, SLOT(clear()));
+}
+
+TrafficTableCache::~TrafficTableCache()
+{
+    clear();
+}
+
+TrafficTableCache *TrafficTableCache::instance(CaptureFile &cf)
+{
+    TrafficTableCache *cache = cf.findChild<TrafficTableCache *>();
+    if (!cache) {
+        cache = new TrafficTableCache(cf);
+    }
+    return cache;
+}
+
+bool TrafficTableCache::load(const QString &key, conv_hash_t *hash, merge_func merge, reset_func reset)
+{
+    if (!isUsable()) {
+        return false;
+    }
+
+    CachedTable *table = tables_.value(key);
+    if (!table) {
+        return false;
+    }
+
+    reset(hash);
+    merge(hash, &table->hash);
+    return true;
+}
+
+void TrafficTableCache::save(const QString &key, const conv_hash_t *hash, merge_func merge, reset_func reset)
+{
+    if (!isUsable()) {
+        capture_file *cf = cap_file_.capFile();
+        if (!cf || cf->state != FILE_READ_DONE) {
+            return;
+        }
+        count_ = cf->count;
+    }
+
+    CachedTable *table = tables_.take(key);
+    if (table) {
+        table->reset(&table->hash);
+    } else {
+        table = new CachedTable();
+    }
+    table->reset = reset;
+    merge(&table->hash, hash);
+    tables_.insert(key, table);
+}
+
+void TrafficTableCache::clear()
+{
+    foreach (CachedTable *table, tables_) {
+        table->reset(&table->hash);
+        delete table;
+    }
+    tables_.clear();
+}
+
+// Our tables are complete only if the file has been read and no packets
+// have been added since we saved them.
+bool TrafficTableCache::isUsable()
+{
+    capture_file *cf = cap_file_.capFile();
+
+    if (!cf || cf->state != FILE_READ_DONE || cf->count != count_) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
 /*
  * Editor modelines
  *
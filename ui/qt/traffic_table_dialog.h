@@ -35,6 +35,7 @@
 #include "wireshark_dialog.h"
 
 #include <QDialog>
+#include <QHash>
 #include <QMenu>
 #include <QTreeWidgetItem>
 
@@ -48,6 +49,43 @@ namespace Ui {
 class TrafficTableDialog;
 }
 
+// Tables filled by earlier retaps of the current capture file, keyed by
+// table type, protocol and tap filter. Reopening a dialog or enabling a
+// table we've already filled copies the cached table instead of retapping.
+class TrafficTableCache : public QObject
+{
+    Q_OBJECT
+public:
+    typedef void (*merge_func)(conv_hash_t *ch, const conv_hash_t *src_ch);
+    typedef void (*reset_func)(conv_hash_t *ch);
+
+    // The cache for cf, which owns it.
+    static TrafficTableCache *instance(CaptureFile &cf);
+
+    // Replace the contents of hash with a cached table. Returns false if
+    // we don't have one.
+    bool load(const QString &key, conv_hash_t *hash, merge_func merge, reset_func reset);
+    void save(const QString &key, const conv_hash_t *hash, merge_func merge, reset_func reset);
+
+public slots:
+    void clear();
+
+private:
+    explicit TrafficTableCache(CaptureFile &cf);
+    ~TrafficTableCache();
+
+    struct CachedTable {
+        conv_hash_t hash;
+        reset_func reset;
+    };
+
+    CaptureFile &cap_file_;
+    guint32 count_;
+    QHash<QString, CachedTable *> tables_;
+
+    bool isUsable();
+};
+
 class TrafficTableTreeWidgetItem : public QTreeWidgetItem
 {
 public:
@@ -75,10 +113,18 @@ public slots:
     const QString &trafficTreeTitle() { return title_; }
     conv_hash_t* trafficTreeHash() {return &hash_;}
 
+    // Fill our table from the cache instead of tapping. Returns false if
+    // the cache doesn't have it.
+    bool loadCachedTable(TrafficTableCache *cache, const QString &filter);
+    void saveCachedTable(TrafficTableCache *cache, const QString &filter);
+
 protected:
     register_ct_t* table_;
     QString title_;
     conv_hash_t hash_;
+    // Set by subclasses to the merge and reset functions for their table type.
+    TrafficTableCache::merge_func merge_table_;
+    TrafficTableCache::reset_func reset_table_;
     bool resolve_names_;
     QMenu ctx_menu_;
 
@@ -127,12 +173,18 @@ protected:
     QMenu traffic_type_menu_;
     QPushButton *copy_bt_;
     QMap<int, TrafficTableTreeWidget *> proto_id_to_tree_;
+    TrafficTableCache *table_cache_;
 
     const QList<int> defaultProtos() const;
     void fillTypeMenu(QList<int> &enabled_protos);
     // Adds a conversation tree. Returns true if the tree was freshly created, false if it was cached.
     virtual bool addTrafficTable(register_ct_t*) { return false; }
     void addProgressFrame(QObject *parent);
+    // The filter our tables are tapped with.
+    const QString tapFilter() const;
+    // Fill our tables from the table cache. Returns false if any of them
+    // must be tapped.
+    bool loadCachedTables();
 
     // UI getters
     QDialogButtonBox *buttonBox() const;
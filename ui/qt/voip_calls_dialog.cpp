@@ -26,6 +26,7 @@
 
 #include "epan/addr_resolv.h"
 #include "epan/dissectors/packet-h225.h"
+#include "epan/tap.h"
 
 #include "ui/rtp_stream.h"
 #include <wsutil/utf8_entities.h>
@@ -71,7 +72,8 @@ class VoipCallsTreeWidgetItem : public QTreeWidgetItem
 public:
     VoipCallsTreeWidgetItem(QTreeWidget *tree, voip_calls_info_t *call_info) :
         QTreeWidgetItem(tree, voip_calls_type_),
-        call_info_(call_info)
+        call_info_(call_info),
+        drawn_npackets_(0)
     {
         drawData();
     }
@@ -82,12 +84,20 @@ public:
         return call_info_;
     }
 
+    // Every change to a call comes with a new packet, so a call that
+    // hasn't grown since it was last drawn doesn't need redrawing.
+    bool changed() {
+        return call_info_ && call_info_->npackets != drawn_npackets_;
+    }
+
     void drawData() {
         if (!call_info_) {
             setText(start_time_col_, QObject::tr("Error"));
             return;
         }
 
+        drawn_npackets_ = call_info_->npackets;
+
         // XXX Pull digit count from capture file precision
         setText(start_time_col_, QString::number(nstime_to_sec(&(call_info_->start_rel_ts)), 'f', 6));
         setText(stop_time_col_, QString::number(nstime_to_sec(&(call_info_->stop_rel_ts)), 'f', 6));
@@ -170,6 +180,7 @@ public:
     }
 private:
     voip_calls_info_t *call_info_;
+    guint32 drawn_npackets_;
 };
 
 VoipCallsDialog::VoipCallsDialog(QWidget &parent, CaptureFile &cf, bool all_flows) :
@@ -202,6 +213,9 @@ VoipCallsDialog::VoipCallsDialog(QWidget &parent, CaptureFile &cf, bool all_flow
 
     voip_calls_init_all_taps(&tapinfo_);
 
+    connect(&cap_file_, SIGNAL(captureCaptureUpdateFinished(capture_session*)),
+            this, SLOT(captureUpdateFinished()));
+
     updateWidgets();
 
     if (cap_file_.isValid()) {
@@ -222,10 +236,22 @@ VoipCallsDialog::~VoipCallsDialog()
 
 void VoipCallsDialog::endRetapPackets()
 {
-    voip_calls_remove_all_tap_listeners(&tapinfo_);
+    // During a live capture keep tapping so that the calls are updated
+    // from new packets as they arrive.
+    if (!cap_file_.capFile() || cap_file_.capFile()->state != FILE_READ_IN_PROGRESS) {
+        voip_calls_remove_all_tap_listeners(&tapinfo_);
+    }
     WiresharkDialog::endRetapPackets();
 }
 
+void VoipCallsDialog::captureUpdateFinished()
+{
+    // Pick up the packets that arrived since the last periodic draw
+    // before the listeners go away.
+    draw_tap_listeners(TRUE);
+    voip_calls_remove_all_tap_listeners(&tapinfo_);
+}
+
 void VoipCallsDialog::captureFileClosing()
 {
     voip_calls_remove_all_tap_listeners(&tapinfo_);
@@ -277,16 +303,13 @@ void VoipCallsDialog::tapDraw(void *tapinfo_ptr)
         return;
     }
 
-    GList *graph_item = g_queue_peek_nth_link(tapinfo->graph_analysis->items, 0);
-    for (; graph_item; graph_item = g_list_next(graph_item)) {
-        for (GList *rsi_entry = g_list_first(tapinfo->rtp_stream_list); rsi_entry; rsi_entry = g_list_next(rsi_entry)) {
-            seq_analysis_item_t * sai = (seq_analysis_item_t *)graph_item->data;
-            rtp_stream_info_t *rsi = (rtp_stream_info_t *)rsi_entry->data;
+    for (GList *rsi_entry = g_list_first(tapinfo->rtp_stream_list); rsi_entry; rsi_entry = g_list_next(rsi_entry)) {
+        rtp_stream_info_t *rsi = (rtp_stream_info_t *)rsi_entry->data;
+        seq_analysis_item_t *sai = (seq_analysis_item_t *)g_hash_table_lookup(tapinfo->graph_analysis->ht, &rsi->start_fd->num);
 
-            if (rsi->start_fd->num == sai->frame_number) {
-                rsi->call_num = sai->conv_num;
-                // VOIP_CALLS_DEBUG("setting conv num %u for frame %u", sai->conv_num, sai->frame_number);
-            }
+        if (sai) {
+            rsi->call_num = sai->conv_num;
+            // VOIP_CALLS_DEBUG("setting conv num %u for frame %u", sai->conv_num, sai->frame_number);
         }
     }
 
@@ -299,6 +322,7 @@ void VoipCallsDialog::tapDraw(void *tapinfo_ptr)
 void VoipCallsDialog::updateCalls()
 {
     GList *cur_call = g_queue_peek_nth_link(tapinfo_.callsinfos, ui->callTreeWidget->topLevelItemCount());
+    bool calls_added = cur_call != NULL;
     ui->callTreeWidget->setSortingEnabled(false);
 
     // Add any missing items
@@ -308,17 +332,21 @@ void VoipCallsDialog::updateCalls()
         cur_call = g_list_next(cur_call);
     }
 
-    // Fill in the tree
+    // Fill in the calls that got packets since the last update
     QTreeWidgetItemIterator iter(ui->callTreeWidget);
     while (*iter) {
         VoipCallsTreeWidgetItem *vcti = static_cast<VoipCallsTreeWidgetItem*>(*iter);
-        vcti->drawData();
+        if (vcti->changed()) {
+            vcti->drawData();
+        }
         ++iter;
     }
 
     // Resize columns
-    for (int i = 0; i < ui->callTreeWidget->columnCount(); i++) {
-        ui->callTreeWidget->resizeColumnToContents(i);
+    if (calls_added) {
+        for (int i = 0; i < ui->callTreeWidget->columnCount(); i++) {
+            ui->callTreeWidget->resizeColumnToContents(i);
+        }
     }
 
     ui->callTreeWidget->setSortingEnabled(true);
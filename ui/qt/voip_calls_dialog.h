@@ -90,6 +90,7 @@ private:
 
 private slots:
     void captureFileClosing();
+    void captureUpdateFinished();
     void on_callTreeWidget_itemActivated(QTreeWidgetItem *item, int);
     void on_callTreeWidget_itemSelectionChanged();
     void on_actionSelect_All_triggered();
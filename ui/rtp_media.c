@@ -26,6 +26,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include <codecs/codecs.h>
 
 #include <epan/rtp_pt.h>
@@ -44,22 +46,14 @@ typedef struct _rtp_decoder_t {
 
 /****************************************************************************/
 /*
- * Return the number of decoded bytes
+ * Find or set up the decoder for a packet's payload type
  */
-
-size_t
-decode_rtp_packet(rtp_packet_t *rp, SAMPLE **out_buff, GHashTable *decoders_hash, unsigned *channels_ptr, unsigned *sample_rate_ptr)
+static rtp_decoder_t *
+rtp_decoder_lookup(rtp_packet_t *rp, GHashTable *decoders_hash)
 {
     unsigned int  payload_type;
     const gchar *p;
     rtp_decoder_t *decoder;
-    SAMPLE *tmp_buff = NULL;
-    size_t tmp_buff_len;
-    size_t decoded_bytes = 0;
-
-    if ((rp->payload_data == NULL) || (rp->info->info_payload_len == 0) ) {
-        return 0;
-    }
 
     payload_type = rp->info->info_payload_type;
 
@@ -83,6 +77,26 @@ decode_rtp_packet(rtp_packet_t *rp, SAMPLE **out_buff, GHashTable *decoders_hash
         }
         g_hash_table_insert(decoders_hash, GUINT_TO_POINTER(payload_type), decoder);
     }
+    return decoder;
+}
+
+/*
+ * Return the number of decoded bytes
+ */
+
+size_t
+decode_rtp_packet(rtp_packet_t *rp, SAMPLE **out_buff, GHashTable *decoders_hash, unsigned *channels_ptr, unsigned *sample_rate_ptr)
+{
+    rtp_decoder_t *decoder;
+    SAMPLE *tmp_buff = NULL;
+    size_t tmp_buff_len;
+    size_t decoded_bytes = 0;
+
+    if ((rp->payload_data == NULL) || (rp->info->info_payload_len == 0) ) {
+        return 0;
+    }
+
+    decoder = rtp_decoder_lookup(rp, decoders_hash);
     if (decoder->handle) {  /* Decode with registered codec */
         tmp_buff_len = codec_decode(decoder->handle, decoder->context, rp->payload_data, rp->info->info_payload_len, NULL, NULL);
         tmp_buff = (SAMPLE *)g_malloc(tmp_buff_len);
@@ -104,6 +118,60 @@ decode_rtp_packet(rtp_packet_t *rp, SAMPLE **out_buff, GHashTable *decoders_hash
     return 0;
 }
 
+/*
+ * Decode the run of packets at the start of rps that share a payload type
+ */
+guint
+decode_rtp_packets(rtp_packet_t **rps, guint count, SAMPLE **out_buff, size_t *decoded_bytes, GHashTable *decoders_hash, unsigned *channels_ptr, unsigned *sample_rate_ptr)
+{
+    rtp_decoder_t *decoder;
+    const void **inputs;
+    size_t *input_lens;
+    size_t buff_len;
+    guint run, i;
+
+    *out_buff = NULL;
+    if (count < 1) {
+        return 0;
+    }
+
+    for (run = 1; run < count; run++) {
+        if (rps[run]->info->info_payload_type != rps[0]->info->info_payload_type)
+            break;
+    }
+    memset(decoded_bytes, 0, run * sizeof(size_t));
+
+    decoder = rtp_decoder_lookup(rps[0], decoders_hash);
+    if (!decoder->handle) {
+        return run;
+    }
+
+    inputs = g_new(const void *, run);
+    input_lens = g_new(size_t, run);
+    for (i = 0; i < run; i++) {
+        inputs[i] = rps[i]->payload_data;
+        input_lens[i] = rps[i]->payload_data ? rps[i]->info->info_payload_len : 0;
+    }
+
+    buff_len = codec_decode_batch(decoder->handle, decoder->context, run, inputs, input_lens, NULL, 0, NULL);
+    if (buff_len > 0) {
+        *out_buff = (SAMPLE *)g_malloc(buff_len);
+        codec_decode_batch(decoder->handle, decoder->context, run, inputs, input_lens, *out_buff, buff_len, decoded_bytes);
+    }
+    g_free(inputs);
+    g_free(input_lens);
+
+    if (channels_ptr) {
+        *channels_ptr = codec_get_channels(decoder->handle, decoder->context);
+    }
+
+    if (sample_rate_ptr) {
+        *sample_rate_ptr = codec_get_frequency(decoder->handle, decoder->context);
+    }
+
+    return run;
+}
+
 /****************************************************************************/
 static void
 rtp_decoder_value_destroy(gpointer dec_arg)
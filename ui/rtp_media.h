@@ -71,6 +71,23 @@ GHashTable *rtp_decoder_hash_table_new(void);
  */
 size_t decode_rtp_packet(rtp_packet_t *rp, SAMPLE **out_buff, GHashTable *decoders_hash, unsigned *channels_ptr, unsigned *sample_rate_ptr);
 
+/** Decode consecutive RTP packets that have the same payload type with
+ * a single batch decode. Decoding stops at the first change of payload
+ * type.
+ *
+ * @param rps Wrappers for per-packet RTP tap data.
+ * @param count Number of packets in rps.
+ * @param out_buff Output audio samples for all of the decoded packets,
+ * back to back, or NULL if nothing was decoded. Free with g_free.
+ * @param decoded_bytes Receives the number of decoded bytes for each
+ * packet. Must have room for count entries.
+ * @param decoders_hash Hash table created with rtp_decoder_hash_table_new.
+ * @param channels_ptr If non-NULL, receives the number of channels in the sample.
+ * @param sample_rate_ptr If non-NULL, receives the sample rate.
+ * @return The number of packets handled, which is at least 1 unless count is 0.
+ */
+guint decode_rtp_packets(rtp_packet_t **rps, guint count, SAMPLE **out_buff, size_t *decoded_bytes, GHashTable *decoders_hash, unsigned *channels_ptr, unsigned *sample_rate_ptr);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -73,6 +73,7 @@ typedef struct _rtp_stream_info {
 
     gboolean        decode; /**< Decode this stream. GTK+ only? */
     GList          *rtp_packet_list; /**< List of RTP rtp_packet_t. GTK+ only */
+    GArray         *packet_index; /**< rtp_packet_index_t for each RTPv2 packet. Set by rtpstream_packet. */
 
     tap_rtp_stat_t  rtp_stats;  /**< here goes the RTP statistics info */
     gboolean        problem;    /**< if the streams had wrong sequence numbers or wrong timestamps */
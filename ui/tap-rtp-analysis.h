@@ -125,11 +125,47 @@ typedef struct _tap_rtp_stat_t {
 /* forward */
 struct _rtp_info;
 
+/** The parts of an RTP packet that rtp_packet_analyse looks at, so that
+ * a stream can be analysed again without retapping.
+ */
+typedef struct _rtp_packet_index_t {
+    guint32     frame_num;
+    guint32     pkt_len;
+    nstime_t    rel_ts;
+    guint32     timestamp;
+    guint32     data_len;
+    guint32     clock_rate;     /**< 0 if unknown */
+    guint16     seq_num;
+    guint8      payload_type;
+    guint8      marker_set : 1;
+    guint8      t_event : 1;    /**< telephone-event payload */
+    guint8      dup_mac : 1;    /**< source MAC differs from the first packet's */
+} rtp_packet_index_t;
+
 /* function for analysing an RTP packet. Called from rtp_analysis and rtp_streams */
 extern void rtp_packet_analyse(tap_rtp_stat_t *statinfo,
                               packet_info *pinfo,
                               const struct _rtp_info *rtpinfo);
 
+/** Fill in a packet index entry.
+ *
+ * @param pkt The entry.
+ * @param statinfo The stream's statistics before the packet is analysed.
+ * @param pinfo Packet info.
+ * @param rtpinfo RTP tap data.
+ */
+extern void rtp_packet_index_set(rtp_packet_index_t *pkt,
+                              const tap_rtp_stat_t *statinfo,
+                              packet_info *pinfo,
+                              const struct _rtp_info *rtpinfo);
+
+/** Analyse an RTP packet from a packet index. Feeding a stream's index
+ * entries through this in order gives the same results as calling
+ * rtp_packet_analyse while tapping.
+ */
+extern void rtp_packet_analyse_index(tap_rtp_stat_t *statinfo,
+                              const rtp_packet_index_t *pkt);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
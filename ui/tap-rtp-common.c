@@ -88,7 +88,10 @@ void rtpstream_reset(rtpstream_tapinfo_t *tapinfo)
 		list = g_list_first(tapinfo->strinfo_list);
 		while (list)
 		{
-			g_free(list->data);
+			rtp_stream_info_t *stream_info = (rtp_stream_info_t *)list->data;
+			if (stream_info->packet_index)
+				g_array_free(stream_info->packet_index, TRUE);
+			g_free(stream_info);
 			list = g_list_next(list);
 		}
 		g_list_free(tapinfo->strinfo_list);
@@ -204,6 +207,7 @@ int rtpstream_packet(void *arg, packet_info *pinfo, epan_dissect_t *edt _U_, con
 	rtp_stream_info_t *stream_info = NULL;
 	GList* list;
 	rtpdump_info_t rtpdump_info;
+	rtp_packet_index_t pkt;
 
 	struct _rtp_conversation_info *p_conv_data = NULL;
 
@@ -238,6 +242,7 @@ int rtpstream_packet(void *arg, packet_info *pinfo, epan_dissect_t *edt _U_, con
 			/* reset RTP stats */
 			new_stream_info.rtp_stats.first_packet = TRUE;
 			new_stream_info.rtp_stats.reg_pt = PT_UNDEFINED;
+			new_stream_info.packet_index = g_array_new(FALSE, FALSE, sizeof(rtp_packet_index_t));
 
 			/* Get the Setup frame number who set this RTP stream */
 			p_conv_data = (struct _rtp_conversation_info *)p_get_proto_data(wmem_file_scope(), pinfo, proto_get_id_by_filter_name("rtp"), 0);
@@ -251,8 +256,17 @@ int rtpstream_packet(void *arg, packet_info *pinfo, epan_dissect_t *edt _U_, con
 			tapinfo->strinfo_list = g_list_append(tapinfo->strinfo_list, stream_info);
 		}
 
-		/* get RTP stats for the packet */
-		rtp_packet_analyse(&(stream_info->rtp_stats), pinfo, rtpinfo);
+		/* get RTP stats for the packet, keeping what the analysis
+		 * looked at so that the stream can be analysed again without
+		 * retapping */
+		rtp_packet_index_set(&pkt, &(stream_info->rtp_stats), pinfo, rtpinfo);
+		if (rtpinfo->info_version == 2) {
+			g_array_append_val(stream_info->packet_index, pkt);
+		}
+		if (stream_info->rtp_stats.first_packet && pinfo->dl_src.type == AT_ETHER) {
+			copy_address(&(stream_info->rtp_stats.first_packet_mac_addr), &(pinfo->dl_src));
+		}
+		rtp_packet_analyse_index(&(stream_info->rtp_stats), &pkt);
 		if (stream_info->rtp_stats.flags & STAT_FLAG_WRONG_TIMESTAMP
 				|| stream_info->rtp_stats.flags & STAT_FLAG_WRONG_SEQ)
 			stream_info->problem = TRUE;
@@ -414,9 +428,57 @@ get_dyn_pt_clock_rate(const gchar *payload_type_str)
 
 /****************************************************************************/
 void
-rtp_packet_analyse(tap_rtp_stat_t *statinfo,
+rtp_packet_index_set(rtp_packet_index_t *pkt,
+		       const tap_rtp_stat_t *statinfo,
 		       packet_info *pinfo,
 		       const struct _rtp_info *rtpinfo)
+{
+	memset(pkt, 0, sizeof(rtp_packet_index_t));
+	pkt->frame_num = pinfo->num;
+	pkt->pkt_len = pinfo->fd->pkt_len;
+	pkt->rel_ts = pinfo->rel_ts;
+	pkt->timestamp = rtpinfo->info_timestamp;
+	pkt->data_len = rtpinfo->info_data_len;
+	pkt->seq_num = rtpinfo->info_seq_num;
+	pkt->payload_type = rtpinfo->info_payload_type;
+	pkt->marker_set = rtpinfo->info_marker_set ? 1 : 0;
+
+	/* Chek for duplicates (src mac differs from first_packet_mac_addr) */
+	if (!statinfo->first_packet && pinfo->dl_src.type == AT_ETHER
+		&& !addresses_equal(&(statinfo->first_packet_mac_addr), &(pinfo->dl_src))) {
+		pkt->dup_mac = 1;
+	}
+
+	/*
+	 * Unknown payload types get a clock rate of 0
+	 */
+	if (rtpinfo->info_payload_type < 96 ){
+		pkt->clock_rate = get_clock_rate(rtpinfo->info_payload_type);
+	}else{ /* Dynamic PT */
+		if ( rtpinfo->info_payload_type_str != NULL ){
+			/* Is it a "telephone-event" ?
+			 * Timestamp is not increased for telepone-event packets impacting
+			 * calculation of Jitter Skew and clock drift.
+			 * see 2.2.1 of RFC 4733
+			 */
+			if (g_ascii_strncasecmp("telephone-event",rtpinfo->info_payload_type_str,(strlen("telephone-event")))==0){
+				pkt->clock_rate = 0;
+				pkt->t_event = 1;
+			}else{
+				if(rtpinfo->info_payload_rate !=0){
+					pkt->clock_rate = rtpinfo->info_payload_rate;
+				}else{
+					pkt->clock_rate = get_dyn_pt_clock_rate(rtpinfo->info_payload_type_str);
+				}
+			}
+		}
+	}
+}
+
+/****************************************************************************/
+void
+rtp_packet_analyse_index(tap_rtp_stat_t *statinfo,
+		       const rtp_packet_index_t *pkt)
 {
 	double current_time;
 	double current_jitter;
@@ -428,28 +490,24 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 	guint32 clock_rate;
 
 	/* Store the current time */
-	current_time = nstime_to_msec(&pinfo->rel_ts);
+	current_time = nstime_to_msec(&pkt->rel_ts);
 
 	/*  Is this the first packet we got in this direction? */
 	if (statinfo->first_packet) {
-		/* Save the MAC address of the first RTP frame */
-		if( pinfo->dl_src.type == AT_ETHER){
-			copy_address(&(statinfo->first_packet_mac_addr), &(pinfo->dl_src));
-		}
-		statinfo->start_seq_nr = rtpinfo->info_seq_num;
-		statinfo->stop_seq_nr = rtpinfo->info_seq_num;
-		statinfo->seq_num = rtpinfo->info_seq_num;
+		statinfo->start_seq_nr = pkt->seq_num;
+		statinfo->stop_seq_nr = pkt->seq_num;
+		statinfo->seq_num = pkt->seq_num;
 		statinfo->start_time = current_time;
-		statinfo->timestamp = rtpinfo->info_timestamp;
-		statinfo->first_timestamp = rtpinfo->info_timestamp;
+		statinfo->timestamp = pkt->timestamp;
+		statinfo->first_timestamp = pkt->timestamp;
 		statinfo->time = current_time;
 		statinfo->lastnominaltime = 0;
-		statinfo->pt = rtpinfo->info_payload_type;
-		statinfo->reg_pt = rtpinfo->info_payload_type;
-		statinfo->bw_history[statinfo->bw_index].bytes = rtpinfo->info_data_len + 28;
+		statinfo->pt = pkt->payload_type;
+		statinfo->reg_pt = pkt->payload_type;
+		statinfo->bw_history[statinfo->bw_index].bytes = pkt->data_len + 28;
 		statinfo->bw_history[statinfo->bw_index].time = current_time;
 		statinfo->bw_index++;
-		statinfo->total_bytes += rtpinfo->info_data_len + 28;
+		statinfo->total_bytes += pkt->data_len + 28;
 		statinfo->bandwidth = (double)(statinfo->total_bytes*8)/1000;
 		/* Not needed ? initialised to zero? */
 		statinfo->delta = 0;
@@ -458,7 +516,7 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 
 		statinfo->total_nr++;
 		statinfo->flags |= STAT_FLAG_FIRST;
-		if (rtpinfo->info_marker_set) {
+		if (pkt->marker_set) {
 			statinfo->flags |= STAT_FLAG_MARKER;
 		}
 		statinfo->first_packet = FALSE;
@@ -469,12 +527,10 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 	statinfo->flags = 0;
 
 	/* Chek for duplicates (src mac differs from first_packet_mac_addr) */
-	if( pinfo->dl_src.type == AT_ETHER){
-		if(!addresses_equal(&(statinfo->first_packet_mac_addr), &(pinfo->dl_src))){
-			statinfo->flags |= STAT_FLAG_DUP_PKT;
-			statinfo->delta = current_time-(statinfo->time);
-			return;
-		}
+	if (pkt->dup_mac) {
+		statinfo->flags |= STAT_FLAG_DUP_PKT;
+		statinfo->delta = current_time-(statinfo->time);
+		return;
 	}
 
 	/* When calculating expected rtp packets the seq number can wrap around
@@ -494,7 +550,7 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 	/* So if the current sequence number is less than the start one
 	 * we assume, that there is another cycle running
 	 */
-	if ((rtpinfo->info_seq_num < statinfo->start_seq_nr) && (statinfo->under == FALSE)){
+	if ((pkt->seq_num < statinfo->start_seq_nr) && (statinfo->under == FALSE)){
 		statinfo->cycles++;
 		statinfo->under = TRUE;
 	}
@@ -502,13 +558,13 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 	 * be true, so we add another condition. XXX The problem would arise
 	 * if one of the packets with seq nr 0 or 65535 would be lost or late
 	 */
-	else if ((rtpinfo->info_seq_num == 0) && (statinfo->stop_seq_nr == 65535) &&
+	else if ((pkt->seq_num == 0) && (statinfo->stop_seq_nr == 65535) &&
 		(statinfo->under == FALSE)){
 		statinfo->cycles++;
 		statinfo->under = TRUE;
 	}
 	/* the whole round is over, so reset the flag */
-	else if ((rtpinfo->info_seq_num > statinfo->start_seq_nr) && (statinfo->under != FALSE)) {
+	else if ((pkt->seq_num > statinfo->start_seq_nr) && (statinfo->under != FALSE)) {
 		statinfo->under = FALSE;
 	}
 
@@ -519,74 +575,54 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 	/* If the current seq number equals the last one or if we are here for
 	 * the first time, then it is ok, we just store the current one as the last one
 	 */
-	if ( (statinfo->seq_num+1 == rtpinfo->info_seq_num) || (statinfo->flags & STAT_FLAG_FIRST) )
-		statinfo->seq_num = rtpinfo->info_seq_num;
+	if ( (statinfo->seq_num+1 == pkt->seq_num) || (statinfo->flags & STAT_FLAG_FIRST) )
+		statinfo->seq_num = pkt->seq_num;
 	/* If the first one is 65535 we wrap */
-	else if ( (statinfo->seq_num == 65535) && (rtpinfo->info_seq_num == 0) )
-		statinfo->seq_num = rtpinfo->info_seq_num;
+	else if ( (statinfo->seq_num == 65535) && (pkt->seq_num == 0) )
+		statinfo->seq_num = pkt->seq_num;
 	/* Lost packets. If the prev seq is enormously larger than the cur seq
 	 * we assume that instead of being massively late we lost the packet(s)
 	 * that would have indicated the sequence number wrapping. An imprecise
 	 * heuristic at best, but it seems to work well enough.
 	 * https://bugs.wireshark.org/bugzilla/show_bug.cgi?id=5958 */
-	else if (statinfo->seq_num+1 < rtpinfo->info_seq_num || statinfo->seq_num - rtpinfo->info_seq_num > 0xFF00) {
-		statinfo->seq_num = rtpinfo->info_seq_num;
+	else if (statinfo->seq_num+1 < pkt->seq_num || statinfo->seq_num - pkt->seq_num > 0xFF00) {
+		statinfo->seq_num = pkt->seq_num;
 		statinfo->sequence++;
 		statinfo->flags |= STAT_FLAG_WRONG_SEQ;
 	}
 	/* Late or duplicated */
-	else if (statinfo->seq_num+1 > rtpinfo->info_seq_num) {
+	else if (statinfo->seq_num+1 > pkt->seq_num) {
 		statinfo->sequence++;
 		statinfo->flags |= STAT_FLAG_WRONG_SEQ;
 	}
 
 	/* Check payload type */
-	if (rtpinfo->info_payload_type == PT_CN
-		|| rtpinfo->info_payload_type == PT_CN_OLD)
+	if (pkt->payload_type == PT_CN
+		|| pkt->payload_type == PT_CN_OLD)
 		statinfo->flags |= STAT_FLAG_PT_CN;
 	if (statinfo->pt == PT_CN
 		|| statinfo->pt == PT_CN_OLD)
 		statinfo->flags |= STAT_FLAG_FOLLOW_PT_CN;
-	if (rtpinfo->info_payload_type != statinfo->pt)
+	if (pkt->payload_type != statinfo->pt)
 		statinfo->flags |= STAT_FLAG_PT_CHANGE;
-	statinfo->pt = rtpinfo->info_payload_type;
+	statinfo->pt = pkt->payload_type;
 
 	/*
-	 * Return for unknown payload types
 	 * Ignore jitter calculation for clockrate = 0
 	 */
-	if (statinfo->pt < 96 ){
-		clock_rate = get_clock_rate(statinfo->pt);
-	}else{ /* Dynamic PT */
-		if ( rtpinfo->info_payload_type_str != NULL ){
-			/* Is it a "telephone-event" ?
-			 * Timestamp is not increased for telepone-event packets impacting
-			 * calculation of Jitter Skew and clock drift.
-			 * see 2.2.1 of RFC 4733
-			 */
-			if (g_ascii_strncasecmp("telephone-event",rtpinfo->info_payload_type_str,(strlen("telephone-event")))==0){
-				clock_rate = 0;
-				statinfo->flags |= STAT_FLAG_PT_T_EVENT;
-			}else{
-				if(rtpinfo->info_payload_rate !=0){
-					clock_rate = rtpinfo->info_payload_rate;
-				}else{
-					clock_rate = get_dyn_pt_clock_rate(rtpinfo->info_payload_type_str);
-				}
-			}
-		}else{
-			clock_rate = 0;
-		}
+	clock_rate = pkt->clock_rate;
+	if (pkt->t_event) {
+		statinfo->flags |= STAT_FLAG_PT_T_EVENT;
 	}
 
 		/* Handle wraparound ? */
 	arrivaltime = current_time - statinfo->start_time;
 
-	if (statinfo->first_timestamp > rtpinfo->info_timestamp){
+	if (statinfo->first_timestamp > pkt->timestamp){
 		/* Handle wraparound */
-		nominaltime = (double)(rtpinfo->info_timestamp + 0xffffffff - statinfo->first_timestamp + 1);
+		nominaltime = (double)(pkt->timestamp + 0xffffffff - statinfo->first_timestamp + 1);
 	}else{
-		nominaltime = (double)(rtpinfo->info_timestamp - statinfo->first_timestamp);
+		nominaltime = (double)(pkt->timestamp - statinfo->first_timestamp);
 	}
 
 	/* Can only analyze defined sampling rates */
@@ -634,7 +670,7 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 	}
 
 	/* Calculate the BW in Kbps adding the IP+UDP header to the RTP -> 20bytes(IP) + 8bytes(UDP) */
-	statinfo->bw_history[statinfo->bw_index].bytes = rtpinfo->info_data_len + 28;
+	statinfo->bw_history[statinfo->bw_index].bytes = pkt->data_len + 28;
 	statinfo->bw_history[statinfo->bw_index].time = current_time;
 
 	/* Check if there are more than 1sec in the history buffer to calculate BW in bps. If so, remove those for the calculation */
@@ -644,16 +680,16 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 		if (statinfo->bw_start_index == BUFF_BW) statinfo->bw_start_index=0;
 	};
 	/* IP hdr + UDP + RTP */
-	statinfo->total_bytes += rtpinfo->info_data_len + 28;
+	statinfo->total_bytes += pkt->data_len + 28;
 	statinfo->bandwidth = (double)(statinfo->total_bytes*8)/1000;
 	statinfo->bw_index++;
 	if (statinfo->bw_index == BUFF_BW) statinfo->bw_index = 0;
 
 
 	/* Is it a packet with the mark bit set? */
-	if (rtpinfo->info_marker_set) {
-		statinfo->delta_timestamp = rtpinfo->info_timestamp - statinfo->timestamp;
-		if (rtpinfo->info_timestamp > statinfo->timestamp){
+	if (pkt->marker_set) {
+		statinfo->delta_timestamp = pkt->timestamp - statinfo->timestamp;
+		if (pkt->timestamp > statinfo->timestamp){
 			statinfo->flags |= STAT_FLAG_MARKER;
 		}
 		else{
@@ -669,7 +705,7 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 		/* Include it in maximum delta calculation */
 		if (statinfo->delta > statinfo->max_delta) {
 			statinfo->max_delta = statinfo->delta;
-			statinfo->max_nr = pinfo->num;
+			statinfo->max_nr = pkt->frame_num;
 		}
 		if (clock_rate != 0) {
 			/* Maximum and mean jitter calculation */
@@ -694,13 +730,31 @@ rtp_packet_analyse(tap_rtp_stat_t *statinfo,
 	}
 
 	statinfo->time = current_time;
-	statinfo->timestamp = rtpinfo->info_timestamp;
-	statinfo->stop_seq_nr = rtpinfo->info_seq_num;
+	statinfo->timestamp = pkt->timestamp;
+	statinfo->stop_seq_nr = pkt->seq_num;
 	statinfo->total_nr++;
 
 	return;
 }
 
+/****************************************************************************/
+void
+rtp_packet_analyse(tap_rtp_stat_t *statinfo,
+		       packet_info *pinfo,
+		       const struct _rtp_info *rtpinfo)
+{
+	rtp_packet_index_t pkt;
+
+	rtp_packet_index_set(&pkt, statinfo, pinfo, rtpinfo);
+
+	/* Save the MAC address of the first RTP frame */
+	if (statinfo->first_packet && pinfo->dl_src.type == AT_ETHER) {
+		copy_address(&(statinfo->first_packet_mac_addr), &(pinfo->dl_src));
+	}
+
+	rtp_packet_analyse_index(statinfo, &pkt);
+}
+
 /*
  * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
  *
@@ -40,13 +40,65 @@
 
 #include "tap-tcp-stream.h"
 
+/* Segments are allocated this many at a time */
+#define SEGMENT_BLOCK_LEN 4096
+
 typedef struct _tcp_scan_t {
     struct segment         *current;
     int                     direction;
     struct tcp_graph       *tg;
     struct segment         *last;
+    guint                   block_used;
+    GHashTable             *stream_frames;  /* frames of every stream, or NULL */
 } tcp_scan_t;
 
+static struct segment *
+new_segment(tcp_scan_t *ts)
+{
+    struct tcp_graph *tg = ts->tg;
+    struct segment   *block;
+
+    if (!tg->segment_blocks) {
+        tg->segment_blocks = g_ptr_array_new();
+    }
+    if (tg->segment_blocks->len == 0 || ts->block_used == SEGMENT_BLOCK_LEN) {
+        g_ptr_array_add(tg->segment_blocks, g_new(struct segment, SEGMENT_BLOCK_LEN));
+        ts->block_used = 0;
+    }
+    block = (struct segment *)g_ptr_array_index(tg->segment_blocks, tg->segment_blocks->len - 1);
+    return &block[ts->block_used++];
+}
+
+/* A stream's segments only have a couple of distinct addresses, so rather
+ * than copying them into each segment, point them at a shared copy. */
+static void
+set_segment_address(struct tcp_graph *tg, address *addr, const address *from)
+{
+    address *shared;
+    guint    i;
+
+    if (!tg->segment_addresses) {
+        tg->segment_addresses = g_ptr_array_new();
+    }
+    for (i = 0; i < tg->segment_addresses->len; i++) {
+        shared = (address *)g_ptr_array_index(tg->segment_addresses, i);
+        if (addresses_equal(shared, from)) {
+            copy_address_shallow(addr, shared);
+            return;
+        }
+    }
+    shared = g_new(address, 1);
+    copy_address(shared, from);
+    g_ptr_array_add(tg->segment_addresses, shared);
+    copy_address_shallow(addr, shared);
+}
+
+static void
+free_frame_array(gpointer data)
+{
+    g_array_free((GArray *)data, TRUE);
+}
+
 
 static gboolean
 tapall_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, const void *vip)
@@ -55,6 +107,19 @@ tapall_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, cons
     struct tcp_graph *tg  = ts->tg;
     const struct tcpheader *tcphdr = (const struct tcpheader *)vip;
 
+    if (ts->stream_frames) {
+        GArray *frames = (GArray *)g_hash_table_lookup(ts->stream_frames, GUINT_TO_POINTER(tcphdr->th_stream));
+
+        if (!frames) {
+            frames = g_array_new(FALSE, FALSE, sizeof(guint32));
+            g_hash_table_insert(ts->stream_frames, GUINT_TO_POINTER(tcphdr->th_stream), frames);
+        }
+        /* A frame can carry more than one segment of a stream */
+        if (frames->len == 0 || g_array_index(frames, guint32, frames->len - 1) != pinfo->num) {
+            g_array_append_val(frames, pinfo->num);
+        }
+    }
+
     if (tg->stream == tcphdr->th_stream
             && (tg->src_address.type == AT_NONE || tg->dst_address.type == AT_NONE)) {
         /*
@@ -74,7 +139,7 @@ tapall_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, cons
                         ts->direction)
         && tg->stream == tcphdr->th_stream)
     {
-        struct segment *segment = (struct segment *)g_malloc(sizeof(struct segment));
+        struct segment *segment = new_segment(ts);
         segment->next      = NULL;
         segment->num       = pinfo->num;
         segment->rel_secs  = (guint32)pinfo->rel_ts.secs;
@@ -90,8 +155,8 @@ tapall_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, cons
         segment->th_sport  = tcphdr->th_sport;
         segment->th_dport  = tcphdr->th_dport;
         segment->th_seglen = tcphdr->th_seglen;
-        copy_address(&segment->ip_src, &tcphdr->ip_src);
-        copy_address(&segment->ip_dst, &tcphdr->ip_dst);
+        set_segment_address(tg, &segment->ip_src, &tcphdr->ip_src);
+        set_segment_address(tg, &segment->ip_dst, &tcphdr->ip_dst);
 
         segment->num_sack_ranges = MIN(MAX_TCP_SACK_RANGES, tcphdr->num_sack_ranges);
         if (segment->num_sack_ranges > 0) {
@@ -111,6 +176,36 @@ tapall_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, cons
     return FALSE;
 }
 
+/* Dissect just the given frames, handing their TCP headers to ts */
+static void
+dissect_stream_frames(capture_file *cf, GArray *frames, tcp_scan_t *ts)
+{
+    epan_dissect_t     edt;
+    struct wtap_pkthdr phdr;
+    Buffer             buf;
+    frame_data        *fdata;
+    guint              i;
+
+    wtap_phdr_init(&phdr);
+    ws_buffer_init(&buf, 1500);
+
+    set_tap_listener_exclusive(ts);
+    epan_dissect_init(&edt, cf->epan, TRUE, FALSE);
+    for (i = 0; i < frames->len; i++) {
+        fdata = frame_data_sequence_find(cf->frames, g_array_index(frames, guint32, i));
+        if (!fdata || !cf_read_record_r(cf, fdata, &phdr, &buf)) {
+            continue;
+        }
+        epan_dissect_run_with_taps(&edt, cf->cd_t, &phdr, frame_tvbuff_new_buffer(fdata, &buf), fdata, NULL);
+        epan_dissect_reset(&edt);
+    }
+    epan_dissect_cleanup(&edt);
+    set_tap_listener_exclusive(NULL);
+
+    wtap_phdr_cleanup(&phdr);
+    ws_buffer_free(&buf);
+}
+
 /* here we collect all the external data we will ever need */
 void
 graph_segment_list_get(capture_file *cf, struct tcp_graph *tg, gboolean stream_known)
@@ -118,6 +213,7 @@ graph_segment_list_get(capture_file *cf, struct tcp_graph *tg, gboolean stream_k
     struct segment current;
     GString    *error_string;
     tcp_scan_t  ts;
+    gboolean    have_stream_frames;
 
     g_log(NULL, G_LOG_LEVEL_DEBUG, "graph_segment_list_get()");
 
@@ -142,6 +238,13 @@ graph_segment_list_get(capture_file *cf, struct tcp_graph *tg, gboolean stream_k
             ts.direction = COMPARE_ANY_DIR;
     }
 
+    /* If we've scanned this capture file before we know which frames
+     * belong to the stream and only need to dissect those.
+     */
+    have_stream_frames = tg->stream_frames
+            && tg->stream_frames_generation == cf->dissection_generation
+            && tg->stream_frames_count == cf->count;
+
     /* rescan all the packets and pick up all interesting tcp headers.
      * we only filter for TCP here for speed and do the actual compare
      * in the tap listener
@@ -149,6 +252,8 @@ graph_segment_list_get(capture_file *cf, struct tcp_graph *tg, gboolean stream_k
     ts.current = &current;
     ts.tg      = tg;
     ts.last    = NULL;
+    ts.block_used = 0;
+    ts.stream_frames = NULL;
     error_string = register_tap_listener("tcp", &ts, "tcp", 0, NULL, tapall_tcpip_packet, NULL);
     if (error_string) {
         fprintf(stderr, "wireshark: Couldn't register tcp_graph tap: %s\n",
@@ -156,23 +261,61 @@ graph_segment_list_get(capture_file *cf, struct tcp_graph *tg, gboolean stream_k
         g_string_free(error_string, TRUE);
         exit(1);   /* XXX: fix this */
     }
-    cf_retap_packets(cf);
+    if (have_stream_frames) {
+        GArray *frames = (GArray *)g_hash_table_lookup(tg->stream_frames, GUINT_TO_POINTER(tg->stream));
+
+        if (frames) {
+            dissect_stream_frames(cf, frames, &ts);
+        }
+    } else {
+        graph_stream_frames_free(tg);
+        ts.stream_frames = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, free_frame_array);
+        if (cf_retap_packets(cf) == CF_READ_OK) {
+            tg->stream_frames = ts.stream_frames;
+            tg->stream_frames_generation = cf->dissection_generation;
+            tg->stream_frames_count = cf->count;
+        } else {
+            g_hash_table_destroy(ts.stream_frames);
+        }
+    }
     remove_tap_listener(&ts);
 }
 
 void
 graph_segment_list_free(struct tcp_graph *tg)
 {
-    struct segment *segment;
+    guint i;
 
-    while (tg->segments) {
-        segment = tg->segments->next;
-        g_free(tg->segments);
-        tg->segments = segment;
+    if (tg->segment_blocks) {
+        for (i = 0; i < tg->segment_blocks->len; i++) {
+            g_free(g_ptr_array_index(tg->segment_blocks, i));
+        }
+        g_ptr_array_free(tg->segment_blocks, TRUE);
+        tg->segment_blocks = NULL;
+    }
+    if (tg->segment_addresses) {
+        for (i = 0; i < tg->segment_addresses->len; i++) {
+            address *addr = (address *)g_ptr_array_index(tg->segment_addresses, i);
+            free_address(addr);
+            g_free(addr);
+        }
+        g_ptr_array_free(tg->segment_addresses, TRUE);
+        tg->segment_addresses = NULL;
     }
     tg->segments = NULL;
 }
 
+void
+graph_stream_frames_free(struct tcp_graph *tg)
+{
+    if (tg->stream_frames) {
+        g_hash_table_destroy(tg->stream_frames);
+        tg->stream_frames = NULL;
+    }
+    tg->stream_frames_generation = 0;
+    tg->stream_frames_count = 0;
+}
+
 int
 compare_headers(address *saddr1, address *daddr1, guint16 sport1, guint16 dport1, const address *saddr2, const address *daddr2, guint16 sport2, guint16 dport2, int dir)
 {
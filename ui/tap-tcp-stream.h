@@ -73,6 +73,18 @@ struct tcp_graph {
     guint32          stream;
     /* Should this be a map or tree instead? */
     struct segment  *segments;
+    /* Storage for the segments, which are allocated in blocks, and for the
+     * addresses they point to, which are shared between them. */
+    GPtrArray       *segment_blocks;
+    GPtrArray       *segment_addresses;
+
+    /* The frames of each TCP stream (GArrays of frame numbers by stream
+     * number), found the first time the capture file was scanned. Later
+     * calls to graph_segment_list_get() only dissect the frames of the
+     * stream as long as the capture file hasn't changed. */
+    GHashTable      *stream_frames;
+    guint32          stream_frames_generation; /* cf->dissection_generation */
+    guint32          stream_frames_count;
 };
 
 /** Fill in the segment list for a TCP graph
@@ -89,6 +101,12 @@ struct tcp_graph {
 void graph_segment_list_get(capture_file *cf, struct tcp_graph *tg, gboolean stream_known );
 void graph_segment_list_free(struct tcp_graph * );
 
+/** Free the frames of each stream collected by graph_segment_list_get().
+ *
+ * @param tg TCP graph
+ */
+void graph_stream_frames_free(struct tcp_graph *tg);
+
 /* for compare_headers() */
 /* segment went the same direction as the currently selected one */
 #define COMPARE_CURR_DIR    0
@@ -32,6 +32,8 @@
 
 #include "ui/ui_util.h"
 
+#include "file.h"
+
 #ifndef HAVE_FLOORL
 #define floorl(x) floor((double)x)
 #endif
@@ -305,6 +307,7 @@ time_shift_all(capture_file *cf, const gchar *offset_text)
             continue;   /* Shouldn't happen */
         modify_time_perform(fd, neg ? SHIFT_NEG : SHIFT_POS, &offset, SHIFT_KEEPOFFSET);
     }
+    cf_times_changed(cf);
     packet_list_queue_draw();
 
     return NULL;
@@ -350,6 +353,7 @@ time_shift_settime(capture_file *cf, guint packet_num, const gchar *time_text)
         modify_time_perform(fd, SHIFT_POS, &diff_time, SHIFT_SETTOZERO);
     }
 
+    cf_times_changed(cf);
     packet_list_queue_draw();
     return NULL;
 }
@@ -433,6 +437,7 @@ time_shift_adjtime(capture_file *cf, guint packet1_num, const gchar *time1_text,
         modify_time_perform(fd, SHIFT_POS, &d3t, SHIFT_SETTOZERO);
     }
 
+    cf_times_changed(cf);
     packet_list_queue_draw();
     return NULL;
 }
@@ -457,6 +462,7 @@ time_shift_undo(capture_file *cf)
             continue;   /* Shouldn't happen */
         modify_time_perform(fd, SHIFT_NEG, &nulltime, SHIFT_SETTOZERO);
     }
+    cf_times_changed(cf);
     packet_list_queue_draw();
     return NULL;
 }
@@ -305,6 +305,10 @@ voip_calls_reset_all_taps(voip_calls_tapinfo_t *tapinfo)
     }
     g_list_free(tapinfo->rtp_stream_list);
     tapinfo->rtp_stream_list = NULL;
+    if (tapinfo->rtp_stream_hash)
+        g_hash_table_remove_all(tapinfo->rtp_stream_hash);
+    if (tapinfo->rtp_streams_changed)
+        g_hash_table_remove_all(tapinfo->rtp_streams_changed);
 
     if (tapinfo->h245_labels) {
         memset(tapinfo->h245_labels, 0, sizeof(h245_labels_t));
@@ -557,6 +561,45 @@ remove_tap_listener_rtp_event(voip_calls_tapinfo_t *tap_id_base)
 /* ***************************TAP for RTP **********************************/
 /****************************************************************************/
 
+/****************************************************************************/
+/* Open RTP streams are looked up by setup frame and SSRC */
+static guint
+rtp_stream_hash_func(gconstpointer key)
+{
+    const rtp_stream_info_t *strinfo = (const rtp_stream_info_t *)key;
+
+    return strinfo->setup_frame_number ^ strinfo->ssrc;
+}
+
+static gboolean
+rtp_stream_equal_func(gconstpointer a, gconstpointer b)
+{
+    const rtp_stream_info_t *strinfo_a = (const rtp_stream_info_t *)a;
+    const rtp_stream_info_t *strinfo_b = (const rtp_stream_info_t *)b;
+
+    return strinfo_a->setup_frame_number == strinfo_b->setup_frame_number
+        && strinfo_a->ssrc == strinfo_b->ssrc;
+}
+
+/* Create the RTP stream tables, adding any streams we already have */
+static void
+rtp_stream_tables_init(voip_calls_tapinfo_t *tapinfo)
+{
+    GList *list;
+
+    if (tapinfo->rtp_stream_hash)
+        return;
+
+    tapinfo->rtp_stream_hash = g_hash_table_new(rtp_stream_hash_func, rtp_stream_equal_func);
+    tapinfo->rtp_streams_changed = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    for (list = g_list_first(tapinfo->rtp_stream_list); list; list = g_list_next(list)) {
+        rtp_stream_info_t *strinfo = (rtp_stream_info_t *)list->data;
+        if (strinfo->end_stream == FALSE)
+            g_hash_table_insert(tapinfo->rtp_stream_hash, strinfo, strinfo);
+    }
+}
+
 /****************************************************************************/
 /* when there is a [re]reading of RTP packets */
 static void
@@ -575,6 +618,10 @@ rtp_reset(void *tap_offset_ptr)
     g_list_free(tapinfo->rtp_stream_list);
     tapinfo->rtp_stream_list = NULL;
     tapinfo->nrtp_streams = 0;
+    if (tapinfo->rtp_stream_hash)
+        g_hash_table_remove_all(tapinfo->rtp_stream_hash);
+    if (tapinfo->rtp_streams_changed)
+        g_hash_table_remove_all(tapinfo->rtp_streams_changed);
 
     if (tapinfo->tap_reset) {
         tapinfo->tap_reset(tapinfo);
@@ -589,9 +636,8 @@ static gboolean
 rtp_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt, void const *rtp_info_ptr)
 {
     voip_calls_tapinfo_t *tapinfo = tap_id_to_base(tap_offset_ptr, tap_id_offset_rtp_);
-    rtp_stream_info_t    *tmp_listinfo;
+    rtp_stream_info_t     key;
     rtp_stream_info_t    *strinfo = NULL;
-    GList                *list;
     struct _rtp_conversation_info *p_conv_data = NULL;
 
     const struct _rtp_info *rtp_info = (const struct _rtp_info *)rtp_info_ptr;
@@ -605,23 +651,18 @@ rtp_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt, void c
         tapinfo->tap_packet(tapinfo, pinfo, edt, rtp_info_ptr);
     }
 
-    /* check whether we already have a RTP stream with this setup frame and ssrc in the list */
-    list = g_list_first(tapinfo->rtp_stream_list);
-    while (list)
-    {
-        tmp_listinfo=(rtp_stream_info_t *)list->data;
-        if ( (tmp_listinfo->setup_frame_number == rtp_info->info_setup_frame_num)
-                && (tmp_listinfo->ssrc == rtp_info->info_sync_src) && (tmp_listinfo->end_stream == FALSE)) {
-            /* if the payload type has changed, we mark the stream as finished to create a new one
-               this is to show multiple payload changes in the Graph for example for DTMF RFC2833 */
-            if ( tmp_listinfo->payload_type != rtp_info->info_payload_type ) {
-                tmp_listinfo->end_stream = TRUE;
-            } else {
-                strinfo = (rtp_stream_info_t*)(list->data);
-                break;
-            }
-        }
-        list = g_list_next(list);
+    rtp_stream_tables_init(tapinfo);
+
+    /* check whether we already have an open RTP stream with this setup frame and ssrc */
+    key.setup_frame_number = rtp_info->info_setup_frame_num;
+    key.ssrc = rtp_info->info_sync_src;
+    strinfo = (rtp_stream_info_t *)g_hash_table_lookup(tapinfo->rtp_stream_hash, &key);
+    /* if the payload type has changed, we mark the stream as finished to create a new one
+       this is to show multiple payload changes in the Graph for example for DTMF RFC2833 */
+    if (strinfo && strinfo->payload_type != rtp_info->info_payload_type) {
+        strinfo->end_stream = TRUE;
+        g_hash_table_remove(tapinfo->rtp_stream_hash, strinfo);
+        strinfo = NULL;
     }
 
     /* if this is a duplicated RTP Event End, just return */
@@ -657,6 +698,7 @@ rtp_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt, void c
         strinfo->call_num = -1;
         strinfo->rtp_event = -1;
         tapinfo->rtp_stream_list = g_list_prepend(tapinfo->rtp_stream_list, strinfo);
+        g_hash_table_insert(tapinfo->rtp_stream_hash, strinfo, strinfo);
     }
 
     /* Add the info to the existing RTP stream */
@@ -668,9 +710,11 @@ rtp_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt, void c
         strinfo->rtp_event = tapinfo->rtp_evt;
         if (tapinfo->rtp_evt_end == TRUE) {
             strinfo->end_stream = TRUE;
+            g_hash_table_remove(tapinfo->rtp_stream_hash, strinfo);
         }
     }
 
+    g_hash_table_insert(tapinfo->rtp_streams_changed, strinfo, strinfo);
     tapinfo->redraw |= REDRAW_RTP;
 
     return FALSE;
@@ -682,7 +726,8 @@ static void
 rtp_draw(void *tap_offset_ptr)
 {
     voip_calls_tapinfo_t *tapinfo = tap_id_to_base(tap_offset_ptr, tap_id_offset_rtp_);
-    GList                *rtp_streams_list;
+    GHashTableIter        iter;
+    gpointer              key;
     rtp_stream_info_t    *rtp_listinfo;
     /* GList *voip_calls_graph_list; */
     seq_analysis_item_t  *gai     = NULL;
@@ -691,11 +736,16 @@ rtp_draw(void *tap_offset_ptr)
     guint32               duration;
     gchar                 time_str[COL_MAX_LEN];
 
-    /* add each rtp stream to the graph */
-    rtp_streams_list = g_list_first(tapinfo->rtp_stream_list);
-    while (rtp_streams_list)
+    if (!tapinfo->rtp_streams_changed) {
+        return;
+    }
+
+    /* add each rtp stream that got packets since the last draw to the graph */
+    g_hash_table_iter_init(&iter, tapinfo->rtp_streams_changed);
+    while (g_hash_table_iter_next(&iter, &key, NULL))
     {
-        rtp_listinfo = (rtp_stream_info_t *)rtp_streams_list->data;
+        rtp_listinfo = (rtp_stream_info_t *)key;
+        gai = NULL;
 
         /* using the setup frame number of the RTP stream, we get the call number that it belongs to*/
         /* voip_calls_graph_list = g_list_first(tapinfo->graph_analysis->list); */
@@ -736,11 +786,12 @@ rtp_draw(void *tap_offset_ptr)
                 new_gai->display=FALSE;
                 new_gai->line_style = 2;  /* the arrow line will be 2 pixels width */
                 g_queue_push_tail(tapinfo->graph_analysis->items, new_gai);
-                g_hash_table_insert(tapinfo->graph_analysis->ht, &rtp_listinfo->start_fd, new_gai);
+                g_hash_table_insert(tapinfo->graph_analysis->ht, &new_gai->frame_number, new_gai);
             }
+            /* streams whose setup frame hasn't been seen yet are retried on the next draw */
+            g_hash_table_iter_remove(&iter);
         }
-        rtp_streams_list = g_list_next(rtp_streams_list);
-    } /* while (rtp_streams_list) */
+    } /* while (g_hash_table_iter_next) */
 
     if (tapinfo->tap_draw && (tapinfo->redraw & REDRAW_RTP)) {
         tapinfo->tap_draw(tapinfo);
@@ -856,6 +907,15 @@ void
 remove_tap_listener_rtp(voip_calls_tapinfo_t *tap_id_base)
 {
     remove_tap_listener(tap_base_to_id(tap_id_base, tap_id_offset_rtp_));
+
+    if (tap_id_base->rtp_stream_hash) {
+        g_hash_table_destroy(tap_id_base->rtp_stream_hash);
+        tap_id_base->rtp_stream_hash = NULL;
+    }
+    if (tap_id_base->rtp_streams_changed) {
+        g_hash_table_destroy(tap_id_base->rtp_streams_changed);
+        tap_id_base->rtp_streams_changed = NULL;
+    }
 }
 
 /****************************************************************************/
@@ -200,6 +200,8 @@ typedef struct _voip_calls_tapinfo {
     epan_t               *session; /**< epan session */
     int                   nrtp_streams; /**< number of rtp streams */
     GList*                rtp_stream_list; /**< list of rtp_stream_info_t */
+    GHashTable*           rtp_stream_hash; /**< open RTP streams (rtp_stream_info_t) by setup frame and SSRC */
+    GHashTable*           rtp_streams_changed; /**< RTP streams (rtp_stream_info_t) not yet updated in the graph */
     guint32               rtp_evt_frame_num;
     guint8                rtp_evt;
     gboolean              rtp_evt_end;
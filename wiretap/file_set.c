@@ -0,0 +1,523 @@
+/* file_set.c
+ *
+ * Read a set of capture files (e.g. the files written by a dumpcap ring
+ * buffer) as if they were one capture file.
+ *
+ * Wiretap Library
+ * Copyright (c) 1998 by Gilbert Ramirez <gram@alumni.rice.edu>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <wsutil/file_util.h>
+
+#include "wtap-int.h"
+#include "file_wrappers.h"
+#include <wsutil/buffer.h>
+#include "file_set.h"
+
+/*
+ * The files of a set are opened lazily.  When reading sequentially, a
+ * member is only opened once the records we're handing out have caught
+ * up with the first time stamp of the member opened before it, so, for
+ * the usual ring buffer whose files don't overlap in time, at most two
+ * members are open at once; members whose records do overlap are merged
+ * by time stamp, the way mergecap does it.  Sequential handles are closed
+ * as soon as their member hits EOF.
+ *
+ * For random access, we keep up to FILE_SET_MAX_RANDOM_OPEN members open,
+ * closing the least recently used one when we need another.
+ *
+ * The offset we hand back for a record has the index of the member in its
+ * top bits and the offset within the member in the rest, so it fits in
+ * frame_data.file_off like any other offset.
+ */
+#define FILE_SET_OFFSET_BITS		47
+#define FILE_SET_OFFSET_MASK		((G_GINT64_CONSTANT(1) << FILE_SET_OFFSET_BITS) - 1)
+#define FILE_SET_MAX_FILES		(1U << (63 - FILE_SET_OFFSET_BITS))
+
+#define FILE_SET_MAKE_OFFSET(idx, off)	(((gint64)(idx) << FILE_SET_OFFSET_BITS) | (off))
+#define FILE_SET_OFFSET_IDX(off)	((guint)((off) >> FILE_SET_OFFSET_BITS))
+#define FILE_SET_OFFSET_OFF(off)	((off) & FILE_SET_OFFSET_MASK)
+
+#define FILE_SET_MAX_RANDOM_OPEN	8
+
+typedef struct {
+	gchar		*filename;
+	gint64		size;		/* as reported by stat() when the set was opened */
+	wtap		*wth;		/* sequential handle, or NULL */
+	wtap		*random_wth;	/* random-access handle, or NULL */
+	guint		random_last_use;
+	gboolean	at_eof;		/* sequential reading is done */
+	gboolean	pending;	/* wth holds a record we haven't handed out yet */
+	gint64		pending_offset;
+	GArray		*idb_map;	/* member interface ID -> set interface ID */
+} file_set_member_t;
+
+struct file_set {
+	unsigned int	type;
+	guint		count;
+	file_set_member_t *members;
+	guint		next_member;	/* first member not yet opened for sequential reading */
+	nstime_t	horizon;	/* first time stamp of the last member opened */
+	gboolean	horizon_set;
+	guint		random_open;
+	guint		random_clock;
+	gint64		total_size;
+};
+
+static gboolean file_set_read(wtap *wth, int *err, gchar **err_info,
+    gint64 *data_offset);
+static gboolean file_set_seek_read(wtap *wth, gint64 seek_off,
+    struct wtap_pkthdr *phdr, Buffer *buf, int *err, gchar **err_info);
+static void file_set_sequential_close(wtap *wth);
+static void file_set_close(wtap *wth);
+
+/*
+ * returns TRUE if first argument is earlier than second
+ */
+static gboolean
+is_earlier(const nstime_t *l, const nstime_t *r)
+{
+	if (l->secs != r->secs)
+		return l->secs < r->secs;
+	return l->nsecs <= r->nsecs;
+}
+
+static gboolean
+same_idb(const wtap_optionblock_t idb1, const wtap_optionblock_t idb2)
+{
+	wtapng_if_descr_mandatory_t *idb1_mand, *idb2_mand;
+
+	idb1_mand = (wtapng_if_descr_mandatory_t*)wtap_optionblock_get_mandatory_data(idb1);
+	idb2_mand = (wtapng_if_descr_mandatory_t*)wtap_optionblock_get_mandatory_data(idb2);
+
+	return idb1_mand->wtap_encap == idb2_mand->wtap_encap &&
+	    idb1_mand->link_type == idb2_mand->link_type &&
+	    idb1_mand->time_units_per_second == idb2_mand->time_units_per_second &&
+	    idb1_mand->tsprecision == idb2_mand->tsprecision &&
+	    idb1_mand->snap_len == idb2_mand->snap_len;
+}
+
+/*
+ * Map any interfaces the member has seen since we last looked to
+ * interfaces of the set, adding the ones we haven't got yet.
+ */
+static void
+file_set_update_idb_map(wtap *wth, file_set_member_t *member)
+{
+	wtap_optionblock_t member_idb, set_idb;
+	guint i, j;
+
+	for (i = member->idb_map->len; i < member->wth->interface_data->len; i++) {
+		member_idb = g_array_index(member->wth->interface_data, wtap_optionblock_t, i);
+		for (j = 0; j < wth->interface_data->len; j++) {
+			if (same_idb(member_idb,
+			    g_array_index(wth->interface_data, wtap_optionblock_t, j)))
+				break;
+		}
+		if (j == wth->interface_data->len) {
+			set_idb = wtap_optionblock_create(WTAP_OPTION_BLOCK_IF_DESCR);
+			wtap_optionblock_copy_options(set_idb, member_idb);
+			g_array_append_val(wth->interface_data, set_idb);
+		}
+		g_array_append_val(member->idb_map, j);
+	}
+}
+
+static void
+file_set_map_interface(file_set_member_t *member, struct wtap_pkthdr *phdr)
+{
+	if ((phdr->presence_flags & WTAP_HAS_INTERFACE_ID) &&
+	    phdr->interface_id < member->idb_map->len)
+		phdr->interface_id = g_array_index(member->idb_map, guint,
+		    phdr->interface_id);
+}
+
+/*
+ * Open the next member for sequential reading and read its first record.
+ */
+static gboolean
+file_set_open_next(wtap *wth, int *err, gchar **err_info)
+{
+	struct file_set *set = wth->file_set;
+	file_set_member_t *member = &set->members[set->next_member];
+
+	member->wth = wtap_open_offline(member->filename, set->type, err,
+	    err_info, FALSE);
+	if (member->wth == NULL)
+		return FALSE;
+	set->next_member++;
+
+	if (wtap_file_encap(member->wth) != wth->file_encap)
+		wth->file_encap = WTAP_ENCAP_PER_PACKET;
+	if (wtap_file_tsprec(member->wth) != wth->file_tsprec)
+		wth->file_tsprec = WTAP_TSPREC_PER_PACKET;
+	if (wtap_snapshot_length(member->wth) > wth->snapshot_length)
+		wth->snapshot_length = wtap_snapshot_length(member->wth);
+
+	if (!wtap_read(member->wth, err, err_info, &member->pending_offset)) {
+		if (*err != 0)
+			return FALSE;
+		member->at_eof = TRUE;
+		wtap_close(member->wth);
+		member->wth = NULL;
+		return TRUE;
+	}
+	member->pending = TRUE;
+	file_set_update_idb_map(wth, member);
+
+	if (member->wth->phdr.presence_flags & WTAP_HAS_TS) {
+		set->horizon = member->wth->phdr.ts;
+		set->horizon_set = TRUE;
+	}
+	return TRUE;
+}
+
+/*
+ * Find the open member whose pending record is the earliest one,
+ * reading a record from each member that doesn't have one yet.
+ */
+static file_set_member_t *
+file_set_earliest(struct file_set *set, int *err, gchar **err_info)
+{
+	file_set_member_t *member, *earliest = NULL;
+	guint i;
+
+	for (i = 0; i < set->next_member; i++) {
+		member = &set->members[i];
+		if (member->wth == NULL)
+			continue;
+
+		if (!member->pending) {
+			if (!wtap_read(member->wth, err, err_info,
+			    &member->pending_offset)) {
+				if (*err != 0)
+					return NULL;
+				member->at_eof = TRUE;
+				wtap_close(member->wth);
+				member->wth = NULL;
+				continue;
+			}
+			member->pending = TRUE;
+		}
+
+		/* Records without a time stamp go out in file order. */
+		if (!(member->wth->phdr.presence_flags & WTAP_HAS_TS))
+			return member;
+		if (earliest == NULL ||
+		    !is_earlier(&earliest->wth->phdr.ts, &member->wth->phdr.ts))
+			earliest = member;
+	}
+	return earliest;
+}
+
+static gboolean
+file_set_read(wtap *wth, int *err, gchar **err_info, gint64 *data_offset)
+{
+	struct file_set *set = wth->file_set;
+	file_set_member_t *member;
+	struct Buffer *frame_buffer;
+	guint idx;
+
+	for (;;) {
+		member = file_set_earliest(set, err, err_info);
+		if (*err != 0)
+			return FALSE;
+		if (set->next_member == set->count)
+			break;
+
+		/*
+		 * If we've caught up with the start of the last member we
+		 * opened, the next one might overlap; open it, so that its
+		 * records are merged in.  Without time stamps, members are
+		 * simply read one after the other.
+		 */
+		if (member != NULL &&
+		    (!(member->wth->phdr.presence_flags & WTAP_HAS_TS) ||
+		     (set->horizon_set &&
+		      !is_earlier(&set->horizon, &member->wth->phdr.ts))))
+			break;
+		if (!file_set_open_next(wth, err, err_info))
+			return FALSE;
+	}
+	if (member == NULL) {
+		/* All members are at EOF. */
+		*err = 0;
+		return FALSE;
+	}
+
+	/*
+	 * Hand out the member's record, swapping frame buffers rather than
+	 * copying the data.
+	 */
+	idx = (guint)(member - set->members);
+	frame_buffer = wth->frame_buffer;
+	wth->frame_buffer = member->wth->frame_buffer;
+	member->wth->frame_buffer = frame_buffer;
+
+	file_set_update_idb_map(wth, member);
+	wth->phdr = member->wth->phdr;
+	file_set_map_interface(member, &wth->phdr);
+
+	*data_offset = FILE_SET_MAKE_OFFSET(idx, member->pending_offset);
+	member->pending = FALSE;
+	return TRUE;
+}
+
+static gboolean
+file_set_seek_read(wtap *wth, gint64 seek_off,
+    struct wtap_pkthdr *phdr, Buffer *buf, int *err, gchar **err_info)
+{
+	struct file_set *set = wth->file_set;
+	file_set_member_t *member, *lru;
+	guint idx, i;
+
+	idx = FILE_SET_OFFSET_IDX(seek_off);
+	if (idx >= set->count) {
+		*err = WTAP_ERR_INTERNAL;
+		*err_info = g_strdup_printf("file set: member %u of %u requested",
+		    idx, set->count);
+		return FALSE;
+	}
+	member = &set->members[idx];
+
+	if (member->random_wth == NULL) {
+		if (set->random_open >= FILE_SET_MAX_RANDOM_OPEN) {
+			lru = NULL;
+			for (i = 0; i < set->count; i++) {
+				if (set->members[i].random_wth != NULL &&
+				    (lru == NULL ||
+				     set->members[i].random_last_use < lru->random_last_use))
+					lru = &set->members[i];
+			}
+			wtap_close(lru->random_wth);
+			lru->random_wth = NULL;
+			set->random_open--;
+		}
+
+		member->random_wth = wtap_open_offline(member->filename,
+		    set->type, err, err_info, TRUE);
+		if (member->random_wth == NULL)
+			return FALSE;
+		/* We only want the random stream. */
+		wtap_sequential_close(member->random_wth);
+		set->random_open++;
+	}
+	member->random_last_use = ++set->random_clock;
+
+	if (!wtap_seek_read(member->random_wth, FILE_SET_OFFSET_OFF(seek_off),
+	    phdr, buf, err, err_info))
+		return FALSE;
+	file_set_map_interface(member, phdr);
+	return TRUE;
+}
+
+static void
+file_set_sequential_close(wtap *wth)
+{
+	struct file_set *set = wth->file_set;
+	guint i;
+
+	for (i = 0; i < set->count; i++) {
+		if (set->members[i].wth != NULL) {
+			wtap_close(set->members[i].wth);
+			set->members[i].wth = NULL;
+		}
+	}
+}
+
+static void
+file_set_close(wtap *wth)
+{
+	struct file_set *set = wth->file_set;
+	guint i;
+
+	file_set_sequential_close(wth);
+	for (i = 0; i < set->count; i++) {
+		if (set->members[i].random_wth != NULL)
+			wtap_close(set->members[i].random_wth);
+		g_array_free(set->members[i].idb_map, TRUE);
+		g_free(set->members[i].filename);
+	}
+	g_free(set->members);
+	g_free(set);
+	wth->file_set = NULL;
+}
+
+gint64
+file_set_size(wtap *wth)
+{
+	return wth->file_set->total_size;
+}
+
+gint64
+file_set_read_so_far(wtap *wth)
+{
+	struct file_set *set = wth->file_set;
+	gint64 so_far = 0;
+	guint i;
+
+	for (i = 0; i < set->next_member; i++) {
+		if (set->members[i].wth != NULL)
+			so_far += wtap_read_so_far(set->members[i].wth);
+		else
+			so_far += set->members[i].size;
+	}
+	return so_far;
+}
+
+void
+file_set_cleareof(wtap *wth)
+{
+	struct file_set *set = wth->file_set;
+	guint i;
+
+	for (i = 0; i < set->count; i++) {
+		if (set->members[i].wth != NULL)
+			wtap_cleareof(set->members[i].wth);
+	}
+}
+
+void
+file_set_fdclose(wtap *wth)
+{
+	struct file_set *set = wth->file_set;
+	guint i;
+
+	/*
+	 * The member handles are reopened lazily anyway, so just close
+	 * the random ones; we can't do without the sequential ones.
+	 */
+	for (i = 0; i < set->count; i++) {
+		if (set->members[i].random_wth != NULL) {
+			wtap_close(set->members[i].random_wth);
+			set->members[i].random_wth = NULL;
+		}
+	}
+	set->random_open = 0;
+}
+
+wtap *
+wtap_open_offline_set(const char *const *filenames, guint count,
+    unsigned int type, int *err, gchar **err_info, gboolean do_random _U_)
+{
+	ws_statb64 statb;
+	struct file_set *set;
+	wtap *wth;
+	wtap_optionblock_t shb;
+	guint i;
+
+	*err = 0;
+	*err_info = NULL;
+
+	if (count == 0 || count > FILE_SET_MAX_FILES) {
+		*err = WTAP_ERR_UNSUPPORTED;
+		*err_info = g_strdup_printf("file set: %u files is not a supported number of files",
+		    count);
+		return NULL;
+	}
+
+	set = g_new0(struct file_set, 1);
+	set->type = type;
+	set->count = count;
+	set->members = g_new0(file_set_member_t, count);
+	for (i = 0; i < count; i++) {
+		set->members[i].filename = g_strdup(filenames[i]);
+		set->members[i].idb_map = g_array_new(FALSE, FALSE, sizeof(guint));
+	}
+
+	wth = (wtap *)g_malloc0(sizeof(wtap));
+	wth->file_set = set;
+	wth->fh = NULL;
+	wth->random_fh = NULL;
+	wth->subtype_read = file_set_read;
+	wth->subtype_seek_read = file_set_seek_read;
+	wth->subtype_sequential_close = file_set_sequential_close;
+	wth->subtype_close = file_set_close;
+	wth->interface_data = g_array_new(FALSE, FALSE, sizeof(wtap_optionblock_t));
+	wth->frame_buffer = (struct Buffer *)g_malloc(sizeof(struct Buffer));
+	ws_buffer_init(wth->frame_buffer, 1500);
+
+	/*
+	 * Make sure all the members are there, without opening them.
+	 */
+	for (i = 0; i < count; i++) {
+		if (ws_stat64(filenames[i], &statb) < 0) {
+			*err = errno;
+			wtap_close(wth);
+			return NULL;
+		}
+		if (!S_ISREG(statb.st_mode)) {
+			*err = WTAP_ERR_NOT_REGULAR_FILE;
+			wtap_close(wth);
+			return NULL;
+		}
+		set->members[i].size = statb.st_size;
+		set->total_size += statb.st_size;
+	}
+
+	/*
+	 * The first member determines the file type and, unless others
+	 * turn out to be different, the encapsulation and time stamp
+	 * precision.
+	 */
+	set->members[0].wth = wtap_open_offline(filenames[0], type, err,
+	    err_info, FALSE);
+	if (set->members[0].wth == NULL) {
+		wtap_close(wth);
+		return NULL;
+	}
+	wth->file_type_subtype = wtap_file_type_subtype(set->members[0].wth);
+	wth->file_encap = wtap_file_encap(set->members[0].wth);
+	wth->file_tsprec = wtap_file_tsprec(set->members[0].wth);
+	wth->snapshot_length = wtap_snapshot_length(set->members[0].wth);
+	wth->shb_hdrs = wtap_file_get_shb_for_new_file(set->members[0].wth);
+	if (wth->shb_hdrs == NULL) {
+		wth->shb_hdrs = g_array_new(FALSE, FALSE, sizeof(wtap_optionblock_t));
+		shb = wtap_optionblock_create(WTAP_OPTION_BLOCK_NG_SECTION);
+		if (shb)
+			g_array_append_val(wth->shb_hdrs, shb);
+	}
+	wth->nrb_hdrs = wtap_file_get_nrb_for_new_file(set->members[0].wth);
+	file_set_update_idb_map(wth, &set->members[0]);
+
+	/*
+	 * Now that we know what it looks like, put it back; it'll be
+	 * opened again, and its first record read, by the first read.
+	 */
+	wtap_close(set->members[0].wth);
+	set->members[0].wth = NULL;
+
+	return wth;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
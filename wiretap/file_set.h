@@ -0,0 +1,36 @@
+/* file_set.h
+ *
+ * Wiretap Library
+ * Copyright (c) 1998 by Gilbert Ramirez <gram@alumni.rice.edu>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __FILE_SET_H__
+#define __FILE_SET_H__
+
+#include <glib.h>
+#include "wtap.h"
+
+/*
+ * A wtap opened with wtap_open_offline_set() has no FILE_T of its own;
+ * these do the file-level operations of wtap.c on its members instead.
+ */
+gint64 file_set_size(wtap *wth);
+gint64 file_set_read_so_far(wtap *wth);
+void file_set_cleareof(wtap *wth);
+void file_set_fdclose(wtap *wth);
+
+#endif /* __FILE_SET_H__ */
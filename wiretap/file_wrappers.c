@@ -47,6 +47,10 @@
 #include "file_wrappers.h"
 #include <wsutil/file_util.h>
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
 #ifdef HAVE_ZLIB
 #define ZLIB_CONST
 #include <zlib.h>
@@ -120,6 +124,12 @@ struct wtap_reader {
     /* fast seeking */
     GPtrArray *fast_seek;
     void *fast_seek_cur;
+#ifdef HAVE_SYS_MMAN_H
+    /* memory mapping, for file_map_data() */
+    unsigned char *map;        /* start of the mapping, or NULL */
+    gint64 map_size;           /* size of the mapping */
+    gboolean map_tried;        /* TRUE if we've tried to map the file */
+#endif
 };
 
 static int     /* gz_load */
@@ -782,6 +792,11 @@ file_fdopen(int fd)
 
     state->fast_seek_cur = NULL;
     state->fast_seek = NULL;
+#ifdef HAVE_SYS_MMAN_H
+    state->map = NULL;
+    state->map_size = 0;
+    state->map_tried = FALSE;
+#endif
 
     /* open the file with the appropriate mode (or just use fd) */
     state->fd = fd;
@@ -1248,6 +1263,82 @@ file_read(void *buf, unsigned int len, FILE_T file)
     return (int)got;
 }
 
+#ifdef HAVE_SYS_MMAN_H
+static void
+file_unmap(FILE_T file)
+{
+    if (file->map != NULL) {
+        munmap(file->map, (size_t)file->map_size);
+        file->map = NULL;
+        file->map_size = 0;
+    }
+    file->map_tried = FALSE;
+}
+#endif
+
+/*
+ * If the file is an uncompressed regular file, return a pointer to the
+ * next len bytes of it in a read-only memory mapping of the file, and
+ * skip past them, as file_read() would.  Otherwise, or if those bytes
+ * aren't all in the mapping (because the file has grown since we mapped
+ * it, or ends before them), return NULL without moving, so that the
+ * caller can file_read() them instead.
+ *
+ * The file is mapped the first time we're asked, and stays mapped until
+ * file_fdclose() or file_close(); the pointer is valid until then.  As
+ * with any memory mapping, if the file is truncated under us, touching
+ * the data gets us a SIGBUS, so this should only be used for files we
+ * don't expect anyone to truncate, such as a capture we're viewing.
+ */
+const guint8 *
+file_map_data(FILE_T file _U_, unsigned int len _U_)
+{
+#ifdef HAVE_SYS_MMAN_H
+    ws_statb64 statb;
+    void *map;
+    gint64 offset;
+    int err;
+
+    /*
+     * We don't know whether the file is compressed until we've read
+     * from it, and in a compressed file the offsets we hand out
+     * aren't offsets in the file.
+     */
+    if (file->compression != UNCOMPRESSED || file->is_compressed)
+        return NULL;
+
+    if (!file->map_tried) {
+        file->map_tried = TRUE;
+        /*
+         * Don't eat up the address space of a 32-bit process
+         * with big captures.
+         */
+        if (GLIB_SIZEOF_VOID_P >= 8 && file->fd != -1 &&
+            ws_fstat64(file->fd, &statb) == 0 && S_ISREG(statb.st_mode) &&
+            statb.st_size > 0) {
+            map = mmap(NULL, (size_t)statb.st_size, PROT_READ, MAP_SHARED,
+                       file->fd, 0);
+            if (map != MAP_FAILED) {
+                file->map = (unsigned char *)map;
+                file->map_size = statb.st_size;
+            }
+        }
+    }
+    if (file->map == NULL)
+        return NULL;
+
+    /* Offsets in an uncompressed file are offsets from where we started */
+    offset = file->start + file_tell(file);
+    if (offset < 0 || offset + len > file->map_size)
+        return NULL;
+    if (file_seek(file, len, SEEK_CUR, &err) == -1)
+        return NULL;
+    return file->map + offset;
+#else
+    return NULL;
+#endif
+}
+
 /*
  * XXX - this *peeks* at next byte, not a character.
  */
@@ -1421,6 +1512,9 @@ file_clearerr(FILE_T stream)
 void
 file_fdclose(FILE_T file)
 {
+#ifdef HAVE_SYS_MMAN_H
+    file_unmap(file);
+#endif
     ws_close(file->fd);
     file->fd = -1;
 }
@@ -1450,6 +1544,9 @@ file_close(FILE_T file)
         g_free(file->in);
     }
     g_free(file->fast_seek_cur);
+#ifdef HAVE_SYS_MMAN_H
+    file_unmap(file);
+#endif
     file->err = 0;
     file->err_info = NULL;
     g_free(file);
@@ -61,10 +61,16 @@ static int libpcap_try_header(wtap *wth, FILE_T fh, int *err, gchar **err_info,
 
 static gboolean libpcap_read(wtap *wth, int *err, gchar **err_info,
     gint64 *data_offset);
+static gboolean libpcap_resync(wtap *wth, gint64 offset,
+    gint64 *record_offset, int *err, gchar **err_info);
 static gboolean libpcap_seek_read(wtap *wth, gint64 seek_off,
     struct wtap_pkthdr *phdr, Buffer *buf, int *err, gchar **err_info);
+static gboolean libpcap_seek_read_ptr(wtap *wth, gint64 seek_off,
+    struct wtap_pkthdr *phdr, Buffer *buf, const guint8 **data, int *err,
+    gchar **err_info);
 static gboolean libpcap_read_packet(wtap *wth, FILE_T fh,
-    struct wtap_pkthdr *phdr, Buffer *buf, int *err, gchar **err_info);
+    struct wtap_pkthdr *phdr, Buffer *buf, const guint8 **data, int *err,
+    gchar **err_info);
 static gboolean libpcap_dump(wtap_dumper *wdh, const struct wtap_pkthdr *phdr,
     const guint8 *pd, int *err, gchar **err_info);
 static int libpcap_read_header(wtap *wth, FILE_T fh, int *err, gchar **err_info,
@@ -266,6 +272,8 @@ wtap_open_return_val libpcap_open(wtap *wth, int *err, gchar **err_info)
 	wth->priv = (void *)libpcap;
 	wth->subtype_read = libpcap_read;
 	wth->subtype_seek_read = libpcap_seek_read;
+	wth->subtype_seek_read_ptr = libpcap_seek_read_ptr;
+	wth->subtype_resync = libpcap_resync;
 	wth->file_encap = file_encap;
 	wth->snapshot_length = hdr.snaplen;
 
@@ -617,17 +625,105 @@ static gboolean libpcap_read(wtap *wth, int *err, gchar **err_info,
 	*data_offset = file_tell(wth->fh);
 
 	return libpcap_read_packet(wth, wth->fh, &wth->phdr,
-	    wth->frame_buffer, err, err_info);
+	    wth->frame_buffer, NULL, err, err_info);
+}
+
+/*
+ * Number of consecutive sane record headers we want to see before we
+ * believe we've found a record boundary, and how far we look for one.
+ */
+#define LIBPCAP_RESYNC_RECORDS	8
+#define LIBPCAP_RESYNC_MAX_SCAN	(2*WTAP_MAX_PACKET_SIZE)
+
+/*
+ * Check whether there's a chain of records starting at offset.
+ *
+ * Return -1 on an I/O error, 0 if it looks like a record boundary, or 1
+ * if it doesn't.
+ */
+static int libpcap_resync_try(wtap *wth, gint64 offset, int *err,
+    gchar **err_info)
+{
+	struct pcaprec_ss990915_hdr hdr;
+	int i;
+
+	for (i = 0; i < LIBPCAP_RESYNC_RECORDS; i++) {
+		if (file_seek(wth->fh, offset, SEEK_SET, err) == -1)
+			return -1;
+		switch (libpcap_try_header(wth, wth->fh, err, err_info, &hdr)) {
+
+		case -1:
+			if (*err == 0 && i != 0) {
+				/* The chain runs up to the end of the file */
+				return 0;
+			}
+			if (*err == 0 || *err == WTAP_ERR_SHORT_READ) {
+				*err = 0;
+				g_free(*err_info);
+				*err_info = NULL;
+				return 1;
+			}
+			return -1;
+
+		case 0:
+			break;
+
+		default:
+			return 1;
+		}
+		offset = file_tell(wth->fh) + hdr.hdr.incl_len;
+	}
+	return 0;
+}
+
+/*
+ * Find the first record at or after offset, for wtap_split_ranges().
+ * pcap records have no marker, so look for a run of headers with
+ * plausible contents each of which ends where the next one starts.
+ */
+static gboolean
+libpcap_resync(wtap *wth, gint64 offset, gint64 *record_offset, int *err,
+    gchar **err_info)
+{
+	gint64 candidate, size;
+
+	size = wtap_file_size(wth, err);
+	if (size == -1)
+		return FALSE;
+
+	for (candidate = offset;
+	    candidate < size && candidate < offset + LIBPCAP_RESYNC_MAX_SCAN;
+	    candidate++) {
+		switch (libpcap_resync_try(wth, candidate, err, err_info)) {
+
+		case -1:
+			return FALSE;
+
+		case 0:
+			*record_offset = candidate;
+			return TRUE;
+		}
+	}
+	*err = 0;
+	return FALSE;
 }
 
 static gboolean
 libpcap_seek_read(wtap *wth, gint64 seek_off, struct wtap_pkthdr *phdr,
     Buffer *buf, int *err, gchar **err_info)
+{
+	return libpcap_seek_read_ptr(wth, seek_off, phdr, buf, NULL, err,
+	    err_info);
+}
+
+static gboolean
+libpcap_seek_read_ptr(wtap *wth, gint64 seek_off, struct wtap_pkthdr *phdr,
+    Buffer *buf, const guint8 **data, int *err, gchar **err_info)
 {
 	if (file_seek(wth->random_fh, seek_off, SEEK_SET, err) == -1)
 		return FALSE;
 
-	if (!libpcap_read_packet(wth, wth->random_fh, phdr, buf, err,
+	if (!libpcap_read_packet(wth, wth->random_fh, phdr, buf, data, err,
 	    err_info)) {
 		if (*err == 0)
 			*err = WTAP_ERR_SHORT_READ;
@@ -638,9 +734,10 @@ libpcap_seek_read(wtap *wth, gint64 seek_off, struct wtap_pkthdr *phdr,
 
 static gboolean
 libpcap_read_packet(wtap *wth, FILE_T fh, struct wtap_pkthdr *phdr,
-    Buffer *buf, int *err, gchar **err_info)
+    Buffer *buf, const guint8 **data, int *err, gchar **err_info)
 {
 	struct pcaprec_ss990915_hdr hdr;
+	guint8 *pd;
 	guint packet_size;
 	guint orig_size;
 	int phdr_len;
@@ -717,14 +814,30 @@ libpcap_read_packet(wtap *wth, FILE_T fh, struct wtap_pkthdr *phdr,
 	phdr->len = orig_size;
 
 	/*
-	 * Read the packet data.
+	 * Read the packet data; if our caller can take a pointer to it,
+	 * and we don't have to fix it up, it can stay where it is in the
+	 * file's memory mapping, if it has one.
 	 */
-	if (!wtap_read_packet_bytes(fh, buf, packet_size, err, err_info))
-		return FALSE;	/* failed */
-
 	libpcap = (libpcap_t *)wth->priv;
+	if (data != NULL &&
+	    !pcap_read_post_process_writes_data(wth->file_encap,
+	      libpcap->byte_swapped)) {
+		if (!wtap_read_packet_bytes_ptr(fh, buf, packet_size, data,
+		    err, err_info))
+			return FALSE;	/* failed */
+		/* pcap_read_post_process() won't write to this */
+		pd = (guint8 *)*data;
+	} else {
+		if (!wtap_read_packet_bytes(fh, buf, packet_size, err,
+		    err_info))
+			return FALSE;	/* failed */
+		pd = ws_buffer_start_ptr(buf);
+		if (data != NULL)
+			*data = pd;
+	}
+
 	pcap_read_post_process(wth->file_type_subtype, wth->file_encap,
-	    phdr, ws_buffer_start_ptr(buf), libpcap->byte_swapped, -1);
+	    phdr, pd, libpcap->byte_swapped, -1);
 	return TRUE;
 }
 
@@ -1907,6 +1907,26 @@ pcap_read_post_process(int file_type, int wtap_encap,
 	}
 }
 
+/*
+ * Returns TRUE if pcap_read_post_process() may modify the packet data,
+ * rather than just the packet header, for this encapsulation; if not,
+ * the data can be left in a read-only memory mapping of the file.
+ */
+gboolean
+pcap_read_post_process_writes_data(int wtap_encap, gboolean bytes_swapped)
+{
+	switch (wtap_encap) {
+
+	case WTAP_ENCAP_USB_LINUX:
+	case WTAP_ENCAP_USB_LINUX_MMAPPED:
+	case WTAP_ENCAP_NFLOG:
+		return bytes_swapped;
+
+	default:
+		return FALSE;
+	}
+}
+
 int
 pcap_get_phdr_size(int encap, const union wtap_pseudo_header *pseudo_header)
 {
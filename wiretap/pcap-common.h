@@ -36,6 +36,9 @@ extern int pcap_process_pseudo_header(FILE_T fh, int file_type, int wtap_encap,
 extern void pcap_read_post_process(int file_type, int wtap_encap,
     struct wtap_pkthdr *phdr, guint8 *pd, gboolean bytes_swapped, int fcs_len);
 
+extern gboolean pcap_read_post_process_writes_data(int wtap_encap,
+    gboolean bytes_swapped);
+
 extern int pcap_get_phdr_size(int encap,
     const union wtap_pseudo_header *pseudo_header);
 
@@ -53,6 +53,13 @@ pcapng_read(wtap *wth, int *err, gchar **err_info,
 static gboolean
 pcapng_seek_read(wtap *wth, gint64 seek_off,
                  struct wtap_pkthdr *phdr, Buffer *buf, int *err, gchar **err_info);
+static gboolean
+pcapng_seek_read_ptr(wtap *wth, gint64 seek_off,
+                     struct wtap_pkthdr *phdr, Buffer *buf, const guint8 **data,
+                     int *err, gchar **err_info);
+static gboolean
+pcapng_resync(wtap *wth, gint64 offset, gint64 *record_offset,
+              int *err, gchar **err_info);
 static void
 pcapng_close(wtap *wth);
 
@@ -212,6 +219,8 @@ typedef struct wtapng_block_s {
      */
     struct wtap_pkthdr *packet_header;
     Buffer *frame_buffer;
+    const guint8 **frame_data;  /* if non-NULL, packet data may be left in the
+                                 * file's memory mapping; set to point to it */
 } wtapng_block_t;
 
 /* Interface data in private struct */
@@ -1014,6 +1023,7 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
     guint8 *option_content;
     int pseudo_header_len;
     int fcslen;
+    guint8 *pd;
 #ifdef HAVE_PLUGINS
     option_handler *handler;
 #endif
@@ -1208,10 +1218,24 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
     wblock->packet_header->ts.secs = (time_t)(ts / iface_info.time_units_per_second);
     wblock->packet_header->ts.nsecs = (int)(((ts % iface_info.time_units_per_second) * 1000000000) / iface_info.time_units_per_second);
 
-    /* "(Enhanced) Packet Block" read capture data */
-    if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
-                                packet.cap_len - pseudo_header_len, err, err_info))
-        return FALSE;
+    /* "(Enhanced) Packet Block" read capture data; if we won't have to
+       fix it up, it can stay in the file's memory mapping, if it has one */
+    if (wblock->frame_data != NULL &&
+        !pcap_read_post_process_writes_data(iface_info.wtap_encap, pn->byte_swapped)) {
+        if (!wtap_read_packet_bytes_ptr(fh, wblock->frame_buffer,
+                                        packet.cap_len - pseudo_header_len,
+                                        wblock->frame_data, err, err_info))
+            return FALSE;
+        /* pcap_read_post_process() won't write to this */
+        pd = (guint8 *)*wblock->frame_data;
+    } else {
+        if (!wtap_read_packet_bytes(fh, wblock->frame_buffer,
+                                    packet.cap_len - pseudo_header_len, err, err_info))
+            return FALSE;
+        pd = ws_buffer_start_ptr(wblock->frame_buffer);
+        if (wblock->frame_data != NULL)
+            *wblock->frame_data = pd;
+    }
     block_read += packet.cap_len - pseudo_header_len;
 
     /* jump over potential padding bytes at end of the packet data */
@@ -1348,7 +1372,7 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
     }
 
     pcap_read_post_process(WTAP_FILE_TYPE_SUBTYPE_PCAPNG, iface_info.wtap_encap,
-                           wblock->packet_header, ws_buffer_start_ptr(wblock->frame_buffer),
+                           wblock->packet_header, pd,
                            pn->byte_swapped, fcslen);
     return TRUE;
 }
@@ -2437,6 +2461,7 @@ pcapng_open(wtap *wth, int *err, gchar **err_info)
     /* we don't expect any packet blocks yet */
     wblock.frame_buffer = NULL;
     wblock.packet_header = NULL;
+    wblock.frame_data = NULL;
 
     pcapng_debug("pcapng_open: opening file");
     /* read first block */
@@ -2492,7 +2517,9 @@ pcapng_open(wtap *wth, int *err, gchar **err_info)
 
     wth->subtype_read = pcapng_read;
     wth->subtype_seek_read = pcapng_seek_read;
+    wth->subtype_seek_read_ptr = pcapng_seek_read_ptr;
     wth->subtype_close = pcapng_close;
+    wth->subtype_resync = pcapng_resync;
     wth->file_type_subtype = WTAP_FILE_TYPE_SUBTYPE_PCAPNG;
 
     /* Loop over all IDB:s that appear before any packets */
@@ -2556,6 +2583,7 @@ pcapng_read(wtap *wth, int *err, gchar **err_info, gint64 *data_offset)
 
     wblock.frame_buffer  = wth->frame_buffer;
     wblock.packet_header = &wth->phdr;
+    wblock.frame_data    = NULL;
 
     pcapng->add_new_ipv4 = wth->add_new_ipv4;
     pcapng->add_new_ipv6 = wth->add_new_ipv6;
@@ -2574,6 +2602,13 @@ pcapng_read(wtap *wth, int *err, gchar **err_info, gint64 *data_offset)
 
             case(BLOCK_TYPE_SHB):
                 pcapng_debug("pcapng_read: another section header block");
+                if (wth->range_resynced) {
+                    /* We've skipped the blocks before it */
+                    wtap_optionblock_free(wblock.block);
+                    *err = WTAP_ERR_UNSUPPORTED;
+                    *err_info = g_strdup("pcapng: file has several sections and can only be read sequentially");
+                    return FALSE;
+                }
                 g_array_append_val(wth->shb_hdrs, wblock.block);
                 break;
 
@@ -2588,6 +2623,16 @@ pcapng_read(wtap *wth, int *err, gchar **err_info, gint64 *data_offset)
             case(BLOCK_TYPE_IDB):
                 /* A new interface */
                 pcapng_debug("pcapng_read: block type BLOCK_TYPE_IDB");
+                if (wth->range_resynced) {
+                    /*
+                     * We may have skipped other IDBs, so we don't know
+                     * what interface number this one has.
+                     */
+                    wtap_optionblock_free(wblock.block);
+                    *err = WTAP_ERR_UNSUPPORTED;
+                    *err_info = g_strdup("pcapng: file has interface description blocks after its first packet and can only be read sequentially");
+                    return FALSE;
+                }
                 pcapng_process_idb(wth, pcapng, &wblock);
                 break;
 
@@ -2649,6 +2694,16 @@ static gboolean
 pcapng_seek_read(wtap *wth, gint64 seek_off,
                  struct wtap_pkthdr *phdr, Buffer *buf,
                  int *err, gchar **err_info)
+{
+    return pcapng_seek_read_ptr(wth, seek_off, phdr, buf, NULL, err, err_info);
+}
+
+
+/* seek to file position and read packet, without copying its data if we can */
+static gboolean
+pcapng_seek_read_ptr(wtap *wth, gint64 seek_off,
+                     struct wtap_pkthdr *phdr, Buffer *buf, const guint8 **data,
+                     int *err, gchar **err_info)
 {
     pcapng_t *pcapng = (pcapng_t *)wth->priv;
     block_return_val ret;
@@ -2663,6 +2718,9 @@ pcapng_seek_read(wtap *wth, gint64 seek_off,
 
     wblock.frame_buffer = buf;
     wblock.packet_header = phdr;
+    wblock.frame_data = data;
+    if (data != NULL)
+        *data = NULL;
 
     /* read the block */
     ret = pcapng_read_block(wth, wth->random_fh, pcapng, &wblock, err, err_info);
@@ -2682,10 +2740,133 @@ pcapng_seek_read(wtap *wth, gint64 seek_off,
         return FALSE;
     }
 
+    /* Only (enhanced) packet blocks are read without copying */
+    if (data != NULL && *data == NULL)
+        *data = ws_buffer_start_ptr(buf);
+
     return TRUE;
 }
 
 
+/*
+ * Number of consecutive well-formed blocks we want to see before we
+ * believe we've found a block boundary.
+ */
+#define PCAPNG_RESYNC_BLOCKS    4
+
+/*
+ * Check whether there's a chain of blocks starting at offset.
+ *
+ * Return -1 on an I/O error, 0 if it looks like a block boundary, or 1
+ * if it doesn't.
+ */
+static int
+pcapng_resync_try(wtap *wth, pcapng_t *pcapng, gint64 offset, int *err,
+                  gchar **err_info)
+{
+    pcapng_block_header_t bh;
+    guint32 block_total_length;
+    int i;
+
+    for (i = 0; i < PCAPNG_RESYNC_BLOCKS; i++) {
+        if (file_seek(wth->fh, offset, SEEK_SET, err) == -1)
+            return -1;
+        if (!wtap_read_bytes_or_eof(wth->fh, &bh, sizeof bh, err, err_info)) {
+            if (*err == 0 && i != 0) {
+                /* The chain runs up to the end of the file */
+                return 0;
+            }
+            if (*err == 0 || *err == WTAP_ERR_SHORT_READ)
+                goto not_a_block;
+            return -1;
+        }
+        if (pcapng->byte_swapped) {
+            bh.block_type         = GUINT32_SWAP_LE_BE(bh.block_type);
+            bh.block_total_length = GUINT32_SWAP_LE_BE(bh.block_total_length);
+        }
+
+        switch (bh.block_type) {
+
+            case(BLOCK_TYPE_SHB):
+            case(BLOCK_TYPE_IDB):
+            case(BLOCK_TYPE_PB):
+            case(BLOCK_TYPE_SPB):
+            case(BLOCK_TYPE_NRB):
+            case(BLOCK_TYPE_ISB):
+            case(BLOCK_TYPE_EPB):
+            case(BLOCK_TYPE_SYSDIG_EVENT):
+            case(BLOCK_TYPE_SYSDIG_EVF):
+                break;
+
+            default:
+                /* Not impossible, but too rare to resynchronise on */
+                return 1;
+        }
+        if (bh.block_total_length < MIN_BLOCK_SIZE ||
+            bh.block_total_length > MAX_BLOCK_SIZE ||
+            (bh.block_total_length % 4) != 0)
+            return 1;
+
+        /* The trailer must repeat the length */
+        if (!file_skip(wth->fh, bh.block_total_length - MIN_BLOCK_SIZE, err))
+            return -1;
+        if (!wtap_read_bytes(wth->fh, &block_total_length,
+                             sizeof block_total_length, err, err_info)) {
+            if (*err == 0 || *err == WTAP_ERR_SHORT_READ)
+                goto not_a_block;
+            return -1;
+        }
+        if (pcapng->byte_swapped)
+            block_total_length = GUINT32_SWAP_LE_BE(block_total_length);
+        if (block_total_length != bh.block_total_length)
+            return 1;
+
+        offset += bh.block_total_length;
+    }
+    return 0;
+
+not_a_block:
+    *err = 0;
+    g_free(*err_info);
+    *err_info = NULL;
+    return 1;
+}
+
+/*
+ * Find the first block at or after offset, for wtap_split_ranges().
+ * Blocks are a multiple of 4 bytes long, so they all start at a multiple
+ * of 4 from the beginning of the file (other than in files with several
+ * sections, which can't be read in ranges anyway); look for a run of
+ * blocks with a known type and matching lengths at either end.
+ */
+static gboolean
+pcapng_resync(wtap *wth, gint64 offset, gint64 *record_offset,
+              int *err, gchar **err_info)
+{
+    pcapng_t *pcapng = (pcapng_t *)wth->priv;
+    gint64 candidate, size;
+
+    size = wtap_file_size(wth, err);
+    if (size == -1)
+        return FALSE;
+
+    for (candidate = (offset + 3) & ~G_GINT64_CONSTANT(3);
+         candidate < size && candidate < offset + MAX_BLOCK_SIZE;
+         candidate += 4) {
+        switch (pcapng_resync_try(wth, pcapng, candidate, err, err_info)) {
+
+            case -1:
+                return FALSE;
+
+            case 0:
+                *record_offset = candidate;
+                return TRUE;
+        }
+    }
+    *err = 0;
+    return FALSE;
+}
+
 /* classic wtap: close capture file */
 static void
 pcapng_close(wtap *wth)
@@ -0,0 +1,433 @@
+/* time_index.c
+ *
+ * Coarse time stamp -> file offset index for pcap and pcapng files, kept
+ * in a sidecar file next to the capture, so that a reader interested in
+ * a time range can start near it rather than reading from the beginning.
+ *
+ * Wiretap Library
+ * Copyright (c) 1998 by Gilbert Ramirez <gram@alumni.rice.edu>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <wsutil/file_util.h>
+
+#include "wtap-int.h"
+#include "file_wrappers.h"
+#include "time_index.h"
+
+/*
+ * Records aren't guaranteed to be in time stamp order (pcapng files
+ * merged from several interfaces often aren't quite), so the index
+ * doesn't map a time to "the first record at or after it".  Instead,
+ * each entry gives a record offset along with
+ *
+ *   the latest time stamp of all the records before that offset, and
+ *   the earliest time stamp of all the records at or after that offset.
+ *
+ * Both are non-decreasing as we go through the file, so both can be
+ * binary searched.  Every record before an entry whose "latest before"
+ * is earlier than the start time can be skipped, and once we've reached
+ * an entry whose "earliest after" is at or past the stop time, there's
+ * nothing left to read.
+ *
+ * A new entry is started whenever the "latest before" time moves into a
+ * new TIME_INDEX_BUCKET_SECS bucket, so the index stays small (about
+ * 60000 entries for a week-long capture) no matter how many records
+ * there are.
+ *
+ * Skipping records also skips whatever other blocks lie between them,
+ * so name resolution blocks in the skipped part of a pcapng file are
+ * lost; interface description blocks are not, as we never start past
+ * one the reader hasn't seen.
+ *
+ * The sidecar is written in host byte order; one written on a machine of
+ * the other byte order has the magic number swapped, and is ignored.
+ */
+#define TIME_INDEX_BUCKET_SECS	10
+#define TIME_INDEX_MAGIC	0x58495457	/* "WTIX" */
+#define TIME_INDEX_VERSION	1
+#define TIME_INDEX_SUFFIX	".tidx"
+
+/* The capture has more than one pcapng section */
+#define TIME_INDEX_FLAG_MULTI_SECTION	0x00000001
+
+typedef struct {
+	guint32	magic;
+	guint32	version;
+	guint32	bucket_secs;
+	guint32	flags;
+	gint64	capture_size;	/* size and modification time of the capture */
+	gint64	capture_mtime;	/* the index was made from */
+	guint32	num_entries;
+	guint32	pad;
+} time_index_hdr_t;
+
+typedef struct {
+	gint64	offset;		/* offset of the first record of the entry */
+	gint64	latest_before;	/* latest time stamp before offset */
+	gint64	earliest_from;	/* earliest time stamp at or after offset */
+	guint32	num_interfaces;	/* interfaces described before offset */
+	guint32	pad;
+} time_index_entry_t;
+
+struct wtap_time_index {
+	gboolean	collecting;	/* building an index as we read */
+	gboolean	complete;	/* ...and we've read to EOF */
+	GArray		*entries;	/* array of time_index_entry_t */
+	gint64		latest;		/* latest time stamp seen so far */
+	gint64		stop_offset;	/* -1, or offset at which to stop */
+};
+
+/*
+ * "Nothing seen yet"; smaller than any real time stamp, so that the first
+ * entry always qualifies as a starting point.
+ */
+#define TIME_INDEX_NONE		G_MININT64
+
+static gint64
+time_index_bucket(gint64 secs)
+{
+	if (secs == TIME_INDEX_NONE)
+		return TIME_INDEX_NONE;
+	/* Round towards minus infinity, so that buckets are all the same width */
+	if (secs < 0)
+		return (secs - TIME_INDEX_BUCKET_SECS + 1) / TIME_INDEX_BUCKET_SECS;
+	return secs / TIME_INDEX_BUCKET_SECS;
+}
+
+static gboolean
+time_index_file_type_ok(int file_type_subtype)
+{
+	switch (file_type_subtype) {
+
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAPNG:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_NSEC:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_AIX:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_SS991029:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_NOKIA:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_SS990417:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_SS990915:
+		return TRUE;
+
+	default:
+		return FALSE;
+	}
+}
+
+static struct wtap_time_index *
+time_index_get(wtap *wth)
+{
+	if (wth->time_index == NULL) {
+		wth->time_index = g_new0(struct wtap_time_index, 1);
+		wth->time_index->latest = TIME_INDEX_NONE;
+		wth->time_index->stop_offset = -1;
+	}
+	return wth->time_index;
+}
+
+static gchar *
+time_index_filename(const char *filename)
+{
+	return g_strconcat(filename, TIME_INDEX_SUFFIX, NULL);
+}
+
+gboolean
+time_index_record(wtap *wth, gint64 data_offset)
+{
+	struct wtap_time_index *ti = wth->time_index;
+	time_index_entry_t *last, entry;
+	gint64 secs;
+
+	if (ti->stop_offset >= 0 && data_offset >= ti->stop_offset)
+		return FALSE;
+
+	if (!ti->collecting)
+		return TRUE;
+
+	last = ti->entries->len == 0 ? NULL :
+	    &g_array_index(ti->entries, time_index_entry_t, ti->entries->len - 1);
+	if (last == NULL ||
+	    time_index_bucket(ti->latest) != time_index_bucket(last->latest_before)) {
+		entry.offset = data_offset;
+		entry.latest_before = ti->latest;
+		entry.earliest_from = G_MAXINT64;	/* filled in as we go */
+		entry.num_interfaces = wth->interface_data != NULL ?
+		    wth->interface_data->len : 0;
+		entry.pad = 0;
+		g_array_append_val(ti->entries, entry);
+		last = &g_array_index(ti->entries, time_index_entry_t, ti->entries->len - 1);
+	}
+
+	if (wth->phdr.presence_flags & WTAP_HAS_TS) {
+		secs = (gint64)wth->phdr.ts.secs;
+		if (secs > ti->latest)
+			ti->latest = secs;
+		if (secs < last->earliest_from)
+			last->earliest_from = secs;
+	}
+	return TRUE;
+}
+
+void
+time_index_eof(wtap *wth)
+{
+	if (wth->time_index->collecting)
+		wth->time_index->complete = TRUE;
+}
+
+void
+time_index_free(wtap *wth)
+{
+	if (wth->time_index == NULL)
+		return;
+	if (wth->time_index->entries != NULL)
+		g_array_free(wth->time_index->entries, TRUE);
+	g_free(wth->time_index);
+	wth->time_index = NULL;
+}
+
+void
+wtap_time_index_collect(wtap *wth)
+{
+	struct wtap_time_index *ti;
+
+	if (!time_index_file_type_ok(wth->file_type_subtype) || wth->fh == NULL)
+		return;
+
+	ti = time_index_get(wth);
+	ti->collecting = TRUE;
+	ti->complete = FALSE;
+	ti->latest = TIME_INDEX_NONE;
+	if (ti->entries == NULL)
+		ti->entries = g_array_new(FALSE, FALSE, sizeof(time_index_entry_t));
+	else
+		g_array_set_size(ti->entries, 0);
+}
+
+gboolean
+wtap_time_index_save(wtap *wth, const char *filename, int *err)
+{
+	struct wtap_time_index *ti = wth->time_index;
+	time_index_hdr_t hdr;
+	ws_statb64 statb;
+	gchar *index_name;
+	FILE *fp;
+	guint i;
+	gint64 earliest;
+
+	*err = 0;
+	if (ti == NULL || !ti->collecting || !ti->complete) {
+		/* We didn't see the whole capture */
+		return FALSE;
+	}
+
+	if (ws_stat64(filename, &statb) < 0) {
+		*err = errno;
+		return FALSE;
+	}
+
+	/* Turn each entry's earliest time stamp into that of all the rest */
+	earliest = G_MAXINT64;
+	for (i = ti->entries->len; i != 0; i--) {
+		time_index_entry_t *entry =
+		    &g_array_index(ti->entries, time_index_entry_t, i - 1);
+
+		if (entry->earliest_from < earliest)
+			earliest = entry->earliest_from;
+		entry->earliest_from = earliest;
+	}
+
+	memset(&hdr, 0, sizeof hdr);
+	hdr.magic = TIME_INDEX_MAGIC;
+	hdr.version = TIME_INDEX_VERSION;
+	hdr.bucket_secs = TIME_INDEX_BUCKET_SECS;
+	if (wth->shb_hdrs != NULL && wth->shb_hdrs->len > 1)
+		hdr.flags |= TIME_INDEX_FLAG_MULTI_SECTION;
+	hdr.capture_size = (gint64)statb.st_size;
+	hdr.capture_mtime = (gint64)statb.st_mtime;
+	hdr.num_entries = ti->entries->len;
+
+	index_name = time_index_filename(filename);
+	fp = ws_fopen(index_name, "wb");
+	if (fp == NULL) {
+		*err = errno;
+		g_free(index_name);
+		return FALSE;
+	}
+	if (fwrite(&hdr, sizeof hdr, 1, fp) != 1 ||
+	    (ti->entries->len != 0 &&
+	     fwrite(ti->entries->data, sizeof (time_index_entry_t),
+	         ti->entries->len, fp) != ti->entries->len)) {
+		*err = errno;
+		fclose(fp);
+		ws_unlink(index_name);
+		g_free(index_name);
+		return FALSE;
+	}
+	if (fclose(fp) == EOF) {
+		*err = errno;
+		ws_unlink(index_name);
+		g_free(index_name);
+		return FALSE;
+	}
+	g_free(index_name);
+	return TRUE;
+}
+
+/*
+ * Read the sidecar index for filename, if there is one and it's still
+ * for the file as it is now; returns NULL if not.
+ */
+static GArray *
+time_index_load(const char *filename)
+{
+	ws_statb64 statb;
+	time_index_hdr_t hdr;
+	gchar *index_name;
+	FILE *fp;
+	GArray *entries;
+
+	if (ws_stat64(filename, &statb) < 0)
+		return NULL;
+
+	index_name = time_index_filename(filename);
+	fp = ws_fopen(index_name, "rb");
+	g_free(index_name);
+	if (fp == NULL)
+		return NULL;
+
+	if (fread(&hdr, sizeof hdr, 1, fp) != 1 ||
+	    hdr.magic != TIME_INDEX_MAGIC ||
+	    hdr.version != TIME_INDEX_VERSION ||
+	    (hdr.flags & TIME_INDEX_FLAG_MULTI_SECTION) ||
+	    hdr.capture_size != (gint64)statb.st_size ||
+	    hdr.capture_mtime != (gint64)statb.st_mtime ||
+	    hdr.num_entries == 0) {
+		fclose(fp);
+		return NULL;
+	}
+
+	entries = g_array_sized_new(FALSE, FALSE, sizeof(time_index_entry_t),
+	    hdr.num_entries);
+	g_array_set_size(entries, hdr.num_entries);
+	if (fread(entries->data, sizeof (time_index_entry_t), hdr.num_entries,
+	    fp) != hdr.num_entries) {
+		g_array_free(entries, TRUE);
+		entries = NULL;
+	}
+	fclose(fp);
+	return entries;
+}
+
+gboolean
+wtap_time_index_seek(wtap *wth, const char *filename, time_t start_time,
+    time_t stop_time, int *err)
+{
+	GArray *entries;
+	time_index_entry_t *entry;
+	guint lo, hi, mid, start_idx;
+	gint64 start_offset, cur_offset;
+
+	*err = 0;
+	if (!time_index_file_type_ok(wth->file_type_subtype) || wth->fh == NULL)
+		return FALSE;
+
+	entries = time_index_load(filename);
+	if (entries == NULL)
+		return FALSE;
+
+	/*
+	 * Find the last entry all of whose predecessors are before the
+	 * start time; entry 0 always is, as nothing precedes it.
+	 */
+	lo = 0;
+	hi = entries->len;
+	while (hi - lo > 1) {
+		mid = lo + (hi - lo) / 2;
+		entry = &g_array_index(entries, time_index_entry_t, mid);
+		if (entry->latest_before < (gint64)start_time)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	/*
+	 * The reader only knows about the interfaces described before the
+	 * first record; we can't skip an IDB it hasn't seen.
+	 */
+	while (lo > 0 &&
+	    g_array_index(entries, time_index_entry_t, lo).num_interfaces >
+	    (wth->interface_data != NULL ? wth->interface_data->len : 0))
+		lo--;
+	start_idx = lo;
+	start_offset = g_array_index(entries, time_index_entry_t, start_idx).offset;
+
+	/*
+	 * If we're not still where the open routine left us, something's
+	 * already been read, and we don't know where we are; don't touch it.
+	 */
+	cur_offset = file_tell(wth->fh);
+	if (cur_offset > g_array_index(entries, time_index_entry_t, 0).offset) {
+		g_array_free(entries, TRUE);
+		return FALSE;
+	}
+
+	if (start_offset > cur_offset &&
+	    file_seek(wth->fh, start_offset, SEEK_SET, err) == -1) {
+		g_array_free(entries, TRUE);
+		return FALSE;
+	}
+
+	/*
+	 * Find the first entry at or after which every record is at or
+	 * past the stop time.
+	 */
+	lo = start_idx;
+	hi = entries->len;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		entry = &g_array_index(entries, time_index_entry_t, mid);
+		if (entry->earliest_from >= (gint64)stop_time)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	time_index_get(wth)->stop_offset = lo < entries->len ?
+	    g_array_index(entries, time_index_entry_t, lo).offset : -1;
+
+	g_array_free(entries, TRUE);
+	return TRUE;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indent=8:tabSize=8:noTabs=false:
+ */
@@ -0,0 +1,41 @@
+/* time_index.h
+ *
+ * Wiretap Library
+ * Copyright (c) 1998 by Gilbert Ramirez <gram@alumni.rice.edu>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __TIME_INDEX_H__
+#define __TIME_INDEX_H__
+
+#include <glib.h>
+#include "wtap.h"
+
+/*
+ * Called by wtap_read() for every record it hands out if wth->time_index
+ * is set; returns FALSE if the record is past the stop offset found by
+ * wtap_time_index_seek(), in which case the read should end as if at EOF.
+ */
+gboolean time_index_record(wtap *wth, gint64 data_offset);
+
+/*
+ * Called by wtap_read() when the subtype read routine reports EOF.
+ */
+void time_index_eof(wtap *wth);
+
+void time_index_free(wtap *wth);
+
+#endif /* __TIME_INDEX_H__ */
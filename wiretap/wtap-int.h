@@ -40,6 +40,11 @@ typedef gboolean (*subtype_read_func)(struct wtap*, int*, char**, gint64*);
 typedef gboolean (*subtype_seek_read_func)(struct wtap*, gint64,
                                            struct wtap_pkthdr *, Buffer *buf,
                                            int *, char **);
+typedef gboolean (*subtype_seek_read_ptr_func)(struct wtap*, gint64,
+                                               struct wtap_pkthdr *, Buffer *buf,
+                                               const guint8 **, int *, char **);
+typedef gboolean (*subtype_resync_func)(struct wtap*, gint64, gint64 *,
+                                        int *, char **);
 
 /**
  * Struct holding data of the currently read file.
@@ -60,8 +65,15 @@ struct wtap {
 
     subtype_read_func           subtype_read;
     subtype_seek_read_func      subtype_seek_read;
+    subtype_seek_read_ptr_func  subtype_seek_read_ptr; /* NULL if the format
+                                                        * can't avoid copying
+                                                        * packet data */
     void                        (*subtype_sequential_close)(struct wtap*);
     void                        (*subtype_close)(struct wtap*);
+    subtype_resync_func         subtype_resync; /* find the first record at or
+                                                 * after an offset, for
+                                                 * wtap_split_ranges(); NULL
+                                                 * if the format can't */
     int                         file_encap;    /* per-file, for those
                                                 * file formats that have
                                                 * per-file encapsulation
@@ -81,6 +93,16 @@ struct wtap {
     wtap_new_ipv4_callback_t    add_new_ipv4;
     wtap_new_ipv6_callback_t    add_new_ipv6;
     GPtrArray                   *fast_seek;
+    struct file_set             *file_set;      /* non-NULL if this is a set of files
+                                                 * opened with wtap_open_offline_set();
+                                                 * see file_set.c */
+    struct wtap_time_index      *time_index;    /* non-NULL if we're building or
+                                                 * using a time index; see
+                                                 * time_index.c */
+    gint64                      range_end;      /* if non-zero, wtap_read()
+                                                 * stops at this offset */
+    gboolean                    range_resynced; /* wtap_set_read_range() has
+                                                 * skipped part of the file */
 };
 
 struct wtap_dumper;
@@ -306,6 +328,15 @@ gboolean
 wtap_read_packet_bytes(FILE_T fh, Buffer *buf, guint length, int *err,
     gchar **err_info);
 
+/*
+ * As wtap_read_packet_bytes(), but, if data is non-null, the packet data
+ * may be left in the file's memory mapping, rather than being copied
+ * into the Buffer; *data is set to point to it, wherever it is.
+ */
+gboolean
+wtap_read_packet_bytes_ptr(FILE_T fh, Buffer *buf, guint length,
+    const guint8 **data, int *err, gchar **err_info);
+
 #endif /* __WTAP_INT_H__ */
 
 /*
@@ -32,6 +32,8 @@
 #include "pcapng.h"
 
 #include "file_wrappers.h"
+#include "file_set.h"
+#include "time_index.h"
 #include <wsutil/file_util.h>
 #include <wsutil/buffer.h>
 
@@ -113,6 +115,9 @@ wtap_file_size(wtap *wth, int *err)
 {
 	ws_statb64 statb;
 
+	if (wth->file_set != NULL)
+		return file_set_size(wth);
+
 	if (file_fstat((wth->fh == NULL) ? wth->random_fh : wth->fh,
 	    &statb, err) == -1)
 		return -1;
@@ -125,6 +130,12 @@ wtap_file_size(wtap *wth, int *err)
 int
 wtap_fstat(wtap *wth, ws_statb64 *statb, int *err)
 {
+	if (wth->file_set != NULL) {
+		/* There's no one file to stat. */
+		*err = WTAP_ERR_UNSUPPORTED;
+		return -1;
+	}
+
 	if (file_fstat((wth->fh == NULL) ? wth->random_fh : wth->fh,
 	    statb, err) == -1)
 		return -1;
@@ -140,6 +151,9 @@ wtap_file_type_subtype(wtap *wth)
 gboolean
 wtap_iscompressed(wtap *wth)
 {
+	if (wth->file_set != NULL)
+		return FALSE;
+
 	return file_iscompressed((wth->fh == NULL) ? wth->random_fh : wth->fh);
 }
 
@@ -1182,6 +1196,8 @@ g_fast_seek_item_free(gpointer data, gpointer user_data _U_)
 void
 wtap_fdclose(wtap *wth)
 {
+	if (wth->file_set != NULL)
+		file_set_fdclose(wth);
 	if (wth->fh != NULL)
 		file_fdclose(wth->fh);
 	if (wth->random_fh != NULL)
@@ -1211,11 +1227,117 @@ wtap_close(wtap *wth)
 	wtap_optionblock_array_free(wth->nrb_hdrs);
 	wtap_optionblock_array_free(wth->interface_data);
 
+	time_index_free(wth);
+
 	g_free(wth);
 }
 
+GArray *
+wtap_split_ranges(wtap *wth, guint max_ranges, int *err, gchar **err_info)
+{
+	GArray *starts;
+	gint64 first, size, target, start;
+	guint i;
+
+	*err = 0;
+	*err_info = NULL;
+	starts = g_array_new(FALSE, FALSE, sizeof(gint64));
+	if (wth->fh == NULL) {
+		/* A file set or a random-access-only wtap */
+		return starts;
+	}
+	first = file_tell(wth->fh);
+	g_array_append_val(starts, first);
+
+	/*
+	 * We can only split files whose format knows how to find a
+	 * record boundary, and only if they're not compressed, as
+	 * seeking into the middle of a compressed file means
+	 * decompressing everything before that point anyway.
+	 */
+	if (max_ranges < 2 || wth->subtype_resync == NULL ||
+	    file_iscompressed(wth->fh))
+		return starts;
+
+	size = wtap_file_size(wth, err);
+	if (size == -1) {
+		g_array_free(starts, TRUE);
+		return NULL;
+	}
+
+	for (i = 1; i < max_ranges; i++) {
+		target = first + (size - first) / max_ranges * i;
+		if (target <= g_array_index(starts, gint64, starts->len - 1))
+			continue;
+		if (!wth->subtype_resync(wth, target, &start, err, err_info)) {
+			if (*err != 0) {
+				g_array_free(starts, TRUE);
+				return NULL;
+			}
+			/* No record boundary past the target */
+			break;
+		}
+		if (start > g_array_index(starts, gint64, starts->len - 1))
+			g_array_append_val(starts, start);
+	}
+
+	/* Go back to where we were, so that the wtap can still be read */
+	if (file_seek(wth->fh, first, SEEK_SET, err) == -1) {
+		g_array_free(starts, TRUE);
+		return NULL;
+	}
+	return starts;
+}
+
+gboolean
+wtap_set_read_range(wtap *wth, gint64 start, gint64 end, int *err)
+{
+	*err = 0;
+	if (wth->fh == NULL) {
+		*err = WTAP_ERR_UNSUPPORTED;
+		return FALSE;
+	}
+	if (start > file_tell(wth->fh)) {
+		if (file_seek(wth->fh, start, SEEK_SET, err) == -1)
+			return FALSE;
+		wth->range_resynced = TRUE;
+	}
+	wth->range_end = end;
+	return TRUE;
+}
+
+gboolean
+wtap_seek_read_is_standalone(int file_type_subtype)
+{
+	switch (file_type_subtype) {
+
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_NSEC:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_AIX:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_SS991029:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_NOKIA:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_SS990417:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_SS990915:
+		/* Everything a record needs is in the file header */
+		return TRUE;
+
+	default:
+		/*
+		 * pcapng only knows the interfaces it has read the
+		 * description blocks of, and other formats may set
+		 * things up as they're read, so assume the worst.
+		 */
+		return FALSE;
+	}
+}
+
 void
 wtap_cleareof(wtap *wth) {
+	if (wth->file_set != NULL) {
+		file_set_cleareof(wth);
+		return;
+	}
+
 	/* Reset EOF */
 	file_clearerr(wth->fh);
 }
@@ -1258,11 +1380,28 @@ wtap_read(wtap *wth, int *err, gchar **err_info, gint64 *data_offset)
 		 * got enough compressed data to decompress the
 		 * last packet of the file.
 		 */
-		if (*err == 0)
+		if (*err == 0 && wth->fh != NULL)
 			*err = file_error(wth->fh, err_info);
+		if (*err == 0 && wth->time_index != NULL)
+			time_index_eof(wth);
 		return FALSE;	/* failure */
 	}
 
+	/*
+	 * If we're using a time index, it may tell us that there's
+	 * nothing more of interest; if we're building one, note
+	 * where this record is.
+	 */
+	if (wth->time_index != NULL && !time_index_record(wth, *data_offset))
+		return FALSE;	/* EOF, as far as the caller's concerned */
+
+	/*
+	 * If we're reading a range of the file, the record at the end
+	 * of it belongs to the next range.
+	 */
+	if (wth->range_end != 0 && *data_offset >= wth->range_end)
+		return FALSE;	/* EOF, as far as the caller's concerned */
+
 	/*
 	 * It makes no sense for the captured data length to be bigger
 	 * than the actual data length.
@@ -1358,6 +1497,22 @@ wtap_read_packet_bytes(FILE_T fh, Buffer *buf, guint length, int *err,
 	    err_info);
 }
 
+gboolean
+wtap_read_packet_bytes_ptr(FILE_T fh, Buffer *buf, guint length,
+    const guint8 **data, int *err, gchar **err_info)
+{
+	if (data != NULL) {
+		*data = file_map_data(fh, length);
+		if (*data != NULL)
+			return TRUE;
+	}
+	if (!wtap_read_packet_bytes(fh, buf, length, err, err_info))
+		return FALSE;
+	if (data != NULL)
+		*data = ws_buffer_start_ptr(buf);
+	return TRUE;
+}
+
 /*
  * Return an approximation of the amount of data we've read sequentially
  * from the file so far.  (gint64, in case that's 64 bits.)
@@ -1365,6 +1520,9 @@ wtap_read_packet_bytes(FILE_T fh, Buffer *buf, guint length, int *err,
 gint64
 wtap_read_so_far(wtap *wth)
 {
+	if (wth->file_set != NULL)
+		return file_set_read_so_far(wth);
+
 	return file_tell_raw(wth->fh);
 }
 
@@ -1431,6 +1589,33 @@ wtap_seek_read(wtap *wth, gint64 seek_off,
 	return TRUE;
 }
 
+gboolean
+wtap_seek_read_ptr(wtap *wth, gint64 seek_off, struct wtap_pkthdr *phdr,
+    Buffer *buf, const guint8 **data, int *err, gchar **err_info)
+{
+	if (wth->subtype_seek_read_ptr == NULL) {
+		if (!wtap_seek_read(wth, seek_off, phdr, buf, err, err_info))
+			return FALSE;
+		*data = ws_buffer_start_ptr(buf);
+		return TRUE;
+	}
+
+	/* See wtap_seek_read() */
+	phdr->pkt_encap = wth->file_encap;
+	phdr->pkt_tsprec = wth->file_tsprec;
+
+	if (!wth->subtype_seek_read_ptr(wth, seek_off, phdr, buf, data, err,
+	    err_info))
+		return FALSE;
+
+	if (phdr->caplen > phdr->len)
+		phdr->caplen = phdr->len;
+
+	g_assert(phdr->pkt_encap != WTAP_ENCAP_PER_PACKET);
+
+	return TRUE;
+}
+
 /*
  * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
  *
@@ -1517,6 +1517,118 @@ WS_DLL_PUBLIC
 struct wtap* wtap_open_offline(const char *filename, unsigned int type, int *err,
     gchar **err_info, gboolean do_random);
 
+/** Open a set of capture files, such as the files written by a dumpcap
+ * ring buffer, as a single capture.  Members are opened as they are needed
+ * and, where their time ranges overlap, their records are merged in time
+ * stamp order.  The data offsets returned by wtap_read() for such a capture
+ * encode the member as well as the offset within it, and can be passed to
+ * wtap_seek_read() as usual.
+ *
+ * @param filenames Names of the member files, in the order in which they
+ * were written
+ * @param count Number of entries in filenames
+ * @param type As for wtap_open_offline(), applied to every member
+ * @param err As for wtap_open_offline()
+ * @param err_info As for wtap_open_offline()
+ * @param do_random As for wtap_open_offline()
+ */
+WS_DLL_PUBLIC
+struct wtap* wtap_open_offline_set(const char *const *filenames, guint count,
+    unsigned int type, int *err, gchar **err_info, gboolean do_random);
+
+/** Start building a time index for a pcap or pcapng file as it is read
+ * with wtap_read(); once it has been read to the end, the index can be
+ * saved with wtap_time_index_save().  Does nothing for other file types.
+ */
+WS_DLL_PUBLIC
+void wtap_time_index_collect(wtap *wth);
+
+/** Save the time index built since wtap_time_index_collect() in a sidecar
+ * file next to the capture, for wtap_time_index_seek() to use later.
+ *
+ * @param wth The wtap, which must have been read to the end
+ * @param filename Name of the capture file
+ * @param err Set to an errno value if the sidecar couldn't be written, or
+ * to 0 if there was no complete index to save
+ * @return TRUE on success, FALSE if nothing was saved
+ */
+WS_DLL_PUBLIC
+gboolean wtap_time_index_save(wtap *wth, const char *filename, int *err);
+
+/** If a capture has an up-to-date time index, skip the records that can't
+ * be at or after start_time, and have wtap_read() report EOF once no
+ * further record can be before stop_time.  Records within the time range
+ * are always read, but some outside it may be as well, so the caller must
+ * still check time stamps.  Must be called before the first wtap_read().
+ *
+ * @param wth The wtap, as returned by wtap_open_offline()
+ * @param filename Name of the capture file
+ * @param start_time Start of the time range
+ * @param stop_time End of the time range (exclusive)
+ * @param err Set to an error code if seeking failed, else to 0
+ * @return TRUE if the index was used, FALSE if all records will be read
+ */
+WS_DLL_PUBLIC
+gboolean wtap_time_index_seek(wtap *wth, const char *filename,
+    time_t start_time, time_t stop_time, int *err);
+
+/** Split an uncompressed capture file into byte ranges that start at record
+ * boundaries, so that it can be read by several threads at once; each of
+ * them opens the file with wtap_open_offline() and calls
+ * wtap_set_read_range() with its range.  The records of range i, in order,
+ * followed by those of range i + 1 are the records of the file, in order.
+ *
+ * Boundaries are found by looking for a few consecutive valid record
+ * headers near evenly spaced offsets, so this is cheap, but only supported
+ * for pcap and pcapng files; for other files, and compressed files, there
+ * is just one range.  Must be called before the first wtap_read().
+ *
+ * @param wth The wtap, as returned by wtap_open_offline()
+ * @param max_ranges The maximum number of ranges wanted
+ * @param err Set to an error code on failure
+ * @param err_info For some errors, a string giving more details
+ * @return An array of gint64 start offsets, range i running from element i
+ * up to element i + 1 or the end of the file, to be freed with
+ * g_array_free(); NULL on failure
+ */
+WS_DLL_PUBLIC
+GArray *wtap_split_ranges(wtap *wth, guint max_ranges, int *err,
+    gchar **err_info);
+
+/** Restrict wtap_read() to the records starting at or after start and
+ * before end, as found by wtap_split_ranges().  Must be called before the
+ * first wtap_read().
+ *
+ * pcapng files whose interface description blocks don't all come before
+ * the first packet can't be read this way; reading a range other than the
+ * first one of such a file fails with WTAP_ERR_UNSUPPORTED when it reaches
+ * such a block, and it must be read sequentially instead.  Name resolution
+ * blocks are only seen by the reader of the range they're in.
+ *
+ * @param wth The wtap, as returned by wtap_open_offline()
+ * @param start Offset of the first record to read
+ * @param end Offset at which to stop reading, or 0 to read to the end
+ * @param err Set to an error code on failure
+ * @return TRUE on success, FALSE on failure
+ */
+WS_DLL_PUBLIC
+gboolean wtap_set_read_range(wtap *wth, gint64 start, gint64 end, int *err);
+
+/** Return TRUE if wtap_seek_read() can read any record of a file of the
+ * given type with a wtap that has just been opened, as is done when
+ * several threads each open the file to read parts of it at random.
+ * Returns FALSE if it may need state that only reading the file
+ * sequentially up to the record sets up; for instance, a pcapng packet
+ * can refer to an interface description block that comes after the
+ * first packet, or to one of a later section.
+ *
+ * @param file_type_subtype The file's type, as returned by
+ * wtap_file_type_subtype()
+ * @return TRUE if a newly opened wtap can seek to any record
+ */
+WS_DLL_PUBLIC
+gboolean wtap_seek_read_is_standalone(int file_type_subtype);
+
 /**
  * If we were compiled with zlib and we're at EOF, unset EOF so that
  * wtap_read/gzread has a chance to succeed. This is necessary if
@@ -1548,6 +1660,17 @@ WS_DLL_PUBLIC
 gboolean wtap_seek_read (wtap *wth, gint64 seek_off,
         struct wtap_pkthdr *phdr, Buffer *buf, int *err, gchar **err_info);
 
+/** As wtap_seek_read(), but, for uncompressed files in formats that allow
+ * it, the packet data is not copied into buf; instead, *data is set to
+ * point to it in a memory mapping of the file, which stays valid until
+ * the wtap is closed.  Otherwise, the data is read into buf as usual, and
+ * *data points to the start of buf.  Either way, the data must not be
+ * modified. */
+WS_DLL_PUBLIC
+gboolean wtap_seek_read_ptr (wtap *wth, gint64 seek_off,
+        struct wtap_pkthdr *phdr, Buffer *buf, const guint8 **data,
+        int *err, gchar **err_info);
+
 /*** get various information snippets about the current packet ***/
 WS_DLL_PUBLIC
 struct wtap_pkthdr *wtap_phdr(wtap *wth);
@@ -0,0 +1,290 @@
+/* wtap_ranges_test.c
+ * Tests for reading capture files in ranges, and at random
+ *
+ * Wiretap Library
+ * Copyright (c) 1998 by Gilbert Ramirez <gram@alumni.rice.edu>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include "wtap.h"
+
+/* Try every number of ranges up to this */
+#define MAX_RANGES	32
+
+typedef struct {
+	gint64		offset;
+	nstime_t	ts;
+	guint32		caplen;
+	guint32		len;
+	guint32		interface_id;
+	guint8		*data;
+} test_record_t;
+
+static void
+free_records(GArray *records)
+{
+	guint i;
+
+	for (i = 0; i < records->len; i++)
+		g_free(g_array_index(records, test_record_t, i).data);
+	g_array_free(records, TRUE);
+}
+
+static wtap *
+open_file(const char *filename)
+{
+	wtap *wth;
+	int err;
+	gchar *err_info;
+
+	wth = wtap_open_offline(filename, WTAP_TYPE_AUTO, &err, &err_info, TRUE);
+	if (wth == NULL) {
+		g_printerr("%s: %s\n", filename, wtap_strerror(err));
+		g_free(err_info);
+	}
+	g_assert(wth != NULL);
+	return wth;
+}
+
+static guint
+num_interfaces(wtap *wth)
+{
+	wtapng_iface_descriptions_t *idb_info;
+	guint count;
+
+	idb_info = wtap_file_get_idb_info(wth);
+	count = idb_info->interface_data->len;
+	g_free(idb_info);
+	return count;
+}
+
+/* Append the records of wth, from where it is to where it stops, to records */
+static void
+read_records(wtap *wth, GArray *records)
+{
+	struct wtap_pkthdr *phdr;
+	test_record_t rec;
+	gint64 data_offset;
+	int err;
+	gchar *err_info;
+
+	while (wtap_read(wth, &err, &err_info, &data_offset)) {
+		phdr = wtap_phdr(wth);
+		if (phdr->rec_type != REC_TYPE_PACKET)
+			continue;
+		rec.offset = data_offset;
+		rec.ts = phdr->ts;
+		rec.caplen = phdr->caplen;
+		rec.len = phdr->len;
+		rec.interface_id = (phdr->presence_flags & WTAP_HAS_INTERFACE_ID) ?
+		    phdr->interface_id : 0;
+		rec.data = (guint8 *)g_memdup(wtap_buf_ptr(wth), phdr->caplen);
+		g_array_append_val(records, rec);
+	}
+	if (err != 0) {
+		g_printerr("%s\n", wtap_strerror(err));
+		g_free(err_info);
+	}
+	g_assert_cmpint(err, ==, 0);
+}
+
+static void
+check_same_records(GArray *ranged, GArray *whole)
+{
+	guint i;
+
+	g_assert_cmpuint(ranged->len, ==, whole->len);
+	for (i = 0; i < whole->len; i++) {
+		test_record_t *r = &g_array_index(ranged, test_record_t, i);
+		test_record_t *w = &g_array_index(whole, test_record_t, i);
+
+		g_assert_cmpint(r->offset, ==, w->offset);
+		g_assert_cmpint(nstime_cmp(&r->ts, &w->ts), ==, 0);
+		g_assert_cmpuint(r->caplen, ==, w->caplen);
+		g_assert_cmpuint(r->len, ==, w->len);
+		g_assert_cmpuint(r->interface_id, ==, w->interface_id);
+		g_assert(memcmp(r->data, w->data, w->caplen) == 0);
+	}
+}
+
+/*
+ * Split the file into up to 1, 2, ... MAX_RANGES ranges, which moves the
+ * offsets at which we look for a record boundary around, read each range
+ * with a wtap of its own, and check that the ranges, one after the other,
+ * give every record of the file once and in order.
+ */
+static void
+wtap_ranges_test_split(gconstpointer data)
+{
+	const char *filename = (const char *)data;
+	GArray *whole, *ranged, *starts;
+	wtap *wth;
+	guint max_ranges, i;
+	gboolean split = FALSE, late_idbs;
+	guint num_at_open;
+	gint64 end;
+	int err;
+	gchar *err_info;
+
+	whole = g_array_new(FALSE, FALSE, sizeof(test_record_t));
+	wth = open_file(filename);
+	num_at_open = num_interfaces(wth);
+	read_records(wth, whole);
+	late_idbs = num_interfaces(wth) != num_at_open;
+	wtap_close(wth);
+	g_assert_cmpuint(whole->len, >, 1);
+
+	if (late_idbs) {
+		/* Such a file can only be read sequentially */
+		g_test_message("%s has interfaces described after its first packet", filename);
+		free_records(whole);
+		return;
+	}
+
+	for (max_ranges = 1; max_ranges <= MAX_RANGES; max_ranges++) {
+		wth = open_file(filename);
+		starts = wtap_split_ranges(wth, max_ranges, &err, &err_info);
+		if (starts == NULL) {
+			g_printerr("%s: %s\n", filename, wtap_strerror(err));
+			g_free(err_info);
+		}
+		g_assert(starts != NULL);
+		wtap_close(wth);
+		g_assert_cmpuint(starts->len, >=, 1);
+		g_assert_cmpuint(starts->len, <=, max_ranges);
+		if (starts->len > 1)
+			split = TRUE;
+
+		ranged = g_array_new(FALSE, FALSE, sizeof(test_record_t));
+		for (i = 0; i < starts->len; i++) {
+			end = (i + 1 < starts->len) ? g_array_index(starts, gint64, i + 1) : 0;
+			wth = open_file(filename);
+			g_assert(wtap_set_read_range(wth, g_array_index(starts, gint64, i), end, &err));
+			read_records(wth, ranged);
+			wtap_close(wth);
+		}
+		check_same_records(ranged, whole);
+
+		free_records(ranged);
+		g_array_free(starts, TRUE);
+	}
+
+	/* Make sure we tested more than reading the file in one go */
+	g_assert(split);
+
+	free_records(whole);
+}
+
+/*
+ * Read every record with a wtap that has only just been opened, as the
+ * parallel packet search does, and check that this works for the file
+ * types wtap_seek_read_is_standalone() says it works for.  pcapng files
+ * with interfaces described after their first packet are the reason
+ * it doesn't say so for pcapng.
+ */
+static void
+wtap_ranges_test_seek_read(gconstpointer data)
+{
+	const char *filename = (const char *)data;
+	GArray *whole;
+	wtap *wth;
+	struct wtap_pkthdr phdr;
+	Buffer buf;
+	guint num_at_open, i, failed = 0;
+	gboolean late_idbs, standalone;
+	int err;
+	gchar *err_info;
+
+	whole = g_array_new(FALSE, FALSE, sizeof(test_record_t));
+	wth = open_file(filename);
+	num_at_open = num_interfaces(wth);
+	read_records(wth, whole);
+	late_idbs = num_interfaces(wth) != num_at_open;
+	standalone = wtap_seek_read_is_standalone(wtap_file_type_subtype(wth));
+	wtap_close(wth);
+	g_assert_cmpuint(whole->len, >, 1);
+
+	wtap_phdr_init(&phdr);
+	ws_buffer_init(&buf, 1500);
+	wth = open_file(filename);
+	/* Go through the records backwards, so that no record is read
+	   after the one before it */
+	for (i = whole->len; i > 0; i--) {
+		test_record_t *w = &g_array_index(whole, test_record_t, i - 1);
+
+		if (!wtap_seek_read(wth, w->offset, &phdr, &buf, &err, &err_info)) {
+			g_free(err_info);
+			failed++;
+			continue;
+		}
+		g_assert_cmpuint(phdr.caplen, ==, w->caplen);
+		g_assert(memcmp(ws_buffer_start_ptr(&buf), w->data, w->caplen) == 0);
+	}
+	wtap_close(wth);
+	ws_buffer_free(&buf);
+	wtap_phdr_cleanup(&phdr);
+
+	if (standalone)
+		g_assert_cmpuint(failed, ==, 0);
+	if (late_idbs)
+		g_assert(!standalone);
+
+	free_records(whole);
+}
+
+int
+main(int argc, char **argv)
+{
+	int i;
+	gchar *path;
+
+	g_test_init(&argc, &argv, NULL);
+
+	if (argc < 2) {
+		fprintf(stderr, "Usage: wtap_ranges_test <pcap or pcapng file> ...\n");
+		return 1;
+	}
+
+	for (i = 1; i < argc; i++) {
+		path = g_strdup_printf("/wtap/split_ranges/%d", i);
+		g_test_add_data_func(path, argv[i], wtap_ranges_test_split);
+		g_free(path);
+		path = g_strdup_printf("/wtap/seek_read/%d", i);
+		g_test_add_data_func(path, argv[i], wtap_ranges_test_seek_read);
+		g_free(path);
+	}
+
+	return g_test_run();
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -0,0 +1,342 @@
+/* ws_memmem.c
+ * Single and multiple pattern byte string search
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include <string.h>
+
+#include <glib.h>
+#include "ws_memmem.h"
+
+/*
+ * SSE2 is part of the baseline instruction set on x86-64 (and is
+ * enabled explicitly for 32-bit x86 builds that ask for it), so no
+ * cpuid check is needed to use it.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WS_MEMMEM_SSE2
+#include <emmintrin.h>
+#endif
+
+/*
+ * Pattern sets whose trie would have more states than this don't get
+ * a transition table (it takes 1KiB per state); ws_mempatterns_exec()
+ * then searches for each pattern in turn.
+ */
+#define WS_MEMPATTERNS_MAX_STATES	1024
+
+#define NO_STATE	G_MAXUINT32
+
+struct _ws_mempatterns {
+	guint	  num_patterns;
+	guint8	**patterns;
+	size_t	 *pattern_lens;
+
+	/* Aho-Corasick automaton; delta is NULL if there are too many states */
+	guint	  num_states;
+	guint32	 *delta;	/* num_states * 256 transitions */
+	gint	 *out;		/* pattern ending in each state, or -1 */
+};
+
+static const guint8 *
+ws_memmem_scalar(const guint8 *haystack, size_t haystack_len,
+		const guint8 *needle, size_t needle_len)
+{
+	const guint8 *begin;
+	const guint8 *const last_possible = haystack + haystack_len - needle_len;
+
+	if (needle_len > haystack_len) {
+		return NULL;
+	}
+
+	for (begin = haystack; begin <= last_possible; begin++) {
+		begin = (const guint8 *)memchr(begin, needle[0],
+				last_possible - begin + 1);
+		if (begin == NULL) {
+			return NULL;
+		}
+		if (memcmp(begin + 1, needle + 1, needle_len - 1) == 0) {
+			return begin;
+		}
+	}
+
+	return NULL;
+}
+
+#ifdef WS_MEMMEM_SSE2
+static unsigned
+lowest_bit(unsigned mask)
+{
+#if defined(__GNUC__)
+	return (unsigned)__builtin_ctz(mask);
+#else
+	unsigned bit = 0;
+
+	while (!(mask & 1)) {
+		mask >>= 1;
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+/*
+ * Compare the first and the last byte of the needle against 16 candidate
+ * positions at once, and only memcmp() the middle of the needle where
+ * both match.  Needles are at least 2 bytes long here.
+ */
+static const guint8 *
+ws_memmem_sse2(const guint8 *haystack, size_t haystack_len,
+		const guint8 *needle, size_t needle_len)
+{
+	const __m128i first = _mm_set1_epi8((char)needle[0]);
+	const __m128i last = _mm_set1_epi8((char)needle[needle_len - 1]);
+	size_t i;
+
+	for (i = 0; i + needle_len + 15 <= haystack_len; i += 16) {
+		__m128i block_first = _mm_loadu_si128((const __m128i *)(haystack + i));
+		__m128i block_last = _mm_loadu_si128((const __m128i *)(haystack + i + needle_len - 1));
+		unsigned mask = (unsigned)_mm_movemask_epi8(
+				_mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+					_mm_cmpeq_epi8(last, block_last)));
+
+		while (mask) {
+			unsigned bit = lowest_bit(mask);
+
+			if (memcmp(haystack + i + bit + 1, needle + 1, needle_len - 2) == 0) {
+				return haystack + i + bit;
+			}
+			mask &= mask - 1;
+		}
+	}
+
+	/* Fewer than 16 candidate positions left */
+	return ws_memmem_scalar(haystack + i, haystack_len - i, needle, needle_len);
+}
+#endif
+
+const guint8 *
+ws_memmem(const guint8 *haystack, size_t haystack_len,
+		const guint8 *needle, size_t needle_len)
+{
+	if (needle_len == 0 || needle_len > haystack_len) {
+		return NULL;
+	}
+
+	if (needle_len == 1) {
+		return (const guint8 *)memchr(haystack, needle[0], haystack_len);
+	}
+
+#ifdef WS_MEMMEM_SSE2
+	return ws_memmem_sse2(haystack, haystack_len, needle, needle_len);
+#else
+	return ws_memmem_scalar(haystack, haystack_len, needle, needle_len);
+#endif
+}
+
+static void
+ws_mempatterns_build(ws_mempatterns *set, guint max_states)
+{
+	guint32 *delta;
+	gint *out;
+	guint32 *fail;
+	guint32 *queue;
+	guint head = 0, tail = 0;
+	guint32 num_states = 1;
+	guint i, c;
+
+	delta = g_new(guint32, (gsize)max_states * 256);
+	out = g_new(gint, max_states);
+	fail = g_new0(guint32, max_states);
+	queue = g_new(guint32, max_states);
+
+	/* Build the trie */
+	for (c = 0; c < 256; c++) {
+		delta[c] = NO_STATE;
+	}
+	out[0] = -1;
+	for (i = 0; i < set->num_patterns; i++) {
+		guint32 s = 0;
+		size_t j;
+
+		if (set->pattern_lens[i] == 0) {
+			continue;
+		}
+		for (j = 0; j < set->pattern_lens[i]; j++) {
+			guint32 *t = &delta[s * 256 + set->patterns[i][j]];
+
+			if (*t == NO_STATE) {
+				*t = num_states;
+				for (c = 0; c < 256; c++) {
+					delta[num_states * 256 + c] = NO_STATE;
+				}
+				out[num_states] = -1;
+				num_states++;
+			}
+			s = *t;
+		}
+		/* Duplicate patterns all end here; report the first one */
+		if (out[s] == -1) {
+			out[s] = (gint)i;
+		}
+	}
+
+	/* Missing edges out of the root loop back to it */
+	for (c = 0; c < 256; c++) {
+		if (delta[c] == NO_STATE) {
+			delta[c] = 0;
+		} else {
+			fail[delta[c]] = 0;
+			queue[tail++] = delta[c];
+		}
+	}
+
+	/*
+	 * Breadth-first, so the failure state of every state (which is
+	 * shallower) is complete before the state itself is; that lets
+	 * missing edges be copied from it to turn the trie into a DFA.
+	 */
+	while (head < tail) {
+		guint32 r = queue[head++];
+
+		if (out[r] == -1) {
+			out[r] = out[fail[r]];
+		}
+		for (c = 0; c < 256; c++) {
+			guint32 u = delta[r * 256 + c];
+
+			if (u == NO_STATE) {
+				delta[r * 256 + c] = delta[fail[r] * 256 + c];
+			} else {
+				fail[u] = delta[fail[r] * 256 + c];
+				queue[tail++] = u;
+			}
+		}
+	}
+
+	g_free(fail);
+	g_free(queue);
+
+	set->num_states = num_states;
+	set->delta = delta;
+	set->out = out;
+}
+
+ws_mempatterns *
+ws_mempatterns_new(const guint8 * const *patterns, const size_t *pattern_lens,
+		guint num_patterns)
+{
+	ws_mempatterns *set;
+	size_t total_len = 0;
+	guint i;
+
+	set = g_new0(ws_mempatterns, 1);
+	set->num_patterns = num_patterns;
+	set->patterns = g_new(guint8 *, num_patterns);
+	set->pattern_lens = g_new(size_t, num_patterns);
+	for (i = 0; i < num_patterns; i++) {
+		set->patterns[i] = (guint8 *)g_memdup(patterns[i], (guint)pattern_lens[i]);
+		set->pattern_lens[i] = pattern_lens[i];
+		total_len += pattern_lens[i];
+	}
+
+	/* The trie has at most one state per pattern byte, plus the root */
+	if (total_len < WS_MEMPATTERNS_MAX_STATES) {
+		ws_mempatterns_build(set, (guint)total_len + 1);
+	}
+
+	return set;
+}
+
+const guint8 *
+ws_mempatterns_exec(const ws_mempatterns *set, const guint8 *haystack,
+		size_t haystack_len, guint *found_pattern)
+{
+	const guint8 *best = NULL;
+	const guint8 *best_end = NULL;
+	guint best_pattern = 0;
+	size_t i;
+
+	if (set->delta) {
+		guint32 s = 0;
+
+		for (i = 0; i < haystack_len; i++) {
+			s = set->delta[s * 256 + haystack[i]];
+			if (set->out[s] >= 0) {
+				if (found_pattern) {
+					*found_pattern = (guint)set->out[s];
+				}
+				return haystack + i + 1 - set->pattern_lens[set->out[s]];
+			}
+		}
+		return NULL;
+	}
+
+	/* No automaton; pick the match that ends first */
+	for (i = 0; i < set->num_patterns; i++) {
+		const guint8 *match;
+
+		match = ws_memmem(haystack, haystack_len,
+				set->patterns[i], set->pattern_lens[i]);
+		if (match && (best == NULL || match + set->pattern_lens[i] < best_end)) {
+			best = match;
+			best_end = match + set->pattern_lens[i];
+			best_pattern = (guint)i;
+		}
+	}
+
+	if (best && found_pattern) {
+		*found_pattern = best_pattern;
+	}
+	return best;
+}
+
+void
+ws_mempatterns_free(ws_mempatterns *set)
+{
+	guint i;
+
+	if (!set) {
+		return;
+	}
+	for (i = 0; i < set->num_patterns; i++) {
+		g_free(set->patterns[i]);
+	}
+	g_free(set->patterns);
+	g_free(set->pattern_lens);
+	g_free(set->delta);
+	g_free(set->out);
+	g_free(set);
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -0,0 +1,67 @@
+/* ws_memmem.h
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __WS_MEMMEM_H__
+#define __WS_MEMMEM_H__
+
+#include <glib.h>
+#include "ws_symbol_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/** Return the first occurrence of needle in haystack, or NULL if there
+ * is none or if either of them is empty.
+ *
+ * Candidate positions are found 16 at a time by comparing the first and
+ * last byte of the needle with SSE2 where that is available; the rest
+ * of the needle is only compared at those positions.
+ */
+WS_DLL_PUBLIC const guint8 *ws_memmem(const guint8 *haystack, size_t haystack_len,
+        const guint8 *needle, size_t needle_len);
+
+/** A set of byte patterns that can be searched for in one pass over
+ * the haystack with ws_mempatterns_exec().
+ */
+typedef struct _ws_mempatterns ws_mempatterns;
+
+/** Compile a pattern set.  Empty patterns are accepted but never match.
+ * The pattern bytes are copied.
+ */
+WS_DLL_PUBLIC ws_mempatterns *ws_mempatterns_new(const guint8 * const *patterns,
+        const size_t *pattern_lens, guint num_patterns);
+
+/** Find the first (leftmost-ending) occurrence of any of the patterns in
+ * haystack.  Returns a pointer to the start of the match, and sets
+ * *found_pattern, if non-NULL, to the index of the pattern that matched;
+ * returns NULL if none of them occurs.
+ */
+WS_DLL_PUBLIC const guint8 *ws_mempatterns_exec(const ws_mempatterns *set,
+        const guint8 *haystack, size_t haystack_len, guint *found_pattern);
+
+WS_DLL_PUBLIC void ws_mempatterns_free(ws_mempatterns *set);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __WS_MEMMEM_H__ */